@@ -0,0 +1,234 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/DataLogReader.h>
+#include <wpi/MemoryBuffer.h>
+#include <wpi/argparse.h>
+#include <wpi/fs.h>
+#include <wpi/mutex.h>
+#include <wpi/print.h>
+#include <wpi/raw_ostream.h>
+
+#include "LogExport.h"
+
+#ifndef RUNNING_DATALOGTOOL_TESTS
+
+namespace {
+enum class Format { kCsvList, kCsvTable, kColumnar };
+
+struct Options {
+  Format format;
+  ColumnarWriter::Compression compression;
+  std::vector<std::string> include;
+  std::vector<std::string> exclude;
+  int64_t startTime;
+  int64_t endTime;
+  std::string outputDir;
+  bool overwrite;
+};
+}  // namespace
+
+static wpi::mutex gPrintMutex;
+
+static bool IsSelected(const Options& options,
+                       const wpi::log::StartRecordData& data) {
+  if (!options.include.empty() &&
+      std::none_of(options.include.begin(), options.include.end(),
+                   [&](auto& p) { return GlobMatch(p, data.name); })) {
+    return false;
+  }
+  return std::none_of(options.exclude.begin(), options.exclude.end(),
+                      [&](auto& p) { return GlobMatch(p, data.name); });
+}
+
+// returns an error message, or empty on success
+static std::string ExportFile(const Options& options,
+                              const std::string& filename) {
+  auto fileBuffer = wpi::MemoryBuffer::GetFile(filename);
+  if (!fileBuffer) {
+    return fmt::format("could not open file: {}",
+                       fileBuffer.error().message());
+  }
+  wpi::log::DataLogReader reader{std::move(*fileBuffer)};
+  if (!reader.IsValid()) {
+    return "not a valid datalog file";
+  }
+
+  fs::path inPath{filename};
+  fs::path outPath = inPath.parent_path();
+  if (!options.outputDir.empty()) {
+    outPath = options.outputDir;
+  }
+  bool binary = options.format == Format::kColumnar;
+  outPath /= inPath.filename().replace_extension(binary ? "wpicol" : "csv");
+
+  std::error_code ec;
+  auto of = fs::OpenFileForWrite(
+      outPath, ec, options.overwrite ? fs::CD_CreateAlways : fs::CD_CreateNew,
+      binary ? fs::OF_None : fs::OF_Text);
+  if (ec) {
+    return fmt::format("{}: {}", outPath.string(), ec.message());
+  }
+  wpi::raw_fd_ostream os{
+      fs::FileToFd(of, ec, binary ? fs::OF_None : fs::OF_Text), true};
+
+  auto selected = [&](const wpi::log::StartRecordData& data) {
+    return IsSelected(options, data);
+  };
+  ExportFilter filter{selected, options.startTime, options.endTime};
+  switch (options.format) {
+    case Format::kCsvList:
+      ExportCsvList(reader, os, filter);
+      break;
+    case Format::kCsvTable:
+      ExportCsvTable(reader, os, GetExportEntryNames(reader, filter), filter);
+      break;
+    case Format::kColumnar:
+      ExportColumnar(reader, os, options.compression, filter);
+      break;
+  }
+  os.close();
+  if (os.has_error()) {
+    auto msg = fmt::format("{}: {}", outPath.string(), os.error().message());
+    os.clear_error();
+    return msg;
+  }
+  return {};
+}
+
+static int64_t SecondsToMicros(double seconds) {
+  if (seconds <= INT64_MIN / 1e6) {
+    return INT64_MIN;
+  } else if (seconds >= INT64_MAX / 1e6) {
+    return INT64_MAX;
+  } else {
+    return std::llround(seconds * 1e6);
+  }
+}
+
+int main(int argc, char** argv) {
+  wpi::ArgumentParser program{"datalogtool-cli"};
+  program.add_description(
+      "Exports data logs to CSV or columnar files without the GUI.  Each "
+      "input file is written to a file of the same name in the output "
+      "directory; multiple files are exported concurrently.");
+  program.add_argument("files")
+      .help("input .wpilog files")
+      .nargs(wpi::nargs_pattern::at_least_one);
+  program.add_argument("-o", "--output")
+      .help("output directory (default: alongside each input file)")
+      .default_value(std::string{});
+  program.add_argument("-f", "--format")
+      .help("output format")
+      .choices("list", "table", "columnar")
+      .default_value(std::string{"list"});
+  program.add_argument("--no-compress")
+      .help("do not compress columnar output")
+      .flag();
+  program.add_argument("-e", "--entry")
+      .help("export only entries matching this glob (may be repeated)")
+      .append()
+      .default_value(std::vector<std::string>{});
+  program.add_argument("-x", "--exclude")
+      .help("do not export entries matching this glob (may be repeated)")
+      .append()
+      .default_value(std::vector<std::string>{});
+  program.add_argument("--start")
+      .help("skip records before this time, in seconds")
+      .scan<'g', double>();
+  program.add_argument("--end")
+      .help("skip records after this time, in seconds")
+      .scan<'g', double>();
+  program.add_argument("-j", "--jobs")
+      .help("number of files to export concurrently (default: CPU count)")
+      .scan<'u', unsigned int>()
+      .default_value(0u);
+  program.add_argument("--overwrite")
+      .help("overwrite existing output files")
+      .flag();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::exception& err) {
+    wpi::print(stderr, "{}\n", err.what());
+    wpi::print(stderr, "{}", program.help().str());
+    return 1;
+  }
+
+  Options options;
+  auto format = program.get<std::string>("--format");
+  if (format == "table") {
+    options.format = Format::kCsvTable;
+  } else if (format == "columnar") {
+    options.format = Format::kColumnar;
+  } else {
+    options.format = Format::kCsvList;
+  }
+  options.compression = program.get<bool>("--no-compress")
+                            ? ColumnarWriter::kNone
+                            : ColumnarWriter::kLz4;
+  options.include = program.get<std::vector<std::string>>("--entry");
+  options.exclude = program.get<std::vector<std::string>>("--exclude");
+  options.startTime = INT64_MIN;
+  if (auto start = program.present<double>("--start")) {
+    options.startTime = SecondsToMicros(*start);
+  }
+  options.endTime = INT64_MAX;
+  if (auto end = program.present<double>("--end")) {
+    options.endTime = SecondsToMicros(*end);
+  }
+  options.outputDir = program.get<std::string>("--output");
+  options.overwrite = program.get<bool>("--overwrite");
+
+  auto files = program.get<std::vector<std::string>>("files");
+  unsigned int numThreads = program.get<unsigned int>("--jobs");
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  numThreads = std::min<size_t>(numThreads, files.size());
+
+  // each worker exports one file at a time; memory use is bounded by the
+  // per-file export buffers, as input files are memory mapped
+  std::atomic<size_t> next{0};
+  std::atomic_int numErrors{0};
+  auto worker = [&] {
+    for (;;) {
+      size_t i = next++;
+      if (i >= files.size()) {
+        return;
+      }
+      auto err = ExportFile(options, files[i]);
+      std::scoped_lock lock{gPrintMutex};
+      if (err.empty()) {
+        wpi::print("{}: done\n", files[i]);
+      } else {
+        wpi::print(stderr, "{}: {}\n", files[i], err);
+        ++numErrors;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+
+  return numErrors == 0 ? 0 : 1;
+}
+
+#endif
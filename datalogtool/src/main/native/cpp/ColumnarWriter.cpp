@@ -0,0 +1,165 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ColumnarWriter.h"
+
+#include <string>
+#include <vector>
+
+#include <wpi/Endian.h>
+#include <wpi/lz4.h>
+#include <wpi/raw_ostream.h>
+
+static constexpr char kMagic[] = "WPICOL";
+static constexpr uint16_t kVersion = 1;
+
+static void Write16(wpi::raw_ostream& os, uint16_t val) {
+  uint8_t buf[2];
+  wpi::support::endian::write16le(buf, val);
+  os.write(buf, sizeof(buf));
+}
+
+static void Write32(wpi::raw_ostream& os, uint32_t val) {
+  uint8_t buf[4];
+  wpi::support::endian::write32le(buf, val);
+  os.write(buf, sizeof(buf));
+}
+
+static void Write64(wpi::raw_ostream& os, uint64_t val) {
+  uint8_t buf[8];
+  wpi::support::endian::write64le(buf, val);
+  os.write(buf, sizeof(buf));
+}
+
+static void WriteString(wpi::raw_ostream& os, std::string_view str) {
+  Write32(os, str.size());
+  os << str;
+}
+
+static void Append32(wpi::SmallVectorImpl<uint8_t>& buf, uint32_t val) {
+  uint8_t data[4];
+  wpi::support::endian::write32le(data, val);
+  buf.append(data, data + sizeof(data));
+}
+
+static void Append64(wpi::SmallVectorImpl<uint8_t>& buf, uint64_t val) {
+  uint8_t data[8];
+  wpi::support::endian::write64le(data, val);
+  buf.append(data, data + sizeof(data));
+}
+
+static uint32_t GetValueSize(std::string_view type) {
+  if (type == "boolean") {
+    return 1;
+  } else if (type == "int64" || type == "int" || type == "double") {
+    // support "int" for compatibility with old NT4 datalogs
+    return 8;
+  } else if (type == "float") {
+    return 4;
+  } else {
+    return 0;
+  }
+}
+
+ColumnarWriter::ColumnarWriter(wpi::raw_ostream& os, Compression compression,
+                               size_t chunkSize)
+    : m_os{os}, m_compression{compression}, m_chunkSize{chunkSize} {
+  m_os << std::string_view{kMagic, 6};
+  Write16(m_os, kVersion);
+}
+
+int ColumnarWriter::AddColumn(std::string_view name, std::string_view type,
+                              std::string_view metadata) {
+  auto& column = m_columns.emplace_back();
+  column.name = name;
+  column.type = type;
+  column.metadata = metadata;
+  column.valueSize = GetValueSize(type);
+  return m_columns.size() - 1;
+}
+
+void ColumnarWriter::Append(int column, int64_t timestamp,
+                            std::span<const uint8_t> data) {
+  auto& col = m_columns[column];
+  if (col.valueSize != 0 && data.size() != col.valueSize) {
+    return;
+  }
+  col.timestamps.emplace_back(timestamp);
+  col.values.insert(col.values.end(), data.begin(), data.end());
+  if (col.valueSize == 0) {
+    col.ends.emplace_back(col.values.size());
+  }
+  if ((col.timestamps.size() * 8 + col.ends.size() * 4 + col.values.size()) >=
+      m_chunkSize) {
+    WriteChunk(col, column);
+  }
+}
+
+void ColumnarWriter::Finish() {
+  for (size_t i = 0; i < m_columns.size(); ++i) {
+    WriteChunk(m_columns[i], i);
+  }
+
+  uint64_t footerOffset = m_os.tell();
+  Write32(m_os, m_columns.size());
+  for (auto&& column : m_columns) {
+    WriteString(m_os, column.name);
+    WriteString(m_os, column.type);
+    WriteString(m_os, column.metadata);
+    Write32(m_os, column.valueSize);
+    Write64(m_os, column.rows);
+    Write32(m_os, column.chunkOffsets.size());
+    for (auto offset : column.chunkOffsets) {
+      Write64(m_os, offset);
+    }
+  }
+
+  Write64(m_os, footerOffset);
+  m_os << std::string_view{kMagic, 6};
+  Write16(m_os, kVersion);
+  m_os.flush();
+}
+
+void ColumnarWriter::WriteChunk(Column& column, int index) {
+  if (column.timestamps.empty()) {
+    return;
+  }
+
+  m_buf.clear();
+  int64_t prev = 0;
+  for (auto timestamp : column.timestamps) {
+    // delta encoding makes regularly sampled timestamps very compressible
+    Append64(m_buf, timestamp - prev);
+    prev = timestamp;
+  }
+  for (auto end : column.ends) {
+    Append32(m_buf, end);
+  }
+  m_buf.append(column.values.begin(), column.values.end());
+
+  std::span<const uint8_t> stored = m_buf;
+  Compression compression = m_compression;
+  if (compression == kLz4) {
+    m_compressed.clear();
+    stored = wpi::Lz4Compress(m_buf, m_compressed);
+    if (stored.size() >= m_buf.size()) {
+      // incompressible; store as-is
+      stored = m_buf;
+      compression = kNone;
+    }
+  }
+
+  column.chunkOffsets.emplace_back(m_os.tell());
+  Write32(m_os, index);
+  Write32(m_os, column.timestamps.size());
+  Write32(m_os, compression);
+  Write32(m_os, m_buf.size());
+  Write32(m_os, stored.size());
+  m_os.write(stored.data(), stored.size());
+
+  column.rows += column.timestamps.size();
+  column.timestamps.clear();
+  column.ends.clear();
+  column.values.clear();
+}
@@ -0,0 +1,108 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/SmallVector.h>
+
+namespace wpi {
+class raw_ostream;
+}  // namespace wpi
+
+/**
+ * Writes log data in a columnar binary format, with one column of timestamps
+ * and values per entry.
+ *
+ * Rows are buffered per column and written in chunks, so memory use is bounded
+ * by the chunk size times the number of columns, regardless of log size.
+ *
+ * File layout (all integers little endian):
+ * - header: "WPICOL" magic, uint16 version (1)
+ * - chunks, in any order: uint32 column, uint32 rows, uint32 compression
+ *   (0 = none, 1 = LZ4 block), uint32 uncompressed size, uint32 stored size,
+ *   stored data.  Uncompressed data is rows int64 timestamps (the first
+ *   absolute, the rest the difference from the previous row), followed by
+ *   the values.  Fixed size values (boolean, int64, float, double) are stored
+ *   directly; other values are stored as rows uint32 end offsets followed by
+ *   the concatenated value bytes, in the same encoding as the data log.
+ * - footer: uint32 number of columns, then for each column: name, type and
+ *   metadata (each uint32 length and bytes), uint32 value size (0 if
+ *   variable), uint64 rows, uint32 chunks, uint64 offset of each chunk
+ * - trailer: uint64 offset of the footer, "WPICOL" magic, uint16 version
+ */
+class ColumnarWriter {
+ public:
+  enum Compression : uint32_t { kNone = 0, kLz4 = 1 };
+
+  static constexpr size_t kDefaultChunkSize = 256 * 1024;
+
+  /**
+   * Constructs a writer and writes the file header.
+   *
+   * @param os output stream; must be opened in binary mode
+   * @param compression chunk compression
+   * @param chunkSize approximate uncompressed size of each chunk, in bytes
+   */
+  ColumnarWriter(wpi::raw_ostream& os, Compression compression,
+                 size_t chunkSize = kDefaultChunkSize);
+
+  ColumnarWriter(const ColumnarWriter&) = delete;
+  ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+  /**
+   * Adds a column.
+   *
+   * @param name entry name
+   * @param type entry type
+   * @param metadata entry metadata
+   * @return Column index
+   */
+  int AddColumn(std::string_view name, std::string_view type,
+                std::string_view metadata);
+
+  /**
+   * Appends a row to a column.  Values of fixed size types that are the wrong
+   * size are skipped.
+   *
+   * @param column column index
+   * @param timestamp timestamp, in integer microseconds
+   * @param data value, in data log record encoding
+   */
+  void Append(int column, int64_t timestamp, std::span<const uint8_t> data);
+
+  /**
+   * Writes all buffered rows and the footer.  No more rows may be appended.
+   */
+  void Finish();
+
+ private:
+  struct Column {
+    std::string name;
+    std::string type;
+    std::string metadata;
+    uint32_t valueSize;
+    uint64_t rows = 0;
+    std::vector<uint64_t> chunkOffsets;
+    // buffered chunk
+    std::vector<int64_t> timestamps;
+    std::vector<uint32_t> ends;
+    std::vector<uint8_t> values;
+  };
+
+  void WriteChunk(Column& column, int index);
+
+  wpi::raw_ostream& m_os;
+  Compression m_compression;
+  size_t m_chunkSize;
+  std::vector<Column> m_columns;
+  wpi::SmallVector<uint8_t, 128> m_buf;
+  wpi::SmallVector<uint8_t, 128> m_compressed;
+};
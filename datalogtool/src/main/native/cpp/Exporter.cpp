@@ -5,7 +5,6 @@
 #include "Exporter.h"
 
 #include <atomic>
-#include <ctime>
 #include <functional>
 #include <future>
 #include <map>
@@ -16,27 +15,24 @@
 #include <utility>
 #include <vector>
 
-#include <fmt/chrono.h>
 #include <fmt/format.h>
-#include <fmt/ranges.h>
 #include <glass/Storage.h>
 #include <glass/support/DataLogReaderThread.h>
 #include <imgui.h>
 #include <imgui_internal.h>
 #include <imgui_stdlib.h>
 #include <portable-file-dialogs.h>
-#include <wpi/DenseMap.h>
 #include <wpi/MemoryBuffer.h>
 #include <wpi/SmallVector.h>
 #include <wpi/SpanExtras.h>
 #include <wpi/StringExtras.h>
-#include <wpi/fmt/raw_ostream.h>
 #include <wpi/fs.h>
 #include <wpi/mutex.h>
-#include <wpi/print.h>
 #include <wpi/raw_ostream.h>
 
 #include "App.h"
+#include "ColumnarWriter.h"
+#include "LogExport.h"
 
 namespace {
 struct InputFile {
@@ -67,9 +63,6 @@ struct Entry {
   bool typeConflict = false;
   bool metadataConflict = false;
   bool selected = true;
-
-  // used only during export
-  int column = -1;
 };
 
 struct EntryTreeNode {
@@ -438,160 +431,50 @@ void DisplayEntries() {
 static wpi::mutex gExportMutex;
 static std::vector<std::string> gExportErrors;
 
-static void PrintEscapedCsvString(wpi::raw_ostream& os, std::string_view str) {
-  auto s = str;
-  while (!s.empty()) {
-    std::string_view fragment;
-    std::tie(fragment, s) = wpi::split(s, '"');
-    os << fragment;
-    if (!s.empty()) {
-      os << '"' << '"';
-    }
-  }
-  if (wpi::ends_with(str, '"')) {
-    os << '"' << '"';
-  }
-}
-
-static void ValueToCsv(wpi::raw_ostream& os, const Entry& entry,
-                       const wpi::log::DataLogRecord& record) {
-  // handle systemTime specially
-  if (entry.name == "systemTime" && entry.type == "int64") {
-    int64_t val;
-    if (record.GetInteger(&val)) {
-      std::time_t timeval = val / 1000000;
-      wpi::print(os, "{:%Y-%m-%d %H:%M:%S}.{:06}", *std::localtime(&timeval),
-                 val % 1000000);
-      return;
-    }
-  } else if (entry.type == "double") {
-    double val;
-    if (record.GetDouble(&val)) {
-      wpi::print(os, "{}", val);
-      return;
-    }
-  } else if (entry.type == "int64" || entry.type == "int") {
-    // support "int" for compatibility with old NT4 datalogs
-    int64_t val;
-    if (record.GetInteger(&val)) {
-      wpi::print(os, "{}", val);
-      return;
-    }
-  } else if (entry.type == "string" || entry.type == "json") {
-    std::string_view val;
-    record.GetString(&val);
-    os << '"';
-    PrintEscapedCsvString(os, val);
-    os << '"';
-    return;
-  } else if (entry.type == "boolean") {
-    bool val;
-    if (record.GetBoolean(&val)) {
-      wpi::print(os, "{}", val);
-      return;
-    }
-  } else if (entry.type == "boolean[]") {
-    std::vector<int> val;
-    if (record.GetBooleanArray(&val)) {
-      wpi::print(os, "{}", fmt::join(val, ";"));
-      return;
-    }
-  } else if (entry.type == "double[]") {
-    std::vector<double> val;
-    if (record.GetDoubleArray(&val)) {
-      wpi::print(os, "{}", fmt::join(val, ";"));
-      return;
-    }
-  } else if (entry.type == "float[]") {
-    std::vector<float> val;
-    if (record.GetFloatArray(&val)) {
-      wpi::print(os, "{}", fmt::join(val, ";"));
-      return;
-    }
-  } else if (entry.type == "int64[]") {
-    std::vector<int64_t> val;
-    if (record.GetIntegerArray(&val)) {
-      wpi::print(os, "{}", fmt::join(val, ";"));
-      return;
-    }
-  } else if (entry.type == "string[]") {
-    std::vector<std::string_view> val;
-    if (record.GetStringArray(&val)) {
-      os << '"';
-      bool first = true;
-      for (auto&& v : val) {
-        if (!first) {
-          os << ';';
-        }
-        first = false;
-        PrintEscapedCsvString(os, v);
-      }
-      os << '"';
-      return;
-    }
-  }
-  wpi::print(os, "<invalid>");
+// selects entries checked in the GUI
+static bool IsSelected(const wpi::log::StartRecordData& data) {
+  auto it = gEntries.find(data.name);
+  return it != gEntries.end() && it->second->selected;
 }
 
 static void ExportCsvFile(InputFile& f, wpi::raw_ostream& os, int style) {
-  // header
+  ExportFilter filter{IsSelected};
   if (style == 0) {
-    os << "Timestamp,Name,Value\n";
+    ExportCsvList(f.datalog->GetReader(), os, filter);
   } else if (style == 1) {
-    // scan for exported fields for this file to print header and assign columns
-    os << "Timestamp";
-    int columnNum = 0;
+    // exported fields for this file, in name order
+    std::vector<std::string> columns;
     for (auto&& entry : gEntries) {
       if (entry.second->selected &&
           entry.second->inputFiles.find(&f) != entry.second->inputFiles.end()) {
-        os << ',' << '"';
-        PrintEscapedCsvString(os, entry.first);
-        os << '"';
-        entry.second->column = columnNum++;
-      } else {
-        entry.second->column = -1;
+        columns.emplace_back(entry.first);
       }
     }
-    os << '\n';
+    ExportCsvTable(f.datalog->GetReader(), os, columns, filter);
   }
+}
 
-  wpi::DenseMap<int, Entry*> nameMap;
-  for (auto&& record : f.datalog->GetReader()) {
-    if (record.IsStart()) {
-      wpi::log::StartRecordData data;
-      if (record.GetStartData(&data)) {
-        auto it = gEntries.find(data.name);
-        if (it != gEntries.end() && it->second->selected) {
-          nameMap[data.entry] = it->second.get();
-        }
-      }
-    } else if (record.IsFinish()) {
-      int entry;
-      if (record.GetFinishEntry(&entry)) {
-        nameMap.erase(entry);
-      }
-    } else if (!record.IsControl()) {
-      auto entryIt = nameMap.find(record.GetEntry());
-      if (entryIt == nameMap.end()) {
+static void ExportColumnarFiles(std::string_view outputFolder,
+                                ColumnarWriter::Compression compression) {
+  fs::path outPath{outputFolder};
+  for (auto&& f : gInputFiles) {
+    if (f.second->datalog) {
+      std::error_code ec;
+      auto of = fs::OpenFileForWrite(
+          outPath / fs::path{f.first}.replace_extension("wpicol"), ec,
+          fs::CD_CreateNew, fs::OF_None);
+      if (ec) {
+        std::scoped_lock lock{gExportMutex};
+        gExportErrors.emplace_back(
+            fmt::format("{}: {}", f.first, ec.message()));
+        ++gExportCount;
         continue;
       }
-      Entry* entry = entryIt->second;
-
-      if (style == 0) {
-        wpi::print(os, "{},\"", record.GetTimestamp() / 1000000.0);
-        PrintEscapedCsvString(os, entry->name);
-        os << '"' << ',';
-        ValueToCsv(os, *entry, record);
-        os << '\n';
-      } else if (style == 1 && entry->column != -1) {
-        wpi::print(os, "{},", record.GetTimestamp() / 1000000.0);
-        for (int i = 0; i < entry->column; ++i) {
-          os << ',';
-        }
-        ValueToCsv(os, *entry, record);
-        os << '\n';
-      }
+      wpi::raw_fd_ostream os{fs::FileToFd(of, ec, fs::OF_None), true};
+      ExportColumnar(f.second->datalog->GetReader(), os, compression,
+                     ExportFilter{IsSelected});
     }
+    ++gExportCount;
   }
 }
 
@@ -630,20 +513,32 @@ void DisplayOutput(glass::Storage& storage) {
     }
     ImGui::TextUnformatted(outputFolder.c_str());
 
-    static const char* const options[] = {"List", "Table"};
+    static const char* const options[] = {"List", "Table", "Columnar"};
     static int style = 0;
     ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8);
     ImGui::Combo("Style", &style, options,
                  sizeof(options) / sizeof(const char*));
+    static bool compress = true;
+    if (style == 2) {
+      ImGui::SameLine();
+      ImGui::Checkbox("Compress", &compress);
+    }
 
     static std::future<void> exporter;
     if (!gInputFiles.empty() && !outputFolder.empty() &&
-        ImGui::Button("Export CSV") &&
+        ImGui::Button(style == 2 ? "Export Columnar" : "Export CSV") &&
         (gExportCount == 0 ||
          gExportCount == static_cast<int>(gInputFiles.size()))) {
       gExportCount = 0;
       gExportErrors.clear();
-      exporter = std::async(std::launch::async, ExportCsv, outputFolder, style);
+      if (style == 2) {
+        exporter = std::async(
+            std::launch::async, ExportColumnarFiles, outputFolder,
+            compress ? ColumnarWriter::kLz4 : ColumnarWriter::kNone);
+      } else {
+        exporter =
+            std::async(std::launch::async, ExportCsv, outputFolder, style);
+      }
     }
     if (exporter.valid()) {
       ImGui::SameLine();
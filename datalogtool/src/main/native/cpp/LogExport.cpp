@@ -0,0 +1,283 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "LogExport.h"
+
+#include <algorithm>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <wpi/DataLogReader.h>
+#include <wpi/DenseMap.h>
+#include <wpi/StringExtras.h>
+#include <wpi/StringMap.h>
+#include <wpi/fmt/raw_ostream.h>
+#include <wpi/print.h>
+#include <wpi/raw_ostream.h>
+
+namespace {
+struct ExportEntry {
+  std::string name;
+  std::string type;
+  int column = -1;
+};
+}  // namespace
+
+// Calls onStart for each selected start record (to fill in the entry column)
+// and func for each record of a selected entry within the time range.
+static void ForEachExportRecord(
+    const wpi::log::DataLogReader& reader, const ExportFilter& filter,
+    wpi::function_ref<void(ExportEntry& entry,
+                           const wpi::log::StartRecordData& data)>
+        onStart,
+    wpi::function_ref<void(const ExportEntry& entry,
+                           const wpi::log::DataLogRecord& record)>
+        func) {
+  wpi::DenseMap<int, ExportEntry> entries;
+  for (auto&& record : reader) {
+    if (record.IsStart()) {
+      wpi::log::StartRecordData data;
+      if (record.GetStartData(&data) &&
+          (!filter.selected || filter.selected(data))) {
+        auto& entry = entries[data.entry];
+        entry.name = data.name;
+        entry.type = data.type;
+        entry.column = -1;
+        onStart(entry, data);
+      }
+    } else if (record.IsFinish()) {
+      int entry;
+      if (record.GetFinishEntry(&entry)) {
+        entries.erase(entry);
+      }
+    } else if (!record.IsControl()) {
+      auto it = entries.find(record.GetEntry());
+      if (it == entries.end()) {
+        continue;
+      }
+      int64_t timestamp = record.GetTimestamp();
+      if (timestamp < filter.startTime || timestamp > filter.endTime) {
+        continue;
+      }
+      func(it->second, record);
+    }
+  }
+}
+
+bool GlobMatch(std::string_view pattern, std::string_view str) {
+  // iterative matching with single-star backtracking
+  size_t p = 0;
+  size_t s = 0;
+  size_t starP = std::string_view::npos;
+  size_t starS = 0;
+  while (s < str.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s])) {
+      ++p;
+      ++s;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      starP = p++;
+      starS = s;
+    } else if (starP != std::string_view::npos) {
+      p = starP + 1;
+      s = ++starS;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+std::vector<std::string> GetExportEntryNames(
+    const wpi::log::DataLogReader& reader, const ExportFilter& filter) {
+  std::vector<std::string> names;
+  for (auto&& record : reader) {
+    if (record.IsStart()) {
+      wpi::log::StartRecordData data;
+      if (record.GetStartData(&data) &&
+          (!filter.selected || filter.selected(data))) {
+        names.emplace_back(data.name);
+      }
+    }
+  }
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+  return names;
+}
+
+static void PrintEscapedCsvString(wpi::raw_ostream& os, std::string_view str) {
+  auto s = str;
+  while (!s.empty()) {
+    std::string_view fragment;
+    std::tie(fragment, s) = wpi::split(s, '"');
+    os << fragment;
+    if (!s.empty()) {
+      os << '"' << '"';
+    }
+  }
+  if (wpi::ends_with(str, '"')) {
+    os << '"' << '"';
+  }
+}
+
+static void ValueToCsv(wpi::raw_ostream& os, const ExportEntry& entry,
+                       const wpi::log::DataLogRecord& record) {
+  // handle systemTime specially
+  if (entry.name == "systemTime" && entry.type == "int64") {
+    int64_t val;
+    if (record.GetInteger(&val)) {
+      std::time_t timeval = val / 1000000;
+      // fmt::localtime is thread safe, unlike std::localtime; files may be
+      // exported concurrently
+      wpi::print(os, "{:%Y-%m-%d %H:%M:%S}.{:06}", fmt::localtime(timeval),
+                 val % 1000000);
+      return;
+    }
+  } else if (entry.type == "double") {
+    double val;
+    if (record.GetDouble(&val)) {
+      wpi::print(os, "{}", val);
+      return;
+    }
+  } else if (entry.type == "int64" || entry.type == "int") {
+    // support "int" for compatibility with old NT4 datalogs
+    int64_t val;
+    if (record.GetInteger(&val)) {
+      wpi::print(os, "{}", val);
+      return;
+    }
+  } else if (entry.type == "string" || entry.type == "json") {
+    std::string_view val;
+    record.GetString(&val);
+    os << '"';
+    PrintEscapedCsvString(os, val);
+    os << '"';
+    return;
+  } else if (entry.type == "boolean") {
+    bool val;
+    if (record.GetBoolean(&val)) {
+      wpi::print(os, "{}", val);
+      return;
+    }
+  } else if (entry.type == "boolean[]") {
+    std::vector<int> val;
+    if (record.GetBooleanArray(&val)) {
+      wpi::print(os, "{}", fmt::join(val, ";"));
+      return;
+    }
+  } else if (entry.type == "double[]") {
+    std::vector<double> val;
+    if (record.GetDoubleArray(&val)) {
+      wpi::print(os, "{}", fmt::join(val, ";"));
+      return;
+    }
+  } else if (entry.type == "float[]") {
+    std::vector<float> val;
+    if (record.GetFloatArray(&val)) {
+      wpi::print(os, "{}", fmt::join(val, ";"));
+      return;
+    }
+  } else if (entry.type == "int64[]") {
+    std::vector<int64_t> val;
+    if (record.GetIntegerArray(&val)) {
+      wpi::print(os, "{}", fmt::join(val, ";"));
+      return;
+    }
+  } else if (entry.type == "string[]") {
+    std::vector<std::string_view> val;
+    if (record.GetStringArray(&val)) {
+      os << '"';
+      bool first = true;
+      for (auto&& v : val) {
+        if (!first) {
+          os << ';';
+        }
+        first = false;
+        PrintEscapedCsvString(os, v);
+      }
+      os << '"';
+      return;
+    }
+  }
+  wpi::print(os, "<invalid>");
+}
+
+void ExportCsvList(const wpi::log::DataLogReader& reader, wpi::raw_ostream& os,
+                   const ExportFilter& filter) {
+  os << "Timestamp,Name,Value\n";
+  ForEachExportRecord(
+      reader, filter, [](auto&, auto&) {},
+      [&](const ExportEntry& entry, const wpi::log::DataLogRecord& record) {
+        wpi::print(os, "{},\"", record.GetTimestamp() / 1000000.0);
+        PrintEscapedCsvString(os, entry.name);
+        os << '"' << ',';
+        ValueToCsv(os, entry, record);
+        os << '\n';
+      });
+}
+
+void ExportCsvTable(const wpi::log::DataLogReader& reader, wpi::raw_ostream& os,
+                    std::span<const std::string> columns,
+                    const ExportFilter& filter) {
+  wpi::StringMap<int> columnMap;
+  os << "Timestamp";
+  for (auto&& name : columns) {
+    os << ',' << '"';
+    PrintEscapedCsvString(os, name);
+    os << '"';
+    columnMap.try_emplace(name, columnMap.size());
+  }
+  os << '\n';
+
+  ForEachExportRecord(
+      reader, filter,
+      [&](ExportEntry& entry, const wpi::log::StartRecordData& data) {
+        auto it = columnMap.find(data.name);
+        if (it != columnMap.end()) {
+          entry.column = it->second;
+        }
+      },
+      [&](const ExportEntry& entry, const wpi::log::DataLogRecord& record) {
+        if (entry.column == -1) {
+          return;
+        }
+        wpi::print(os, "{},", record.GetTimestamp() / 1000000.0);
+        for (int i = 0; i < entry.column; ++i) {
+          os << ',';
+        }
+        ValueToCsv(os, entry, record);
+        os << '\n';
+      });
+}
+
+void ExportColumnar(const wpi::log::DataLogReader& reader,
+                    wpi::raw_ostream& os,
+                    ColumnarWriter::Compression compression,
+                    const ExportFilter& filter) {
+  ColumnarWriter writer{os, compression};
+  // an entry that is restarted (possibly with a different ID) continues the
+  // same column
+  wpi::StringMap<int> columnMap;
+  ForEachExportRecord(
+      reader, filter,
+      [&](ExportEntry& entry, const wpi::log::StartRecordData& data) {
+        auto [it, isNew] = columnMap.try_emplace(data.name, 0);
+        if (isNew) {
+          it->second = writer.AddColumn(data.name, data.type, data.metadata);
+        }
+        entry.column = it->second;
+      },
+      [&](const ExportEntry& entry, const wpi::log::DataLogRecord& record) {
+        writer.Append(entry.column, record.GetTimestamp(), record.GetRaw());
+      });
+  writer.Finish();
+}
@@ -0,0 +1,94 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/function_ref.h>
+
+#include "ColumnarWriter.h"
+
+// Export functions shared by the GUI and the command line tool.  These stream
+// directly from the reader to the output and do not depend on any GUI state.
+
+namespace wpi {
+class raw_ostream;
+namespace log {
+class DataLogReader;
+struct StartRecordData;
+}  // namespace log
+}  // namespace wpi
+
+/** Selects the entries and records to export. */
+struct ExportFilter {
+  /** Returns true if an entry should be exported (all if null). */
+  wpi::function_ref<bool(const wpi::log::StartRecordData& entry)> selected;
+  /** Records before this time (in integer microseconds) are skipped. */
+  int64_t startTime = INT64_MIN;
+  /** Records after this time (in integer microseconds) are skipped. */
+  int64_t endTime = INT64_MAX;
+};
+
+/**
+ * Matches a string against a glob pattern.  "*" matches any sequence of
+ * characters (including "/"), and "?" matches any single character.
+ *
+ * @param pattern glob pattern
+ * @param str string
+ * @return True if the string matches
+ */
+bool GlobMatch(std::string_view pattern, std::string_view str);
+
+/**
+ * Gets the names of the entries in a log that pass the filter, sorted by name.
+ * This scans the entire log.
+ *
+ * @param reader data log reader
+ * @param filter filter
+ * @return Entry names
+ */
+std::vector<std::string> GetExportEntryNames(
+    const wpi::log::DataLogReader& reader, const ExportFilter& filter);
+
+/**
+ * Exports a log as CSV with one row per record (timestamp, name, value).
+ *
+ * @param reader data log reader
+ * @param os output stream
+ * @param filter filter
+ */
+void ExportCsvList(const wpi::log::DataLogReader& reader, wpi::raw_ostream& os,
+                   const ExportFilter& filter);
+
+/**
+ * Exports a log as CSV with one row per record and one column per entry.
+ *
+ * @param reader data log reader
+ * @param os output stream
+ * @param columns entry names of the columns, in order; entries not listed are
+ *                not exported
+ * @param filter filter
+ */
+void ExportCsvTable(const wpi::log::DataLogReader& reader, wpi::raw_ostream& os,
+                    std::span<const std::string> columns,
+                    const ExportFilter& filter);
+
+/**
+ * Exports a log in the columnar format written by ColumnarWriter.
+ *
+ * @param reader data log reader
+ * @param os output stream; must be opened in binary mode
+ * @param compression chunk compression
+ * @param filter filter
+ */
+void ExportColumnar(const wpi::log::DataLogReader& reader,
+                    wpi::raw_ostream& os,
+                    ColumnarWriter::Compression compression,
+                    const ExportFilter& filter);
@@ -0,0 +1,299 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ColumnarWriter.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <bit>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wpi/Endian.h>
+#include <wpi/lz4.h>
+#include <wpi/raw_ostream.h>
+
+namespace {
+struct ReadColumn {
+  std::string name;
+  std::string type;
+  std::string metadata;
+  uint32_t valueSize = 0;
+  uint64_t rows = 0;
+  std::vector<int64_t> timestamps;
+  std::vector<std::vector<uint8_t>> values;
+};
+
+struct ReadFile {
+  std::vector<ReadColumn> columns;
+  // number of chunks stored with each compression
+  int chunks[2] = {0, 0};
+};
+
+// Minimal reader for the format documented in ColumnarWriter.h; reads the
+// footer through the trailer, then each column's chunks through the footer
+// offsets, checking the layout along the way.
+class Reader {
+ public:
+  explicit Reader(std::span<const uint8_t> data) : m_data{data} {}
+
+  void Read(ReadFile* file) {
+    // header and trailer
+    ASSERT_GE(m_data.size(), 8u + 16u);
+    EXPECT_EQ(GetString(0, 6), "WPICOL");
+    EXPECT_EQ(wpi::support::endian::read16le(&m_data[6]), 1);
+    size_t trailer = m_data.size() - 16;
+    EXPECT_EQ(GetString(trailer + 8, 6), "WPICOL");
+    EXPECT_EQ(wpi::support::endian::read16le(&m_data[trailer + 14]), 1);
+    m_pos = Read64At(trailer);
+    ASSERT_LT(m_pos, trailer);
+
+    // footer
+    uint32_t numColumns = Read32();
+    for (uint32_t i = 0; i < numColumns; ++i) {
+      auto& column = file->columns.emplace_back();
+      column.name = ReadString();
+      column.type = ReadString();
+      column.metadata = ReadString();
+      column.valueSize = Read32();
+      column.rows = Read64();
+      uint32_t numChunks = Read32();
+      std::vector<uint64_t> offsets;
+      for (uint32_t j = 0; j < numChunks; ++j) {
+        offsets.emplace_back(Read64());
+      }
+      ASSERT_FALSE(m_failed);
+      size_t footerPos = m_pos;
+      for (auto offset : offsets) {
+        m_pos = offset;
+        ReadChunk(i, &column, file);
+        ASSERT_FALSE(m_failed);
+      }
+      m_pos = footerPos;
+      EXPECT_EQ(column.timestamps.size(), column.rows);
+    }
+    // footer ends at the trailer
+    EXPECT_EQ(m_pos, trailer);
+    EXPECT_FALSE(m_failed);
+  }
+
+ private:
+  void ReadChunk(uint32_t index, ReadColumn* column, ReadFile* file) {
+    EXPECT_EQ(Read32(), index);
+    uint32_t rows = Read32();
+    uint32_t compression = Read32();
+    uint32_t size = Read32();
+    uint32_t stored = Read32();
+    ASSERT_FALSE(m_failed);
+    ASSERT_LE(stored, m_data.size() - m_pos);
+    auto storedData = m_data.subspan(m_pos, stored);
+    m_pos += stored;
+
+    std::vector<uint8_t> chunk(size);
+    ASSERT_LT(compression, 2u);
+    ++file->chunks[compression];
+    if (compression == ColumnarWriter::kNone) {
+      ASSERT_EQ(stored, size);
+      chunk.assign(storedData.begin(), storedData.end());
+    } else {
+      ASSERT_TRUE(wpi::Lz4Decompress(storedData, chunk));
+    }
+
+    // timestamps
+    ASSERT_GE(chunk.size(), rows * 8u);
+    int64_t timestamp = 0;
+    for (uint32_t i = 0; i < rows; ++i) {
+      timestamp += wpi::support::endian::read64le(&chunk[i * 8]);
+      column->timestamps.emplace_back(timestamp);
+    }
+    std::span<const uint8_t> rest{chunk};
+    rest = rest.subspan(rows * 8);
+
+    // values
+    if (column->valueSize != 0) {
+      ASSERT_EQ(rest.size(), rows * column->valueSize);
+      for (uint32_t i = 0; i < rows; ++i) {
+        auto value = rest.subspan(i * column->valueSize, column->valueSize);
+        column->values.emplace_back(value.begin(), value.end());
+      }
+    } else {
+      ASSERT_GE(rest.size(), rows * 4u);
+      auto values = rest.subspan(rows * 4);
+      uint32_t start = 0;
+      for (uint32_t i = 0; i < rows; ++i) {
+        uint32_t end = wpi::support::endian::read32le(&rest[i * 4]);
+        ASSERT_LE(start, end);
+        ASSERT_LE(end, values.size());
+        column->values.emplace_back(values.begin() + start,
+                                    values.begin() + end);
+        start = end;
+      }
+      EXPECT_EQ(start, values.size());
+    }
+  }
+
+  std::string GetString(size_t pos, size_t len) {
+    return {reinterpret_cast<const char*>(m_data.data() + pos), len};
+  }
+
+  bool Check(size_t len) {
+    if (m_failed || len > m_data.size() - m_pos) {
+      m_failed = true;
+      return false;
+    }
+    return true;
+  }
+
+  uint32_t Read32() {
+    if (!Check(4)) {
+      return 0;
+    }
+    m_pos += 4;
+    return wpi::support::endian::read32le(&m_data[m_pos - 4]);
+  }
+
+  uint64_t Read64() {
+    if (!Check(8)) {
+      return 0;
+    }
+    m_pos += 8;
+    return wpi::support::endian::read64le(&m_data[m_pos - 8]);
+  }
+
+  uint64_t Read64At(size_t pos) {
+    return wpi::support::endian::read64le(&m_data[pos]);
+  }
+
+  std::string ReadString() {
+    uint32_t len = Read32();
+    if (!Check(len)) {
+      return {};
+    }
+    m_pos += len;
+    return GetString(m_pos - len, len);
+  }
+
+  std::span<const uint8_t> m_data;
+  size_t m_pos = 0;
+  bool m_failed = false;
+};
+
+std::vector<uint8_t> Bytes(std::string_view str) {
+  return {str.begin(), str.end()};
+}
+
+std::vector<uint8_t> DoubleBytes(double value) {
+  std::vector<uint8_t> rv(8);
+  wpi::support::endian::write64le(rv.data(),
+                                  std::bit_cast<uint64_t>(value));
+  return rv;
+}
+
+struct Row {
+  int64_t timestamp;
+  std::vector<uint8_t> value;
+};
+
+void CheckColumn(const ReadColumn& column, const std::vector<Row>& rows) {
+  ASSERT_EQ(column.rows, rows.size());
+  ASSERT_EQ(column.timestamps.size(), rows.size());
+  ASSERT_EQ(column.values.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    EXPECT_EQ(column.timestamps[i], rows[i].timestamp) << "row " << i;
+    EXPECT_EQ(column.values[i], rows[i].value) << "row " << i;
+  }
+}
+
+void RoundTrip(ColumnarWriter::Compression compression, ReadFile* file) {
+  std::vector<Row> doubles;
+  std::vector<Row> booleans;
+  std::vector<Row> strings;
+  std::vector<Row> raws;
+  std::vector<uint8_t> data;
+  {
+    wpi::raw_uvector_ostream os{data};
+    // small chunks, so each column is split across several chunks
+    ColumnarWriter writer{os, compression, 512};
+    int doubleCol = writer.AddColumn("/double", "double", "{\"a\":1}");
+    int boolCol = writer.AddColumn("/bool", "boolean", "");
+    int strCol = writer.AddColumn("/str", "string", "");
+    int rawCol = writer.AddColumn("/raw", "raw", "meta");
+    for (int i = 0; i < 300; ++i) {
+      // not monotonic, to exercise negative deltas
+      int64_t timestamp = 1000000 + i * 20000 - ((i % 10) == 5 ? 30000 : 0);
+      doubles.emplace_back(Row{timestamp, DoubleBytes(i * 0.5)});
+      booleans.emplace_back(Row{timestamp + 1, {static_cast<uint8_t>(i & 1)}});
+      // strings of varying length, including empty
+      strings.emplace_back(
+          Row{timestamp + 2, Bytes(std::string(i % 7, 'a' + (i % 26)))});
+      if ((i % 3) == 0) {
+        raws.emplace_back(Row{timestamp + 3, {static_cast<uint8_t>(i), 0xff}});
+      }
+    }
+    for (int i = 0; i < 300; ++i) {
+      writer.Append(doubleCol, doubles[i].timestamp, doubles[i].value);
+      writer.Append(boolCol, booleans[i].timestamp, booleans[i].value);
+      writer.Append(strCol, strings[i].timestamp, strings[i].value);
+      if ((i % 3) == 0) {
+        writer.Append(rawCol, raws[i / 3].timestamp, raws[i / 3].value);
+      }
+      // wrong size values of fixed size columns are skipped
+      if (i == 10) {
+        writer.Append(doubleCol, 0, Bytes("bad"));
+      }
+    }
+    writer.Finish();
+  }
+
+  Reader{data}.Read(file);
+  ASSERT_EQ(file->columns.size(), 4u);
+  auto& columns = file->columns;
+  EXPECT_EQ(columns[0].name, "/double");
+  EXPECT_EQ(columns[0].type, "double");
+  EXPECT_EQ(columns[0].metadata, "{\"a\":1}");
+  EXPECT_EQ(columns[0].valueSize, 8u);
+  EXPECT_EQ(columns[1].name, "/bool");
+  EXPECT_EQ(columns[1].valueSize, 1u);
+  EXPECT_EQ(columns[2].name, "/str");
+  EXPECT_EQ(columns[2].valueSize, 0u);
+  EXPECT_EQ(columns[3].name, "/raw");
+  EXPECT_EQ(columns[3].metadata, "meta");
+  EXPECT_EQ(columns[3].valueSize, 0u);
+  CheckColumn(columns[0], doubles);
+  CheckColumn(columns[1], booleans);
+  CheckColumn(columns[2], strings);
+  CheckColumn(columns[3], raws);
+}
+}  // namespace
+
+TEST(ColumnarWriterTest, RoundTripUncompressed) {
+  ReadFile file;
+  RoundTrip(ColumnarWriter::kNone, &file);
+  EXPECT_GT(file.chunks[ColumnarWriter::kNone], 4);
+  EXPECT_EQ(file.chunks[ColumnarWriter::kLz4], 0);
+}
+
+TEST(ColumnarWriterTest, RoundTripLz4) {
+  ReadFile file;
+  RoundTrip(ColumnarWriter::kLz4, &file);
+  EXPECT_GT(file.chunks[ColumnarWriter::kLz4], 4);
+}
+
+TEST(ColumnarWriterTest, Empty) {
+  std::vector<uint8_t> data;
+  {
+    wpi::raw_uvector_ostream os{data};
+    ColumnarWriter writer{os, ColumnarWriter::kLz4};
+    writer.AddColumn("/unused", "int64", "");
+    writer.Finish();
+  }
+  ReadFile file;
+  Reader{data}.Read(&file);
+  ASSERT_EQ(file.columns.size(), 1u);
+  EXPECT_EQ(file.columns[0].rows, 0u);
+  EXPECT_EQ(file.chunks[0] + file.chunks[1], 0);
+}
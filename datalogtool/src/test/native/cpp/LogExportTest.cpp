@@ -0,0 +1,214 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "LogExport.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <wpi/DataLogReader.h>
+#include <wpi/DataLogWriter.h>
+#include <wpi/Logger.h>
+#include <wpi/MemoryBuffer.h>
+#include <wpi/raw_ostream.h>
+
+TEST(GlobMatchTest, Literal) {
+  EXPECT_TRUE(GlobMatch("/a/b", "/a/b"));
+  EXPECT_FALSE(GlobMatch("/a/b", "/a/c"));
+  // anchored at both ends
+  EXPECT_FALSE(GlobMatch("/a", "/a/b"));
+  EXPECT_FALSE(GlobMatch("a/b", "/a/b"));
+}
+
+TEST(GlobMatchTest, Empty) {
+  EXPECT_TRUE(GlobMatch("", ""));
+  EXPECT_FALSE(GlobMatch("", "a"));
+  EXPECT_FALSE(GlobMatch("a", ""));
+  EXPECT_TRUE(GlobMatch("*", ""));
+  EXPECT_FALSE(GlobMatch("?", ""));
+}
+
+TEST(GlobMatchTest, Question) {
+  EXPECT_TRUE(GlobMatch("/a?c", "/abc"));
+  EXPECT_TRUE(GlobMatch("/a?c", "/a/c"));
+  EXPECT_FALSE(GlobMatch("/a?c", "/ac"));
+  EXPECT_FALSE(GlobMatch("/a?c", "/abbc"));
+}
+
+TEST(GlobMatchTest, Star) {
+  EXPECT_TRUE(GlobMatch("*", "/a/b"));
+  EXPECT_TRUE(GlobMatch("/a/*", "/a/"));
+  EXPECT_TRUE(GlobMatch("/a/*", "/a/b"));
+  // spans "/"
+  EXPECT_TRUE(GlobMatch("/a/*", "/a/b/c"));
+  EXPECT_FALSE(GlobMatch("/a/*", "/b/a/c"));
+  EXPECT_TRUE(GlobMatch("*/c", "/a/b/c"));
+  EXPECT_FALSE(GlobMatch("*/c", "/a/b/cd"));
+  EXPECT_TRUE(GlobMatch("/a**", "/ab"));
+}
+
+TEST(GlobMatchTest, MultipleStars) {
+  // requires backtracking past the first candidate match
+  EXPECT_TRUE(GlobMatch("*a*b", "xaybzab"));
+  EXPECT_FALSE(GlobMatch("*a*b", "xaybzac"));
+  EXPECT_TRUE(GlobMatch("/*/?/*x", "/robot/a/drive/x"));
+  EXPECT_FALSE(GlobMatch("/*/?/*x", "/robot/ab/drive/x"));
+}
+
+class LogExportTest : public ::testing::Test {
+ public:
+  LogExportTest() {
+    wpi::Logger msglog;
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+    int a = log.Start("/a", "double", "", 1);
+    int b = log.Start("/b", "int64", "", 1);
+    int c = log.Start("/dir/c", "string", "", 1);
+    log.AppendDouble(a, 1.5, 1000);
+    log.AppendDouble(a, 2.5, 2000);
+    log.AppendInteger(b, 7, 2500);
+    log.AppendDouble(a, 3.5, 3000);
+    log.AppendString(c, "x", 3000);
+    log.AppendDouble(a, 4.5, 4000);
+    log.Flush();
+  }
+
+  std::string ExportCsvList(const ExportFilter& filter) {
+    wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+    std::string out;
+    wpi::raw_string_ostream os{out};
+    ::ExportCsvList(reader, os, filter);
+    os.flush();
+    return out;
+  }
+
+  std::vector<std::string> GetExportEntryNames(const ExportFilter& filter) {
+    wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+    return ::GetExportEntryNames(reader, filter);
+  }
+
+  std::vector<uint8_t> data;
+};
+
+TEST_F(LogExportTest, NoFilter) {
+  EXPECT_EQ(ExportCsvList({}),
+            "Timestamp,Name,Value\n"
+            "0.001,\"/a\",1.5\n"
+            "0.002,\"/a\",2.5\n"
+            "0.0025,\"/b\",7\n"
+            "0.003,\"/a\",3.5\n"
+            "0.003,\"/dir/c\",\"x\"\n"
+            "0.004,\"/a\",4.5\n");
+  EXPECT_EQ(GetExportEntryNames({}),
+            (std::vector<std::string>{"/a", "/b", "/dir/c"}));
+}
+
+TEST_F(LogExportTest, TimeRange) {
+  // both ends are inclusive
+  ExportFilter filter;
+  filter.startTime = 2000;
+  filter.endTime = 3000;
+  EXPECT_EQ(ExportCsvList(filter),
+            "Timestamp,Name,Value\n"
+            "0.002,\"/a\",2.5\n"
+            "0.0025,\"/b\",7\n"
+            "0.003,\"/a\",3.5\n"
+            "0.003,\"/dir/c\",\"x\"\n");
+
+  filter.startTime = 3001;
+  filter.endTime = INT64_MAX;
+  EXPECT_EQ(ExportCsvList(filter),
+            "Timestamp,Name,Value\n"
+            "0.004,\"/a\",4.5\n");
+
+  // empty range
+  filter.startTime = 5000;
+  EXPECT_EQ(ExportCsvList(filter), "Timestamp,Name,Value\n");
+}
+
+TEST_F(LogExportTest, Selected) {
+  auto selected = [](const wpi::log::StartRecordData& entry) {
+    return GlobMatch("/dir/*", entry.name) || entry.type == "int64";
+  };
+  ExportFilter filter;
+  filter.selected = selected;
+  EXPECT_EQ(ExportCsvList(filter),
+            "Timestamp,Name,Value\n"
+            "0.0025,\"/b\",7\n"
+            "0.003,\"/dir/c\",\"x\"\n");
+  EXPECT_EQ(GetExportEntryNames(filter),
+            (std::vector<std::string>{"/b", "/dir/c"}));
+}
+
+TEST_F(LogExportTest, SelectedAndTimeRange) {
+  auto selected = [](const wpi::log::StartRecordData& entry) {
+    return GlobMatch("/?", entry.name);
+  };
+  ExportFilter filter;
+  filter.selected = selected;
+  filter.startTime = 2500;
+  filter.endTime = 3500;
+  EXPECT_EQ(ExportCsvList(filter),
+            "Timestamp,Name,Value\n"
+            "0.0025,\"/b\",7\n"
+            "0.003,\"/a\",3.5\n");
+  // entry names are not filtered by time
+  EXPECT_EQ(GetExportEntryNames(filter),
+            (std::vector<std::string>{"/a", "/b"}));
+}
+
+TEST(LogExportConcurrentTest, SystemTime) {
+  // the command line tool exports files on multiple threads (-j); export two
+  // logs with systemTime entries at once and compare with a serial export
+  std::vector<uint8_t> data[2];
+  for (int i = 0; i < 2; ++i) {
+    wpi::Logger msglog;
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data[i])};
+    int entry = log.Start("systemTime", "int64", "", 1);
+    for (int j = 0; j < 1000; ++j) {
+      // far apart, so each log formats different dates
+      log.AppendInteger(entry,
+                        (i == 0 ? 1000000000 : 1700000000) * 1000000ll +
+                            j * 86400000123ll,
+                        j);
+    }
+    log.Flush();
+  }
+
+  auto exportLog = [&](int i) {
+    wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data[i])};
+    std::string out;
+    wpi::raw_string_ostream os{out};
+    ExportCsvList(reader, os, {});
+    os.flush();
+    return out;
+  };
+  std::string expected[2] = {exportLog(0), exportLog(1)};
+  ASSERT_NE(expected[0], expected[1]);
+
+  std::string actual[2];
+  std::thread thread{[&] {
+    for (int j = 0; j < 20; ++j) {
+      actual[1] = exportLog(1);
+      if (actual[1] != expected[1]) {
+        break;
+      }
+    }
+  }};
+  for (int j = 0; j < 20; ++j) {
+    actual[0] = exportLog(0);
+    if (actual[0] != expected[0]) {
+      break;
+    }
+  }
+  thread.join();
+  EXPECT_EQ(actual[0], expected[0]);
+  EXPECT_EQ(actual[1], expected[1]);
+}
@@ -6,7 +6,9 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
+#include <wpi/DataLogParallelReader.h>
 #include <wpi/StringExtras.h>
 #include <wpi/print.h>
 
@@ -19,80 +21,135 @@ DataLogReaderThread::~DataLogReaderThread() {
   }
 }
 
+namespace {
+struct ReadChunk {
+  // positions of control records, in file order
+  std::vector<size_t> control;
+  // position of the last data record for each entry ID
+  wpi::DenseMap<int, size_t> lastData;
+  unsigned int numRecords = 0;
+};
+}  // namespace
+
+// number of records to read before updating the shared record count
+static constexpr unsigned int kRecordCountBatch = 4096;
+
 void DataLogReaderThread::ReadMain() {
-  wpi::SmallDenseMap<
-      int, std::pair<DataLogReaderEntry*, std::span<const uint8_t>>, 8>
+  // entry ID to entry and position of its start record, and schema data
+  wpi::SmallDenseMap<int,
+                     std::pair<std::pair<DataLogReaderEntry*, size_t>,
+                               std::span<const uint8_t>>,
+                     8>
       schemaEntries;
 
-  for (auto recordIt = m_reader.begin(), recordEnd = m_reader.end();
-       recordIt != recordEnd; ++recordIt) {
-    auto& record = *recordIt;
-    if (!m_active) {
-      break;
-    }
-    ++m_numRecords;
-    if (record.IsStart()) {
-      DataLogReaderEntry data;
-      if (record.GetStartData(&data)) {
-        std::scoped_lock lock{m_mutex};
-        auto& entryPtr = m_entriesById[data.entry];
-        if (entryPtr) {
-          wpi::print("...DUPLICATE entry ID, overriding\n");
-        }
-        auto [it, isNew] = m_entriesByName.emplace(data.name, data);
-        if (isNew) {
-          it->second.ranges.emplace_back(recordIt, recordEnd);
+  // scan the log in parallel; the few control records are collected per chunk
+  // and processed in file order as each chunk is completed, because entry IDs
+  // are only meaningful in the context of the Start and Finish records before
+  // them.  This makes entries available while the rest of the log is read.
+  auto recordEnd = m_reader.end();
+  wpi::log::DataLogParallelReader parallel{m_reader};
+  std::vector<ReadChunk> chunks(parallel.GetNumChunks());
+  parallel.ForEachRecord(
+      [&](size_t i) {
+        m_numRecords -= chunks[i].numRecords -
+                        (chunks[i].numRecords % kRecordCountBatch);
+        chunks[i] = ReadChunk();
+      },
+      [&](size_t i, wpi::log::DataLogIterator recordIt) {
+        // stop reading if the thread is being destroyed
+        if (!m_active) {
+          return false;
         }
-        entryPtr = &it->second;
-        if (data.type == "structschema" ||
-            data.type == "proto:FileDescriptorProto") {
-          schemaEntries.try_emplace(data.entry, entryPtr,
-                                    std::span<const uint8_t>{});
+        auto& chunk = chunks[i];
+        if ((++chunk.numRecords % kRecordCountBatch) == 0) {
+          m_numRecords += kRecordCountBatch;
         }
-        sigEntryAdded(data);
-      } else {
-        wpi::print("Start(INVALID)\n");
-      }
-    } else if (record.IsFinish()) {
-      int entry;
-      if (record.GetFinishEntry(&entry)) {
-        std::scoped_lock lock{m_mutex};
-        auto it = m_entriesById.find(entry);
-        if (it == m_entriesById.end()) {
-          wpi::print("...ID not found\n");
+        int entry = recordIt->GetEntry();
+        if (entry == 0) {
+          chunk.control.emplace_back(recordIt.GetPosition());
         } else {
-          it->second->ranges.back().m_end = recordIt;
-          m_entriesById.erase(it);
+          chunk.lastData[entry] = recordIt.GetPosition();
         }
-      } else {
-        wpi::print("Finish(INVALID)\n");
-      }
-    } else if (record.IsSetMetadata()) {
-      wpi::log::MetadataRecordData data;
-      if (record.GetSetMetadataData(&data)) {
-        std::scoped_lock lock{m_mutex};
-        auto it = m_entriesById.find(data.entry);
-        if (it == m_entriesById.end()) {
-          wpi::print("...ID not found\n");
-        } else {
-          it->second->metadata = data.metadata;
+        return true;
+      },
+      [&](size_t i) {
+        auto& chunk = chunks[i];
+        m_numRecords += chunk.numRecords % kRecordCountBatch;
+        if (!m_active) {
+          return;
         }
-      } else {
-        wpi::print("SetMetadata(INVALID)\n");
-      }
-    } else if (record.IsControl()) {
-      wpi::print("Unrecognized control record\n");
-    } else {
-      auto it = schemaEntries.find(record.GetEntry());
-      if (it != schemaEntries.end()) {
-        it->second.second = record.GetRaw();
-      }
-    }
-  }
+        for (size_t pos : chunk.control) {
+          auto recordIt = m_reader.Seek(pos);
+          auto& record = *recordIt;
+          if (record.IsStart()) {
+            DataLogReaderEntry data;
+            if (record.GetStartData(&data)) {
+              std::scoped_lock lock{m_mutex};
+              auto& entryPtr = m_entriesById[data.entry];
+              if (entryPtr) {
+                wpi::print("...DUPLICATE entry ID, overriding\n");
+              }
+              auto [it, isNew] = m_entriesByName.emplace(data.name, data);
+              if (isNew) {
+                it->second.ranges.emplace_back(recordIt, recordEnd);
+              }
+              entryPtr = &it->second;
+              if (data.type == "structschema" ||
+                  data.type == "proto:FileDescriptorProto") {
+                schemaEntries.try_emplace(data.entry, std::pair{entryPtr, pos},
+                                          std::span<const uint8_t>{});
+              }
+              sigEntryAdded(data);
+            } else {
+              wpi::print("Start(INVALID)\n");
+            }
+          } else if (record.IsFinish()) {
+            int entry;
+            if (record.GetFinishEntry(&entry)) {
+              std::scoped_lock lock{m_mutex};
+              auto it = m_entriesById.find(entry);
+              if (it == m_entriesById.end()) {
+                wpi::print("...ID not found\n");
+              } else {
+                it->second->ranges.back().m_end = recordIt;
+                m_entriesById.erase(it);
+              }
+            } else {
+              wpi::print("Finish(INVALID)\n");
+            }
+          } else if (record.IsSetMetadata()) {
+            wpi::log::MetadataRecordData data;
+            if (record.GetSetMetadataData(&data)) {
+              std::scoped_lock lock{m_mutex};
+              auto it = m_entriesById.find(data.entry);
+              if (it == m_entriesById.end()) {
+                wpi::print("...ID not found\n");
+              } else {
+                it->second->metadata = data.metadata;
+              }
+            } else {
+              wpi::print("SetMetadata(INVALID)\n");
+            }
+          } else {
+            wpi::print("Unrecognized control record\n");
+          }
+        }
+
+        // the last schema record in the chunk is the latest value
+        for (auto&& [entry, pos] : chunk.lastData) {
+          auto it = schemaEntries.find(entry);
+          if (it != schemaEntries.end() && pos > it->second.first.second) {
+            it->second.second = m_reader.Seek(pos)->GetRaw();
+          }
+        }
+
+        // no longer needed
+        chunk = ReadChunk();
+      });
 
   // build schema databases
   for (auto&& schemaPair : schemaEntries) {
-    auto name = schemaPair.second.first->name;
+    auto name = schemaPair.second.first.first->name;
     auto data = schemaPair.second.second;
     if (data.empty()) {
       continue;
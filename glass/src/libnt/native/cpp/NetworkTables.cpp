@@ -35,8 +35,7 @@
 #include <wpi/raw_ostream.h>
 
 #ifndef NO_PROTOBUF
-#include <google/protobuf/descriptor.h>
-#include <google/protobuf/message.h>
+#include <wpi/protobuf/DynamicProtobufDecoder.h>
 #endif
 
 #include "glass/Context.h"
@@ -355,194 +354,249 @@ static void UpdateStructValueSource(NetworkTablesModel& model,
 }
 
 #ifndef NO_PROTOBUF
-static void UpdateProtobufValueSource(NetworkTablesModel& model,
-                                      NetworkTablesModel::ValueSource* out,
-                                      const google::protobuf::Message& msg,
-                                      std::string_view name, int64_t time) {
-  auto desc = msg.GetDescriptor();
-  out->typeStr = "proto:" + desc->full_name();
+namespace {
+// Updates a value source tree from a decoded protobuf message.  Values are
+// collected per field while each message is decoded, and written to the
+// children of the message's value source when the message ends.  Fields not
+// present in the data are set to their default values, as with reflection.
+class ProtobufValueSourceVisitor : public wpi::DynamicProtobufDecoder::Visitor {
+ public:
+  using Field = wpi::DynamicProtobufDecoder::Field;
+  using FieldType = wpi::DynamicProtobufDecoder::FieldType;
+
+  ProtobufValueSourceVisitor(NetworkTablesModel& model,
+                             const wpi::DynamicProtobufDecoder& decoder,
+                             int64_t time)
+      : m_model{model}, m_decoder{decoder}, m_time{time} {}
+
+  void Start(NetworkTablesModel::ValueSource* out, int message,
+             std::string_view name);
+  void Finish();
+
+  void Int(const Field& field, int64_t value) override {
+    GetValues(field).ints.emplace_back(value);
+  }
+  void Uint(const Field& field, uint64_t value) override {
+    GetValues(field).ints.emplace_back(static_cast<int64_t>(value));
+  }
+  void Float(const Field& field, float value) override {
+    GetValues(field).floats.emplace_back(value);
+  }
+  void Double(const Field& field, double value) override {
+    GetValues(field).doubles.emplace_back(value);
+  }
+  void Bool(const Field& field, bool value) override {
+    GetValues(field).ints.emplace_back(value);
+  }
+  void String(const Field& field, std::string_view value) override {
+    GetValues(field).strings.emplace_back(value);
+  }
+  void Bytes(const Field& field, std::span<const uint8_t> value) override {
+    GetValues(field).strings.emplace_back(
+        reinterpret_cast<const char*>(value.data()), value.size());
+  }
+  void StartMessage(const Field& field) override;
+  void EndMessage(const Field& field) override { Finish(); }
+
+ private:
+  // decoded values of a field; strings refer to the decoded data
+  struct FieldValues {
+    std::vector<int64_t> ints;
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    std::vector<std::string_view> strings;
+    size_t numMessages = 0;
+  };
+
+  struct Frame {
+    NetworkTablesModel::ValueSource* out;
+    const wpi::DynamicProtobufDecoder::Message* message;
+    std::vector<FieldValues> fields;
+  };
+
+  size_t GetIndex(const Field& field) const {
+    return static_cast<size_t>(&field -
+                               m_frames.back().message->fields.data());
+  }
+  FieldValues& GetValues(const Field& field) {
+    return m_frames.back().fields[GetIndex(field)];
+  }
+
+  template <typename T>
+  static T Last(const std::vector<T>& values, T defaultValue) {
+    return values.empty() ? defaultValue : values.back();
+  }
+
+  NetworkTablesModel& m_model;
+  const wpi::DynamicProtobufDecoder& m_decoder;
+  int64_t m_time;
+  std::vector<Frame> m_frames;
+};
+}  // namespace
+
+// default values are only filled in to this depth, in case a message type
+// contains itself
+static constexpr size_t kMaxProtobufDefaultDepth = 32;
+
+void ProtobufValueSourceVisitor::Start(NetworkTablesModel::ValueSource* out,
+                                       int message, std::string_view name) {
+  auto& msg = m_decoder.GetMessages()[message];
+  out->typeStr = "proto:" + msg.name;
   if (!out->valueChildrenMap ||
-      desc->field_count() != static_cast<int>(out->valueChildren.size())) {
+      msg.fields.size() != out->valueChildren.size()) {
     out->valueChildren.clear();
     out->valueChildrenMap = true;
-    out->valueChildren.reserve(desc->field_count());
-    for (int i = 0, end = desc->field_count(); i < end; ++i) {
+    out->valueChildren.reserve(msg.fields.size());
+    for (auto&& field : msg.fields) {
       out->valueChildren.emplace_back();
       auto& child = out->valueChildren.back();
-      child.name = desc->field(i)->name();
+      child.name = field.name;
       child.path = fmt::format("{}/{}", name, child.name);
     }
   }
-  auto refl = msg.GetReflection();
-  auto outIt = out->valueChildren.begin();
-  for (int fieldNum = 0, end = desc->field_count(); fieldNum < end;
-       ++fieldNum) {
-    auto field = desc->field(fieldNum);
-    auto& child = *outIt++;
-    switch (field->cpp_type()) {
-      case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<int> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedBool(msg, field, i));
+  m_frames.emplace_back(
+      Frame{out, &msg, std::vector<FieldValues>(msg.fields.size())});
+}
+
+void ProtobufValueSourceVisitor::StartMessage(const Field& field) {
+  auto& frame = m_frames.back();
+  size_t index = GetIndex(field);
+  auto& child = frame.out->valueChildren[index];
+  size_t i = frame.fields[index].numMessages++;
+  if (!field.repeated) {
+    Start(&child, field.message, child.path);
+    return;
+  }
+  if (child.valueChildrenMap) {
+    child.valueChildren.clear();
+    child.valueChildrenMap = false;
+  }
+  if (child.valueChildren.size() <= i) {
+    child.valueChildren.resize(i + 1);
+  }
+  auto& child2 = child.valueChildren[i];
+  if (child2.name.empty()) {
+    child2.name = fmt::format("[{}]", i);
+    child2.path = fmt::format("{}{}", child.path, child2.name);
+  }
+  Start(&child2, field.message, child2.path);
+}
+
+void ProtobufValueSourceVisitor::Finish() {
+  Frame frame = std::move(m_frames.back());
+  m_frames.pop_back();
+  for (size_t i = 0; i < frame.fields.size(); ++i) {
+    auto& field = frame.message->fields[i];
+    auto& values = frame.fields[i];
+    auto& child = frame.out->valueChildren[i];
+    switch (field.type) {
+      case FieldType::kMessage:
+        if (field.repeated) {
+          if (child.valueChildrenMap) {
+            child.valueChildren.clear();
+            child.valueChildrenMap = false;
           }
-          child.value = nt::Value::MakeBooleanArray(std::move(v), time);
-        } else {
-          child.value = nt::Value::MakeBoolean(refl->GetBool(msg, field), time);
-        }
-        child.UpdateFromValue(model, child.path, "");
-        break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<std::string> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedString(msg, field, i));
+          child.valueChildren.resize(values.numMessages);
+        } else if (values.numMessages == 0) {
+          // not present; show the default values
+          if (m_frames.size() < kMaxProtobufDefaultDepth) {
+            Start(&child, field.message, child.path);
+            Finish();
+          } else {
+            child.valueChildren.clear();
           }
-          child.value = nt::Value::MakeStringArray(std::move(v), time);
-        } else {
-          child.value =
-              nt::Value::MakeString(refl->GetString(msg, field), time);
-          child.UpdateFromValue(model, child.path, "");
         }
-        break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<int64_t> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedInt32(msg, field, i));
-          }
-          child.value = nt::Value::MakeIntegerArray(std::move(v), time);
+        continue;
+      case FieldType::kBool:
+        if (field.repeated) {
+          child.value = nt::Value::MakeBooleanArray(
+              std::vector<int>(values.ints.begin(), values.ints.end()),
+              m_time);
         } else {
           child.value =
-              nt::Value::MakeInteger(refl->GetInt32(msg, field), time);
+              nt::Value::MakeBoolean(Last<int64_t>(values.ints, 0), m_time);
         }
-        child.UpdateFromValue(model, child.path, "");
         break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<int64_t> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedInt64(msg, field, i));
-          }
-          child.value = nt::Value::MakeIntegerArray(std::move(v), time);
+      case FieldType::kString:
+      case FieldType::kBytes:
+        if (field.repeated) {
+          child.value = nt::Value::MakeStringArray(
+              std::vector<std::string>(values.strings.begin(),
+                                       values.strings.end()),
+              m_time);
         } else {
-          child.value =
-              nt::Value::MakeInteger(refl->GetInt64(msg, field), time);
+          child.value = nt::Value::MakeString(
+              Last<std::string_view>(values.strings, {}), m_time);
         }
-        child.UpdateFromValue(model, child.path, "");
         break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<int64_t> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedUInt32(msg, field, i));
-          }
-          child.value = nt::Value::MakeIntegerArray(std::move(v), time);
-        } else {
+      case FieldType::kFloat:
+        if (field.repeated) {
           child.value =
-              nt::Value::MakeInteger(refl->GetUInt32(msg, field), time);
-        }
-        child.UpdateFromValue(model, child.path, "");
-        break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<int64_t> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedUInt64(msg, field, i));
-          }
-          child.value = nt::Value::MakeIntegerArray(std::move(v), time);
+              nt::Value::MakeFloatArray(std::move(values.floats), m_time);
         } else {
           child.value =
-              nt::Value::MakeInteger(refl->GetUInt64(msg, field), time);
+              nt::Value::MakeFloat(Last<float>(values.floats, 0), m_time);
         }
-        child.UpdateFromValue(model, child.path, "");
         break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<float> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedFloat(msg, field, i));
-          }
-          child.value = nt::Value::MakeFloatArray(std::move(v), time);
-        } else {
-          child.value = nt::Value::MakeFloat(refl->GetFloat(msg, field), time);
-        }
-        child.UpdateFromValue(model, child.path, "");
-        break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
-          std::vector<double> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedDouble(msg, field, i));
-          }
-          child.value = nt::Value::MakeDoubleArray(std::move(v), time);
+      case FieldType::kDouble:
+        if (field.repeated) {
+          child.value =
+              nt::Value::MakeDoubleArray(std::move(values.doubles), m_time);
         } else {
           child.value =
-              nt::Value::MakeDouble(refl->GetDouble(msg, field), time);
+              nt::Value::MakeDouble(Last<double>(values.doubles, 0), m_time);
         }
-        child.UpdateFromValue(model, child.path, "");
         break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
-        if (field->is_repeated()) {
-          size_t size = refl->FieldSize(msg, field);
+      case FieldType::kEnum: {
+        auto toName = [&](int64_t value) {
+          auto name = field.GetEnumName(value);
+          return name.empty() ? fmt::format("{}", value) : std::string{name};
+        };
+        if (field.repeated) {
           std::vector<std::string> v;
-          v.reserve(size);
-          for (size_t i = 0; i < size; ++i) {
-            v.emplace_back(refl->GetRepeatedEnum(msg, field, i)->name());
+          v.reserve(values.ints.size());
+          for (auto value : values.ints) {
+            v.emplace_back(toName(value));
           }
-          child.value = nt::Value::MakeStringArray(std::move(v), time);
+          child.value = nt::Value::MakeStringArray(std::move(v), m_time);
+        } else if (values.ints.empty()) {
+          // the default is the first declared value
+          child.value = nt::Value::MakeString(
+              field.enumValues.empty() ? "" : field.enumValues[0].second,
+              m_time);
         } else {
-          child.value =
-              nt::Value::MakeString(refl->GetEnum(msg, field)->name(), time);
+          child.value = nt::Value::MakeString(toName(values.ints.back()),
+                                              m_time);
         }
-        child.UpdateFromValue(model, child.path, "");
         break;
-      case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
-        if (field->is_repeated()) {
-          if (child.valueChildrenMap) {
-            child.valueChildren.clear();
-            child.valueChildrenMap = false;
-          }
-          size_t size = refl->FieldSize(msg, field);
-          child.valueChildren.resize(size);
-          unsigned int i = 0;
-          for (auto&& child2 : child.valueChildren) {
-            if (child2.name.empty()) {
-              child2.name = fmt::format("[{}]", i);
-              child2.path = fmt::format("{}{}", name, child.name);
-            }
-            UpdateProtobufValueSource(model, &child2,
-                                      refl->GetRepeatedMessage(msg, field, i),
-                                      child2.path, time);  // recurse
-            ++i;
-          }
+      }
+      default:
+        // integer types
+        if (field.repeated) {
+          child.value =
+              nt::Value::MakeIntegerArray(std::move(values.ints), m_time);
         } else {
-          UpdateProtobufValueSource(
-              model, &child,
-              refl->GetMessage(msg, field,
-                               model.GetProtobufDatabase().GetMessageFactory()),
-              child.path, time);  // recurse
+          child.value =
+              nt::Value::MakeInteger(Last<int64_t>(values.ints, 0), m_time);
         }
         break;
     }
+    child.UpdateFromValue(m_model, child.path, "");
   }
 }
+
+static bool UpdateProtobufValueSource(
+    NetworkTablesModel& model, NetworkTablesModel::ValueSource* out,
+    const wpi::DynamicProtobufDecoder& decoder, std::span<const uint8_t> data,
+    std::string_view name, int64_t time) {
+  ProtobufValueSourceVisitor visitor{model, decoder, time};
+  visitor.Start(out, 0, name);
+  if (!decoder.Decode(data, visitor)) {
+    return false;
+  }
+  visitor.Finish();
+  return true;
+}
 #endif
 
 static void UpdateJsonValueSource(NetworkTablesModel& model,
@@ -775,17 +829,10 @@ void NetworkTablesModel::ValueSource::UpdateFromValue(
         }
       } else if (auto filename = wpi::remove_prefix(typeStr, "proto:")) {
 #ifndef NO_PROTOBUF
-        auto msg = model.m_protoDb.Find(*filename);
-        if (msg) {
-          msg->Clear();
-          auto raw = value.GetRaw();
-          if (msg->ParseFromArray(raw.data(), raw.size())) {
-            UpdateProtobufValueSource(model, this, *msg, name,
-                                      value.last_change());
-          } else {
-            valueChildren.clear();
-          }
-        } else {
+        auto decoder = model.m_protoDb.FindDecoder(*filename);
+        if (!decoder ||
+            !UpdateProtobufValueSource(model, this, *decoder, value.GetRaw(),
+                                       name, value.last_change())) {
           valueChildren.clear();
         }
 #else
@@ -0,0 +1,478 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+// ntcore benchmark suite.
+//
+// Usage: ntcoreBenchmarks [--list] [filter]
+//
+// Runs every benchmark whose name contains filter (all if omitted).  Each
+// benchmark is repeated several times and the median, minimum, and maximum
+// are reported, so results from different builds can be compared directly.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/Logger.h>
+#include <wpi/SmallVector.h>
+#include <wpi/Synchronization.h>
+#include <wpi/print.h>
+#include <wpi/raw_ostream.h>
+#include <wpi/timestamp.h>
+
+#include "net/WireDecoder.h"
+#include "net/WireEncoder.h"
+#include "networktables/NetworkTableValue.h"
+#include "ntcore_cpp.h"
+#include "server/ServerImpl.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Benchmark {
+  std::string name;
+  // returns the measured quantity for a single repetition
+  std::function<double()> run;
+  // unit of the measured quantity, e.g. "ns/op" or "values/s"
+  std::string_view unit;
+  int repetitions = 5;
+};
+
+double NsPerOp(Clock::time_point start, Clock::time_point stop, int ops) {
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+                 .count()) /
+         ops;
+}
+
+double PerSecond(Clock::time_point start, Clock::time_point stop,
+                 int64_t count) {
+  return count / std::chrono::duration<double>(stop - start).count();
+}
+
+// waits up to timeout for pred to become true; returns false on timeout
+template <typename Pred>
+bool WaitFor(Pred&& pred, std::chrono::milliseconds timeout = 10s) {
+  auto end = Clock::now() + timeout;
+  while (!pred()) {
+    if (Clock::now() > end) {
+      return false;
+    }
+    std::this_thread::sleep_for(100us);
+  }
+  return true;
+}
+
+constexpr const char* kPersistFilename = "ntcorebench.json";
+
+// each network benchmark uses its own port so lingering sockets from a
+// previous repetition don't interfere
+unsigned int NextPort() {
+  static unsigned int port = 20000;
+  return port++;
+}
+
+// local publish immediately followed by a subscriber read
+double LocalPubSub(int ops) {
+  auto inst = nt::CreateInstance();
+  auto topic = nt::GetTopic(inst, "bench");
+  auto pub = nt::Publish(topic, NT_DOUBLE, "double");
+  auto sub = nt::Subscribe(topic, NT_DOUBLE, "double");
+
+  auto start = Clock::now();
+  for (int i = 1; i <= ops; ++i) {
+    nt::SetDouble(pub, i, i);
+    if (nt::GetDouble(sub, 0) != i) {
+      wpi::print(stderr, "LocalPubSub: wrong value\n");
+    }
+  }
+  auto stop = Clock::now();
+
+  nt::DestroyInstance(inst);
+  return NsPerOp(start, stop, ops);
+}
+
+// local publish followed by a read of the subscriber's value queue
+double LocalPubReadQueue(int ops) {
+  auto inst = nt::CreateInstance();
+  auto topic = nt::GetTopic(inst, "bench");
+  auto pub = nt::Publish(topic, NT_DOUBLE, "double");
+  auto sub = nt::Subscribe(topic, NT_DOUBLE, "double", {.pollStorage = 10});
+
+  auto start = Clock::now();
+  for (int i = 1; i <= ops; ++i) {
+    nt::SetDouble(pub, i, i);
+    nt::ReadQueueDouble(sub);
+  }
+  auto stop = Clock::now();
+
+  nt::DestroyInstance(inst);
+  return NsPerOp(start, stop, ops);
+}
+
+// time from a local publish until a value listener callback runs
+double ListenerLatency(int ops) {
+  auto inst = nt::CreateInstance();
+  auto topic = nt::GetTopic(inst, "bench");
+  auto pub = nt::Publish(topic, NT_DOUBLE, "double");
+  auto sub = nt::Subscribe(topic, NT_DOUBLE, "double");
+  wpi::Event received;
+  nt::AddListener(sub, NT_EVENT_VALUE_ALL,
+                  [&](const nt::Event&) { received.Set(); });
+
+  auto start = Clock::now();
+  for (int i = 1; i <= ops; ++i) {
+    nt::SetDouble(pub, i, i);
+    wpi::WaitForObject(received.GetHandle());
+  }
+  auto stop = Clock::now();
+
+  nt::DestroyInstance(inst);
+  return NsPerOp(start, stop, ops);
+}
+
+// cost of queueing and polling value events with many listeners per topic
+double ListenerDispatch(int ops, int numListeners) {
+  auto inst = nt::CreateInstance();
+  auto topic = nt::GetTopic(inst, "bench");
+  auto pub = nt::Publish(topic, NT_DOUBLE, "double");
+  auto poller = nt::CreateListenerPoller(inst);
+  std::vector<NT_Subscriber> subs;
+  for (int i = 0; i < numListeners; ++i) {
+    subs.emplace_back(nt::Subscribe(topic, NT_DOUBLE, "double"));
+    nt::AddPolledListener(poller, subs.back(), NT_EVENT_VALUE_ALL);
+  }
+
+  size_t events = 0;
+  auto start = Clock::now();
+  for (int i = 1; i <= ops; ++i) {
+    nt::SetDouble(pub, i, i);
+    events += nt::ReadListenerQueue(poller).size();
+  }
+  auto stop = Clock::now();
+  if (events != static_cast<size_t>(ops) * numListeners) {
+    wpi::print(stderr, "ListenerDispatch: got {} events, expected {}\n",
+               events, ops * numListeners);
+  }
+
+  nt::DestroyListenerPoller(poller);
+  nt::DestroyInstance(inst);
+  return NsPerOp(start, stop, ops);
+}
+
+// server-to-client value throughput over loopback
+double LoopbackThroughput(int numClients) {
+  constexpr int kTopics = 100;
+  constexpr int kRounds = 50;
+
+  auto port = NextPort();
+  auto server = nt::CreateInstance();
+  nt::StartServer(server, kPersistFilename, "127.0.0.1", 0, port);
+
+  std::vector<NT_Inst> clients;
+  std::vector<NT_Subscriber> lastSubs;
+  for (int i = 0; i < numClients; ++i) {
+    auto client = nt::CreateInstance();
+    nt::SubscribeMultiple(client, {{std::string_view{"bench/"}}},
+                          {.periodic = 0.005, .sendAll = true});
+    auto lastTopic =
+        nt::GetTopic(client, fmt::format("bench/{}", kTopics - 1));
+    lastSubs.emplace_back(nt::Subscribe(lastTopic, NT_DOUBLE, "double"));
+    nt::StartClient4(client, fmt::format("client{}", i));
+    nt::SetServer(client, "127.0.0.1", port);
+    clients.emplace_back(client);
+  }
+  WaitFor([&] {
+    return nt::GetConnections(server).size() == static_cast<size_t>(numClients);
+  });
+
+  std::vector<NT_Publisher> pubs;
+  for (int i = 0; i < kTopics; ++i) {
+    pubs.emplace_back(nt::Publish(
+        nt::GetTopic(server, fmt::format("bench/{}", i)), NT_DOUBLE, "double"));
+    nt::SetDouble(pubs.back(), 0);
+  }
+  nt::Flush(server);
+  // wait for announcements and initial values to reach all clients
+  WaitFor([&] {
+    return std::all_of(lastSubs.begin(), lastSubs.end(), [](auto sub) {
+      return nt::GetTopicExists(sub);
+    });
+  });
+
+  auto start = Clock::now();
+  for (int round = 1; round <= kRounds; ++round) {
+    for (auto pub : pubs) {
+      nt::SetDouble(pub, round);
+    }
+    nt::Flush(server);
+    std::this_thread::sleep_for(1ms);
+  }
+  bool ok = WaitFor([&] {
+    return std::all_of(lastSubs.begin(), lastSubs.end(), [](auto sub) {
+      return nt::GetDouble(sub, 0) == kRounds;
+    });
+  });
+  auto stop = Clock::now();
+  if (!ok) {
+    wpi::print(stderr, "LoopbackThroughput: timed out\n");
+  }
+
+  for (auto client : clients) {
+    nt::DestroyInstance(client);
+  }
+  nt::DestroyInstance(server);
+  return PerSecond(start, stop,
+                   static_cast<int64_t>(kTopics) * kRounds * numClients);
+}
+
+// time for a burst of newly published topics to be announced to a client
+double AnnounceStorm(int numTopics) {
+  auto port = NextPort();
+  auto server = nt::CreateInstance();
+  auto client = nt::CreateInstance();
+  nt::StartServer(server, kPersistFilename, "127.0.0.1", 0, port);
+  nt::SubscribeMultiple(client, {{std::string_view{}}}, {.topicsOnly = true});
+  nt::StartClient4(client, "client");
+  nt::SetServer(client, "127.0.0.1", port);
+  WaitFor([&] { return nt::IsConnected(client); });
+
+  std::atomic<int> announced{0};
+  nt::AddListener(client, {{std::string_view{"storm/"}}}, NT_EVENT_PUBLISH,
+                  [&](const nt::Event&) { ++announced; });
+
+  auto start = Clock::now();
+  for (int i = 0; i < numTopics; ++i) {
+    nt::Publish(nt::GetTopic(server, fmt::format("storm/{}/value", i)),
+                NT_DOUBLE, "double");
+  }
+  nt::Flush(server);
+  bool ok = WaitFor([&] { return announced == numTopics; });
+  auto stop = Clock::now();
+  if (!ok) {
+    wpi::print(stderr, "AnnounceStorm: timed out ({} of {})\n",
+               announced.load(), numTopics);
+  }
+
+  nt::DestroyInstance(client);
+  nt::DestroyInstance(server);
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+std::string MakePersistentJson(int numTopics) {
+  std::string out;
+  wpi::raw_string_ostream os{out};
+  os << "[\n";
+  for (int i = 0; i < numTopics; ++i) {
+    if (i != 0) {
+      os << ",\n";
+    }
+    if (i % 2 == 0) {
+      os << fmt::format(
+          "{{\"name\":\"/Preferences/Value{}\",\"type\":\"double\","
+          "\"value\":{:.2f},\"properties\":{{\"persistent\":true}}}}",
+          i, i * 0.5);
+    } else {
+      os << fmt::format(
+          "{{\"name\":\"/Preferences/Value{}\",\"type\":\"string\","
+          "\"value\":\"string value {}\",\"properties\":{{\"persistent\":true}}"
+          "}}",
+          i, i);
+    }
+  }
+  os << "\n]\n";
+  os.flush();
+  return out;
+}
+
+// ServerImpl persistent load (parse and create topics)
+double PersistentLoad(int numTopics) {
+  auto json = MakePersistentJson(numTopics);
+  wpi::Logger logger;
+
+  auto start = Clock::now();
+  nt::server::ServerImpl server{logger};
+  auto errs = server.LoadPersistent(json);
+  auto stop = Clock::now();
+  if (!errs.empty()) {
+    wpi::print(stderr, "PersistentLoad: {}\n", errs);
+  }
+  return std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+// ServerImpl persistent save (JSON serialization)
+double PersistentSave(int numTopics) {
+  constexpr int kSaves = 20;
+  wpi::Logger logger;
+  nt::server::ServerImpl server{logger};
+  server.LoadPersistent(MakePersistentJson(numTopics));
+
+  size_t size = 0;
+  auto start = Clock::now();
+  for (int i = 0; i < kSaves; ++i) {
+    size += server.DumpPersistent().size();
+  }
+  auto stop = Clock::now();
+  if (size == 0) {
+    wpi::print(stderr, "PersistentSave: empty output\n");
+  }
+  return std::chrono::duration<double, std::micro>(stop - start).count() /
+         kSaves;
+}
+
+// binary value message encode
+double WireEncode(const nt::Value& value, int ops) {
+  wpi::SmallVector<char, 128> buf;
+  wpi::raw_svector_ostream os{buf};
+
+  auto start = Clock::now();
+  for (int i = 0; i < ops; ++i) {
+    buf.clear();
+    nt::net::WireEncodeBinary(os, 5, i, value);
+  }
+  auto stop = Clock::now();
+  return NsPerOp(start, stop, ops);
+}
+
+// binary value message decode
+double WireDecode(const nt::Value& value, int ops) {
+  constexpr int kPerFrame = 100;
+  std::vector<uint8_t> frame;
+  {
+    wpi::SmallVector<char, 128> buf;
+    wpi::raw_svector_ostream os{buf};
+    for (int i = 0; i < kPerFrame; ++i) {
+      nt::net::WireEncodeBinary(os, 5, i, value);
+    }
+    frame.assign(buf.begin(), buf.end());
+  }
+
+  int id;
+  nt::Value out;
+  std::string error;
+  auto start = Clock::now();
+  for (int i = 0; i < ops / kPerFrame; ++i) {
+    std::span<const uint8_t> data{frame};
+    while (!data.empty()) {
+      if (!nt::net::WireDecodeBinary(&data, &id, &out, &error, 0)) {
+        wpi::print(stderr, "WireDecode: {}\n", error);
+        return 0;
+      }
+    }
+  }
+  auto stop = Clock::now();
+  return NsPerOp(start, stop, ops / kPerFrame * kPerFrame);
+}
+
+std::vector<Benchmark> MakeBenchmarks() {
+  std::vector<Benchmark> b;
+  b.push_back({"LocalPubSub", [] { return LocalPubSub(200000); }, "ns/op"});
+  b.push_back(
+      {"LocalPubReadQueue", [] { return LocalPubReadQueue(200000); }, "ns/op"});
+  b.push_back(
+      {"ListenerLatency", [] { return ListenerLatency(20000); }, "ns/op"});
+  for (int n : {1, 10, 100}) {
+    b.push_back({fmt::format("ListenerDispatch/{}", n),
+                 [n] { return ListenerDispatch(20000 / n, n); }, "ns/op"});
+  }
+  for (int n : {1, 2, 4, 8}) {
+    b.push_back({fmt::format("LoopbackThroughput/{}", n),
+                 [n] { return LoopbackThroughput(n); }, "values/s", 3});
+  }
+  for (int n : {100, 1000, 5000}) {
+    b.push_back({fmt::format("AnnounceStorm/{}", n),
+                 [n] { return AnnounceStorm(n); }, "ms", 3});
+  }
+  for (int n : {100, 1000}) {
+    b.push_back({fmt::format("PersistentLoad/{}", n),
+                 [n] { return PersistentLoad(n); }, "us"});
+    b.push_back({fmt::format("PersistentSave/{}", n),
+                 [n] { return PersistentSave(n); }, "us"});
+  }
+  b.push_back({"WireEncode/double",
+               [] { return WireEncode(nt::Value::MakeDouble(1.5), 1000000); },
+               "ns/op"});
+  b.push_back({"WireDecode/double",
+               [] { return WireDecode(nt::Value::MakeDouble(1.5), 1000000); },
+               "ns/op"});
+  b.push_back({"WireEncode/double[100]",
+               [] {
+                 return WireEncode(
+                     nt::Value::MakeDoubleArray(std::vector<double>(100, 1.5)),
+                     200000);
+               },
+               "ns/op"});
+  b.push_back({"WireDecode/double[100]",
+               [] {
+                 return WireDecode(
+                     nt::Value::MakeDoubleArray(std::vector<double>(100, 1.5)),
+                     200000);
+               },
+               "ns/op"});
+  b.push_back({"WireEncode/string",
+               [] {
+                 return WireEncode(nt::Value::MakeString("a typical string"),
+                                   1000000);
+               },
+               "ns/op"});
+  return b;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  wpi::impl::SetupNowDefaultOnRio();
+
+  bool list = false;
+  std::string_view filter;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg{argv[i]};
+    if (arg == "--list") {
+      list = true;
+    } else if (arg.starts_with("-")) {
+      wpi::print(stderr, "Usage: {} [--list] [filter]\n", argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      filter = arg;
+    }
+  }
+
+  auto benchmarks = MakeBenchmarks();
+  if (list) {
+    for (auto&& bench : benchmarks) {
+      wpi::print("{}\n", bench.name);
+    }
+    return EXIT_SUCCESS;
+  }
+
+  wpi::print("{:<28} {:>14} {:>14} {:>14}  {}\n", "benchmark", "median", "min",
+             "max", "unit");
+  for (auto&& bench : benchmarks) {
+    if (!filter.empty() && bench.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    std::vector<double> results;
+    for (int i = 0; i < bench.repetitions; ++i) {
+      results.emplace_back(bench.run());
+    }
+    std::sort(results.begin(), results.end());
+    wpi::print("{:<28} {:>14.1f} {:>14.1f} {:>14.1f}  {}\n", bench.name,
+               results[results.size() / 2], results.front(), results.back(),
+               bench.unit);
+  }
+  std::remove(kPersistFilename);
+  return EXIT_SUCCESS;
+}
@@ -9,17 +9,25 @@
 #include <cstdlib>
 #include <limits>
 #include <numeric>
+#include <optional>
 #include <random>
+#include <string>
 #include <string_view>
 #include <thread>
 #include <vector>
 
 #include <fmt/format.h>
 #include <fmt/ranges.h>
+#include <wpi/Logger.h>
 #include <wpi/Synchronization.h>
+#include <wpi/json.h>
 #include <wpi/print.h>
+#include <wpi/raw_ostream.h>
 #include <wpi/timestamp.h>
 
+#include "net/MessageHandler.h"
+#include "net/WireDecoder.h"
+#include "net/WireEncoder.h"
 #include "networktables/DoubleArrayTopic.h"
 #include "networktables/NetworkTableInstance.h"
 #include "ntcore.h"
@@ -28,6 +36,9 @@
 
 void bench();
 void bench2();
+void contention();
+void decode();
+void latest();
 void stress();
 void stress2();
 
@@ -42,6 +53,18 @@ int main(int argc, char* argv[]) {
     bench2();
     return EXIT_SUCCESS;
   }
+  if (argc == 2 && std::string_view{argv[1]} == "contention") {
+    contention();
+    return EXIT_SUCCESS;
+  }
+  if (argc == 2 && std::string_view{argv[1]} == "decode") {
+    decode();
+    return EXIT_SUCCESS;
+  }
+  if (argc == 2 && std::string_view{argv[1]} == "latest") {
+    latest();
+    return EXIT_SUCCESS;
+  }
   if (argc == 2 && std::string_view{argv[1]} == "stress") {
     stress();
     return EXIT_SUCCESS;
@@ -208,6 +231,151 @@ void bench2() {
   PrintTimes(flushTimes);
 }
 
+// local publish/read throughput with 1-8 threads, each on its own topic
+void contention() {
+  constexpr int kIterations = 200000;
+
+  auto inst = nt::CreateInstance();
+
+  for (int numThreads = 1; numThreads <= 8; ++numThreads) {
+    std::vector<NT_Publisher> pubs;
+    std::vector<NT_Subscriber> subs;
+    for (int i = 0; i < numThreads; ++i) {
+      auto topic = nt::GetTopic(inst, fmt::format("contention/{}", i));
+      pubs.emplace_back(nt::Publish(topic, NT_DOUBLE, "double"));
+      subs.emplace_back(nt::Subscribe(topic, NT_DOUBLE, "double"));
+    }
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < numThreads; ++i) {
+      threads.emplace_back([pub = pubs[i], sub = subs[i]] {
+        for (int j = 1; j <= kIterations; ++j) {
+          nt::SetDouble(pub, j, j);
+          nt::GetAtomicDouble(sub, 0);
+          nt::ReadQueueDouble(sub);
+        }
+      });
+    }
+    for (auto&& thr : threads) {
+      thr.join();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(stop - start)
+                  .count();
+    wpi::print("{} threads: {}us total, {:.1f} Mops/s\n", numThreads, us,
+               static_cast<double>(numThreads) * kIterations * 3 / us);
+
+    for (auto pub : pubs) {
+      nt::Unpublish(pub);
+    }
+    for (auto sub : subs) {
+      nt::Unsubscribe(sub);
+    }
+  }
+
+  nt::DestroyInstance(inst);
+}
+
+// per-read cost of default vs latestOnly subscribers
+void latest() {
+  constexpr int kTopics = 50;
+  constexpr int kIterations = 20000;
+
+  auto inst = nt::CreateInstance();
+
+  for (bool latestOnly : {false, true}) {
+    std::vector<NT_Subscriber> subs;
+    for (int i = 0; i < kTopics; ++i) {
+      auto topic = nt::GetTopic(inst, fmt::format("latest/{}", i));
+      nt::SetDouble(nt::Publish(topic, NT_DOUBLE, "double"), i);
+      subs.emplace_back(
+          nt::Subscribe(topic, NT_DOUBLE, "double", {.latestOnly = latestOnly}));
+    }
+
+    double sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < kIterations; ++j) {
+      for (auto sub : subs) {
+        sum += nt::GetDouble(sub, 0);
+      }
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+                  .count();
+    wpi::print("latestOnly={}: {:.1f}ns per read (sum {})\n", latestOnly,
+               static_cast<double>(ns) / (kTopics * kIterations), sum);
+  }
+
+  nt::DestroyInstance(inst);
+}
+
+// decode time of a 5000-topic announce burst, as sent on client connect
+void decode() {
+  constexpr int kTopics = 5000;
+  constexpr int kIterations = 50;
+
+  struct Handler final : public nt::net::ServerMessageHandler {
+    int ServerAnnounce(std::string_view name, int id, std::string_view typeStr,
+                       const wpi::json& properties,
+                       std::optional<int> pubuid) final {
+      ++count;
+      return 0;
+    }
+    void ServerUnannounce(std::string_view name, int id) final {}
+    void ServerPropertiesUpdate(std::string_view name, const wpi::json& update,
+                                bool ack) final {}
+    void ServerSetValue(int topicuid, const nt::Value& value) final {}
+    int count = 0;
+  };
+
+  static constexpr std::string_view kTypes[] = {"double", "boolean", "string",
+                                                "double[]", "int"};
+  std::string frame;
+  wpi::raw_string_ostream os{frame};
+  os << '[';
+  for (int i = 0; i < kTopics; ++i) {
+    if (i != 0) {
+      os << ',';
+    }
+    wpi::json props = wpi::json::object();
+    if (i % 10 == 0) {
+      props["persistent"] = true;
+    }
+    nt::net::WireEncodeAnnounce(
+        os, fmt::format("/SmartDashboard/Subsystem{}/Value{}", i / 50, i), i,
+        kTypes[i % std::size(kTypes)], props, std::nullopt);
+  }
+  os << ']';
+  os.flush();
+
+  wpi::Logger logger;
+  Handler handler;
+  std::vector<int64_t> times;
+  times.reserve(kIterations);
+  for (int i = 0; i < kIterations; ++i) {
+    int64_t start = nt::Now();
+    nt::net::WireDecodeText(frame, handler, logger);
+    times.emplace_back(nt::Now() - start);
+  }
+  wpi::print("{} byte frame, {} announces decoded\n", frame.size(),
+             handler.count);
+  wpi::print("-- WireDecodeText (us) --\n");
+  PrintTimes(times);
+
+  // for reference, the cost of just building a DOM for the frame
+  times.clear();
+  for (int i = 0; i < kIterations; ++i) {
+    int64_t start = nt::Now();
+    auto j = wpi::json::parse(frame);
+    times.emplace_back(nt::Now() - start);
+  }
+  wpi::print("-- wpi::json::parse (us) --\n");
+  PrintTimes(times);
+}
+
 static std::random_device r;
 static std::mt19937 gen(r());
 static std::uniform_real_distribution<double> dist;
@@ -1388,6 +1388,19 @@ public final class NetworkTableInstance implements AutoCloseable {
     return NetworkTablesJNI.getServerTimeOffset(m_handle);
   }
 
+  /**
+   * Limits the average rate at which data is sent on each network connection. When the limit is
+   * reached, updates for topics subscribed with a higher priority (see {@link
+   * PubSubOption#priority(int)}) are sent first and the remainder are deferred to later sends. The
+   * limit applies to each connection separately and only to NT4 connections.
+   *
+   * @param bytesPerSecond maximum average send rate, in bytes per second; 0 (the default) is
+   *     unlimited
+   */
+  public void setNetworkBandwidthLimit(double bytesPerSecond) {
+    NetworkTablesJNI.setNetworkBandwidthLimit(m_handle, bytesPerSecond);
+  }
+
   /**
    * Starts logging entry changes to a DataLog.
    *
@@ -1539,6 +1539,14 @@ public final class NetworkTablesJNI {
    */
   public static native OptionalLong getServerTimeOffset(int inst);
 
+  /**
+   * Limits the average rate at which data is sent on each network connection.
+   *
+   * @param inst NT instance handle.
+   * @param bytesPerSecond maximum average send rate, in bytes per second; 0 is unlimited
+   */
+  public static native void setNetworkBandwidthLimit(int inst, double bytesPerSecond);
+
   /**
    * Returns the current timestamp in microseconds.
    *
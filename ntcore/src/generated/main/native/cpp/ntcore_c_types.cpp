@@ -6,6 +6,9 @@
 
 #include "ntcore_c_types.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "Value_internal.h"
 #include "ntcore_cpp.h"
 
@@ -135,6 +138,22 @@ NT_Bool* NT_ReadQueueValuesBoolean(NT_Handle subentry, size_t* len) {
   return ConvertToC<NT_Bool>(arr, len);
 }
 
+size_t NT_ReadQueueIntoBoolean(NT_Handle subentry, struct NT_TimestampedBoolean* arr, size_t len) {
+  nt::TimestampedBoolean buf[32];
+  size_t count = 0;
+  while (count < len) {
+    size_t n = (std::min)(len - count, std::size(buf));
+    auto vals = nt::ReadQueueBoolean(subentry, std::span{buf, n});
+    for (auto&& val : vals) {
+      ConvertToC(val, &arr[count++]);
+    }
+    if (vals.size() < n) {
+      break;
+    }
+  }
+  return count;
+}
+
 
 NT_Bool NT_SetInteger(NT_Handle pubentry, int64_t time, int64_t value) {
   return nt::SetInteger(pubentry, value, time);
@@ -172,6 +191,22 @@ int64_t* NT_ReadQueueValuesInteger(NT_Handle subentry, size_t* len) {
   return ConvertToC<int64_t>(arr, len);
 }
 
+size_t NT_ReadQueueIntoInteger(NT_Handle subentry, struct NT_TimestampedInteger* arr, size_t len) {
+  nt::TimestampedInteger buf[32];
+  size_t count = 0;
+  while (count < len) {
+    size_t n = (std::min)(len - count, std::size(buf));
+    auto vals = nt::ReadQueueInteger(subentry, std::span{buf, n});
+    for (auto&& val : vals) {
+      ConvertToC(val, &arr[count++]);
+    }
+    if (vals.size() < n) {
+      break;
+    }
+  }
+  return count;
+}
+
 
 NT_Bool NT_SetFloat(NT_Handle pubentry, int64_t time, float value) {
   return nt::SetFloat(pubentry, value, time);
@@ -209,6 +244,22 @@ float* NT_ReadQueueValuesFloat(NT_Handle subentry, size_t* len) {
   return ConvertToC<float>(arr, len);
 }
 
+size_t NT_ReadQueueIntoFloat(NT_Handle subentry, struct NT_TimestampedFloat* arr, size_t len) {
+  nt::TimestampedFloat buf[32];
+  size_t count = 0;
+  while (count < len) {
+    size_t n = (std::min)(len - count, std::size(buf));
+    auto vals = nt::ReadQueueFloat(subentry, std::span{buf, n});
+    for (auto&& val : vals) {
+      ConvertToC(val, &arr[count++]);
+    }
+    if (vals.size() < n) {
+      break;
+    }
+  }
+  return count;
+}
+
 
 NT_Bool NT_SetDouble(NT_Handle pubentry, int64_t time, double value) {
   return nt::SetDouble(pubentry, value, time);
@@ -246,6 +297,22 @@ double* NT_ReadQueueValuesDouble(NT_Handle subentry, size_t* len) {
   return ConvertToC<double>(arr, len);
 }
 
+size_t NT_ReadQueueIntoDouble(NT_Handle subentry, struct NT_TimestampedDouble* arr, size_t len) {
+  nt::TimestampedDouble buf[32];
+  size_t count = 0;
+  while (count < len) {
+    size_t n = (std::min)(len - count, std::size(buf));
+    auto vals = nt::ReadQueueDouble(subentry, std::span{buf, n});
+    for (auto&& val : vals) {
+      ConvertToC(val, &arr[count++]);
+    }
+    if (vals.size() < n) {
+      break;
+    }
+  }
+  return count;
+}
+
 
 NT_Bool NT_SetString(NT_Handle pubentry, int64_t time, const struct WPI_String* value) {
   return nt::SetString(pubentry, ConvertFromC(value), time);
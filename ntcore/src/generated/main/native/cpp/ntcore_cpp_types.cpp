@@ -78,6 +78,17 @@ static inline std::vector<Timestamped<typename TypeInfo<T>::Value>> ReadQueue(
   }
 }
 
+template <typename T>
+static inline std::span<Timestamped<typename TypeInfo<T>::Value>> ReadQueue(
+    NT_Handle subentry,
+    std::span<Timestamped<typename TypeInfo<T>::Value>> out) {
+  if (auto ii = InstanceImpl::Get(Handle{subentry}.GetInst())) {
+    return ii->localStorage.ReadQueue<T>(subentry, out);
+  } else {
+    return {};
+  }
+}
+
 template <typename T>
 static inline typename ValuesType<T>::Vector ReadQueueValues(
     NT_Handle subentry) {
@@ -111,6 +122,10 @@ std::vector<TimestampedBoolean> ReadQueueBoolean(NT_Handle subentry) {
   return ReadQueue<bool>(subentry);
 }
 
+std::span<TimestampedBoolean> ReadQueueBoolean(NT_Handle subentry, std::span<TimestampedBoolean> out) {
+  return ReadQueue<bool>(subentry, out);
+}
+
 std::vector<int> ReadQueueValuesBoolean(NT_Handle subentry) {
   return ReadQueueValues<bool>(subentry);
 }
@@ -137,6 +152,10 @@ std::vector<TimestampedInteger> ReadQueueInteger(NT_Handle subentry) {
   return ReadQueue<int64_t>(subentry);
 }
 
+std::span<TimestampedInteger> ReadQueueInteger(NT_Handle subentry, std::span<TimestampedInteger> out) {
+  return ReadQueue<int64_t>(subentry, out);
+}
+
 std::vector<int64_t> ReadQueueValuesInteger(NT_Handle subentry) {
   return ReadQueueValues<int64_t>(subentry);
 }
@@ -163,6 +182,10 @@ std::vector<TimestampedFloat> ReadQueueFloat(NT_Handle subentry) {
   return ReadQueue<float>(subentry);
 }
 
+std::span<TimestampedFloat> ReadQueueFloat(NT_Handle subentry, std::span<TimestampedFloat> out) {
+  return ReadQueue<float>(subentry, out);
+}
+
 std::vector<float> ReadQueueValuesFloat(NT_Handle subentry) {
   return ReadQueueValues<float>(subentry);
 }
@@ -189,6 +212,10 @@ std::vector<TimestampedDouble> ReadQueueDouble(NT_Handle subentry) {
   return ReadQueue<double>(subentry);
 }
 
+std::span<TimestampedDouble> ReadQueueDouble(NT_Handle subentry, std::span<TimestampedDouble> out) {
+  return ReadQueue<double>(subentry, out);
+}
+
 std::vector<double> ReadQueueValuesDouble(NT_Handle subentry) {
   return ReadQueueValues<double>(subentry);
 }
@@ -215,6 +242,10 @@ std::vector<TimestampedString> ReadQueueString(NT_Handle subentry) {
   return ReadQueue<std::string>(subentry);
 }
 
+std::span<TimestampedString> ReadQueueString(NT_Handle subentry, std::span<TimestampedString> out) {
+  return ReadQueue<std::string>(subentry, out);
+}
+
 std::vector<std::string> ReadQueueValuesString(NT_Handle subentry) {
   return ReadQueueValues<std::string>(subentry);
 }
@@ -255,6 +286,10 @@ std::vector<TimestampedRaw> ReadQueueRaw(NT_Handle subentry) {
   return ReadQueue<uint8_t[]>(subentry);
 }
 
+std::span<TimestampedRaw> ReadQueueRaw(NT_Handle subentry, std::span<TimestampedRaw> out) {
+  return ReadQueue<uint8_t[]>(subentry, out);
+}
+
 std::vector<std::vector<uint8_t>> ReadQueueValuesRaw(NT_Handle subentry) {
   return ReadQueueValues<uint8_t[]>(subentry);
 }
@@ -295,6 +330,10 @@ std::vector<TimestampedBooleanArray> ReadQueueBooleanArray(NT_Handle subentry) {
   return ReadQueue<bool[]>(subentry);
 }
 
+std::span<TimestampedBooleanArray> ReadQueueBooleanArray(NT_Handle subentry, std::span<TimestampedBooleanArray> out) {
+  return ReadQueue<bool[]>(subentry, out);
+}
+
 std::vector<std::vector<int>> ReadQueueValuesBooleanArray(NT_Handle subentry) {
   return ReadQueueValues<bool[]>(subentry);
 }
@@ -335,6 +374,10 @@ std::vector<TimestampedIntegerArray> ReadQueueIntegerArray(NT_Handle subentry) {
   return ReadQueue<int64_t[]>(subentry);
 }
 
+std::span<TimestampedIntegerArray> ReadQueueIntegerArray(NT_Handle subentry, std::span<TimestampedIntegerArray> out) {
+  return ReadQueue<int64_t[]>(subentry, out);
+}
+
 std::vector<std::vector<int64_t>> ReadQueueValuesIntegerArray(NT_Handle subentry) {
   return ReadQueueValues<int64_t[]>(subentry);
 }
@@ -375,6 +418,10 @@ std::vector<TimestampedFloatArray> ReadQueueFloatArray(NT_Handle subentry) {
   return ReadQueue<float[]>(subentry);
 }
 
+std::span<TimestampedFloatArray> ReadQueueFloatArray(NT_Handle subentry, std::span<TimestampedFloatArray> out) {
+  return ReadQueue<float[]>(subentry, out);
+}
+
 std::vector<std::vector<float>> ReadQueueValuesFloatArray(NT_Handle subentry) {
   return ReadQueueValues<float[]>(subentry);
 }
@@ -415,6 +462,10 @@ std::vector<TimestampedDoubleArray> ReadQueueDoubleArray(NT_Handle subentry) {
   return ReadQueue<double[]>(subentry);
 }
 
+std::span<TimestampedDoubleArray> ReadQueueDoubleArray(NT_Handle subentry, std::span<TimestampedDoubleArray> out) {
+  return ReadQueue<double[]>(subentry, out);
+}
+
 std::vector<std::vector<double>> ReadQueueValuesDoubleArray(NT_Handle subentry) {
   return ReadQueueValues<double[]>(subentry);
 }
@@ -455,6 +506,10 @@ std::vector<TimestampedStringArray> ReadQueueStringArray(NT_Handle subentry) {
   return ReadQueue<std::string[]>(subentry);
 }
 
+std::span<TimestampedStringArray> ReadQueueStringArray(NT_Handle subentry, std::span<TimestampedStringArray> out) {
+  return ReadQueue<std::string[]>(subentry, out);
+}
+
 std::vector<std::vector<std::string>> ReadQueueValuesStringArray(NT_Handle subentry) {
   return ReadQueueValues<std::string[]>(subentry);
 }
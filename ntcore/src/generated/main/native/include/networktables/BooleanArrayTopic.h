@@ -165,6 +165,20 @@ class BooleanArraySubscriber : public Subscriber {
     return ::nt::ReadQueueBooleanArray(m_subHandle);
   }
 
+  /**
+   * Get value changes since the last call to ReadQueue into a caller-provided
+   * buffer, reusing its storage. Values that do not fit remain queued for the
+   * next call.
+   *
+   * @param out buffer to fill
+   * @return Filled portion of out; empty if no new changes have been
+   *     published since the previous call.
+   */
+  std::span<TimestampedValueType> ReadQueue(
+      std::span<TimestampedValueType> out) {
+    return ::nt::ReadQueueBooleanArray(m_subHandle, out);
+  }
+
   /**
    * Get the corresponding topic.
    *
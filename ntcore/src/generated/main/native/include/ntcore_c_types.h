@@ -123,6 +123,18 @@ void NT_FreeQueueBoolean(struct NT_TimestampedBoolean* arr, size_t len);
  */
 NT_Bool* NT_ReadQueueValuesBoolean(NT_Handle subentry, size_t* len);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, without allocating. Values that do not fit remain queued for the
+ * next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param arr buffer to fill
+ * @param len length of buffer
+ * @return Number of values written to arr
+ */
+size_t NT_ReadQueueIntoBoolean(NT_Handle subentry, struct NT_TimestampedBoolean* arr, size_t len);
+
 /** @} */
 
 /**
@@ -233,6 +245,18 @@ void NT_FreeQueueInteger(struct NT_TimestampedInteger* arr, size_t len);
  */
 int64_t* NT_ReadQueueValuesInteger(NT_Handle subentry, size_t* len);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, without allocating. Values that do not fit remain queued for the
+ * next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param arr buffer to fill
+ * @param len length of buffer
+ * @return Number of values written to arr
+ */
+size_t NT_ReadQueueIntoInteger(NT_Handle subentry, struct NT_TimestampedInteger* arr, size_t len);
+
 /** @} */
 
 /**
@@ -343,6 +367,18 @@ void NT_FreeQueueFloat(struct NT_TimestampedFloat* arr, size_t len);
  */
 float* NT_ReadQueueValuesFloat(NT_Handle subentry, size_t* len);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, without allocating. Values that do not fit remain queued for the
+ * next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param arr buffer to fill
+ * @param len length of buffer
+ * @return Number of values written to arr
+ */
+size_t NT_ReadQueueIntoFloat(NT_Handle subentry, struct NT_TimestampedFloat* arr, size_t len);
+
 /** @} */
 
 /**
@@ -453,6 +489,18 @@ void NT_FreeQueueDouble(struct NT_TimestampedDouble* arr, size_t len);
  */
 double* NT_ReadQueueValuesDouble(NT_Handle subentry, size_t* len);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, without allocating. Values that do not fit remain queued for the
+ * next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param arr buffer to fill
+ * @param len length of buffer
+ * @return Number of values written to arr
+ */
+size_t NT_ReadQueueIntoDouble(NT_Handle subentry, struct NT_TimestampedDouble* arr, size_t len);
+
 /** @} */
 
 /**
@@ -113,6 +113,19 @@ TimestampedBoolean GetAtomicBoolean(NT_Handle subentry, bool defaultValue);
  */
 std::vector<TimestampedBoolean> ReadQueueBoolean(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedBoolean> ReadQueueBoolean(NT_Handle subentry, std::span<TimestampedBoolean> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -192,6 +205,19 @@ TimestampedInteger GetAtomicInteger(NT_Handle subentry, int64_t defaultValue);
  */
 std::vector<TimestampedInteger> ReadQueueInteger(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedInteger> ReadQueueInteger(NT_Handle subentry, std::span<TimestampedInteger> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -271,6 +297,19 @@ TimestampedFloat GetAtomicFloat(NT_Handle subentry, float defaultValue);
  */
 std::vector<TimestampedFloat> ReadQueueFloat(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedFloat> ReadQueueFloat(NT_Handle subentry, std::span<TimestampedFloat> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -350,6 +389,19 @@ TimestampedDouble GetAtomicDouble(NT_Handle subentry, double defaultValue);
  */
 std::vector<TimestampedDouble> ReadQueueDouble(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedDouble> ReadQueueDouble(NT_Handle subentry, std::span<TimestampedDouble> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -435,6 +487,19 @@ TimestampedString GetAtomicString(NT_Handle subentry, std::string_view defaultVa
  */
 std::vector<TimestampedString> ReadQueueString(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedString> ReadQueueString(NT_Handle subentry, std::span<TimestampedString> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -527,6 +592,19 @@ TimestampedRaw GetAtomicRaw(NT_Handle subentry, std::span<const uint8_t> default
  */
 std::vector<TimestampedRaw> ReadQueueRaw(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedRaw> ReadQueueRaw(NT_Handle subentry, std::span<TimestampedRaw> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -619,6 +697,19 @@ TimestampedBooleanArray GetAtomicBooleanArray(NT_Handle subentry, std::span<cons
  */
 std::vector<TimestampedBooleanArray> ReadQueueBooleanArray(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedBooleanArray> ReadQueueBooleanArray(NT_Handle subentry, std::span<TimestampedBooleanArray> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -711,6 +802,19 @@ TimestampedIntegerArray GetAtomicIntegerArray(NT_Handle subentry, std::span<cons
  */
 std::vector<TimestampedIntegerArray> ReadQueueIntegerArray(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedIntegerArray> ReadQueueIntegerArray(NT_Handle subentry, std::span<TimestampedIntegerArray> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -803,6 +907,19 @@ TimestampedFloatArray GetAtomicFloatArray(NT_Handle subentry, std::span<const fl
  */
 std::vector<TimestampedFloatArray> ReadQueueFloatArray(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedFloatArray> ReadQueueFloatArray(NT_Handle subentry, std::span<TimestampedFloatArray> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -895,6 +1012,19 @@ TimestampedDoubleArray GetAtomicDoubleArray(NT_Handle subentry, std::span<const
  */
 std::vector<TimestampedDoubleArray> ReadQueueDoubleArray(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedDoubleArray> ReadQueueDoubleArray(NT_Handle subentry, std::span<TimestampedDoubleArray> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -981,6 +1111,19 @@ TimestampedStringArray GetAtomicStringArray(NT_Handle subentry, std::span<const
  */
 std::vector<TimestampedStringArray> ReadQueueStringArray(NT_Handle subentry);
 
+/**
+ * Get value changes since the last call to ReadQueue into a caller-provided
+ * buffer, reusing its storage (including that of array values), so steady
+ * state polling does not allocate. Values that do not fit remain queued for
+ * the next call.
+ *
+ * @param subentry subscriber or entry handle
+ * @param out buffer to fill
+ * @return Filled portion of out; empty if no new changes have been published
+ *     since the previous call.
+ */
+std::span<TimestampedStringArray> ReadQueueStringArray(NT_Handle subentry, std::span<TimestampedStringArray> out);
+
 /**
  * Get an array of all value changes since the last call to ReadQueue.
  *
@@ -54,7 +54,14 @@ public final class NetworkTableEvent {
     kLogMessage(0x0100),
 
     /** Time synchronized with server. */
-    kTimeSync(0x0200);
+    kTimeSync(0x0200),
+
+    /**
+     * Only deliver the latest value. Combine with kValueRemote, kValueLocal, or kValueAll; if a
+     * value event for the same topic has not yet been read from the queue, it is replaced rather
+     * than a new event being queued.
+     */
+    kValueLatest(0x0400);
 
     private final int value;
 
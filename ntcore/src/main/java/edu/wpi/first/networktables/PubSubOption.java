@@ -16,7 +16,9 @@ public class PubSubOption {
     disableLocal,
     excludePublisher,
     excludeSelf,
-    hidden
+    hidden,
+    latestOnly,
+    priority
   }
 
   PubSubOption(Kind kind, boolean value) {
@@ -162,6 +164,30 @@ public class PubSubOption {
     return new PubSubOption(Kind.hidden, enabled);
   }
 
+  /**
+   * For subscriptions, only the latest value is of interest. Enables a lock-free, allocation-free
+   * native get() for boolean, integer, float, and double subscribers. Has no effect on entries.
+   *
+   * @param enabled True to enable, false to disable
+   * @return option
+   */
+  public static PubSubOption latestOnly(boolean enabled) {
+    return new PubSubOption(Kind.latestOnly, enabled);
+  }
+
+  /**
+   * Network send priority. When a connection's bandwidth is limited (see {@link
+   * NetworkTableInstance#setNetworkBandwidthLimit(double)}), value updates for higher priority
+   * publishers and subscriptions are sent before lower priority ones. For subscriptions, this is the
+   * priority the server uses when sending to this client. The default is 0.
+   *
+   * @param priority priority
+   * @return option
+   */
+  public static PubSubOption priority(int priority) {
+    return new PubSubOption(Kind.priority, priority);
+  }
+
   final Kind m_kind;
   final boolean m_bValue;
   final int m_iValue;
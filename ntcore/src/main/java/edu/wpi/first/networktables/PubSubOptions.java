@@ -25,6 +25,8 @@ public class PubSubOptions {
         case excludePublisher -> excludePublisher = option.m_iValue;
         case excludeSelf -> excludeSelf = option.m_bValue;
         case hidden -> hidden = option.m_bValue;
+        case latestOnly -> latestOnly = option.m_bValue;
+        case priority -> priority = option.m_iValue;
         default -> {
           // NOP
         }
@@ -43,7 +45,9 @@ public class PubSubOptions {
       boolean disableRemote,
       boolean disableLocal,
       boolean excludeSelf,
-      boolean hidden) {
+      boolean hidden,
+      boolean latestOnly,
+      int priority) {
     this.pollStorage = pollStorage;
     this.periodic = periodic;
     this.excludePublisher = excludePublisher;
@@ -55,6 +59,8 @@ public class PubSubOptions {
     this.disableLocal = disableLocal;
     this.excludeSelf = excludeSelf;
     this.hidden = hidden;
+    this.latestOnly = latestOnly;
+    this.priority = priority;
   }
 
   /** Default value of periodic. */
@@ -116,4 +122,18 @@ public class PubSubOptions {
    * this one, and the subscription will not appear in metatopics.
    */
   public boolean hidden;
+
+  /**
+   * For subscriptions, only the latest value is of interest. Enables a lock-free, allocation-free
+   * native get() for boolean, integer, float, and double subscribers. Has no effect on entries.
+   */
+  public boolean latestOnly;
+
+  /**
+   * Network send priority. When a connection's bandwidth is limited (see {@link
+   * NetworkTableInstance#setNetworkBandwidthLimit(double)}), value updates for higher priority
+   * publishers and subscriptions are sent before lower priority ones. For subscriptions, this is the
+   * priority the server uses when sending to this client. The default is 0.
+   */
+  public int priority;
 }
@@ -56,6 +56,7 @@ int ConnectionList::AddConnection(const ConnectionInfo& info) {
 void ConnectionList::RemoveConnection(int handle) {
   std::scoped_lock lock{m_mutex};
   auto val = m_connections.erase(handle);
+  m_trafficStats.erase(handle);
   if (m_connections.empty()) {
     m_connected = false;
   }
@@ -77,6 +78,22 @@ void ConnectionList::ClearConnections() {
     m_listenerStorage.Notify({}, NT_EVENT_DISCONNECTED, &(*conn));
   }
   m_connections.clear();
+  m_trafficStats.clear();
+}
+
+void ConnectionList::SetTrafficStats(int handle, uint64_t sentBytes,
+                                     uint64_t deferredBytes,
+                                     uint64_t droppedBytes) {
+  std::scoped_lock lock{m_mutex};
+  if (handle < 0 || static_cast<size_t>(handle) >= m_connections.size() ||
+      !m_connections[handle]) {
+    return;
+  }
+  auto& stats = m_trafficStats[handle];
+  stats.remote_id = m_connections[handle]->remote_id;
+  stats.sent_bytes = sentBytes;
+  stats.deferred_bytes = deferredBytes;
+  stats.dropped_bytes = droppedBytes;
 }
 
 std::vector<ConnectionInfo> ConnectionList::GetConnections() const {
@@ -93,6 +110,16 @@ bool ConnectionList::IsConnected() const {
   return m_connected;
 }
 
+std::vector<NetworkTrafficStats> ConnectionList::GetTrafficStats() const {
+  std::scoped_lock lock{m_mutex};
+  std::vector<NetworkTrafficStats> stats;
+  stats.reserve(m_trafficStats.size());
+  for (auto&& entry : m_trafficStats) {
+    stats.emplace_back(entry.second);
+  }
+  return stats;
+}
+
 void ConnectionList::AddListener(NT_Listener listener, unsigned int eventMask) {
   std::scoped_lock lock{m_mutex};
   eventMask &= (NT_EVENT_CONNECTION | NT_EVENT_IMMEDIATE);
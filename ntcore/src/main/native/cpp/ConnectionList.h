@@ -14,6 +14,7 @@
 #include <vector>
 
 #include <wpi/DataLog.h>
+#include <wpi/DenseMap.h>
 #include <wpi/UidVector.h>
 #include <wpi/mutex.h>
 
@@ -35,10 +36,13 @@ class ConnectionList final : public IConnectionList {
   int AddConnection(const ConnectionInfo& info) final;
   void RemoveConnection(int handle) final;
   void ClearConnections() final;
+  void SetTrafficStats(int handle, uint64_t sentBytes, uint64_t deferredBytes,
+                       uint64_t droppedBytes) final;
 
   // user-facing functions
   std::vector<ConnectionInfo> GetConnections() const final;
   bool IsConnected() const final;
+  std::vector<NetworkTrafficStats> GetTrafficStats() const;
 
   void AddListener(NT_Listener listener, unsigned int eventMask);
 
@@ -54,6 +58,8 @@ class ConnectionList final : public IConnectionList {
   // shared with user (must be atomic or mutex-protected)
   std::atomic_bool m_connected{false};
   wpi::UidVector<std::optional<ConnectionInfo>, 8> m_connections;
+  // indexed by connection handle
+  wpi::DenseMap<int, NetworkTrafficStats> m_trafficStats;
 
   struct DataLoggerData {
     static constexpr auto kType = Handle::kConnectionDataLogger;
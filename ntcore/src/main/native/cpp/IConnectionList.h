@@ -17,6 +17,9 @@ class IConnectionList {
   virtual int AddConnection(const ConnectionInfo& info) = 0;
   virtual void RemoveConnection(int handle) = 0;
   virtual void ClearConnections() = 0;
+  virtual void SetTrafficStats(int handle, uint64_t sentBytes,
+                               uint64_t deferredBytes,
+                               uint64_t droppedBytes) = 0;
   virtual std::vector<ConnectionInfo> GetConnections() const = 0;
   virtual bool IsConnected() const = 0;
 };
@@ -39,6 +39,11 @@ class IListenerStorage {
                               unsigned int flags, int64_t serverTimeOffset,
                               int64_t rtt2, bool valid) = 0;
 
+  // Between these calls, events are still queued immediately, but listeners
+  // are only woken once, at the end.  Calls may be nested.
+  virtual void BeginNotifyBatch() = 0;
+  virtual void EndNotifyBatch() = 0;
+
   void Notify(std::span<const NT_Listener> handles, unsigned int flags,
               const ConnectionInfo* info) {
     Notify(handles, flags, {&info, 1});
@@ -25,6 +25,8 @@ class INetworkClient {
 
   virtual void FlushLocal() = 0;
   virtual void Flush() = 0;
+
+  virtual void SetBandwidthLimit(double bytesPerSecond) = 0;
 };
 
 }  // namespace nt
@@ -113,6 +113,9 @@ void InstanceImpl::StartServer(std::string_view persistFilename,
         std::scoped_lock lock{m_mutex};
         networkMode &= ~NT_NET_MODE_STARTING;
       });
+  if (m_bandwidthLimit != 0) {
+    m_networkServer->SetBandwidthLimit(m_bandwidthLimit);
+  }
   networkMode = NT_NET_MODE_SERVER | NT_NET_MODE_STARTING;
   listenerStorage.NotifyTimeSync({}, NT_EVENT_TIMESYNC, 0, 0, true);
   m_serverTimeOffset = 0;
@@ -144,6 +147,9 @@ void InstanceImpl::StartClient3(std::string_view identity) {
   if (!m_servers.empty()) {
     m_networkClient->SetServers(m_servers);
   }
+  if (m_bandwidthLimit != 0) {
+    m_networkClient->SetBandwidthLimit(m_bandwidthLimit);
+  }
   networkMode = NT_NET_MODE_CLIENT3;
 }
 
@@ -169,6 +175,9 @@ void InstanceImpl::StartClient4(std::string_view identity) {
   if (!m_servers.empty()) {
     m_networkClient->SetServers(m_servers);
   }
+  if (m_bandwidthLimit != 0) {
+    m_networkClient->SetBandwidthLimit(m_bandwidthLimit);
+  }
   networkMode = NT_NET_MODE_CLIENT4;
 }
 
@@ -191,6 +200,17 @@ void InstanceImpl::StopClient() {
   }
 }
 
+void InstanceImpl::SetBandwidthLimit(double bytesPerSecond) {
+  std::scoped_lock lock{m_mutex};
+  m_bandwidthLimit = bytesPerSecond;
+  if (m_networkServer) {
+    m_networkServer->SetBandwidthLimit(bytesPerSecond);
+  }
+  if (m_networkClient) {
+    m_networkClient->SetBandwidthLimit(bytesPerSecond);
+  }
+}
+
 void InstanceImpl::SetServers(
     std::span<const std::pair<std::string, unsigned int>> servers) {
   std::scoped_lock lock{m_mutex};
@@ -234,6 +254,7 @@ void InstanceImpl::Reset() {
   m_networkServer.reset();
   m_networkClient.reset();
   m_servers.clear();
+  m_bandwidthLimit = 0;
   networkMode = NT_NET_MODE_NONE;
   m_serverTimeOffset.reset();
   m_rtt2 = 0;
@@ -53,6 +53,7 @@ class InstanceImpl {
   void StopClient();
   void SetServers(
       std::span<const std::pair<std::string, unsigned int>> servers);
+  void SetBandwidthLimit(double bytesPerSecond);
 
   std::shared_ptr<NetworkServer> GetServer();
   std::shared_ptr<INetworkClient> GetClient();
@@ -81,6 +82,7 @@ class InstanceImpl {
   std::shared_ptr<NetworkServer> m_networkServer;
   std::shared_ptr<INetworkClient> m_networkClient;
   std::vector<std::pair<std::string, unsigned int>> m_servers;
+  double m_bandwidthLimit{0};
   std::optional<int64_t> m_serverTimeOffset;
   int64_t m_rtt2 = 0;
   int m_inst;
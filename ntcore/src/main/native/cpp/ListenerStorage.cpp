@@ -5,15 +5,40 @@
 #include "ListenerStorage.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <utility>
 #include <vector>
 
 #include <wpi/SmallVector.h>
+#include <wpi/timestamp.h>
 
 #include "ntcore_c.h"
 
 using namespace nt;
 
+namespace {
+struct ThreadNotifyBatch {
+  uint64_t storageId;
+  int depth;
+  // listeners to signal at the end of the batch
+  wpi::SmallVector<NT_Listener, 4> pendingSignals;
+};
+}  // namespace
+
+// open notify batches for the current thread; typically empty or a single
+// element. Keyed by a never-reused id, as with LocalStorage's value batches.
+static thread_local wpi::SmallVector<ThreadNotifyBatch, 1> gNotifyBatches;
+
+static ThreadNotifyBatch* FindNotifyBatch(uint64_t storageId) {
+  for (auto&& batch : gNotifyBatches) {
+    if (batch.storageId == storageId) {
+      return &batch;
+    }
+  }
+  return nullptr;
+}
+
 void ListenerStorage::Thread::Main() {
   while (m_active) {
     WPI_Handle signaledBuf[3];
@@ -90,8 +115,7 @@ void ListenerStorage::Notify(std::span<const NT_Listener> handles,
           }
         }
       }
-      listener.handle.Set();
-      listener.poller->handle.Set();
+      Signal(listener);
     }
   };
 
@@ -133,8 +157,7 @@ void ListenerStorage::Notify(std::span<const NT_Listener> handles,
         }
       }
       if (count > 0) {
-        listener.handle.Set();
-        listener.poller->handle.Set();
+        Signal(listener);
       }
     }
   };
@@ -170,14 +193,16 @@ void ListenerStorage::Notify(std::span<const NT_Listener> handles,
           if (finishEvent &&
               !finishEvent(mask, &listener.poller->queue.back())) {
             listener.poller->queue.pop_back();
+          } else if ((mask & NT_EVENT_VALUE_LATEST) != 0 &&
+                     Coalesce(*listener.poller, topic)) {
+            // replaced the unread event; it is still queued and signaled
           } else {
             ++count;
           }
         }
       }
       if (count > 0) {
-        listener.handle.Set();
-        listener.poller->handle.Set();
+        Signal(listener);
       }
     }
   };
@@ -218,8 +243,7 @@ void ListenerStorage::Notify(unsigned int flags, unsigned int level,
         }
       }
       if (count > 0) {
-        listener->handle.Set();
-        listener->poller->handle.Set();
+        Signal(*listener);
       }
     }
   }
@@ -243,8 +267,7 @@ void ListenerStorage::NotifyTimeSync(std::span<const NT_Listener> handles,
           // finishEvent is never set (see InstanceImpl)
         }
       }
-      listener.handle.Set();
-      listener.poller->handle.Set();
+      Signal(listener);
     }
   };
 
@@ -263,10 +286,11 @@ void ListenerStorage::NotifyTimeSync(std::span<const NT_Listener> handles,
 
 NT_Listener ListenerStorage::AddListener(ListenerCallback callback) {
   std::scoped_lock lock{m_mutex};
-  if (!m_thread) {
-    m_thread.Start(m_pollers.Add(m_inst)->handle);
+  size_t index = m_nextThread++ % m_numThreads;
+  while (m_threads.size() <= index) {
+    m_threads.emplace_back().Start(m_pollers.Add(m_inst)->handle);
   }
-  if (auto thr = m_thread.GetThread()) {
+  if (auto thr = m_threads[index].GetThread()) {
     auto listener = DoAddListener(thr->m_poller);
     if (listener) {
       thr->m_callbacks.try_emplace(listener, std::move(callback));
@@ -318,6 +342,25 @@ std::vector<Event> ListenerStorage::ReadListenerQueue(
   if (auto poller = m_pollers.Get(pollerHandle)) {
     std::vector<Event> rv;
     rv.swap(poller->queue);
+    poller->latest.clear();
+    if (!rv.empty()) {
+      m_dispatchedEvents += rv.size();
+      m_maxQueueDepth = (std::max)(m_maxQueueDepth, uint64_t{rv.size()});
+      int64_t now = wpi::Now();
+      if (poller->firstQueuedTime != 0) {
+        m_maxDispatchLatency =
+            (std::max)(m_maxDispatchLatency, now - poller->firstQueuedTime);
+      }
+      // every event contributes to the average; events never signaled (none
+      // normally) are counted as zero latency
+      m_dispatchLatencySum +=
+          static_cast<int64_t>(poller->timedEvents) * now -
+          poller->queuedTimeSum;
+      m_dispatchCount += rv.size();
+    }
+    poller->firstQueuedTime = 0;
+    poller->timedEvents = 0;
+    poller->queuedTimeSum = 0;
     return rv;
   } else {
     return {};
@@ -331,19 +374,101 @@ ListenerStorage::RemoveListener(NT_Listener listenerHandle) {
 }
 
 bool ListenerStorage::WaitForListenerQueue(double timeout) {
-  WPI_EventHandle h;
+  wpi::SmallVector<WPI_EventHandle, 4> handles;
   {
     std::scoped_lock lock{m_mutex};
-    if (auto thr = m_thread.GetThread()) {
-      h = thr->m_waitQueueWaiter.GetHandle();
-      thr->m_waitQueueWakeup.Set();
-    } else {
+    for (auto&& thread : m_threads) {
+      if (auto thr = thread.GetThread()) {
+        handles.emplace_back(thr->m_waitQueueWaiter.GetHandle());
+        thr->m_waitQueueWakeup.Set();
+      }
+    }
+  }
+  if (handles.empty()) {
+    return false;
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (auto h : handles) {
+    double remaining = timeout;
+    if (timeout > 0) {
+      remaining -= std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+      if (remaining < 0) {
+        remaining = 0;
+      }
+    }
+    bool timedOut;
+    wpi::WaitForObject(h, remaining, &timedOut);
+    if (timedOut) {
       return false;
     }
   }
-  bool timedOut;
-  wpi::WaitForObject(h, timeout, &timedOut);
-  return !timedOut;
+  return true;
+}
+
+void ListenerStorage::SetDispatchThreads(int count) {
+  std::scoped_lock lock{m_mutex};
+  m_numThreads = (std::max)(count, 1);
+}
+
+ListenerStats ListenerStorage::GetStats() const {
+  std::scoped_lock lock{m_mutex};
+  ListenerStats stats;
+  stats.dispatched_events = m_dispatchedEvents;
+  stats.coalesced_events = m_coalescedEvents;
+  for (auto&& poller : m_pollers) {
+    stats.queue_depth += poller->queue.size();
+  }
+  stats.max_queue_depth = m_maxQueueDepth;
+  if (m_dispatchCount != 0) {
+    stats.avg_dispatch_latency = m_dispatchLatencySum / m_dispatchCount;
+  }
+  stats.max_dispatch_latency = m_maxDispatchLatency;
+  return stats;
+}
+
+uint64_t ListenerStorage::NextBatchId() {
+  static std::atomic<uint64_t> nextId{1};
+  return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+ListenerStorage::~ListenerStorage() {
+  // drop any batch left open on the destroying thread; batches open on other
+  // threads are orphaned and freed when those threads exit
+  if (auto batch = FindNotifyBatch(m_batchId)) {
+    gNotifyBatches.erase(gNotifyBatches.begin() +
+                         (batch - gNotifyBatches.data()));
+  }
+}
+
+void ListenerStorage::BeginNotifyBatch() {
+  if (auto batch = FindNotifyBatch(m_batchId)) {
+    ++batch->depth;
+  } else {
+    gNotifyBatches.emplace_back(ThreadNotifyBatch{m_batchId, 1, {}});
+  }
+}
+
+void ListenerStorage::EndNotifyBatch() {
+  auto batch = FindNotifyBatch(m_batchId);
+  if (!batch || --batch->depth != 0) {
+    return;
+  }
+  auto pendingSignals = std::move(batch->pendingSignals);
+  gNotifyBatches.erase(gNotifyBatches.begin() +
+                       (batch - gNotifyBatches.data()));
+  if (pendingSignals.empty()) {
+    return;
+  }
+  std::scoped_lock lock{m_mutex};
+  for (auto handle : pendingSignals) {
+    // the listener may have been removed (or the storage reset) since
+    if (auto listener = m_listeners.Get(handle)) {
+      listener->handle.Set();
+      listener->poller->handle.Set();
+    }
+  }
 }
 
 void ListenerStorage::Reset() {
@@ -355,21 +480,78 @@ void ListenerStorage::Reset() {
   m_valueListeners.clear();
   m_logListeners.clear();
   m_timeSyncListeners.clear();
-  if (m_thread) {
-    m_thread.Stop();
+  for (auto&& thread : m_threads) {
+    thread.Stop();
+  }
+  m_threads.clear();
+  m_numThreads = 1;
+  m_nextThread = 0;
+  m_dispatchedEvents = 0;
+  m_coalescedEvents = 0;
+  m_maxQueueDepth = 0;
+  m_dispatchCount = 0;
+  m_dispatchLatencySum = 0;
+  m_maxDispatchLatency = 0;
+}
+
+void ListenerStorage::Signal(ListenerData& listener) {
+  auto& poller = *listener.poller;
+  if (poller.timedEvents < poller.queue.size()) {
+    // record the queue time of the events added since the last signal;
+    // coalesced events keep the time of the event they replaced
+    int64_t now = wpi::Now();
+    if (poller.firstQueuedTime == 0) {
+      poller.firstQueuedTime = now;
+    }
+    poller.queuedTimeSum +=
+        static_cast<int64_t>(poller.queue.size() - poller.timedEvents) * now;
+    poller.timedEvents = poller.queue.size();
   }
+  // only a batch open on the notifying thread defers the signal
+  auto batch = FindNotifyBatch(m_batchId);
+  if (!batch) {
+    listener.handle.Set();
+    listener.poller->handle.Set();
+  } else if (std::find(batch->pendingSignals.begin(),
+                       batch->pendingSignals.end(),
+                       listener.handle) == batch->pendingSignals.end()) {
+    // defer until the batch ends, so a batch results in one wakeup
+    batch->pendingSignals.emplace_back(listener.handle);
+  }
+}
+
+bool ListenerStorage::Coalesce(PollerData& poller, NT_Topic topic) {
+  auto& event = poller.queue.back();
+  auto [it, isNew] = poller.latest.try_emplace(
+      std::pair{event.listener, topic}, poller.queue.size() - 1);
+  if (isNew) {
+    return false;
+  }
+  auto& prev = poller.queue[it->second];
+  auto prevData = prev.GetValueEventData();
+  if (!prevData ||
+      prevData->subentry != event.GetValueEventData()->subentry) {
+    it->second = poller.queue.size() - 1;
+    return false;
+  }
+  prev = std::move(event);
+  poller.queue.pop_back();
+  ++m_coalescedEvents;
+  return true;
 }
 
 std::vector<std::pair<NT_Listener, unsigned int>>
 ListenerStorage::DoRemoveListeners(std::span<const NT_Listener> handles) {
   std::vector<std::pair<NT_Listener, unsigned int>> rv;
-  auto thr = m_thread.GetThread();
   for (auto handle : handles) {
     if (auto listener = m_listeners.Remove(handle)) {
       rv.emplace_back(handle, listener->eventMask);
-      if (thr) {
-        if (thr->m_poller == listener->poller->handle) {
-          thr->m_callbacks.erase(handle);
+      for (auto&& thread : m_threads) {
+        if (auto thr = thread.GetThread()) {
+          if (thr->m_poller == listener->poller->handle) {
+            thr->m_callbacks.erase(handle);
+            break;
+          }
         }
       }
       if ((listener->eventMask & NT_EVENT_CONNECTION) != 0) {
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <functional>
 #include <memory>
 #include <span>
@@ -28,6 +30,7 @@ namespace nt {
 class ListenerStorage final : public IListenerStorage {
  public:
   explicit ListenerStorage(int inst) : m_inst{inst} {}
+  ~ListenerStorage() final;
   ListenerStorage(const ListenerStorage&) = delete;
   ListenerStorage& operator=(const ListenerStorage&) = delete;
 
@@ -44,6 +47,8 @@ class ListenerStorage final : public IListenerStorage {
               unsigned int line, std::string_view message) final;
   void NotifyTimeSync(std::span<const NT_Listener> handles, unsigned int flags,
                       int64_t serverTimeOffset, int64_t rtt2, bool valid) final;
+  void BeginNotifyBatch() final;
+  void EndNotifyBatch() final;
 
   // user-facing functions
   NT_Listener AddListener(ListenerCallback callback);
@@ -64,6 +69,11 @@ class ListenerStorage final : public IListenerStorage {
 
   bool WaitForListenerQueue(double timeout);
 
+  // applies to callback listeners added after this call
+  void SetDispatchThreads(int count);
+
+  ListenerStats GetStats() const;
+
   void Reset();
 
  private:
@@ -82,6 +92,15 @@ class ListenerStorage final : public IListenerStorage {
 
     wpi::SignalObject<NT_ListenerPoller> handle;
     std::vector<Event> queue;
+    // index into queue of the last value event for each (listener, topic),
+    // for listeners with NT_EVENT_VALUE_LATEST
+    wpi::DenseMap<std::pair<NT_Listener, NT_Topic>, size_t> latest;
+    // time the first event in queue was queued (0 if none)
+    int64_t firstQueuedTime{0};
+    // number of events in queue with a recorded queue time, and the sum of
+    // those times (for the average dispatch latency)
+    size_t timedEvents{0};
+    int64_t queuedTimeSum{0};
   };
   HandleMap<PollerData, 8> m_pollers;
 
@@ -98,6 +117,17 @@ class ListenerStorage final : public IListenerStorage {
   };
   HandleMap<ListenerData, 8> m_listeners;
 
+  // these assume the mutex is already held
+  void Signal(ListenerData& listener);
+  // replaces an earlier unread value event for the same topic with the event
+  // at the back of the queue; returns true if replaced
+  bool Coalesce(PollerData& poller, NT_Topic topic);
+
+  static uint64_t NextBatchId();
+
+  // identifies this instance's notify batches in the thread-local batch list
+  const uint64_t m_batchId{NextBatchId()};
+
   VectorSet<ListenerData*> m_connListeners;
   VectorSet<ListenerData*> m_topicListeners;
   VectorSet<ListenerData*> m_valueListeners;
@@ -115,7 +145,19 @@ class ListenerStorage final : public IListenerStorage {
     wpi::Event m_waitQueueWakeup;
     wpi::Event m_waitQueueWaiter;
   };
-  wpi::SafeThreadOwner<Thread> m_thread;
+  // callback listeners are assigned round-robin; all events for a listener
+  // are dispatched by a single thread to preserve per-listener ordering
+  std::vector<wpi::SafeThreadOwner<Thread>> m_threads;
+  size_t m_numThreads{1};
+  size_t m_nextThread{0};
+
+  // statistics
+  uint64_t m_dispatchedEvents{0};
+  uint64_t m_coalescedEvents{0};
+  uint64_t m_maxQueueDepth{0};
+  uint64_t m_dispatchCount{0};
+  int64_t m_dispatchLatencySum{0};
+  int64_t m_maxDispatchLatency{0};
 };
 
 }  // namespace nt
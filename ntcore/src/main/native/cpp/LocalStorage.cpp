@@ -4,10 +4,55 @@
 
 #include "LocalStorage.h"
 
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
 #include <vector>
 
+#include <wpi/SmallVector.h>
+
+#include "IListenerStorage.h"
+
 using namespace nt;
 
+namespace {
+struct ThreadBatch {
+  uint64_t storageId;
+  int depth;
+  std::vector<std::pair<NT_Handle, Value>> values;
+};
+}  // namespace
+
+// open batches for the current thread; typically empty or a single element.
+// Batches are keyed by a never-reused id rather than by LocalStorage pointer,
+// so a batch left open when its instance is destroyed can never be matched
+// (and committed into freed memory) by a later instance at the same address.
+static thread_local wpi::SmallVector<ThreadBatch, 1> gThreadBatches;
+
+static ThreadBatch* FindThreadBatch(uint64_t storageId) {
+  for (auto&& batch : gThreadBatches) {
+    if (batch.storageId == storageId) {
+      return &batch;
+    }
+  }
+  return nullptr;
+}
+
+uint64_t LocalStorage::NextBatchId() {
+  static std::atomic<uint64_t> nextId{1};
+  return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+LocalStorage::~LocalStorage() {
+  // drop any batch left open on the destroying thread; batches open on other
+  // threads are orphaned and freed when those threads exit
+  if (auto batch = FindThreadBatch(m_batchId)) {
+    gThreadBatches.erase(gThreadBatches.begin() +
+                         (batch - gThreadBatches.data()));
+  }
+}
+
 std::vector<NT_Topic> LocalStorage::GetTopics(std::string_view prefix,
                                               unsigned int types) {
   std::scoped_lock lock(m_mutex);
@@ -66,8 +111,9 @@ void LocalStorage::Release(NT_Handle pubsubentryHandle) {
 }
 
 Value LocalStorage::GetEntryValue(NT_Handle subentryHandle) {
-  std::scoped_lock lock{m_mutex};
+  std::shared_lock lock{m_mutex};
   if (auto subscriber = m_impl.GetSubEntry(subentryHandle)) {
+    std::scoped_lock topicLock{subscriber->topic->valueMutex};
     if (subscriber->config.type == NT_UNASSIGNED ||
         !subscriber->topic->lastValue ||
         subscriber->config.type == subscriber->topic->lastValue.type()) {
@@ -83,7 +129,8 @@ Value LocalStorage::GetEntryValue(NT_Handle subentryHandle) {
 
 void LocalStorage::AddListener(NT_Listener listenerHandle, NT_Handle handle,
                                unsigned int mask) {
-  mask &= (NT_EVENT_TOPIC | NT_EVENT_VALUE_ALL | NT_EVENT_IMMEDIATE);
+  mask &= (NT_EVENT_TOPIC | NT_EVENT_VALUE_ALL | NT_EVENT_VALUE_LATEST |
+           NT_EVENT_IMMEDIATE);
   std::scoped_lock lock{m_mutex};
   if (auto topic = m_impl.GetTopicByHandle(handle)) {
     m_impl.AddListenerImpl(listenerHandle, topic, mask);
@@ -96,3 +143,65 @@ void LocalStorage::AddListener(NT_Listener listenerHandle, NT_Handle handle,
                            entry->handle, false);
   }
 }
+
+void LocalStorage::BeginBatch() {
+  if (auto batch = FindThreadBatch(m_batchId)) {
+    ++batch->depth;
+  } else {
+    gThreadBatches.emplace_back(ThreadBatch{m_batchId, 1, {}});
+  }
+}
+
+bool LocalStorage::AddToBatch(NT_Handle pubentryHandle, const Value& value) {
+  if (gThreadBatches.empty()) {
+    return false;
+  }
+  if (auto batch = FindThreadBatch(m_batchId)) {
+    batch->values.emplace_back(pubentryHandle, value);
+    return true;
+  }
+  return false;
+}
+
+bool LocalStorage::CommitBatch() {
+  auto batch = FindThreadBatch(m_batchId);
+  if (!batch) {
+    return false;
+  }
+  if (--batch->depth > 0) {
+    return true;
+  }
+  auto values = std::move(batch->values);
+  gThreadBatches.erase(gThreadBatches.begin() +
+                       (batch - gThreadBatches.data()));
+  if (values.empty()) {
+    return true;
+  }
+
+  // listeners are woken once for the whole batch rather than once per value
+  m_listenerStorage.BeginNotifyBatch();
+  bool needsPublish = false;
+  {
+    std::shared_lock lock{m_mutex};
+    for (auto&& [handle, value] : values) {
+      if (auto publisher = m_impl.GetPubEntry(handle)) {
+        std::scoped_lock topicLock{publisher->topic->valueMutex};
+        m_impl.PublishLocalValue(publisher, value);
+        value = Value{};  // mark as done
+      } else {
+        needsPublish = true;
+      }
+    }
+  }
+  if (needsPublish) {
+    // entries that have not been published yet need the exclusive lock
+    std::unique_lock lock{m_mutex};
+    for (auto&& [handle, value] : values) {
+      if (value) {
+        m_impl.SetEntryValue(handle, value);
+      }
+    }
+  }
+  m_listenerStorage.EndNotifyBatch();
+  return true;
+}
@@ -6,7 +6,9 @@
 
 #include <stdint.h>
 
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <span>
 #include <string>
 #include <string_view>
@@ -33,7 +35,9 @@ class IListenerStorage;
 class LocalStorage final : public net::ILocalStorage {
  public:
   LocalStorage(int inst, IListenerStorage& listenerStorage, wpi::Logger& logger)
-      : m_impl{inst, listenerStorage, logger} {}
+      : m_listenerStorage{listenerStorage},
+        m_impl{inst, listenerStorage, logger} {}
+  ~LocalStorage();
   LocalStorage(const LocalStorage&) = delete;
   LocalStorage& operator=(const LocalStorage&) = delete;
 
@@ -61,8 +65,9 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   void ServerSetValue(int topicId, const Value& value) final {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicById(topicId)) {
+      std::scoped_lock topicLock{topic->valueMutex};
       m_impl.ServerSetValue(topic, value);
     }
   }
@@ -93,12 +98,18 @@ class LocalStorage final : public net::ILocalStorage {
     if (name.empty()) {
       return {};
     }
-    std::scoped_lock lock{m_mutex};
+    {
+      std::shared_lock lock{m_mutex};
+      if (auto topic = m_impl.GetTopicByName(name)) {
+        return topic->handle;
+      }
+    }
+    std::unique_lock lock{m_mutex};
     return m_impl.GetOrCreateTopic(name)->handle;
   }
 
   std::string GetTopicName(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
       return topic->name;
     } else {
@@ -107,8 +118,9 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   NT_Type GetTopicType(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
+      std::scoped_lock topicLock{topic->valueMutex};
       return topic->type;
     } else {
       return {};
@@ -116,7 +128,7 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   std::string GetTopicTypeString(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
       return topic->typeStr;
     } else {
@@ -132,7 +144,7 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   bool GetTopicPersistent(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
       return (topic->GetFlags() & NT_PERSISTENT) != 0;
     } else {
@@ -148,7 +160,7 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   bool GetTopicRetained(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
       return (topic->GetFlags() & NT_RETAINED) != 0;
     } else {
@@ -164,7 +176,7 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   bool GetTopicCached(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
       return (topic->GetFlags() & NT_UNCACHED) == 0;
     } else {
@@ -173,13 +185,13 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   bool GetTopicExists(NT_Handle handle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     local::LocalTopic* topic = m_impl.GetTopic(handle);
     return topic && topic->Exists();
   }
 
   wpi::json GetTopicProperty(NT_Topic topicHandle, std::string_view name) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
       return topic->properties.value(name, wpi::json{});
     } else {
@@ -203,7 +215,7 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   wpi::json GetTopicProperties(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
       return topic->properties;
     } else {
@@ -221,8 +233,9 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   TopicInfo GetTopicInfo(NT_Topic topicHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopicByHandle(topicHandle)) {
+      std::scoped_lock topicLock{topic->valueMutex};
       return topic->GetTopicInfo();
     } else {
       return {};
@@ -302,7 +315,7 @@ class LocalStorage final : public net::ILocalStorage {
   void Release(NT_Handle pubsubentry);
 
   NT_Topic GetTopicFromHandle(NT_Handle pubsubentryHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto topic = m_impl.GetTopic(pubsubentryHandle)) {
       return topic->handle;
     } else {
@@ -311,10 +324,29 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   bool SetEntryValue(NT_Handle pubentryHandle, const Value& value) {
-    std::scoped_lock lock{m_mutex};
+    if (!value) {
+      return false;
+    }
+    if (AddToBatch(pubentryHandle, value)) {
+      return true;
+    }
+    {
+      // fast path: existing publisher, so only topic-local state changes
+      std::shared_lock lock{m_mutex};
+      if (auto publisher = m_impl.GetPubEntry(pubentryHandle)) {
+        std::scoped_lock topicLock{publisher->topic->valueMutex};
+        return m_impl.PublishLocalValue(publisher, value);
+      }
+    }
+    // slow path: entry needs to be published first
+    std::unique_lock lock{m_mutex};
     return m_impl.SetEntryValue(pubentryHandle, value);
   }
 
+  // Value batching; batches are per-thread.  See nt::BeginBatch().
+  void BeginBatch();
+  bool CommitBatch();
+
   bool SetDefaultEntryValue(NT_Handle pubsubentryHandle, const Value& value) {
     std::scoped_lock lock{m_mutex};
     return m_impl.SetDefaultEntryValue(pubsubentryHandle, value);
@@ -323,13 +355,21 @@ class LocalStorage final : public net::ILocalStorage {
   template <ValidType T>
   Timestamped<typename TypeInfo<T>::Value> GetAtomic(
       NT_Handle subentry, typename TypeInfo<T>::View defaultValue) {
-    std::scoped_lock lock{m_mutex};
-    Value* value = m_impl.GetSubEntryValue(subentry);
-    if (value && (IsNumericConvertibleTo<T>(*value) || IsType<T>(*value))) {
-      return GetTimestamped<T, true>(*value);
-    } else {
-      return {0, 0, CopyValue<T>(defaultValue)};
+    if constexpr (local::LatestValueType<T>) {
+      // lock-free path for latestOnly subscribers
+      if (auto rv = m_impl.GetLatestValues().Load<T>(subentry, defaultValue)) {
+        return *rv;
+      }
+    }
+    std::shared_lock lock{m_mutex};
+    if (auto subscriber = m_impl.GetSubEntry(subentry)) {
+      std::scoped_lock topicLock{subscriber->topic->valueMutex};
+      const Value& value = subscriber->topic->lastValue;
+      if (IsNumericConvertibleTo<T>(value) || IsType<T>(value)) {
+        return GetTimestamped<T, true>(value);
+      }
     }
+    return {0, 0, CopyValue<T>(defaultValue)};
   }
 
   template <SmallArrayType T>
@@ -337,35 +377,63 @@ class LocalStorage final : public net::ILocalStorage {
       NT_Handle subentry,
       wpi::SmallVectorImpl<typename TypeInfo<T>::SmallElem>& buf,
       typename TypeInfo<T>::View defaultValue) {
-    std::scoped_lock lock{m_mutex};
-    Value* value = m_impl.GetSubEntryValue(subentry);
-    if (value && (IsNumericConvertibleTo<T>(*value) || IsType<T>(*value))) {
-      return GetTimestamped<T, true>(*value, buf);
-    } else {
-      return {0, 0, CopyValue<T>(defaultValue, buf)};
+    std::shared_lock lock{m_mutex};
+    if (auto subscriber = m_impl.GetSubEntry(subentry)) {
+      std::scoped_lock topicLock{subscriber->topic->valueMutex};
+      const Value& value = subscriber->topic->lastValue;
+      if (IsNumericConvertibleTo<T>(value) || IsType<T>(value)) {
+        return GetTimestamped<T, true>(value, buf);
+      }
     }
+    return {0, 0, CopyValue<T>(defaultValue, buf)};
   }
 
   std::vector<Value> ReadQueueValue(NT_Handle subentry, unsigned int types) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     auto subscriber = m_impl.GetSubEntry(subentry);
     if (!subscriber) {
       return {};
     }
+    std::scoped_lock topicLock{subscriber->topic->valueMutex};
     return subscriber->pollStorage.ReadValue(types);
   }
 
+  std::span<Value> ReadQueueValue(NT_Handle subentry, std::span<Value> out,
+                                  unsigned int types) {
+    std::shared_lock lock{m_mutex};
+    auto subscriber = m_impl.GetSubEntry(subentry);
+    if (!subscriber) {
+      return {};
+    }
+    std::scoped_lock topicLock{subscriber->topic->valueMutex};
+    return subscriber->pollStorage.ReadValue(out, types);
+  }
+
   template <ValidType T>
   std::vector<Timestamped<typename TypeInfo<T>::Value>> ReadQueue(
       NT_Handle subentry) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     auto subscriber = m_impl.GetSubEntry(subentry);
     if (!subscriber) {
       return {};
     }
+    std::scoped_lock topicLock{subscriber->topic->valueMutex};
     return subscriber->pollStorage.Read<T>();
   }
 
+  template <ValidType T>
+  std::span<Timestamped<typename TypeInfo<T>::Value>> ReadQueue(
+      NT_Handle subentry,
+      std::span<Timestamped<typename TypeInfo<T>::Value>> out) {
+    std::shared_lock lock{m_mutex};
+    auto subscriber = m_impl.GetSubEntry(subentry);
+    if (!subscriber) {
+      return {};
+    }
+    std::scoped_lock topicLock{subscriber->topic->valueMutex};
+    return subscriber->pollStorage.Read<T>(out);
+  }
+
   //
   // Backwards compatible user functions
   //
@@ -380,7 +448,7 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   unsigned int GetEntryFlags(NT_Entry entryHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto entry = m_impl.GetEntryByHandle(entryHandle)) {
       return entry->subscriber->topic->GetFlags();
     } else {
@@ -399,7 +467,7 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   std::string GetEntryName(NT_Entry subentryHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto subscriber = m_impl.GetSubEntry(subentryHandle)) {
       return subscriber->topic->name;
     } else {
@@ -408,8 +476,9 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   NT_Type GetEntryType(NT_Entry subentryHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto subscriber = m_impl.GetSubEntry(subentryHandle)) {
+      std::scoped_lock topicLock{subscriber->topic->valueMutex};
       return subscriber->topic->type;
     } else {
       return {};
@@ -417,8 +486,9 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
   int64_t GetEntryLastChange(NT_Entry subentryHandle) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     if (auto subscriber = m_impl.GetSubEntry(subentryHandle)) {
+      std::scoped_lock topicLock{subscriber->topic->valueMutex};
       return subscriber->topic->lastValue.time();
     } else {
       return 0;
@@ -432,7 +502,8 @@ class LocalStorage final : public net::ILocalStorage {
   void AddListener(NT_Listener listenerHandle,
                    std::span<const std::string_view> prefixes,
                    unsigned int mask) {
-    mask &= (NT_EVENT_TOPIC | NT_EVENT_VALUE_ALL | NT_EVENT_IMMEDIATE);
+    mask &= (NT_EVENT_TOPIC | NT_EVENT_VALUE_ALL | NT_EVENT_VALUE_LATEST |
+             NT_EVENT_IMMEDIATE);
     std::scoped_lock lock{m_mutex};
     // subscribe to make sure topic updates are received
     if (auto sub = m_impl.AddMultiSubscriber(
@@ -470,7 +541,7 @@ class LocalStorage final : public net::ILocalStorage {
   // Schema functions
   //
   bool HasSchema(std::string_view name) {
-    std::scoped_lock lock{m_mutex};
+    std::shared_lock lock{m_mutex};
     return m_impl.HasSchema(name);
   }
 
@@ -486,7 +557,20 @@ class LocalStorage final : public net::ILocalStorage {
   }
 
  private:
-  wpi::mutex m_mutex;
+  // returns false if there is no open batch on this thread
+  bool AddToBatch(NT_Handle pubentryHandle, const Value& value);
+
+  static uint64_t NextBatchId();
+
+  // identifies this instance's batches in the thread-local batch list
+  const uint64_t m_batchId{NextBatchId()};
+  IListenerStorage& m_listenerStorage;
+
+  // Structural changes (creating topics, publishers, subscribers, listeners,
+  // network start/stop) take this exclusively.  Value operations on an
+  // existing publisher/subscriber take it shared plus the topic's valueMutex,
+  // so value operations on different topics do not contend.
+  std::shared_mutex m_mutex;
   local::StorageImpl m_impl;
 };
 
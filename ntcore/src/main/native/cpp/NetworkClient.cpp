@@ -315,6 +315,9 @@ NetworkClient::NetworkClient(
         if (m_clientImpl) {
           HandleLocal();
           m_clientImpl->SendOutgoing(m_loop.Now().count(), false);
+          auto& stats = m_clientImpl->GetOutgoingStats();
+          m_connList.SetTrafficStats(m_connHandle, stats.sentBytes,
+                                     stats.deferredBytes, stats.droppedBytes);
         }
       });
       m_readLocalTimer->Start(uv::Timer::Time{100}, uv::Timer::Time{100});
@@ -360,6 +363,15 @@ NetworkClient::~NetworkClient() {
   m_loopRunner.Stop();
 }
 
+void NetworkClient::SetBandwidthLimit(double bytesPerSecond) {
+  m_loopRunner.ExecAsync([=, this](uv::Loop&) {
+    m_bandwidthLimit = bytesPerSecond;
+    if (m_clientImpl) {
+      m_clientImpl->SetBandwidthLimit(bytesPerSecond);
+    }
+  });
+}
+
 void NetworkClient::HandleLocal() {
   for (;;) {
     auto msgs = m_localQueue.ReadQueue(m_localMsgs);
@@ -387,7 +399,8 @@ void NetworkClient::TcpConnected(uv::Tcp& tcp) {
   wpi::SmallString<128> idBuf;
   auto ws = wpi::WebSocket::CreateClient(
       tcp, fmt::format("/nt/{}", wpi::EscapeURI(m_id, idBuf)), "",
-      {"v4.1.networktables.first.wpi.edu", "networktables.first.wpi.edu"},
+      {"v4.2.networktables.first.wpi.edu", "v4.1.networktables.first.wpi.edu",
+       "networktables.first.wpi.edu"},
       options);
   ws->SetMaxMessageSize(kMaxMessageSize);
   ws->open.connect([this, &tcp, ws = ws.get()](std::string_view protocol) {
@@ -407,8 +420,7 @@ void NetworkClient::WsConnected(wpi::WebSocket& ws, uv::Tcp& tcp,
 
   ConnectionInfo connInfo;
   uv::AddrToName(tcp.GetPeer(), &connInfo.remote_ip, &connInfo.remote_port);
-  connInfo.protocol_version =
-      protocol == "v4.1.networktables.first.wpi.edu" ? 0x0401 : 0x0400;
+  connInfo.protocol_version = net::GetProtocolVersion(protocol);
 
   INFO("CONNECTED NT4 to {} port {}", connInfo.remote_ip, connInfo.remote_port);
   m_connHandle = m_connList.AddConnection(connInfo);
@@ -427,6 +439,7 @@ void NetworkClient::WsConnected(wpi::WebSocket& ws, uv::Tcp& tcp,
         }
       });
   m_clientImpl->SetLocal(&m_localStorage);
+  m_clientImpl->SetBandwidthLimit(m_bandwidthLimit);
   m_localStorage.StartNetwork(&m_localQueue);
   HandleLocal();
   m_clientImpl->SendInitial();
@@ -110,6 +110,9 @@ class NetworkClient3 final : public NetworkClientBase {
     DoSetServers(servers, NT_DEFAULT_PORT3);
   }
 
+  // NT3 connections are not rate limited
+  void SetBandwidthLimit(double bytesPerSecond) final {}
+
  private:
   void HandleLocal();
   void TcpConnected(wpi::uv::Tcp& tcp) final;
@@ -134,6 +137,8 @@ class NetworkClient final : public NetworkClientBase {
     DoSetServers(servers, NT_DEFAULT_PORT4);
   }
 
+  void SetBandwidthLimit(double bytesPerSecond) final;
+
  private:
   void HandleLocal();
   void TcpConnected(wpi::uv::Tcp& tcp) final;
@@ -146,6 +151,9 @@ class NetworkClient final : public NetworkClientBase {
       m_timeSyncUpdated;
   std::shared_ptr<net::WebSocketConnection> m_wire;
   std::unique_ptr<net::ClientImpl> m_clientImpl;
+
+  // used only from loop
+  double m_bandwidthLimit{0};
 };
 
 }  // namespace nt
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <span>
@@ -44,6 +45,13 @@ static constexpr size_t kMaxMessageSize = 2 * 1024 * 1024;
 
 static constexpr size_t kClientProcessMessageCountMax = 16;
 
+// persistent filename extension that selects the binary format
+static constexpr std::string_view kPersistentBinaryExt = ".msgpack";
+
+// binary persistent file is rewritten once appended records exceed both
+// this and the number of records in the last full save
+static constexpr size_t kPersistentCompactMin = 256;
+
 class NetworkServer::ServerConnection {
  public:
   ServerConnection(NetworkServer& server, std::string_view addr,
@@ -92,7 +100,8 @@ class NetworkServer::ServerConnection4 final
       : ServerConnection{server, addr, port, logger},
         HttpWebSocketServerConnection(
             stream,
-            {"v4.1.networktables.first.wpi.edu", "networktables.first.wpi.edu",
+            {"v4.2.networktables.first.wpi.edu",
+             "v4.1.networktables.first.wpi.edu", "networktables.first.wpi.edu",
              "rtt.networktables.first.wpi.edu"}) {
     m_info.protocol_version = 0x0400;
   }
@@ -247,8 +256,7 @@ void NetworkServer::ServerConnection4::ProcessWsUpgrade() {
 
   m_websocket->open.connect([this, name = std::string{name}](
                                 std::string_view protocol) {
-    m_info.protocol_version =
-        protocol == "v4.1.networktables.first.wpi.edu" ? 0x0401 : 0x0400;
+    m_info.protocol_version = net::GetProtocolVersion(protocol);
     m_wire = std::make_shared<net::WebSocketConnection>(
         *m_websocket, m_info.protocol_version, m_logger);
 
@@ -321,12 +329,14 @@ NetworkServer::NetworkServer(std::string_view persistentFilename,
       m_logger{logger},
       m_initDone{std::move(initDone)},
       m_persistentFilename{persistentFilename},
+      m_persistentBinary{persistentFilename.ends_with(kPersistentBinaryExt)},
       m_listenAddress{wpi::trim(listenAddress)},
       m_port3{port3},
       m_port4{port4},
       m_serverImpl{logger},
       m_localQueue{logger},
       m_loop(*m_loopRunner.GetLoop()) {
+  m_serverImpl.SetPersistentIncremental(m_persistentBinary);
   m_loopRunner.ExecAsync([=, this](uv::Loop& loop) {
     // connect local storage to server
     m_serverImpl.SetLocal(&m_localStorage, &m_localQueue);
@@ -373,34 +383,40 @@ void NetworkServer::LoadPersistent() {
     fs::copy_file(m_persistentFilename, m_persistentFilename + ".bak",
                   std::filesystem::copy_options::overwrite_existing, ec);
     // try to write an empty file so it doesn't happen again
-    wpi::raw_fd_ostream os{m_persistentFilename, ec, fs::F_Text};
+    wpi::raw_fd_ostream os{m_persistentFilename, ec,
+                           m_persistentBinary ? fs::F_None : fs::F_Text};
     if (ec.value() == 0) {
-      os << "[]\n";
+      if (m_persistentBinary) {
+        os << server::ServerStorage::kPersistentBinaryHeader;
+      } else {
+        os << "[]\n";
+      }
       os.close();
     }
     return;
   }
   m_persistentData =
       std::string{fileBuffer.value()->begin(), fileBuffer.value()->end()};
-  DEBUG4("read data: {}", m_persistentData);
+  DEBUG4("read {} bytes of persistent data", m_persistentData.size());
 }
 
-void NetworkServer::SavePersistent(std::string_view filename,
+bool NetworkServer::SavePersistent(std::string_view filename,
                                    std::string_view data) {
   // write to temporary file
   auto tmp = fmt::format("{}.tmp", filename);
   std::error_code ec;
-  wpi::raw_fd_ostream os{tmp, ec, fs::F_Text};
+  wpi::raw_fd_ostream os{tmp, ec, m_persistentBinary ? fs::F_None : fs::F_Text};
   if (ec.value() != 0) {
     INFO("could not open persistent file '{}' for write: {}", tmp,
          ec.message());
-    return;
+    return false;
   }
   os << data;
   os.close();
   if (os.has_error()) {
+    os.clear_error();
     fs::remove(tmp);
-    return;
+    return false;
   }
 
   // move to real file
@@ -411,7 +427,66 @@ void NetworkServer::SavePersistent(std::string_view filename,
   if (ec.value() != 0) {
     // attempt to restore backup
     fs::rename(bak, filename, ec);
+    return false;
   }
+  return true;
+}
+
+bool NetworkServer::AppendPersistent(std::string_view filename,
+                                     std::string_view data) {
+  std::error_code ec;
+  wpi::raw_fd_ostream os{filename, ec, fs::F_Append};
+  if (ec.value() != 0) {
+    INFO("could not open persistent file '{}' for append: {}", filename,
+         ec.message());
+    return false;
+  }
+  os << data;
+  os.close();
+  if (os.has_error()) {
+    os.clear_error();
+    return false;
+  }
+  return true;
+}
+
+void NetworkServer::StartSavePersistent() {
+  // don't overlap saves; changes are picked up by a later call
+  if (m_persistentSaving) {
+    return;
+  }
+  if (!m_serverImpl.PersistentChanged() && m_persistentSaveOk) {
+    return;
+  }
+
+  std::string data;
+  bool full = true;
+  if (m_persistentBinary) {
+    // a failed save may have left a partial record, so rewrite everything
+    full = m_persistentNeedsFull || !m_persistentSaveOk ||
+           m_persistentAppended >
+               (std::max)(m_persistentFullCount, kPersistentCompactMin);
+    size_t count;
+    data = m_serverImpl.DumpPersistentBinary(full, &count);
+    if (full) {
+      m_persistentNeedsFull = false;
+      m_persistentFullCount = count;
+      m_persistentAppended = 0;
+    } else {
+      m_persistentAppended += count;
+    }
+  } else {
+    data = m_serverImpl.DumpPersistent();
+  }
+
+  m_persistentSaving = true;
+  uv::QueueWork(
+      m_loop,
+      [this, full, fn = m_persistentFilename, data = std::move(data)] {
+        m_persistentSaveOk =
+            full ? SavePersistent(fn, data) : AppendPersistent(fn, data);
+      },
+      [this] { m_persistentSaving = false; });
 }
 
 void NetworkServer::Init() {
@@ -431,23 +506,14 @@ void NetworkServer::Init() {
         DEBUG4("Starting idle processing");
         m_idle->Start();  // more to process
       }
+      UpdateTrafficStats();
     });
     m_readLocalTimer->Start(uv::Timer::Time{100}, uv::Timer::Time{100});
   }
 
   m_savePersistentTimer = uv::Timer::Create(m_loop);
   if (m_savePersistentTimer) {
-    m_savePersistentTimer->timeout.connect([this] {
-      if (m_serverImpl.PersistentChanged()) {
-        uv::QueueWork(
-            m_loop,
-            [this, fn = m_persistentFilename,
-             data = m_serverImpl.DumpPersistent()] {
-              SavePersistent(fn, data);
-            },
-            nullptr);
-      }
-    });
+    m_savePersistentTimer->timeout.connect([this] { StartSavePersistent(); });
     m_savePersistentTimer->Start(uv::Timer::Time{1000}, uv::Timer::Time{1000});
   }
 
@@ -559,6 +625,21 @@ void NetworkServer::Init() {
   }
 }
 
+void NetworkServer::SetBandwidthLimit(double bytesPerSecond) {
+  m_loopRunner.ExecAsync([=, this](uv::Loop&) {
+    m_serverImpl.SetBandwidthLimit(bytesPerSecond);
+  });
+}
+
+void NetworkServer::UpdateTrafficStats() {
+  std::scoped_lock lock{m_mutex};
+  for (auto&& conn : m_connections) {
+    auto stats = m_serverImpl.GetOutgoingStats(conn.conn->GetClientId());
+    m_connList.SetTrafficStats(conn.connHandle, stats.sentBytes,
+                               stats.deferredBytes, stats.droppedBytes);
+  }
+}
+
 void NetworkServer::AddConnection(ServerConnection* conn,
                                   const ConnectionInfo& info) {
   std::scoped_lock lock{m_mutex};
@@ -45,6 +45,8 @@ class NetworkServer {
   void FlushLocal();
   void Flush();
 
+  void SetBandwidthLimit(double bytesPerSecond);
+
  private:
   class ServerConnection;
   class ServerConnection3;
@@ -52,8 +54,11 @@ class NetworkServer {
 
   void ProcessAllLocal();
   void LoadPersistent();
-  void SavePersistent(std::string_view filename, std::string_view data);
+  bool SavePersistent(std::string_view filename, std::string_view data);
+  bool AppendPersistent(std::string_view filename, std::string_view data);
+  void StartSavePersistent();
   void Init();
+  void UpdateTrafficStats();
   void AddConnection(ServerConnection* conn, const ConnectionInfo& info);
   void RemoveConnection(ServerConnection* conn);
 
@@ -63,6 +68,8 @@ class NetworkServer {
   std::function<void()> m_initDone;
   std::string m_persistentData;
   std::string m_persistentFilename;
+  // use binary format (with incremental saves) rather than JSON
+  bool m_persistentBinary;
   std::string m_listenAddress;
   unsigned int m_port3;
   unsigned int m_port4;
@@ -74,6 +81,13 @@ class NetworkServer {
   std::shared_ptr<wpi::uv::Async<>> m_flush;
   std::shared_ptr<wpi::uv::Idle> m_idle;
   bool m_shutdown = false;
+  bool m_persistentSaving = false;
+  bool m_persistentSaveOk = true;  // written by worker thread
+  // binary format records appended since the last full save; a full save
+  // is forced on the first save after load to convert/compact the file
+  size_t m_persistentAppended = 0;
+  size_t m_persistentFullCount = 0;
+  bool m_persistentNeedsFull = true;
 
   using Queue = net::LocalClientMessageQueue;
   net::ClientMessage m_localMsgs[Queue::kBlockSize];
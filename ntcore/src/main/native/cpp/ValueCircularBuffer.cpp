@@ -4,6 +4,7 @@
 
 #include "ValueCircularBuffer.h"
 
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -21,3 +22,16 @@ std::vector<Value> ValueCircularBuffer::ReadValue(unsigned int types) {
   m_storage.reset();
   return rv;
 }
+
+std::span<Value> ValueCircularBuffer::ReadValue(std::span<Value> out,
+                                                unsigned int types) {
+  size_t count = 0;
+  while (count < out.size() && m_storage.size() != 0) {
+    Value val = m_storage.pop_front();
+    if (types != 0 && (types & val.type()) == 0) {
+      continue;
+    }
+    out[count++] = std::move(val);
+  }
+  return out.first(count);
+}
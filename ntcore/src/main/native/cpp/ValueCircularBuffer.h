@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -28,6 +29,13 @@ class ValueCircularBuffer {
   template <ValidType T>
   std::vector<Timestamped<typename TypeInfo<T>::Value>> Read();
 
+  // These read at most out.size() values into out (reusing its storage) and
+  // return the filled portion; values that do not fit are left queued.
+  std::span<Value> ReadValue(std::span<Value> out, unsigned int types);
+  template <ValidType T>
+  std::span<Timestamped<typename TypeInfo<T>::Value>> Read(
+      std::span<Timestamped<typename TypeInfo<T>::Value>> out);
+
  private:
   wpi::circular_buffer<Value> m_storage;
 };
@@ -46,4 +54,20 @@ ValueCircularBuffer::Read() {
   return rv;
 }
 
+template <ValidType T>
+std::span<Timestamped<typename TypeInfo<T>::Value>> ValueCircularBuffer::Read(
+    std::span<Timestamped<typename TypeInfo<T>::Value>> out) {
+  size_t count = 0;
+  while (count < out.size() && m_storage.size() != 0) {
+    Value val = m_storage.pop_front();
+    if (IsNumericConvertibleTo<T>(val) || IsType<T>(val)) {
+      auto& elem = out[count++];
+      elem.time = val.time();
+      elem.serverTime = val.server_time();
+      GetValueInto<T, true>(val, elem.value);
+    }
+  }
+  return out.first(count);
+}
+
 }  // namespace nt
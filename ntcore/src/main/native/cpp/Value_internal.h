@@ -372,6 +372,33 @@ inline typename TypeInfo<T>::Value GetValueCopy(const Value& value) {
   }
 }
 
+// like GetValueCopy(), but reuses the storage of out
+template <ValidType T, bool ConvertNumeric>
+inline void GetValueInto(const Value& value, typename TypeInfo<T>::Value& out) {
+  if constexpr (ConvertNumeric && NumericType<T>) {
+    out = GetNumericAs<T>(value);
+  } else if constexpr (ConvertNumeric && NumericArrayType<T>) {
+    if (value.IsIntegerArray()) {
+      auto arr = value.GetIntegerArray();
+      out.assign(arr.begin(), arr.end());
+    } else if (value.IsFloatArray()) {
+      auto arr = value.GetFloatArray();
+      out.assign(arr.begin(), arr.end());
+    } else if (value.IsDoubleArray()) {
+      auto arr = value.GetDoubleArray();
+      out.assign(arr.begin(), arr.end());
+    } else {
+      out.clear();
+    }
+  } else if constexpr (ArrayType<T> || IsNTType<T, NT_RAW> ||
+                       IsNTType<T, NT_STRING>) {
+    auto view = GetValueView<T>(value);
+    out.assign(view.begin(), view.end());
+  } else {
+    out = GetValueView<T>(value);
+  }
+}
+
 template <SmallArrayType T, bool ConvertNumeric>
 inline typename TypeInfo<T>::SmallRet GetValueCopy(
     const Value& value,
@@ -143,6 +143,8 @@ static nt::PubSubOptions FromJavaPubSubOptions(JNIEnv* env, jobject joptions) {
   FIELD(disableLocal, "Z");
   FIELD(excludeSelf, "Z");
   FIELD(hidden, "Z");
+  FIELD(latestOnly, "Z");
+  FIELD(priority, "I");
 
 #undef FIELD
 
@@ -159,7 +161,9 @@ static nt::PubSubOptions FromJavaPubSubOptions(JNIEnv* env, jobject joptions) {
           FIELD(bool, Boolean, disableRemote),
           FIELD(bool, Boolean, disableLocal),
           FIELD(bool, Boolean, excludeSelf),
-          FIELD(bool, Boolean, hidden)};
+          FIELD(bool, Boolean, hidden),
+          FIELD(bool, Boolean, latestOnly),
+          FIELD(int, Int, priority)};
 
 #undef GET
 #undef FIELD
@@ -1428,6 +1432,18 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_getServerTimeOffset
   return MakeJObject(env, nt::GetServerTimeOffset(inst));
 }
 
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    setNetworkBandwidthLimit
+ * Signature: (ID)V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_setNetworkBandwidthLimit
+  (JNIEnv*, jclass, jint inst, jdouble bytesPerSecond)
+{
+  nt::SetNetworkBandwidthLimit(inst, bytesPerSecond);
+}
+
 /*
  * Class:     edu_wpi_first_networktables_NetworkTablesJNI
  * Method:    now
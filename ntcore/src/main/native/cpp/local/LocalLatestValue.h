@@ -0,0 +1,194 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <optional>
+
+#include "Handle.h"
+#include "Value_internal.h"
+#include "networktables/NetworkTableValue.h"
+#include "ntcore_cpp_types.h"
+
+namespace nt::local {
+
+// types that can be read from a LatestValueCell
+template <typename T>
+concept LatestValueType = IsNTType<T, NT_BOOLEAN> || NumericType<T>;
+
+// Seqlock-protected copy of a topic's last scalar value, kept for latestOnly
+// subscribers so GetAtomic() can read it without taking any locks.  Writes
+// are serialized by the storage lock / topic valueMutex; reads are lock-free.
+class LatestValueCell {
+ public:
+  // sets the owning subscriber handle (0 to release) and the value
+  void Set(NT_Handle handle, const Value& value) {
+    BeginWrite();
+    m_handle.store(handle, std::memory_order_relaxed);
+    StoreValue(value);
+    EndWrite();
+  }
+
+  void Update(const Value& value) {
+    BeginWrite();
+    StoreValue(value);
+    EndWrite();
+  }
+
+  // returns nullopt if the cell is not owned by handle
+  template <LatestValueType T>
+  std::optional<Timestamped<typename TypeInfo<T>::Value>> Load(
+      NT_Handle handle, typename TypeInfo<T>::View defaultValue) const {
+    using V = typename TypeInfo<T>::Value;
+    NT_Handle curHandle;
+    NT_Type type;
+    uint64_t bits;
+    int64_t time;
+    int64_t serverTime;
+    for (;;) {
+      uint32_t seq = m_seq.load(std::memory_order_acquire);
+      if ((seq & 1) != 0) {
+        continue;  // write in progress
+      }
+      curHandle = m_handle.load(std::memory_order_relaxed);
+      type = m_type.load(std::memory_order_relaxed);
+      bits = m_bits.load(std::memory_order_relaxed);
+      time = m_time.load(std::memory_order_relaxed);
+      serverTime = m_serverTime.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_seq.load(std::memory_order_relaxed) == seq) {
+        break;
+      }
+    }
+
+    if (curHandle == 0 || curHandle != handle) {
+      return std::nullopt;
+    }
+    if constexpr (IsNTType<T, NT_BOOLEAN>) {
+      if (type == NT_BOOLEAN) {
+        return Timestamped<V>{time, serverTime, bits != 0};
+      }
+    } else {
+      if (type == NT_INTEGER) {
+        return Timestamped<V>{time, serverTime,
+                              static_cast<V>(std::bit_cast<int64_t>(bits))};
+      } else if (type == NT_FLOAT || type == NT_DOUBLE) {
+        return Timestamped<V>{time, serverTime,
+                              static_cast<V>(std::bit_cast<double>(bits))};
+      }
+    }
+    return Timestamped<V>{0, 0, defaultValue};
+  }
+
+ private:
+  void BeginWrite() {
+    m_seq.store(m_seq.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void EndWrite() {
+    m_seq.store(m_seq.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  void StoreValue(const Value& value) {
+    uint64_t bits = 0;
+    switch (value.type()) {
+      case NT_BOOLEAN:
+        bits = value.GetBoolean() ? 1 : 0;
+        break;
+      case NT_INTEGER:
+        bits = std::bit_cast<uint64_t>(value.GetInteger());
+        break;
+      case NT_FLOAT:
+        // float to double is exact, so conversions on read are unchanged
+        bits = std::bit_cast<uint64_t>(static_cast<double>(value.GetFloat()));
+        break;
+      case NT_DOUBLE:
+        bits = std::bit_cast<uint64_t>(value.GetDouble());
+        break;
+      default:
+        break;
+    }
+    m_type.store(value.type(), std::memory_order_relaxed);
+    m_bits.store(bits, std::memory_order_relaxed);
+    m_time.store(value.time(), std::memory_order_relaxed);
+    m_serverTime.store(value.server_time(), std::memory_order_relaxed);
+  }
+
+  std::atomic<uint32_t> m_seq{0};
+  std::atomic<NT_Handle> m_handle{0};
+  std::atomic<NT_Type> m_type{NT_UNASSIGNED};
+  std::atomic<uint64_t> m_bits{0};
+  std::atomic<int64_t> m_time{0};
+  std::atomic<int64_t> m_serverTime{0};
+};
+
+// Subscriber index to LatestValueCell mapping.  Chunks are allocated on
+// demand (with the storage lock held exclusive) and never freed until the
+// storage is destroyed, so lookups need no locking.
+class LatestValueTable {
+ public:
+  LatestValueTable() = default;
+  LatestValueTable(const LatestValueTable&) = delete;
+  LatestValueTable& operator=(const LatestValueTable&) = delete;
+  ~LatestValueTable() {
+    for (auto&& chunk : m_chunks) {
+      delete chunk.load(std::memory_order_relaxed);
+    }
+  }
+
+  LatestValueCell* Add(NT_Subscriber subHandle, const Value& value) {
+    unsigned int i = Handle{subHandle}.GetIndex();
+    auto& chunkPtr = m_chunks[i / kChunkSize];
+    Chunk* chunk = chunkPtr.load(std::memory_order_relaxed);
+    if (!chunk) {
+      chunk = new Chunk;
+      chunkPtr.store(chunk, std::memory_order_release);
+    }
+    auto cell = &(*chunk)[i % kChunkSize];
+    cell->Set(subHandle, value);
+    return cell;
+  }
+
+  template <LatestValueType T>
+  std::optional<Timestamped<typename TypeInfo<T>::Value>> Load(
+      NT_Handle subentryHandle, typename TypeInfo<T>::View defaultValue) const {
+    Handle h{subentryHandle};
+    if (!h.IsType(Handle::kSubscriber)) {
+      return std::nullopt;
+    }
+    unsigned int i = h.GetIndex();
+    Chunk* chunk = m_chunks[i / kChunkSize].load(std::memory_order_acquire);
+    if (!chunk) {
+      return std::nullopt;
+    }
+    return (*chunk)[i % kChunkSize].Load<T>(subentryHandle, defaultValue);
+  }
+
+  // releases all cells
+  void Reset() {
+    for (auto&& chunk : m_chunks) {
+      if (Chunk* c = chunk.load(std::memory_order_relaxed)) {
+        for (auto&& cell : *c) {
+          cell.Set(0, {});
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr unsigned int kChunkSize = 256;
+  using Chunk = std::array<LatestValueCell, kChunkSize>;
+  std::array<std::atomic<Chunk*>, (Handle::kIndexMax + 1) / kChunkSize>
+      m_chunks{};
+};
+
+}  // namespace nt::local
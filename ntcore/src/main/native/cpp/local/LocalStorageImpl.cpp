@@ -289,7 +289,7 @@ bool StorageImpl::SetDefaultEntryValue(NT_Handle pubsubentryHandle,
       if (publisher) {
         PublishLocalValue(publisher, newValue, true);
       } else {
-        topic->lastValue = newValue;
+        topic->SetLastValue(newValue);
       }
       return true;
     }
@@ -556,7 +556,9 @@ void StorageImpl::AddListenerImpl(NT_Listener listenerHandle,
       return;
     }
     m_listenerStorage.Activate(
-        listenerHandle, eventMask & (NT_EVENT_VALUE_ALL | NT_EVENT_IMMEDIATE),
+        listenerHandle,
+        eventMask &
+            (NT_EVENT_VALUE_ALL | NT_EVENT_VALUE_LATEST | NT_EVENT_IMMEDIATE),
         [subentryHandle](unsigned int mask, Event* event) {
           if (auto valueData = event->GetValueEventData()) {
             valueData->subentry = subentryHandle;
@@ -632,7 +634,9 @@ void StorageImpl::AddListenerImpl(NT_Listener listenerHandle,
     }
 
     m_listenerStorage.Activate(
-        listenerHandle, eventMask & (NT_EVENT_VALUE_ALL | NT_EVENT_IMMEDIATE),
+        listenerHandle,
+        eventMask &
+            (NT_EVENT_VALUE_ALL | NT_EVENT_VALUE_LATEST | NT_EVENT_IMMEDIATE),
         [subentryHandle = subscriber->handle.GetHandle()](unsigned int mask,
                                                           Event* event) {
           if (auto valueData = event->GetValueEventData()) {
@@ -767,6 +771,7 @@ void StorageImpl::Reset() {
   m_nameTopics.clear();
   m_listeners.clear();
   m_topicPrefixListeners.clear();
+  m_latestValues.Reset();
 }
 
 void StorageImpl::NotifyTopic(LocalTopic* topic, unsigned int eventFlags) {
@@ -818,7 +823,7 @@ bool StorageImpl::SetValue(LocalTopic* topic, const Value& value,
     if (!(suppressIfDuplicate && isDuplicate)) {
       topic->type = value.type();
       if (topic->IsCached()) {
-        topic->lastValue = value;
+        topic->SetLastValue(value);
         topic->lastValueFromNetwork = false;
       }
       NotifyValue(topic, value, eventFlags, isDuplicate, publisher);
@@ -990,6 +995,11 @@ LocalSubscriber* StorageImpl::AddLocalSubscriber(LocalTopic* topic,
   DEBUG4("AddLocalSubscriber({})", topic->name);
   auto subscriber = m_subscribers.Add(m_inst, topic, config);
   topic->localSubscribers.Add(subscriber);
+  if (config.latestOnly) {
+    subscriber->latestValue =
+        m_latestValues.Add(subscriber->handle, topic->lastValue);
+    topic->latestValues.Add(subscriber->latestValue);
+  }
   // set subscriber to active if the type matches
   subscriber->UpdateActive();
   if (topic->Exists() && !subscriber->active) {
@@ -1024,6 +1034,10 @@ std::unique_ptr<LocalSubscriber> StorageImpl::RemoveLocalSubscriber(
   if (subscriber) {
     auto topic = subscriber->topic;
     topic->localSubscribers.Remove(subscriber.get());
+    if (subscriber->latestValue) {
+      topic->latestValues.Remove(subscriber->latestValue);
+      subscriber->latestValue->Set(0, {});
+    }
     for (auto&& listener : m_listeners) {
       if (listener.getSecond()->subscriber == subscriber.get()) {
         listener.getSecond()->subscriber = nullptr;
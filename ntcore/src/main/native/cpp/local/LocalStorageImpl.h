@@ -17,6 +17,7 @@
 #include "HandleMap.h"
 #include "local/LocalDataLogger.h"
 #include "local/LocalEntry.h"
+#include "local/LocalLatestValue.h"
 #include "local/LocalListener.h"
 #include "local/LocalMultiSubscriber.h"
 #include "local/LocalPublisher.h"
@@ -56,6 +57,7 @@ class StorageImpl {
   void NetworkPropertiesUpdate(LocalTopic* topic, const wpi::json& update,
                                bool ack);
 
+  // Only modifies topic value state; see PublishLocalValue().
   void ServerSetValue(LocalTopic* topic, const Value& value) {
     if (SetValue(topic, value, NT_EVENT_VALUE_REMOTE, false, nullptr)) {
       if (topic->IsCached()) {
@@ -140,13 +142,10 @@ class StorageImpl {
   bool SetEntryValue(NT_Handle pubentryHandle, const Value& value);
   bool SetDefaultEntryValue(NT_Handle pubsubentryHandle, const Value& value);
 
-  Value* GetSubEntryValue(NT_Handle subentryHandle) {
-    if (auto subscriber = GetSubEntry(subentryHandle)) {
-      return &subscriber->topic->lastValue;
-    } else {
-      return nullptr;
-    }
-  }
+  // Only modifies topic value state (and notifies); safe to call with the
+  // storage lock held shared as long as the topic's valueMutex is held.
+  bool PublishLocalValue(LocalPublisher* publisher, const Value& value,
+                         bool force = false);
 
   //
   // Publish/Subscribe/Entry functions
@@ -199,6 +198,20 @@ class StorageImpl {
 
   LocalSubscriber* GetSubEntry(NT_Handle subentryHandle);
 
+  // may be used without holding the storage lock
+  const LatestValueTable& GetLatestValues() const { return m_latestValues; }
+
+  // does not create a publisher for entries that have not yet published
+  LocalPublisher* GetPubEntry(NT_Handle pubentryHandle) {
+    if (auto publisher = m_publishers.Get(pubentryHandle)) {
+      return publisher;
+    } else if (auto entry = m_entries.Get(pubentryHandle)) {
+      return entry->publisher;
+    } else {
+      return nullptr;
+    }
+  }
+
   LocalEntry* GetEntryByHandle(NT_Entry entryHandle) {
     return m_entries.Get(entryHandle);
   }
@@ -287,9 +300,6 @@ class StorageImpl {
 
   LocalPublisher* PublishEntry(LocalEntry* entry, NT_Type type);
 
-  bool PublishLocalValue(LocalPublisher* publisher, const Value& value,
-                         bool force = false);
-
  private:
   int m_inst;
   IListenerStorage& m_listenerStorage;
@@ -315,6 +325,9 @@ class StorageImpl {
 
   // schema publishers
   wpi::StringMap<NT_Publisher> m_schemas;
+
+  // lock-free value snapshots for latestOnly subscribers
+  LatestValueTable m_latestValues;
 };
 
 }  // namespace nt::local
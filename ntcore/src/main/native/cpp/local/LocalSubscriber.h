@@ -12,6 +12,7 @@
 #include "Types_internal.h"
 #include "ValueCircularBuffer.h"
 #include "VectorSet.h"
+#include "local/LocalLatestValue.h"
 #include "local/LocalTopic.h"
 #include "local/PubSubConfig.h"
 #include "ntcore_c.h"
@@ -46,6 +47,9 @@ struct LocalSubscriber {
   // polling storage
   ValueCircularBuffer pollStorage;
 
+  // lock-free last value (latestOnly subscribers only)
+  LatestValueCell* latestValue{nullptr};
+
   // value listeners
   VectorSet<NT_Listener> valueListeners;
 };
@@ -64,7 +64,7 @@ wpi::json LocalTopic::SetFlags(unsigned int flags) {
     update["cached"] = wpi::json();
   }
   if ((flags & NT_UNCACHED) != 0) {
-    lastValue = {};
+    SetLastValue({});
     lastValueNetwork = {};
     lastValueFromNetwork = false;
   }
@@ -176,7 +176,7 @@ void LocalTopic::ResetIfDoesNotExist() {
   if (Exists()) {
     return;
   }
-  lastValue = {};
+  SetLastValue({});
   lastValueNetwork = {};
   lastValueFromNetwork = false;
   type = NT_UNASSIGNED;
@@ -219,7 +219,7 @@ void LocalTopic::RefreshFlags() {
   }
 
   if ((m_flags & NT_UNCACHED) != 0) {
-    lastValue = {};
+    SetLastValue({});
     lastValueNetwork = {};
     lastValueFromNetwork = false;
   }
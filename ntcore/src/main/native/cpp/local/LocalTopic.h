@@ -12,11 +12,13 @@
 #include <wpi/SmallVector.h>
 #include <wpi/Synchronization.h>
 #include <wpi/json.h>
+#include <wpi/mutex.h>
 
 #include "Handle.h"
 #include "VectorSet.h"
 #include "local/LocalDataLogger.h"
 #include "local/LocalDataLoggerEntry.h"
+#include "local/LocalLatestValue.h"
 #include "ntcore_cpp.h"
 
 namespace nt::local {
@@ -76,11 +78,24 @@ struct LocalTopic {
 
   void ResetIfDoesNotExist();
 
+  // updates lastValue and any latestOnly subscriber cells
+  void SetLastValue(const Value& value) {
+    lastValue = value;
+    for (auto&& cell : latestValues) {
+      cell->Update(lastValue);
+    }
+  }
+
   // invariants
   wpi::SignalObject<NT_Topic> handle;
   std::string name;
   bool special;
 
+  // Guards the value state below (lastValue, lastValueNetwork, type updates
+  // from value sets, and the poll storage of local subscribers).  Only needed
+  // when the storage lock is held shared; holding it exclusive is sufficient.
+  wpi::mutex valueMutex;
+
   Value lastValue;  // also stores timestamp
   Value lastValueNetwork;
   NT_Type type{NT_UNASSIGNED};
@@ -98,6 +113,7 @@ struct LocalTopic {
   VectorSet<LocalSubscriber*> localSubscribers;
   VectorSet<LocalMultiSubscriber*> multiSubscribers;
   VectorSet<LocalEntry*> entries;
+  VectorSet<LatestValueCell*> latestValues;
   VectorSet<NT_Listener> listeners;
 
  private:
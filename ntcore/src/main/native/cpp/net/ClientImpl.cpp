@@ -61,12 +61,31 @@ void ClientImpl::ProcessIncomingBinary(uint64_t curTimeMs,
     Value value;
     std::string error;
     if (!WireDecodeBinary(&data, &id, &value, &error,
-                          -m_outgoing.GetTimeOffset())) {
+                          -m_outgoing.GetTimeOffset(),
+                          [&](int id) -> const Value* {
+                            auto it = m_deltaBases.find(id);
+                            return it != m_deltaBases.end() ? &it->second
+                                                            : nullptr;
+                          })) {
       ERR("binary decode error: {}", error);
       break;  // FIXME
     }
     DEBUG4("BinaryMessage({})", id);
 
+    // keep array values the server may send deltas from
+    if (m_wire.GetVersion() >= 0x0402) {
+      switch (value.type()) {
+        case NT_BOOLEAN_ARRAY:
+        case NT_INTEGER_ARRAY:
+        case NT_FLOAT_ARRAY:
+        case NT_DOUBLE_ARRAY:
+          m_deltaBases[id] = value;
+          break;
+        default:
+          break;
+      }
+    }
+
     // handle RTT ping response (only use first one)
     if (id == -1) {
       if (!m_haveTimeOffset) {
@@ -179,7 +198,7 @@ void ClientImpl::Publish(int32_t pubuid, std::string_view name,
   if (publisher->periodMs < kMinPeriodMs) {
     publisher->periodMs = kMinPeriodMs;
   }
-  m_outgoing.SetPeriod(pubuid, publisher->periodMs);
+  m_outgoing.SetPeriod(pubuid, publisher->periodMs, options.priority);
 
   // update period
   m_periodMs = UpdatePeriodCalc(m_periodMs, publisher->periodMs);
@@ -236,6 +255,7 @@ void ClientImpl::ServerUnannounce(std::string_view name, int id) {
   assert(m_local);
   m_local->ServerUnannounce(name, m_topicMap[id]);
   m_topicMap.erase(id);
+  m_deltaBases.erase(id);
 }
 
 void ClientImpl::ServerPropertiesUpdate(std::string_view name,
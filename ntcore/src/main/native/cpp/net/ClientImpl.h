@@ -52,6 +52,14 @@ class ClientImpl final : private ServerMessageHandler {
   void SetLocal(ServerMessageHandler* local) { m_local = local; }
   void SendInitial();
 
+  // limits the average send rate; 0 is unlimited
+  void SetBandwidthLimit(double bytesPerSecond) {
+    m_outgoing.SetBandwidthLimit(bytesPerSecond);
+  }
+  const NetworkOutgoingStats& GetOutgoingStats() const {
+    return m_outgoing.GetStats();
+  }
+
  private:
   struct PublisherData {
     PubSubOptionsImpl options;
@@ -89,6 +97,9 @@ class ClientImpl final : private ServerMessageHandler {
   // indexed by server-provided topic id
   wpi::DenseMap<int, int> m_topicMap;
 
+  // last array value received, indexed by server-provided topic id
+  wpi::DenseMap<int, Value> m_deltaBases;
+
   // ping
   NetworkPing m_ping;
 
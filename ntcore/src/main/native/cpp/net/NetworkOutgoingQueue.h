@@ -61,32 +61,57 @@ concept NetworkMessage =
 
 enum class ValueSendMode { kDisabled = 0, kAll, kNormal, kImm };
 
+struct NetworkOutgoingStats {
+  // bytes written to the connection
+  uint64_t sentBytes = 0;
+  // approximate bytes of messages held back by the bandwidth limit; messages
+  // held back for multiple sends are counted each time
+  uint64_t deferredBytes = 0;
+  // approximate bytes of values replaced by a newer value before being sent
+  uint64_t droppedBytes = 0;
+};
+
+// Provides binary value message encodings that are shared across multiple
+// connections, so a value sent to many connections is only encoded once.
+class SharedValueEncoder {
+ public:
+  virtual ~SharedValueEncoder() = default;
+
+  // Returns the same bytes as WireEncodeBinary(os, id, value.time(), value).
+  // The result is valid until the next call.
+  virtual std::span<const uint8_t> GetEncodedValue(int id,
+                                                   const Value& value) = 0;
+};
+
 template <NetworkMessage MessageType>
 class NetworkOutgoingQueue {
  public:
-  NetworkOutgoingQueue(WireConnection& wire, bool local)
-      : m_wire{wire}, m_local{local} {
+  NetworkOutgoingQueue(WireConnection& wire, bool local,
+                       SharedValueEncoder* sharedEncoder = nullptr)
+      : m_wire{wire}, m_sharedEncoder{sharedEncoder}, m_local{local} {
     m_queues.emplace_back(100);  // default queue is 100 ms period
   }
 
-  void SetPeriod(int id, uint32_t periodMs) {
+  void SetPeriod(int id, uint32_t periodMs, int priority = 0) {
     // it's quite common to set a lot of things in a row with the same period
     unsigned int queueIndex;
-    if (m_lastSetPeriod == periodMs) {
+    if (m_lastSetPeriod == periodMs && m_lastSetPriority == priority) {
       queueIndex = m_lastSetPeriodQueueIndex;
     } else {
-      // find and possibly create queue for this period
-      auto it =
-          std::find_if(m_queues.begin(), m_queues.end(),
-                       [&](const auto& q) { return q.periodMs == periodMs; });
+      // find and possibly create queue for this period and priority
+      auto it = std::find_if(
+          m_queues.begin(), m_queues.end(), [&](const auto& q) {
+            return q.periodMs == periodMs && q.priority == priority;
+          });
       if (it == m_queues.end()) {
         queueIndex = m_queues.size();
-        m_queues.emplace_back(periodMs);
+        m_queues.emplace_back(periodMs, priority);
       } else {
         queueIndex = it - m_queues.begin();
       }
       m_lastSetPeriodQueueIndex = queueIndex;
       m_lastSetPeriod = periodMs;
+      m_lastSetPriority = priority;
     }
 
     // map the handle to the queue
@@ -107,7 +132,10 @@ class NetworkOutgoingQueue {
     infoIt->getSecond().queueIndex = queueIndex;
   }
 
-  void EraseId(int id) { m_idMap.erase(id); }
+  void EraseId(int id) {
+    m_idMap.erase(id);
+    m_deltaMap.erase(id);
+  }
 
   template <typename T>
   void SendMessage(int id, T&& msg) {
@@ -115,9 +143,18 @@ class NetworkOutgoingQueue {
     m_totalSize += sizeof(Message);
   }
 
-  void SendValue(int id, const Value& value, ValueSendMode mode) {
+  // if delta is true, array values are sent as deltas from the previous
+  // value when that's smaller; the receiver must support this
+  void SendValue(int id, const Value& value, ValueSendMode mode,
+                 bool delta = false) {
     if (m_local) {
       mode = ValueSendMode::kImm;  // always send local immediately
+      delta = false;
+    }
+    if (delta) {
+      m_deltaMap.try_emplace(id);
+    } else if (!m_deltaMap.empty()) {
+      m_deltaMap.erase(id);
     }
     // backpressure by stopping sending all if the buffer is too full
     if (mode == ValueSendMode::kAll && m_totalSize >= kOutgoingLimit) {
@@ -149,6 +186,7 @@ class NetworkOutgoingQueue {
             if (elem.id == id &&
                 (m->value.time() == 0 || value.time() >= m->value.time())) {
               int delta = value.size() - m->value.size();
+              m_stats.droppedBytes += m->value.size();
               m->value = value;
               m_totalSize += delta;
               return;
@@ -177,6 +215,14 @@ class NetworkOutgoingQueue {
       return;  // don't bother, still sending the last batch
     }
 
+    // refill token bucket
+    if (m_bytesPerMs > 0) {
+      m_tokens = (std::min)(
+          m_tokens + (curTimeMs - m_lastRefillMs) * m_bytesPerMs,
+          (std::max)(m_bytesPerMs * kBurstMs, kMinBurstBytes));
+      m_lastRefillMs = curTimeMs;
+    }
+
     // what queues are ready to send?
     wpi::SmallVector<unsigned int, 16> queues;
     for (unsigned int i = 0; i < m_queues.size(); ++i) {
@@ -189,30 +235,62 @@ class NetworkOutgoingQueue {
       return;  // nothing needs to be sent yet
     }
 
-    // Sort transmission order by what queue has been waiting the longest time.
+    // Sort transmission order by priority, then by what queue has been waiting
+    // the longest time.
     // XXX: byte-weighted fair queueing might be better, but is much more
     // complex to implement.
     std::sort(queues.begin(), queues.end(), [&](const auto& a, const auto& b) {
+      if (m_queues[a].priority != m_queues[b].priority) {
+        return m_queues[a].priority > m_queues[b].priority;
+      }
       return m_queues[a].nextSendMs < m_queues[b].nextSendMs;
     });
 
+    bool overBudget = false;
     for (unsigned int queueIndex : queues) {
       auto& queue = m_queues[queueIndex];
       auto& msgs = queue.msgs;
+      if (overBudget || (m_bytesPerMs > 0 && m_tokens <= 0)) {
+        // out of bandwidth; lower priority queues wait for the next send
+        overBudget = true;
+        for (auto&& msg : msgs) {
+          m_stats.deferredBytes += EstimateSize(msg);
+        }
+        continue;
+      }
       auto it = msgs.begin();
       auto end = msgs.end();
       int unsent = 0;
-      for (; it != end && unsent == 0; ++it) {
+      m_msgBytes.clear();
+      for (; it != end && unsent == 0 && !overBudget; ++it) {
         if (auto m = std::get_if<ValueMsg>(&it->msg.contents)) {
-          unsent = m_wire.WriteBinary(
-              [&](auto& os) { EncodeValue(os, it->id, m->value); });
+          DeltaInfo* deltaInfo = nullptr;
+          if (!m_deltaMap.empty()) {
+            auto deltaIt = m_deltaMap.find(it->id);
+            if (deltaIt != m_deltaMap.end()) {
+              deltaInfo = &deltaIt->second;
+            }
+          }
+          unsent = m_wire.WriteBinary([&](auto& os) {
+            uint64_t start = os.tell();
+            EncodeValue(os, it->id, m->value, deltaInfo);
+            m_msgBytes.emplace_back(os.tell() - start);
+          });
         } else {
           unsent = m_wire.WriteText([&](auto& os) {
+            uint64_t start = os.tell();
             if (!WireEncodeText(os, it->msg)) {
               os << "{}";
             }
+            m_msgBytes.emplace_back(os.tell() - start);
           });
         }
+        if (m_bytesPerMs > 0) {
+          // allowed to go negative, so a message larger than the bucket
+          // still gets sent
+          m_tokens -= m_msgBytes.back();
+          overBudget = m_tokens <= 0;
+        }
       }
       if (unsent < 0) {
         return;  // error
@@ -225,13 +303,36 @@ class NetworkOutgoingQueue {
         }
       }
       int delta = it - msgs.begin() - unsent;
+      for (int i = 0; i < static_cast<int>(m_msgBytes.size()); ++i) {
+        if (i < delta) {
+          m_stats.sentBytes += m_msgBytes[i];
+        } else if (m_bytesPerMs > 0) {
+          m_tokens += m_msgBytes[i];  // refund
+        }
+      }
+      if (overBudget) {
+        for (auto&& msg : std::span{msgs}.subspan(delta)) {
+          m_stats.deferredBytes += EstimateSize(msg);
+        }
+      }
       for (auto&& msg : std::span{msgs}.subspan(0, delta)) {
         if (auto m = std::get_if<ValueMsg>(&msg.msg.contents)) {
           m_totalSize -= sizeof(Message) + m->value.size();
+          if (!m_deltaMap.empty()) {
+            auto deltaIt = m_deltaMap.find(msg.id);
+            if (deltaIt != m_deltaMap.end()) {
+              deltaIt->second.sentValue = m->value;
+            }
+          }
         } else {
           m_totalSize -= sizeof(Message);
         }
       }
+      // unsent messages will be encoded again, so deltas must be from the
+      // last value the receiver actually got
+      for (auto&& kv : m_deltaMap) {
+        kv.second.encodedValue = kv.second.sentValue;
+      }
       msgs.erase(msgs.begin(), it - unsent);
       for (auto&& kv : m_idMap) {
         auto& info = kv.getSecond();
@@ -244,8 +345,9 @@ class NetworkOutgoingQueue {
         }
       }
 
-      // try to stay on periodic timing, unless it's falling behind current time
-      if (unsent == 0) {
+      // try to stay on periodic timing, unless it's falling behind current time;
+      // messages held back by the bandwidth limit are sent as soon as possible
+      if (unsent == 0 && !overBudget) {
         queue.nextSendMs += queue.periodMs;
         if (queue.nextSendMs < curTimeMs) {
           queue.nextSendMs = curTimeMs + queue.periodMs;
@@ -259,13 +361,29 @@ class NetworkOutgoingQueue {
   void SetTimeOffset(int64_t offsetUs) { m_timeOffsetUs = offsetUs; }
   int64_t GetTimeOffset() const { return m_timeOffsetUs; }
 
+  // limits the average send rate; 0 is unlimited
+  void SetBandwidthLimit(double bytesPerSecond) {
+    m_bytesPerMs = bytesPerSecond > 0 ? bytesPerSecond / 1000 : 0;
+    m_tokens = 0;
+  }
+
+  const NetworkOutgoingStats& GetStats() const { return m_stats; }
+
  public:
   WireConnection& m_wire;
 
  private:
+  SharedValueEncoder* m_sharedEncoder;
+
   using ValueMsg = typename MessageType::ValueMsg;
 
-  void EncodeValue(wpi::raw_ostream& os, int id, const Value& value) {
+  struct DeltaInfo {
+    Value sentValue;     // last value sent
+    Value encodedValue;  // last value encoded (may not have been sent)
+  };
+
+  void EncodeValue(wpi::raw_ostream& os, int id, const Value& value,
+                   DeltaInfo* deltaInfo = nullptr) {
     int64_t time = value.time();
     if constexpr (std::same_as<ValueMsg, ClientValueMsg>) {
       if (time != 0) {
@@ -276,6 +394,21 @@ class NetworkOutgoingQueue {
         }
       }
     }
+    if (deltaInfo) {
+      bool encoded =
+          deltaInfo->encodedValue &&
+          WireEncodeBinaryDelta(os, id, time, value, deltaInfo->encodedValue);
+      deltaInfo->encodedValue = value;
+      if (encoded) {
+        return;
+      }
+    }
+    if constexpr (std::same_as<ValueMsg, ServerValueMsg>) {
+      if (m_sharedEncoder) {
+        os << m_sharedEncoder->GetEncodedValue(id, value);
+        return;
+      }
+    }
     WireEncodeBinary(os, id, time, value);
   }
 
@@ -288,8 +421,16 @@ class NetworkOutgoingQueue {
     int id;
   };
 
+  static size_t EstimateSize(const Message& msg) {
+    if (auto m = std::get_if<ValueMsg>(&msg.msg.contents)) {
+      return m->value.size();
+    }
+    return sizeof(Message);
+  }
+
   struct Queue {
-    explicit Queue(uint32_t periodMs) : periodMs{periodMs} {}
+    explicit Queue(uint32_t periodMs, int priority = 0)
+        : periodMs{periodMs}, priority{priority} {}
     template <typename T>
     void Append(NT_Handle handle, T&& msg) {
       msgs.emplace_back(std::forward<T>(msg), handle);
@@ -297,6 +438,7 @@ class NetworkOutgoingQueue {
     std::vector<Message> msgs;
     uint64_t nextSendMs = 0;
     uint32_t periodMs;
+    int priority;
   };
 
   std::vector<Queue> m_queues;
@@ -306,13 +448,28 @@ class NetworkOutgoingQueue {
     int valuePos = -1;  // -1 if not in queue
   };
   wpi::DenseMap<int, HandleInfo> m_idMap;
+  // only ids with delta encoding enabled
+  wpi::DenseMap<int, DeltaInfo> m_deltaMap;
   size_t m_totalSize{0};
   uint64_t m_lastSendMs{0};
   int64_t m_timeOffsetUs{0};
   unsigned int m_lastSetPeriodQueueIndex = 0;
   unsigned int m_lastSetPeriod = 100;
+  int m_lastSetPriority = 0;
   bool m_local;
 
+  // bandwidth limiting (token bucket)
+  double m_bytesPerMs{0};
+  double m_tokens{0};
+  uint64_t m_lastRefillMs{0};
+  // encoded size of each message written by the current SendOutgoing() queue
+  std::vector<size_t> m_msgBytes;
+  NetworkOutgoingStats m_stats;
+
+  // bucket size is enough for this much time at the limit rate
+  static constexpr double kBurstMs = 100;
+  static constexpr double kMinBurstBytes = 1500;
+
   // maximum total size of outgoing queues in bytes (approximate)
   static constexpr size_t kOutgoingLimit = 1024 * 1024;
 };
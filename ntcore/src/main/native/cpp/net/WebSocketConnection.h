@@ -22,6 +22,18 @@ class Logger;
 
 namespace nt::net {
 
+// Returns the NT4 protocol version for a negotiated WebSocket subprotocol.
+// Version 4.2 adds array delta binary messages.
+inline unsigned int GetProtocolVersion(std::string_view protocol) {
+  if (protocol == "v4.2.networktables.first.wpi.edu") {
+    return 0x0402;
+  } else if (protocol == "v4.1.networktables.first.wpi.edu") {
+    return 0x0401;
+  } else {
+    return 0x0400;
+  }
+}
+
 class WebSocketConnection final
     : public WireConnection,
       public std::enable_shared_from_this<WebSocketConnection> {
@@ -6,415 +6,724 @@
 
 #include <algorithm>
 #include <concepts>
+#include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include <fmt/format.h>
 #include <wpi/Logger.h>
+#include <wpi/SmallVector.h>
 #include <wpi/SpanExtras.h>
 #include <wpi/json.h>
 #include <wpi/mpack.h>
 
 #include "Message.h"
 #include "MessageHandler.h"
+#include "WireEncoder.h"
 
 using namespace nt;
 using namespace nt::net;
 using namespace mpack;
 
-static bool GetNumber(wpi::json& val, double* num) {
-  if (auto v = val.get_ptr<const int64_t*>()) {
-    *num = *v;
-  } else if (auto v = val.get_ptr<const uint64_t*>()) {
-    *num = *v;
-  } else if (auto v = val.get_ptr<const double*>()) {
-    *num = *v;
-  } else {
+// avoid a fmtlib "unused type alias 'char_type'" warning false positive
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-local-typedef"
+#endif
+
+namespace {
+
+// Decoded value of a single params/options field.  Storage is reused across
+// messages in a frame, so steady-state decoding does not allocate.
+template <typename T>
+struct Param {
+  enum State : uint8_t { kMissing, kValid, kInvalid };
+
+  void Reset() { state = kMissing; }
+  // returns false and sets error if missing or invalid
+  bool Check(std::string_view key, std::string_view what,
+             std::string* error) const {
+    if (state == kMissing) {
+      *error = fmt::format("no {} key", key);
+      return false;
+    } else if (state == kInvalid) {
+      *error = fmt::format("{} must be {}", key, what);
+      return false;
+    }
+    return true;
+  }
+
+  T value{};
+  State state{kMissing};
+};
+
+// SAX handler that decodes NT4 text frames (a JSON array of control
+// messages) without building a DOM for the whole frame.  Fields are
+// collected as they are parsed (keys may appear in any order) and each
+// message is validated and dispatched when its object ends.  Only
+// properties/update values, which the handlers take as JSON, are built as
+// JSON subtrees.
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+class TextDecoder {
+ public:
+  TextDecoder(T& out, wpi::Logger& logger) : m_out{out}, m_logger{logger} {}
+
+  // true if any client publish/subscribe messages were dispatched
+  bool GetResult() const { return m_rv; }
+
+  // SAX interface
+  bool null() { return Scalar(kNull); }
+  bool boolean(bool val) {
+    m_bool = val;
+    return Scalar(kBool);
+  }
+  bool number_integer(int64_t val) {
+    m_int = val;
+    m_double = val;
+    return Scalar(kInt);
+  }
+  bool number_unsigned(uint64_t val) {
+    m_int = val;
+    m_double = val;
+    return Scalar(kInt);
+  }
+  bool number_float(double val, const std::string&) {
+    m_double = val;
+    return Scalar(kFloat);
+  }
+  bool string(std::string& val) {
+    m_str = &val;
+    return Scalar(kString);
+  }
+  bool binary(wpi::json::binary_t&) { return Scalar(kNull); }
+  bool start_object(size_t) { return StartContainer(true); }
+  bool key(std::string& val);
+  bool end_object() { return EndContainer(); }
+  bool start_array(size_t) { return StartContainer(false); }
+  bool end_array() { return EndContainer(); }
+  bool parse_error(size_t, const std::string&, const wpi::json::exception& ex) {
+    WPI_WARNING(m_logger, "could not decode JSON message: {}", ex.what());
     return false;
   }
+
+ private:
+  enum Kind { kNull, kBool, kInt, kFloat, kString };
+  enum Context { kTop, kMessages, kMessage, kParams, kOptions, kTopics, kDone };
+  enum Field {
+    kOther,
+    kMethod,
+    kParamsField,
+    kName,
+    kType,
+    kId,
+    kPubuid,
+    kSubuid,
+    kProperties,
+    kUpdate,
+    kAck,
+    kOptionsField,
+    kTopicsField,
+    kPeriodic,
+    kAll,
+    kTopicsOnly,
+    kPrefix,
+    kPriority
+  };
+
+  bool Scalar(Kind kind);
+  bool StartContainer(bool isObject);
+  bool EndContainer();
+  void StartMessage();
+  void EndMessage();
+  bool Dispatch(std::string* error);
+  void CaptureScalar(Kind kind, wpi::json* j);
+  // returns the JSON field being captured (properties or update)
+  Param<wpi::json>* CaptureField() {
+    return m_field == kUpdate ? &m_update : &m_properties;
+  }
+  void SetInt(Param<int64_t>* p, Kind kind) {
+    if (kind == kInt) {
+      p->value = m_int;
+      p->state = p->kValid;
+    } else {
+      p->state = p->kInvalid;
+    }
+  }
+  void SetBool(Param<bool>* p, Kind kind) {
+    if (kind == kBool) {
+      p->value = m_bool;
+      p->state = p->kValid;
+    } else {
+      p->state = p->kInvalid;
+    }
+  }
+  void SetString(Param<std::string>* p, Kind kind) {
+    if (kind == kString) {
+      p->value.assign(*m_str);
+      p->state = p->kValid;
+    } else {
+      p->state = p->kInvalid;
+    }
+  }
+
+  T& m_out;
+  wpi::Logger& m_logger;
+  bool m_rv{false};
+
+  Context m_ctx{kTop};
+  Field m_field{kOther};
+  int m_index{-1};       // message index
+  int m_skipDepth{0};    // nesting depth of ignored values
+  bool m_badMessage{false};
+
+  // current scalar
+  bool m_bool{false};
+  int64_t m_int{0};
+  double m_double{0};
+  std::string* m_str{nullptr};
+
+  // JSON subtree being built for properties/update
+  wpi::SmallVector<wpi::json*, 8> m_captureStack;
+  std::string m_captureKey;
+
+  // message fields
+  Param<std::string> m_method;
+  Param<bool> m_params;
+  Param<std::string> m_name;
+  Param<std::string> m_type;
+  Param<int64_t> m_id;
+  Param<int64_t> m_pubuid;
+  Param<int64_t> m_subuid;
+  Param<wpi::json> m_properties;
+  Param<wpi::json> m_update;
+  Param<bool> m_ack;
+  Param<bool> m_options;
+  Param<double> m_periodic;
+  Param<bool> m_all;
+  Param<bool> m_topicsOnly;
+  Param<bool> m_prefix;
+  Param<int64_t> m_priority;
+  Param<bool> m_topics;
+  std::vector<std::string> m_topicNames;
+  size_t m_numTopics{0};
+  bool m_topicBad{false};
+  size_t m_badTopic{0};
+};
+
+}  // namespace
+
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+bool TextDecoder<T>::key(std::string& val) {
+  if (m_skipDepth > 0) {
+    return true;
+  }
+  if (!m_captureStack.empty()) {
+    m_captureKey.assign(val);
+    return true;
+  }
+  m_field = kOther;
+  switch (m_ctx) {
+    case kMessage:
+      if (val == "method") {
+        m_field = kMethod;
+      } else if (val == "params") {
+        m_field = kParamsField;
+      }
+      break;
+    case kParams:
+      if (val == "name") {
+        m_field = kName;
+      } else if (val == "type") {
+        m_field = kType;
+      } else if (val == "id") {
+        m_field = kId;
+      } else if (val == "pubuid") {
+        m_field = kPubuid;
+      } else if (val == "subuid") {
+        m_field = kSubuid;
+      } else if (val == "properties") {
+        m_field = kProperties;
+      } else if (val == "update") {
+        m_field = kUpdate;
+      } else if (val == "ack") {
+        m_field = kAck;
+      } else if (val == "options") {
+        m_field = kOptionsField;
+      } else if (val == "topics") {
+        m_field = kTopicsField;
+      }
+      break;
+    case kOptions:
+      if (val == "periodic") {
+        m_field = kPeriodic;
+      } else if (val == "all") {
+        m_field = kAll;
+      } else if (val == "topicsonly") {
+        m_field = kTopicsOnly;
+      } else if (val == "prefix") {
+        m_field = kPrefix;
+      } else if (val == "priority") {
+        m_field = kPriority;
+      }
+      break;
+    default:
+      break;
+  }
   return true;
 }
 
-static bool GetNumber(wpi::json& val, int64_t* num) {
-  if (auto v = val.get_ptr<const int64_t*>()) {
-    *num = *v;
-  } else if (auto v = val.get_ptr<const uint64_t*>()) {
-    *num = *v;
-  } else {
-    return false;
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+void TextDecoder<T>::CaptureScalar(Kind kind, wpi::json* j) {
+  switch (kind) {
+    case kNull:
+      *j = nullptr;
+      break;
+    case kBool:
+      *j = m_bool;
+      break;
+    case kInt:
+      *j = m_int;
+      break;
+    case kFloat:
+      *j = m_double;
+      break;
+    case kString:
+      *j = *m_str;
+      break;
   }
-  return true;
 }
 
-static std::string* ObjGetString(wpi::json::object_t& obj, std::string_view key,
-                                 std::string* error) {
-  auto it = obj.find(key);
-  if (it == obj.end()) {
-    *error = fmt::format("no {} key", key);
-    return nullptr;
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+bool TextDecoder<T>::Scalar(Kind kind) {
+  if (m_skipDepth > 0) {
+    return true;
+  }
+  if (!m_captureStack.empty()) {
+    auto parent = m_captureStack.back();
+    if (parent->is_object()) {
+      CaptureScalar(kind, &(*parent)[m_captureKey]);
+    } else {
+      CaptureScalar(kind, &parent->emplace_back());
+    }
+    return true;
   }
-  auto val = it->second.get_ptr<std::string*>();
-  if (!val) {
-    *error = fmt::format("{} must be a string", key);
+  switch (m_ctx) {
+    case kTop:
+      WPI_WARNING(m_logger, "expected JSON array at top level");
+      return false;
+    case kMessages:
+      WPI_WARNING(m_logger, "{}: expected message to be an object", ++m_index);
+      break;
+    case kMessage:
+      if (m_field == kMethod) {
+        SetString(&m_method, kind);
+      } else if (m_field == kParamsField) {
+        m_params.state = m_params.kInvalid;
+      }
+      break;
+    case kParams:
+      switch (m_field) {
+        case kName:
+          SetString(&m_name, kind);
+          break;
+        case kType:
+          SetString(&m_type, kind);
+          break;
+        case kId:
+          SetInt(&m_id, kind);
+          break;
+        case kPubuid:
+          SetInt(&m_pubuid, kind);
+          break;
+        case kSubuid:
+          SetInt(&m_subuid, kind);
+          break;
+        case kProperties:
+        case kUpdate: {
+          auto p = CaptureField();
+          CaptureScalar(kind, &p->value);
+          p->state = p->kInvalid;
+          break;
+        }
+        case kAck:
+          SetBool(&m_ack, kind);
+          break;
+        case kOptionsField:
+          m_options.state = m_options.kInvalid;
+          break;
+        case kTopicsField:
+          m_topics.state = m_topics.kInvalid;
+          break;
+        default:
+          break;
+      }
+      break;
+    case kOptions:
+      switch (m_field) {
+        case kPeriodic:
+          if (kind == kInt || kind == kFloat) {
+            m_periodic.value = m_double;
+            m_periodic.state = m_periodic.kValid;
+          } else {
+            m_periodic.state = m_periodic.kInvalid;
+          }
+          break;
+        case kAll:
+          SetBool(&m_all, kind);
+          break;
+        case kTopicsOnly:
+          SetBool(&m_topicsOnly, kind);
+          break;
+        case kPrefix:
+          SetBool(&m_prefix, kind);
+          break;
+        case kPriority:
+          SetInt(&m_priority, kind);
+          break;
+        default:
+          break;
+      }
+      break;
+    case kTopics:
+      if (kind == kString) {
+        if (m_numTopics < m_topicNames.size()) {
+          m_topicNames[m_numTopics].assign(*m_str);
+        } else {
+          m_topicNames.emplace_back(*m_str);
+        }
+        ++m_numTopics;
+      } else if (!m_topicBad) {
+        m_topicBad = true;
+        m_badTopic = m_numTopics;
+      }
+      break;
+    case kDone:
+      break;
   }
-  return val;
+  return true;
 }
 
-static bool ObjGetNumber(wpi::json::object_t& obj, std::string_view key,
-                         std::string* error, int64_t* num) {
-  auto it = obj.find(key);
-  if (it == obj.end()) {
-    *error = fmt::format("no {} key", key);
-    return false;
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+bool TextDecoder<T>::StartContainer(bool isObject) {
+  if (m_skipDepth > 0) {
+    ++m_skipDepth;
+    return true;
+  }
+  if (!m_captureStack.empty()) {
+    auto parent = m_captureStack.back();
+    wpi::json* j;
+    if (parent->is_object()) {
+      j = &(*parent)[m_captureKey];
+    } else {
+      j = &parent->emplace_back();
+    }
+    *j = isObject ? wpi::json::object() : wpi::json::array();
+    m_captureStack.emplace_back(j);
+    return true;
+  }
+
+  switch (m_ctx) {
+    case kTop:
+      if (!isObject) {
+        m_ctx = kMessages;
+        return true;
+      }
+      break;
+    case kMessages:
+      if (isObject) {
+        StartMessage();
+        m_ctx = kMessage;
+        return true;
+      }
+      break;
+    case kMessage:
+      if (m_field == kParamsField && isObject) {
+        m_params.state = m_params.kValid;
+        m_ctx = kParams;
+        return true;
+      }
+      break;
+    case kParams:
+      if (m_field == kProperties || m_field == kUpdate) {
+        auto p = CaptureField();
+        if (isObject) {
+          if (p->value.is_object()) {
+            p->value.clear();  // reuse storage
+          } else {
+            p->value = wpi::json::object();
+          }
+          p->state = p->kValid;
+        } else {
+          p->value = wpi::json::array();
+          p->state = p->kInvalid;
+        }
+        m_captureStack.emplace_back(&p->value);
+        return true;
+      } else if (m_field == kOptionsField && isObject) {
+        m_options.state = m_options.kValid;
+        m_ctx = kOptions;
+        return true;
+      } else if (m_field == kTopicsField && !isObject) {
+        m_topics.state = m_topics.kValid;
+        m_numTopics = 0;
+        m_topicBad = false;
+        m_ctx = kTopics;
+        return true;
+      }
+      break;
+    default:
+      break;
   }
-  if (!GetNumber(it->second, num)) {
-    *error = fmt::format("{} must be a number", key);
+
+  // not a container we descend into; handle it like an invalid scalar
+  if (!Scalar(kNull)) {
     return false;
   }
+  // ignore the contents of this container
+  m_skipDepth = 1;
   return true;
 }
 
-static bool ObjGetStringArray(wpi::json::object_t& obj, std::string_view key,
-                              std::string* error,
-                              std::vector<std::string>* out) {
-  // prefixes
-  auto it = obj.find(key);
-  if (it == obj.end()) {
-    *error = fmt::format("no {} key", key);
-    return false;
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+bool TextDecoder<T>::EndContainer() {
+  if (m_skipDepth > 0) {
+    --m_skipDepth;
+    return true;
   }
-  auto jarr = it->second.get_ptr<wpi::json::array_t*>();
-  if (!jarr) {
-    *error = fmt::format("{} must be an array", key);
-    return false;
+  if (!m_captureStack.empty()) {
+    m_captureStack.pop_back();
+    return true;
   }
-  out->resize(0);
-  out->reserve(jarr->size());
-  for (auto&& jval : *jarr) {
-    auto str = jval.get_ptr<std::string*>();
-    if (!str) {
-      *error = fmt::format("{}/{} must be a string", key, out->size());
-      return false;
-    }
-    out->emplace_back(std::move(*str));
+  switch (m_ctx) {
+    case kMessages:
+      m_ctx = kDone;
+      break;
+    case kMessage:
+      EndMessage();
+      m_ctx = kMessages;
+      break;
+    case kParams:
+    case kOptions:
+    case kTopics:
+      m_ctx = m_ctx == kParams ? kMessage : kParams;
+      break;
+    default:
+      break;
   }
   return true;
 }
 
-// avoid a fmtlib "unused type alias 'char_type'" warning false positive
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wunused-local-typedef"
-#endif
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+void TextDecoder<T>::StartMessage() {
+  ++m_index;
+  m_method.Reset();
+  m_params.Reset();
+  m_name.Reset();
+  m_type.Reset();
+  m_id.Reset();
+  m_pubuid.Reset();
+  m_subuid.Reset();
+  m_properties.Reset();
+  m_update.Reset();
+  m_ack.Reset();
+  m_options.Reset();
+  m_periodic.Reset();
+  m_all.Reset();
+  m_topicsOnly.Reset();
+  m_prefix.Reset();
+  m_priority.Reset();
+  m_topics.Reset();
+  m_numTopics = 0;
+}
 
 template <typename T>
   requires(std::same_as<T, ClientMessageHandler> ||
            std::same_as<T, ServerMessageHandler>)
-static bool WireDecodeTextImpl(std::string_view in, T& out,
-                               wpi::Logger& logger) {
-  wpi::json j;
-  try {
-    j = wpi::json::parse(in);
-  } catch (wpi::json::parse_error& err) {
-    WPI_WARNING(logger, "could not decode JSON message: {}", err.what());
-    return false;
+void TextDecoder<T>::EndMessage() {
+  std::string error;
+  if (!Dispatch(&error)) {
+    WPI_WARNING(m_logger, "{}: {}", m_index, error);
   }
+}
 
-  if (!j.is_array()) {
-    WPI_WARNING(logger, "expected JSON array at top level");
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+bool TextDecoder<T>::Dispatch(std::string* error) {
+  if (!m_method.Check("method", "a string", error) ||
+      !m_params.Check("params", "an object", error)) {
     return false;
   }
-
-  bool rv = false;
-  int i = -1;
-  for (auto&& jmsg : j) {
-    ++i;
-    std::string error;
-    {
-      auto obj = jmsg.get_ptr<wpi::json::object_t*>();
-      if (!obj) {
-        error = "expected message to be an object";
-        goto err;
+  std::string_view method = m_method.value;
+
+  if constexpr (std::same_as<T, ClientMessageHandler>) {
+    if (method == PublishMsg::kMethodStr) {
+      if (!m_name.Check("name", "a string", error) ||
+          !m_type.Check("type", "a string", error) ||
+          !m_pubuid.Check("pubuid", "a number", error)) {
+        return false;
       }
-
-      auto method = ObjGetString(*obj, "method", &error);
-      if (!method) {
-        goto err;
+      // properties; allow missing (treated as empty)
+      if (m_properties.state == m_properties.kMissing) {
+        m_properties.value = wpi::json::object();
+      } else if (!m_properties.Check("properties", "an object", error)) {
+        return false;
       }
-
-      auto paramsIt = obj->find("params");
-      if (paramsIt == obj->end()) {
-        error = "no params key";
-        goto err;
+      m_out.ClientPublish(m_pubuid.value, m_name.value, m_type.value,
+                          m_properties.value, {});
+      m_rv = true;
+    } else if (method == UnpublishMsg::kMethodStr) {
+      if (!m_pubuid.Check("pubuid", "a number", error)) {
+        return false;
       }
-      auto params = paramsIt->second.get_ptr<wpi::json::object_t*>();
-      if (!params) {
-        error = "params must be an object";
-        goto err;
+      m_out.ClientUnpublish(m_pubuid.value);
+      m_rv = true;
+    } else if (method == SetPropertiesMsg::kMethodStr) {
+      if (!m_name.Check("name", "a string", error) ||
+          !m_update.Check("update", "an object", error)) {
+        return false;
+      }
+      m_out.ClientSetProperties(m_name.value, m_update.value);
+    } else if (method == SubscribeMsg::kMethodStr) {
+      if (!m_subuid.Check("subuid", "a number", error)) {
+        return false;
       }
 
-      if constexpr (std::same_as<T, ClientMessageHandler>) {
-        if (*method == PublishMsg::kMethodStr) {
-          // name
-          auto name = ObjGetString(*params, "name", &error);
-          if (!name) {
-            goto err;
-          }
-
-          // type
-          auto typeStr = ObjGetString(*params, "type", &error);
-          if (!typeStr) {
-            goto err;
-          }
-
-          // pubuid
-          int64_t pubuid;
-          if (!ObjGetNumber(*params, "pubuid", &error, &pubuid)) {
-            goto err;
-          }
-
-          // properties; allow missing (treated as empty)
-          wpi::json* properties = nullptr;
-          auto propertiesIt = params->find("properties");
-          if (propertiesIt != params->end()) {
-            properties = &propertiesIt->second;
-            if (!properties->is_object()) {
-              error = "properties must be an object";
-              goto err;
-            }
-          }
-          wpi::json propertiesEmpty;
-          if (!properties) {
-            propertiesEmpty = wpi::json::object();
-            properties = &propertiesEmpty;
-          }
-
-          // complete
-          out.ClientPublish(pubuid, *name, *typeStr, *properties, {});
-          rv = true;
-        } else if (*method == UnpublishMsg::kMethodStr) {
-          // pubuid
-          int64_t pubuid;
-          if (!ObjGetNumber(*params, "pubuid", &error, &pubuid)) {
-            goto err;
-          }
-
-          // complete
-          out.ClientUnpublish(pubuid);
-          rv = true;
-        } else if (*method == SetPropertiesMsg::kMethodStr) {
-          // name
-          auto name = ObjGetString(*params, "name", &error);
-          if (!name) {
-            goto err;
-          }
-
-          // update
-          auto updateIt = params->find("update");
-          if (updateIt == params->end()) {
-            error = "no update key";
-            goto err;
-          }
-          auto update = &updateIt->second;
-          if (!update->is_object()) {
-            error = "update must be an object";
-            goto err;
-          }
-
-          // complete
-          out.ClientSetProperties(*name, *update);
-        } else if (*method == SubscribeMsg::kMethodStr) {
-          // subuid
-          int64_t subuid;
-          if (!ObjGetNumber(*params, "subuid", &error, &subuid)) {
-            goto err;
-          }
-
-          // options
-          PubSubOptionsImpl options;
-          auto optionsIt = params->find("options");
-          if (optionsIt != params->end()) {
-            auto joptions = optionsIt->second.get_ptr<wpi::json::object_t*>();
-            if (!joptions) {
-              error = "options must be an object";
-              goto err;
-            }
-
-            // periodic
-            auto periodicIt = joptions->find("periodic");
-            if (periodicIt != joptions->end()) {
-              double val;
-              if (!GetNumber(periodicIt->second, &val)) {
-                error = "periodic value must be a number";
-                goto err;
-              }
-              options.periodic = val;
-              options.periodicMs = val * 1000;
-            }
-
-            // send all changes
-            auto sendAllIt = joptions->find("all");
-            if (sendAllIt != joptions->end()) {
-              auto sendAll = sendAllIt->second.get_ptr<bool*>();
-              if (!sendAll) {
-                error = "all value must be a boolean";
-                goto err;
-              }
-              options.sendAll = *sendAll;
-            }
-
-            // topics only
-            auto topicsOnlyIt = joptions->find("topicsonly");
-            if (topicsOnlyIt != joptions->end()) {
-              auto topicsOnly = topicsOnlyIt->second.get_ptr<bool*>();
-              if (!topicsOnly) {
-                error = "topicsonly value must be a boolean";
-                goto err;
-              }
-              options.topicsOnly = *topicsOnly;
-            }
-
-            // prefix match
-            auto prefixMatchIt = joptions->find("prefix");
-            if (prefixMatchIt != joptions->end()) {
-              auto prefixMatch = prefixMatchIt->second.get_ptr<bool*>();
-              if (!prefixMatch) {
-                error = "prefix value must be a boolean";
-                goto err;
-              }
-              options.prefixMatch = *prefixMatch;
-            }
-          }
-
-          // topic names
-          std::vector<std::string> topicNames;
-          if (!ObjGetStringArray(*params, "topics", &error, &topicNames)) {
-            goto err;
-          }
-
-          // complete
-          out.ClientSubscribe(subuid, topicNames, options);
-          rv = true;
-        } else if (*method == UnsubscribeMsg::kMethodStr) {
-          // subuid
-          int64_t subuid;
-          if (!ObjGetNumber(*params, "subuid", &error, &subuid)) {
-            goto err;
-          }
-
-          // complete
-          out.ClientUnsubscribe(subuid);
-          rv = true;
-        } else {
-          error = fmt::format("unrecognized method '{}'", *method);
-          goto err;
+      PubSubOptionsImpl options;
+      if (m_options.state != m_options.kMissing) {
+        if (!m_options.Check("options", "an object", error)) {
+          return false;
         }
-      } else if constexpr (std::same_as<T, ServerMessageHandler>) {
-        if (*method == AnnounceMsg::kMethodStr) {
-          // name
-          auto name = ObjGetString(*params, "name", &error);
-          if (!name) {
-            goto err;
-          }
-
-          // id
-          int64_t id;
-          if (!ObjGetNumber(*params, "id", &error, &id)) {
-            goto err;
-          }
-
-          // type
-          auto typeStr = ObjGetString(*params, "type", &error);
-          if (!typeStr) {
-            goto err;
-          }
-
-          // pubuid
-          std::optional<int64_t> pubuid;
-          auto pubuidIt = params->find("pubuid");
-          if (pubuidIt != params->end()) {
-            int64_t val;
-            if (!GetNumber(pubuidIt->second, &val)) {
-              error = "pubuid value must be a number";
-              goto err;
-            }
-            pubuid = val;
-          }
-
-          // properties
-          auto propertiesIt = params->find("properties");
-          if (propertiesIt == params->end()) {
-            error = "no properties key";
-            goto err;
+        if (m_periodic.state != m_periodic.kMissing) {
+          if (!m_periodic.Check("periodic value", "a number", error)) {
+            return false;
           }
-          auto properties = &propertiesIt->second;
-          if (!properties->is_object()) {
-            WPI_WARNING(logger, "{}: properties is not an object", *name);
-            *properties = wpi::json::object();
-          }
-
-          // complete
-          out.ServerAnnounce(*name, id, *typeStr, *properties, pubuid);
-        } else if (*method == UnannounceMsg::kMethodStr) {
-          // name
-          auto name = ObjGetString(*params, "name", &error);
-          if (!name) {
-            goto err;
-          }
-
-          // id
-          int64_t id;
-          if (!ObjGetNumber(*params, "id", &error, &id)) {
-            goto err;
+          options.periodic = m_periodic.value;
+          options.periodicMs = m_periodic.value * 1000;
+        }
+        if (m_all.state != m_all.kMissing) {
+          if (!m_all.Check("all value", "a boolean", error)) {
+            return false;
           }
-
-          // complete
-          out.ServerUnannounce(*name, id);
-        } else if (*method == PropertiesUpdateMsg::kMethodStr) {
-          // name
-          auto name = ObjGetString(*params, "name", &error);
-          if (!name) {
-            goto err;
+          options.sendAll = m_all.value;
+        }
+        if (m_topicsOnly.state != m_topicsOnly.kMissing) {
+          if (!m_topicsOnly.Check("topicsonly value", "a boolean", error)) {
+            return false;
           }
-
-          // update
-          auto updateIt = params->find("update");
-          if (updateIt == params->end()) {
-            error = "no update key";
-            goto err;
+          options.topicsOnly = m_topicsOnly.value;
+        }
+        if (m_prefix.state != m_prefix.kMissing) {
+          if (!m_prefix.Check("prefix value", "a boolean", error)) {
+            return false;
           }
-          auto update = &updateIt->second;
-          if (!update->is_object()) {
-            error = "update must be an object";
-            goto err;
+          options.prefixMatch = m_prefix.value;
+        }
+        if (m_priority.state != m_priority.kMissing) {
+          if (!m_priority.Check("priority value", "a number", error)) {
+            return false;
           }
+          options.priority = m_priority.value;
+        }
+      }
 
-          bool ack = false;
-          auto ackIt = params->find("ack");
-          if (ackIt != params->end()) {
-            auto val = ackIt->second.get_ptr<bool*>();
-            if (!val) {
-              error = "ack must be a boolean";
-              goto err;
-            }
-            ack = *val;
-          }
+      if (!m_topics.Check("topics", "an array", error)) {
+        return false;
+      }
+      if (m_topicBad) {
+        *error = fmt::format("topics/{} must be a string", m_badTopic);
+        return false;
+      }
 
-          // complete
-          out.ServerPropertiesUpdate(*name, *update, ack);
-        } else {
-          error = fmt::format("unrecognized method '{}'", *method);
-          goto err;
+      m_out.ClientSubscribe(
+          m_subuid.value,
+          std::span<const std::string>{m_topicNames.data(), m_numTopics},
+          options);
+      m_rv = true;
+    } else if (method == UnsubscribeMsg::kMethodStr) {
+      if (!m_subuid.Check("subuid", "a number", error)) {
+        return false;
+      }
+      m_out.ClientUnsubscribe(m_subuid.value);
+      m_rv = true;
+    } else {
+      *error = fmt::format("unrecognized method '{}'", method);
+      return false;
+    }
+  } else if constexpr (std::same_as<T, ServerMessageHandler>) {
+    if (method == AnnounceMsg::kMethodStr) {
+      if (!m_name.Check("name", "a string", error) ||
+          !m_id.Check("id", "a number", error) ||
+          !m_type.Check("type", "a string", error)) {
+        return false;
+      }
+      std::optional<int64_t> pubuid;
+      if (m_pubuid.state != m_pubuid.kMissing) {
+        if (!m_pubuid.Check("pubuid value", "a number", error)) {
+          return false;
         }
+        pubuid = m_pubuid.value;
+      }
+      if (m_properties.state == m_properties.kMissing) {
+        *error = "no properties key";
+        return false;
+      } else if (m_properties.state == m_properties.kInvalid) {
+        WPI_WARNING(m_logger, "{}: properties is not an object", m_name.value);
+        m_properties.value = wpi::json::object();
+      }
+      m_out.ServerAnnounce(m_name.value, m_id.value, m_type.value,
+                           m_properties.value, pubuid);
+    } else if (method == UnannounceMsg::kMethodStr) {
+      if (!m_name.Check("name", "a string", error) ||
+          !m_id.Check("id", "a number", error)) {
+        return false;
+      }
+      m_out.ServerUnannounce(m_name.value, m_id.value);
+    } else if (method == PropertiesUpdateMsg::kMethodStr) {
+      if (!m_name.Check("name", "a string", error) ||
+          !m_update.Check("update", "an object", error)) {
+        return false;
       }
-      continue;
+      bool ack = false;
+      if (m_ack.state != m_ack.kMissing) {
+        if (!m_ack.Check("ack", "a boolean", error)) {
+          return false;
+        }
+        ack = m_ack.value;
+      }
+      m_out.ServerPropertiesUpdate(m_name.value, m_update.value, ack);
+    } else {
+      *error = fmt::format("unrecognized method '{}'", method);
+      return false;
     }
-  err:
-    WPI_WARNING(logger, "{}: {}", i, error);
   }
+  return true;
+}
 
-  return rv;
+template <typename T>
+  requires(std::same_as<T, ClientMessageHandler> ||
+           std::same_as<T, ServerMessageHandler>)
+static bool WireDecodeTextImpl(std::string_view in, T& out,
+                               wpi::Logger& logger) {
+  TextDecoder<T> decoder{out, logger};
+  wpi::json::sax_parse(in, &decoder);
+  return decoder.GetResult();
 }
 
 #ifdef __clang__
@@ -431,9 +740,56 @@ void nt::net::WireDecodeText(std::string_view in, ServerMessageHandler& out,
   ::WireDecodeTextImpl(in, out, logger);
 }
 
-bool nt::net::WireDecodeBinary(std::span<const uint8_t>* in, int* outId,
-                               Value* outValue, std::string* error,
-                               int64_t localTimeOffset) {
+// applies an array delta payload to base
+template <typename T, typename F>
+static void DecodeDelta(mpack_reader_t* reader, std::span<const T> base,
+                        std::vector<T>* out, F&& read) {
+  uint32_t count = mpack_expect_array(reader);
+  if ((count % 2) != 1) {
+    mpack_reader_flag_error(reader, mpack_error_data);
+    return;
+  }
+  uint32_t length = mpack_expect_u32(reader);
+  out->assign(base.begin(),
+              base.begin() + (std::min)(base.size(), size_t{length}));
+  uint64_t prevEnd = 0;
+  for (uint32_t i = 1; i < count; i += 2) {
+    uint32_t start = mpack_expect_u32(reader);
+    uint32_t n = mpack_expect_array(reader);
+    if (mpack_reader_error(reader) != mpack_ok) {
+      return;
+    }
+    // ranges must be in order, and can only extend the array at the end
+    if (start < prevEnd || start > out->size() ||
+        uint64_t{start} + n > length) {
+      mpack_reader_flag_error(reader, mpack_error_data);
+      return;
+    }
+    for (uint32_t j = 0; j < n; ++j) {
+      T val = read(reader);
+      if (mpack_reader_error(reader) != mpack_ok) {
+        return;
+      }
+      if (start + j < out->size()) {
+        (*out)[start + j] = val;
+      } else {
+        out->emplace_back(val);
+      }
+    }
+    mpack_done_array(reader);
+    prevEnd = uint64_t{start} + n;
+  }
+  if (out->size() != length) {
+    mpack_reader_flag_error(reader, mpack_error_data);
+    return;
+  }
+  mpack_done_array(reader);
+}
+
+bool nt::net::WireDecodeBinary(
+    std::span<const uint8_t>* in, int* outId, Value* outValue,
+    std::string* error, int64_t localTimeOffset,
+    wpi::function_ref<const Value*(int id)> getDeltaBase) {
   mpack_reader_t reader;
   mpack_reader_init_data(&reader, reinterpret_cast<const char*>(in->data()),
                          in->size());
@@ -557,6 +913,57 @@ bool nt::net::WireDecodeBinary(std::span<const uint8_t>* in, int* outId,
       mpack_done_array(&reader);
       break;
     }
+    case 16 + kBinaryDeltaTypeOffset:
+    case 17 + kBinaryDeltaTypeOffset:
+    case 18 + kBinaryDeltaTypeOffset:
+    case 19 + kBinaryDeltaTypeOffset: {  // array delta
+      static constexpr NT_Type kTypes[] = {NT_BOOLEAN_ARRAY, NT_DOUBLE_ARRAY,
+                                           NT_INTEGER_ARRAY, NT_FLOAT_ARRAY};
+      const Value* base = getDeltaBase ? getDeltaBase(*outId) : nullptr;
+      if (!base || base->type() != kTypes[type - 16 - kBinaryDeltaTypeOffset]) {
+        *error = fmt::format("delta for id {} without previous value", *outId);
+        return false;
+      }
+      switch (base->type()) {
+        case NT_BOOLEAN_ARRAY: {
+          std::vector<int> arr;
+          DecodeDelta(&reader, base->GetBooleanArray(), &arr,
+                      [](auto r) -> int { return mpack_expect_bool(r); });
+          if (mpack_reader_error(&reader) == mpack_ok) {
+            *outValue = Value::MakeBooleanArray(std::move(arr), 1);
+          }
+          break;
+        }
+        case NT_INTEGER_ARRAY: {
+          std::vector<int64_t> arr;
+          DecodeDelta(&reader, base->GetIntegerArray(), &arr,
+                      [](auto r) { return mpack_expect_i64(r); });
+          if (mpack_reader_error(&reader) == mpack_ok) {
+            *outValue = Value::MakeIntegerArray(std::move(arr), 1);
+          }
+          break;
+        }
+        case NT_FLOAT_ARRAY: {
+          std::vector<float> arr;
+          DecodeDelta(&reader, base->GetFloatArray(), &arr,
+                      [](auto r) { return mpack_expect_float(r); });
+          if (mpack_reader_error(&reader) == mpack_ok) {
+            *outValue = Value::MakeFloatArray(std::move(arr), 1);
+          }
+          break;
+        }
+        default: {
+          std::vector<double> arr;
+          DecodeDelta(&reader, base->GetDoubleArray(), &arr,
+                      [](auto r) { return mpack_expect_double(r); });
+          if (mpack_reader_error(&reader) == mpack_ok) {
+            *outValue = Value::MakeDoubleArray(std::move(arr), 1);
+          }
+          break;
+        }
+      }
+      break;
+    }
     default:
       *error = fmt::format("unrecognized type {}", type);
       return false;
@@ -10,6 +10,8 @@
 #include <string>
 #include <string_view>
 
+#include <wpi/function_ref.h>
+
 namespace wpi {
 class Logger;
 }  // namespace wpi
@@ -29,8 +31,12 @@ bool WireDecodeText(std::string_view in, ClientMessageHandler& out,
 void WireDecodeText(std::string_view in, ServerMessageHandler& out,
                     wpi::Logger& logger);
 
-// returns true if successfully decoded a message
-bool WireDecodeBinary(std::span<const uint8_t>* in, int* outId, Value* outValue,
-                      std::string* error, int64_t localTimeOffset);
+// returns true if successfully decoded a message; getDeltaBase returns the
+// previous value for an id (or nullptr), and is required to decode array
+// delta messages
+bool WireDecodeBinary(
+    std::span<const uint8_t>* in, int* outId, Value* outValue,
+    std::string* error, int64_t localTimeOffset,
+    wpi::function_ref<const Value*(int id)> getDeltaBase = nullptr);
 
 }  // namespace nt::net
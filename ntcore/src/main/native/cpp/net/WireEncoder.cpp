@@ -4,9 +4,14 @@
 
 #include "WireEncoder.h"
 
+#include <algorithm>
+#include <bit>
+#include <concepts>
 #include <optional>
+#include <span>
 #include <string>
 
+#include <wpi/SmallVector.h>
 #include <wpi/json.h>
 #include <wpi/mpack.h>
 #include <wpi/raw_ostream.h>
@@ -105,6 +110,14 @@ static void WireEncodeSubscribeImpl(wpi::raw_ostream& os, int subuid,
     }
     os << "\"periodic\":";
     s.dump_float(options.periodicMs / 1000.0);
+    first = false;
+  }
+  if (options.priority != 0) {
+    if (!first) {
+      os << ',';
+    }
+    os << "\"priority\":";
+    s.dump_integer(options.priority);
   }
   os << "},\"topics\":";
   EncodePrefixes(os, topicNames, s);
@@ -312,3 +325,148 @@ bool nt::net::WireEncodeBinary(wpi::raw_ostream& os, int id, int64_t time,
   mpack_finish_array(&writer);
   return mpack_writer_destroy(&writer) == mpack_ok;
 }
+
+namespace {
+struct DeltaRange {
+  size_t start;
+  size_t end;
+};
+}  // namespace
+
+// unchanged runs shorter than this are sent rather than splitting a range
+static constexpr size_t kDeltaMaxGap = 4;
+
+template <typename T>
+static bool DeltaEqual(T a, T b) {
+  // compare floating point bits so sign of zero changes are sent
+  if constexpr (std::same_as<T, float>) {
+    return std::bit_cast<uint32_t>(a) == std::bit_cast<uint32_t>(b);
+  } else if constexpr (std::same_as<T, double>) {
+    return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+  } else {
+    return a == b;
+  }
+}
+
+// returns false if the delta isn't worth sending
+template <typename T>
+static bool FindDeltaRanges(std::span<const T> cur, std::span<const T> prev,
+                            wpi::SmallVectorImpl<DeltaRange>& ranges) {
+  size_t common = (std::min)(cur.size(), prev.size());
+  size_t changed = 0;
+  size_t i = 0;
+  while (i < common) {
+    if (DeltaEqual(cur[i], prev[i])) {
+      ++i;
+      continue;
+    }
+    size_t start = i;
+    size_t end = ++i;
+    while (i < common && (i - end) < kDeltaMaxGap) {
+      if (!DeltaEqual(cur[i], prev[i])) {
+        end = i + 1;
+      }
+      ++i;
+    }
+    ranges.push_back({start, end});
+    changed += end - start;
+  }
+  if (cur.size() > common) {
+    ranges.push_back({common, cur.size()});
+    changed += cur.size() - common;
+  }
+  // each range costs roughly two elements of overhead
+  return (changed + 2 * ranges.size()) * 2 <= cur.size();
+}
+
+template <typename T, typename F>
+static void WriteDeltaRanges(mpack_writer_t* writer, std::span<const T> cur,
+                             std::span<const DeltaRange> ranges, F&& write) {
+  mpack_start_array(writer, 1 + 2 * ranges.size());
+  mpack_write_u32(writer, cur.size());
+  for (auto&& range : ranges) {
+    mpack_write_u32(writer, range.start);
+    mpack_start_array(writer, range.end - range.start);
+    for (auto&& val : cur.subspan(range.start, range.end - range.start)) {
+      write(writer, val);
+    }
+    mpack_finish_array(writer);
+  }
+  mpack_finish_array(writer);
+}
+
+bool nt::net::WireEncodeBinaryDelta(wpi::raw_ostream& os, int id, int64_t time,
+                                    const Value& value, const Value& prev) {
+  if (value.type() != prev.type()) {
+    return false;
+  }
+  wpi::SmallVector<DeltaRange, 16> ranges;
+  int type;
+  switch (value.type()) {
+    case NT_BOOLEAN_ARRAY:
+      if (!FindDeltaRanges(value.GetBooleanArray(), prev.GetBooleanArray(),
+                           ranges)) {
+        return false;
+      }
+      type = 16;
+      break;
+    case NT_INTEGER_ARRAY:
+      if (!FindDeltaRanges(value.GetIntegerArray(), prev.GetIntegerArray(),
+                           ranges)) {
+        return false;
+      }
+      type = 18;
+      break;
+    case NT_FLOAT_ARRAY:
+      if (!FindDeltaRanges(value.GetFloatArray(), prev.GetFloatArray(),
+                           ranges)) {
+        return false;
+      }
+      type = 19;
+      break;
+    case NT_DOUBLE_ARRAY:
+      if (!FindDeltaRanges(value.GetDoubleArray(), prev.GetDoubleArray(),
+                           ranges)) {
+        return false;
+      }
+      type = 17;
+      break;
+    default:
+      return false;
+  }
+
+  char buf[128];
+  mpack_writer_t writer;
+  mpack_writer_init(&writer, buf, sizeof(buf));
+  mpack_writer_set_context(&writer, &os);
+  mpack_writer_set_flush(
+      &writer, [](mpack_writer_t* writer, const char* buffer, size_t count) {
+        static_cast<wpi::raw_ostream*>(writer->context)->write(buffer, count);
+      });
+  mpack_start_array(&writer, 4);
+  mpack_write_int(&writer, id);
+  mpack_write_int(&writer, time);
+  mpack_write_u8(&writer, type + kBinaryDeltaTypeOffset);
+  switch (value.type()) {
+    case NT_BOOLEAN_ARRAY:
+      WriteDeltaRanges(&writer, value.GetBooleanArray(), ranges,
+                       [](auto w, int v) { mpack_write_bool(w, v); });
+      break;
+    case NT_INTEGER_ARRAY:
+      WriteDeltaRanges(&writer, value.GetIntegerArray(), ranges,
+                       [](auto w, int64_t v) { mpack_write_int(w, v); });
+      break;
+    case NT_FLOAT_ARRAY:
+      WriteDeltaRanges(&writer, value.GetFloatArray(), ranges,
+                       [](auto w, float v) { mpack_write_float(w, v); });
+      break;
+    case NT_DOUBLE_ARRAY:
+      WriteDeltaRanges(&writer, value.GetDoubleArray(), ranges,
+                       [](auto w, double v) { mpack_write_double(w, v); });
+      break;
+    default:
+      break;
+  }
+  mpack_finish_array(&writer);
+  return mpack_writer_destroy(&writer) == mpack_ok;
+}
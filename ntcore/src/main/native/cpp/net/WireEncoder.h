@@ -58,4 +58,15 @@ bool WireEncodeText(wpi::raw_ostream& os, const ServerMessage& msg);
 bool WireEncodeBinary(wpi::raw_ostream& os, int id, int64_t time,
                       const Value& value);
 
+// Type code offset for array delta binary messages (protocol 4.2+).  The
+// payload is [length, start1, [values...], start2, [values...], ...], and
+// replaces the given ranges of the previous value with the same id.
+inline constexpr int kBinaryDeltaTypeOffset = 32;
+
+// Encodes value as a delta from prev, the last value sent with the same id.
+// Returns false without writing anything if value can't be delta encoded
+// from prev, or if the delta would not be much smaller than the full value.
+bool WireEncodeBinaryDelta(wpi::raw_ostream& os, int id, int64_t time,
+                           const Value& value, const Value& prev);
+
 }  // namespace nt::net
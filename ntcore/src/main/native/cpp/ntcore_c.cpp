@@ -42,6 +42,14 @@ static void ConvertToC(const ConnectionInfo& in, NT_ConnectionInfo* out) {
   out->protocol_version = in.protocol_version;
 }
 
+static void ConvertToC(const NetworkTrafficStats& in,
+                       NT_NetworkTrafficStats* out) {
+  ConvertToC(in.remote_id, &out->remote_id);
+  out->sent_bytes = in.sent_bytes;
+  out->deferred_bytes = in.deferred_bytes;
+  out->dropped_bytes = in.dropped_bytes;
+}
+
 static void ConvertToC(const ValueEventData& in, NT_ValueEventData* out) {
   out->topic = in.topic;
   out->subentry = in.subentry;
@@ -129,6 +137,8 @@ static PubSubOptions ConvertToCpp(const NT_PubSubOptions* in) {
   out.disableLocal = in->disableLocal;
   out.excludeSelf = in->excludeSelf;
   out.hidden = in->hidden;
+  out.latestOnly = in->latestOnly;
+  out.priority = in->priority;
   return out;
 }
 
@@ -200,6 +210,14 @@ int NT_SetEntryValue(NT_Entry entry, const struct NT_Value* value) {
   return nt::SetEntryValue(entry, ConvertFromC(*value));
 }
 
+void NT_BeginBatch(NT_Inst inst) {
+  nt::BeginBatch(inst);
+}
+
+NT_Bool NT_CommitBatch(NT_Inst inst) {
+  return nt::CommitBatch(inst);
+}
+
 void NT_SetEntryFlags(NT_Entry entry, unsigned int flags) {
   nt::SetEntryFlags(entry, flags);
 }
@@ -447,6 +465,20 @@ NT_Bool NT_WaitForListenerQueue(NT_Handle handle, double timeout) {
   return nt::WaitForListenerQueue(handle, timeout);
 }
 
+void NT_SetListenerDispatchThreads(NT_Inst inst, int count) {
+  nt::SetListenerDispatchThreads(inst, count);
+}
+
+void NT_GetListenerStats(NT_Inst inst, struct NT_ListenerStats* stats) {
+  auto stats_cpp = nt::GetListenerStats(inst);
+  stats->dispatched_events = stats_cpp.dispatched_events;
+  stats->coalesced_events = stats_cpp.coalesced_events;
+  stats->queue_depth = stats_cpp.queue_depth;
+  stats->max_queue_depth = stats_cpp.max_queue_depth;
+  stats->avg_dispatch_latency = stats_cpp.avg_dispatch_latency;
+  stats->max_dispatch_latency = stats_cpp.max_dispatch_latency;
+}
+
 NT_Listener NT_AddListenerSingle(NT_Inst inst, const struct WPI_String* prefix,
                                  unsigned int mask, void* data,
                                  NT_ListenerCallback callback) {
@@ -609,6 +641,16 @@ int64_t NT_GetServerTimeOffset(NT_Inst inst, NT_Bool* valid) {
   }
 }
 
+void NT_SetNetworkBandwidthLimit(NT_Inst inst, double bytesPerSecond) {
+  nt::SetNetworkBandwidthLimit(inst, bytesPerSecond);
+}
+
+struct NT_NetworkTrafficStats* NT_GetNetworkTrafficStats(NT_Inst inst,
+                                                         size_t* count) {
+  auto stats_v = nt::GetNetworkTrafficStats(inst);
+  return ConvertToC<NT_NetworkTrafficStats>(stats_v, count);
+}
+
 /*
  * Utility Functions
  */
@@ -732,6 +774,14 @@ void NT_DisposeConnectionInfoArray(NT_ConnectionInfo* arr, size_t count) {
   std::free(arr);
 }
 
+void NT_DisposeNetworkTrafficStatsArray(NT_NetworkTrafficStats* arr,
+                                        size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    WPI_FreeString(&arr[i].remote_id);
+  }
+  std::free(arr);
+}
+
 void NT_DisposeTopicInfoArray(NT_TopicInfo* arr, size_t count) {
   for (size_t i = 0; i < count; i++) {
     DisposeTopicInfo(&arr[i]);
@@ -132,6 +132,29 @@ bool SetEntryValue(NT_Entry entry, const Value& value) {
   }
 }
 
+void BeginBatch(NT_Inst inst) {
+  if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
+    ii->localStorage.BeginBatch();
+  }
+}
+
+bool CommitBatch(NT_Inst inst) {
+  if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
+    if (!ii->localStorage.CommitBatch()) {
+      return false;
+    }
+    // hand the whole batch to the network at once
+    if (auto client = ii->GetClient()) {
+      client->FlushLocal();
+    } else if (auto server = ii->GetServer()) {
+      server->FlushLocal();
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
 void SetEntryFlags(NT_Entry entry, unsigned int flags) {
   if (auto ii = InstanceImpl::GetHandle(entry)) {
     ii->localStorage.SetEntryFlags(entry, flags);
@@ -158,6 +181,15 @@ std::vector<Value> ReadQueueValue(NT_Handle subentry, unsigned int types) {
   }
 }
 
+std::span<Value> ReadQueueValue(NT_Handle subentry, std::span<Value> out,
+                                unsigned int types) {
+  if (auto ii = InstanceImpl::GetHandle(subentry)) {
+    return ii->localStorage.ReadQueueValue(subentry, out, types);
+  } else {
+    return {};
+  }
+}
+
 /*
  * Topic Functions
  */
@@ -489,6 +521,20 @@ bool WaitForListenerQueue(NT_Handle handle, double timeout) {
   }
 }
 
+void SetListenerDispatchThreads(NT_Inst inst, int count) {
+  if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
+    ii->listenerStorage.SetDispatchThreads(count);
+  }
+}
+
+ListenerStats GetListenerStats(NT_Inst inst) {
+  if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
+    return ii->listenerStorage.GetStats();
+  } else {
+    return {};
+  }
+}
+
 NT_Listener AddListener(NT_Inst inst,
                         std::span<const std::string_view> prefixes,
                         unsigned int mask, ListenerCallback callback) {
@@ -777,6 +823,20 @@ std::optional<int64_t> GetServerTimeOffset(NT_Inst inst) {
   }
 }
 
+void SetNetworkBandwidthLimit(NT_Inst inst, double bytesPerSecond) {
+  if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
+    ii->SetBandwidthLimit(bytesPerSecond);
+  }
+}
+
+std::vector<NetworkTrafficStats> GetNetworkTrafficStats(NT_Inst inst) {
+  if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
+    return ii->connectionList.GetTrafficStats();
+  } else {
+    return {};
+  }
+}
+
 NT_Listener AddLogger(NT_Inst inst, unsigned int minLevel,
                       unsigned int maxLevel, ListenerCallback func) {
   if (auto ii = InstanceImpl::GetTyped(inst, Handle::kInstance)) {
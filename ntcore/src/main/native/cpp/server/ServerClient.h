@@ -76,6 +76,10 @@ class ServerClient {
 
   virtual void UpdatePeriod(TopicClientData& tcd, ServerTopic* topic) {}
 
+  // limits the average send rate; 0 is unlimited
+  virtual void SetBandwidthLimit(double bytesPerSecond) {}
+  virtual net::NetworkOutgoingStats GetOutgoingStats() const { return {}; }
+
  protected:
   std::string m_name;
   std::string m_connInfo;
@@ -4,6 +4,8 @@
 
 #include "ServerClient4.h"
 
+#include <algorithm>
+#include <climits>
 #include <string>
 
 #include <wpi/timestamp.h>
@@ -25,7 +27,7 @@ ServerClient4::ServerClient4(std::string_view name, std::string_view connInfo,
       m_wire{wire},
       m_ping{wire},
       m_incoming{logger},
-      m_outgoing{wire, local} {
+      m_outgoing{wire, local, &storage} {
   // create client meta topics
   m_metaPub = storage.CreateMetaTopic(fmt::format("$clientpub${}", name));
   m_metaSub = storage.CreateMetaTopic(fmt::format("$clientsub${}", name));
@@ -91,7 +93,8 @@ bool ServerClient4::ProcessIncomingBinary(std::span<const uint8_t> data) {
 
 void ServerClient4::SendValue(ServerTopic* topic, const Value& value,
                               net::ValueSendMode mode) {
-  m_outgoing.SendValue(topic->id, value, mode);
+  m_outgoing.SendValue(topic->id, value, mode,
+                       topic->delta && m_wire.GetVersion() >= 0x0402);
 }
 
 void ServerClient4::SendAnnounce(ServerTopic* topic,
@@ -175,6 +178,14 @@ void ServerClient4::SendOutgoing(uint64_t curTimeMs, bool flush) {
 void ServerClient4::UpdatePeriod(TopicClientData& tcd, ServerTopic* topic) {
   uint32_t period = net::CalculatePeriod(
       tcd.subscribers, [](auto& x) { return x->GetPeriodMs(); });
-  DEBUG4("updating {} period to {} ms", topic->name, period);
-  m_outgoing.SetPeriod(topic->id, period);
+  int priority = INT_MIN;
+  for (auto&& sub : tcd.subscribers) {
+    priority = (std::max)(priority, sub->GetOptions().priority);
+  }
+  if (priority == INT_MIN) {
+    priority = 0;
+  }
+  DEBUG4("updating {} period to {} ms, priority {}", topic->name, period,
+         priority);
+  m_outgoing.SetPeriod(topic->id, period, priority);
 }
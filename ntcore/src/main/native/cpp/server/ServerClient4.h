@@ -42,6 +42,13 @@ class ServerClient4 final : public ServerClient4Base {
 
   void UpdatePeriod(TopicClientData& tcd, ServerTopic* topic) final;
 
+  void SetBandwidthLimit(double bytesPerSecond) final {
+    m_outgoing.SetBandwidthLimit(bytesPerSecond);
+  }
+  net::NetworkOutgoingStats GetOutgoingStats() const final {
+    return m_outgoing.GetStats();
+  }
+
  public:
   net::WireConnection& m_wire;
 
@@ -55,6 +55,7 @@ std::pair<std::string, int> ServerImpl::AddClient(std::string_view name,
   clientData = std::make_unique<ServerClient4>(dedupName, connInfo, local, wire,
                                                std::move(setPeriodic),
                                                m_storage, index, m_logger);
+  clientData->SetBandwidthLimit(m_bandwidthLimit);
 
   DEBUG3("AddClient('{}', '{}') -> {}", name, connInfo, index);
   return {std::move(dedupName), index};
@@ -83,6 +84,23 @@ std::shared_ptr<void> ServerImpl::RemoveClient(int clientId) {
   return std::move(client);
 }
 
+void ServerImpl::SetBandwidthLimit(double bytesPerSecond) {
+  m_bandwidthLimit = bytesPerSecond;
+  for (auto&& client : m_clients) {
+    if (client) {
+      client->SetBandwidthLimit(bytesPerSecond);
+    }
+  }
+}
+
+net::NetworkOutgoingStats ServerImpl::GetOutgoingStats(int clientId) const {
+  if (clientId < 0 || static_cast<size_t>(clientId) >= m_clients.size() ||
+      !m_clients[clientId]) {
+    return {};
+  }
+  return m_clients[clientId]->GetOutgoingStats();
+}
+
 size_t ServerImpl::GetEmptyClientSlot() {
   size_t size = m_clients.size();
   // find an empty slot
@@ -214,3 +232,11 @@ std::string ServerImpl::DumpPersistent() {
   os.flush();
   return rv;
 }
+
+std::string ServerImpl::DumpPersistentBinary(bool full, size_t* count) {
+  std::string rv;
+  wpi::raw_string_ostream os{rv};
+  *count = m_storage.DumpPersistentBinary(os, full);
+  os.flush();
+  return rv;
+}
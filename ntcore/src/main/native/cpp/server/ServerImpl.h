@@ -44,6 +44,10 @@ class ServerImpl final {
   void SendAllOutgoing(uint64_t curTimeMs, bool flush);
   void SendOutgoing(int clientId, uint64_t curTimeMs);
 
+  // limits the average send rate to each client; 0 is unlimited
+  void SetBandwidthLimit(double bytesPerSecond);
+  net::NetworkOutgoingStats GetOutgoingStats(int clientId) const;
+
   void SetLocal(net::ServerMessageHandler* local,
                 net::ClientMessageQueue* queue);
 
@@ -74,6 +78,11 @@ class ServerImpl final {
   bool PersistentChanged() { return m_storage.PersistentChanged(); }
 
   std::string DumpPersistent();
+  void SetPersistentIncremental(bool enable) {
+    m_storage.SetPersistentIncremental(enable);
+  }
+  // see ServerStorage::DumpPersistentBinary()
+  std::string DumpPersistentBinary(bool full, size_t* count);
   // returns newline-separated errors
   std::string LoadPersistent(std::string_view in) {
     return m_storage.LoadPersistent(in);
@@ -84,6 +93,7 @@ class ServerImpl final {
 
   ServerClientLocal* m_localClient;
   std::vector<std::unique_ptr<ServerClient>> m_clients;
+  double m_bandwidthLimit{0};
 
   ServerStorage m_storage;
 
@@ -5,6 +5,8 @@
 #include "ServerStorage.h"
 
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,9 +14,15 @@
 #include <fmt/format.h>
 #include <wpi/Base64.h>
 #include <wpi/MessagePack.h>
+#include <wpi/SpanExtras.h>
+#include <wpi/StringMap.h>
 #include <wpi/json.h>
+#include <wpi/raw_ostream.h>
 
 #include "Log.h"
+#include "Types_internal.h"
+#include "net/WireDecoder.h"
+#include "net/WireEncoder.h"
 #include "server/MessagePackWriter.h"
 #include "server/ServerClient.h"
 
@@ -94,8 +102,8 @@ void ServerStorage::SetProperties(ServerClient* client, ServerTopic* topic,
   bool wasPersistent = topic->persistent;
   if (topic->SetProperties(update)) {
     // update persistentChanged flag
-    if (topic->persistent != wasPersistent) {
-      m_persistentChanged = true;
+    if (topic->persistent || wasPersistent) {
+      MarkPersistentChanged(topic);
     }
     PropertiesChanged(client, topic, update);
   }
@@ -107,7 +115,7 @@ void ServerStorage::SetFlags(ServerClient* client, ServerTopic* topic,
   if (topic->SetFlags(flags)) {
     // update persistentChanged flag
     if (topic->persistent != wasPersistent) {
-      m_persistentChanged = true;
+      MarkPersistentChanged(topic);
       wpi::json update;
       if (topic->persistent) {
         update = {{"persistent", true}};
@@ -132,7 +140,7 @@ void ServerStorage::SetValue(ServerClient* client, ServerTopic* topic,
 
     // if persistent, update flag
     if (topic->persistent) {
-      m_persistentChanged = true;
+      MarkPersistentChanged(topic);
     }
   }
 
@@ -144,6 +152,18 @@ void ServerStorage::SetValue(ServerClient* client, ServerTopic* topic,
   }
 }
 
+std::span<const uint8_t> ServerStorage::GetEncodedValue(int id,
+                                                        const Value& value) {
+  if (auto topic = GetTopic(id)) {
+    return topic->GetEncodedValue(value);
+  }
+  // shouldn't happen, but encode into scratch space if it does
+  m_encodeScratch.clear();
+  wpi::raw_uvector_ostream os{m_encodeScratch};
+  net::WireEncodeBinary(os, id, value.time(), value);
+  return m_encodeScratch;
+}
+
 void ServerStorage::RemoveClient(ServerClient* client) {
   // remove all publishers and subscribers for this client
   wpi::SmallVector<ServerTopic*, 16> toDelete;
@@ -346,6 +366,23 @@ static void DumpValue(wpi::raw_ostream& os, const Value& value,
   }
 }
 
+void ServerStorage::MarkPersistentChanged(ServerTopic* topic) {
+  m_persistentChanged = true;
+  if (m_persistentIncremental && !topic->persistentDirty) {
+    topic->persistentDirty = true;
+    m_persistentDirty.emplace_back(topic->name);
+  }
+}
+
+void ServerStorage::ClearPersistentDirty() {
+  for (auto&& name : m_persistentDirty) {
+    if (auto topic = GetTopic(name)) {
+      topic->persistentDirty = false;
+    }
+  }
+  m_persistentDirty.clear();
+}
+
 void ServerStorage::DumpPersistent(wpi::raw_ostream& os) {
   wpi::json::serializer s{os, ' ', 16};
   os << "[\n";
@@ -386,10 +423,154 @@ static std::string* ObjGetString(wpi::json::object_t& obj, std::string_view key,
   return val;
 }
 
+static void DumpPersistentRecord(wpi::raw_ostream& os,
+                                 const ServerTopic* topic) {
+  Writer w;
+  mpack_start_array(&w, 3);
+  mpack_write_str(&w, topic->name);
+  mpack_write_str(&w, topic->typeStr);
+  mpack_write_str(&w, topic->properties.dump());
+  mpack_finish_array(&w);
+  if (mpack_writer_destroy(&w) == mpack_ok) {
+    os << w.bytes;
+    net::WireEncodeBinary(os, 0, 0, topic->lastValue);
+  }
+}
+
+size_t ServerStorage::DumpPersistentBinary(wpi::raw_ostream& os, bool full) {
+  size_t count = 0;
+  if (full) {
+    ClearPersistentDirty();
+    os << kPersistentBinaryHeader;
+    for (const auto& topic : m_topics) {
+      if (topic->persistent && topic->lastValue) {
+        DumpPersistentRecord(os, topic.get());
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  for (auto&& name : m_persistentDirty) {
+    auto topic = GetTopic(name);
+    if (topic) {
+      topic->persistentDirty = false;
+    }
+    if (topic && topic->persistent && topic->lastValue) {
+      DumpPersistentRecord(os, topic);
+    } else {
+      // no longer persistent; write a removal record
+      Writer w;
+      mpack_start_array(&w, 1);
+      mpack_write_str(&w, name);
+      mpack_finish_array(&w);
+      if (mpack_writer_destroy(&w) == mpack_ok) {
+        os << w.bytes;
+      }
+    }
+    ++count;
+  }
+  m_persistentDirty.clear();
+  return count;
+}
+
+std::string ServerStorage::LoadPersistentBinary(std::string_view in) {
+  struct Record {
+    std::string typeStr;
+    wpi::json props;
+    Value value;
+  };
+  // replay records in order; last record for each name wins
+  wpi::StringMap<std::optional<Record>> records;
+
+  std::string allerrors;
+  auto data = std::span{reinterpret_cast<const uint8_t*>(in.data()), in.size()}
+                  .subspan(kPersistentBinaryHeader.size());
+  for (int i = 0; !data.empty(); ++i) {
+    mpack_reader_t reader;
+    mpack_reader_init_data(&reader, reinterpret_cast<const char*>(data.data()),
+                           data.size());
+    auto readStr = [&](std::string* out) {
+      uint32_t len = mpack_expect_str(&reader);
+      const char* str = mpack_read_bytes_inplace(&reader, len);
+      if (mpack_reader_error(&reader) == mpack_ok) {
+        out->assign(str, len);
+      }
+      mpack_done_str(&reader);
+    };
+    std::string name;
+    std::string typeStr;
+    std::string propsStr;
+    uint32_t len = mpack_expect_array_range(&reader, 1, 3);
+    readStr(&name);
+    if (len == 3) {
+      readStr(&typeStr);
+      readStr(&propsStr);
+    } else if (len != 1) {
+      mpack_reader_flag_error(&reader, mpack_error_type);
+    }
+    mpack_done_array(&reader);
+    size_t remaining = mpack_reader_remaining(&reader, nullptr);
+    if (auto err = mpack_reader_destroy(&reader); err != mpack_ok) {
+      // likely a truncated final record from an interrupted save
+      allerrors += fmt::format("{}: {}\n", i, mpack_error_to_string(err));
+      break;
+    }
+    data = wpi::take_back(data, remaining);
+
+    if (len == 1) {
+      records[name].reset();
+      continue;
+    }
+
+    int id;
+    Value value;
+    std::string error;
+    if (!net::WireDecodeBinary(&data, &id, &value, &error, 0)) {
+      allerrors += fmt::format("{}: {}\n", i, error);
+      break;
+    }
+    if (StringToType(typeStr) != value.type()) {
+      allerrors += fmt::format("{}: type '{}' does not match value\n", i,
+                               typeStr);
+      continue;
+    }
+    wpi::json props;
+    try {
+      props = wpi::json::parse(propsStr);
+    } catch (wpi::json::parse_error& err) {
+      allerrors += fmt::format("{}: could not decode properties: {}\n", i,
+                               err.what());
+      continue;
+    }
+    records[name] =
+        Record{std::move(typeStr), std::move(props), std::move(value)};
+  }
+
+  bool persistentChanged = m_persistentChanged;
+  auto time = nt::Now();
+  for (auto&& [name, rec] : records) {
+    if (!rec) {
+      continue;
+    }
+    rec->value.SetTime(time);
+    rec->value.SetServerTime(time);
+    auto topic = CreateTopic(nullptr, name, rec->typeStr, rec->props);
+    SetValue(nullptr, topic, rec->value);
+  }
+  ClearPersistentDirty();
+  m_persistentChanged = persistentChanged;  // restore flag
+
+  return allerrors;
+}
+
 std::string ServerStorage::LoadPersistent(std::string_view in) {
   if (in.empty()) {
     return {};
   }
+  if (IsPersistentBinary(in)) {
+    return LoadPersistentBinary(in);
+  }
 
   wpi::json j;
   try {
@@ -602,6 +783,7 @@ std::string ServerStorage::LoadPersistent(std::string_view in) {
     allerrors += fmt::format("{}: {}\n", i, error);
   }
 
+  ClearPersistentDirty();
   m_persistentChanged = persistentChanged;  // restore flag
 
   return allerrors;
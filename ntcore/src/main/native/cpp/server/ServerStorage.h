@@ -5,14 +5,17 @@
 #pragma once
 
 #include <concepts>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <wpi/StringMap.h>
 #include <wpi/UidVector.h>
 #include <wpi/json_fwd.h>
 
+#include "net/NetworkOutgoingQueue.h"
 #include "server/ServerTopic.h"
 
 namespace wpi {
@@ -24,7 +27,7 @@ namespace nt::server {
 
 class ServerClient;
 
-class ServerStorage final {
+class ServerStorage final : public net::SharedValueEncoder {
  public:
   ServerStorage(wpi::Logger& logger,
                 std::function<void(ServerTopic* topic, ServerClient* client)>
@@ -59,6 +62,8 @@ class ServerStorage final {
     return it->second;
   }
 
+  std::span<const uint8_t> GetEncodedValue(int id, const Value& value) final;
+
   // Approximate upper bound, not exact quantity
   size_t GetNumTopics() const { return m_topics.size(); }
 
@@ -80,9 +85,28 @@ class ServerStorage final {
   }
 
   void DumpPersistent(wpi::raw_ostream& os);
-  // returns newline-separated errors
+  // returns newline-separated errors; accepts either JSON or binary format
   std::string LoadPersistent(std::string_view in);
 
+  // Binary persistent format: kPersistentBinaryHeader followed by a sequence
+  // of MessagePack records, each either [name, type, properties JSON] followed
+  // by a value message (as in WireEncodeBinary), or [name] to remove the
+  // topic. Later records override earlier ones, so saves can be appended.
+  static constexpr std::string_view kPersistentBinaryHeader{"NTPS\x01", 5};
+  static bool IsPersistentBinary(std::string_view in) {
+    return in.starts_with(kPersistentBinaryHeader);
+  }
+
+  // Enables tracking of changed topics for incremental binary dumps.
+  void SetPersistentIncremental(bool enable) {
+    m_persistentIncremental = enable;
+  }
+
+  // Writes records for persistent topics changed since the last dump, or
+  // the header and all persistent topics if full is true.
+  // Returns the number of records written.
+  size_t DumpPersistentBinary(wpi::raw_ostream& os, bool full);
+
  private:
   wpi::Logger& m_logger;
   std::function<void(ServerTopic* topic, ServerClient* client)> m_sendAnnounce;
@@ -90,6 +114,14 @@ class ServerStorage final {
   wpi::UidVector<std::unique_ptr<ServerTopic>, 16> m_topics;
   wpi::StringMap<ServerTopic*> m_nameTopics;
   bool m_persistentChanged{false};
+  bool m_persistentIncremental{false};
+  std::vector<uint8_t> m_encodeScratch;
+  // names of persistent topics changed since the last dump
+  std::vector<std::string> m_persistentDirty;
+
+  void MarkPersistentChanged(ServerTopic* topic);
+  void ClearPersistentDirty();
+  std::string LoadPersistentBinary(std::string_view in);
 };
 
 }  // namespace nt::server
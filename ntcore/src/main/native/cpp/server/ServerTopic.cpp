@@ -4,10 +4,73 @@
 
 #include "ServerTopic.h"
 
+#include <stdint.h>
+
+#include <bit>
+#include <span>
+
+#include <wpi/raw_ostream.h>
+
 #include "Log.h"
+#include "net/WireEncoder.h"
 
+using namespace nt;
 using namespace nt::server;
 
+// true if b is a copy of a (shares the same storage), which is much cheaper
+// to check than full equality
+static bool IsSameValue(const Value& a, const Value& b) {
+  if (a.type() != b.type() || a.time() != b.time() ||
+      a.server_time() != b.server_time()) {
+    return false;
+  }
+  switch (a.type()) {
+    case NT_BOOLEAN:
+      return a.GetBoolean() == b.GetBoolean();
+    case NT_INTEGER:
+      return a.GetInteger() == b.GetInteger();
+    case NT_FLOAT:
+      return std::bit_cast<uint32_t>(a.GetFloat()) ==
+             std::bit_cast<uint32_t>(b.GetFloat());
+    case NT_DOUBLE:
+      return std::bit_cast<uint64_t>(a.GetDouble()) ==
+             std::bit_cast<uint64_t>(b.GetDouble());
+    case NT_STRING:
+      return a.GetString().data() == b.GetString().data() &&
+             a.GetString().size() == b.GetString().size();
+    case NT_RAW:
+      return a.GetRaw().data() == b.GetRaw().data() &&
+             a.GetRaw().size() == b.GetRaw().size();
+    case NT_BOOLEAN_ARRAY:
+      return a.GetBooleanArray().data() == b.GetBooleanArray().data() &&
+             a.GetBooleanArray().size() == b.GetBooleanArray().size();
+    case NT_INTEGER_ARRAY:
+      return a.GetIntegerArray().data() == b.GetIntegerArray().data() &&
+             a.GetIntegerArray().size() == b.GetIntegerArray().size();
+    case NT_FLOAT_ARRAY:
+      return a.GetFloatArray().data() == b.GetFloatArray().data() &&
+             a.GetFloatArray().size() == b.GetFloatArray().size();
+    case NT_DOUBLE_ARRAY:
+      return a.GetDoubleArray().data() == b.GetDoubleArray().data() &&
+             a.GetDoubleArray().size() == b.GetDoubleArray().size();
+    case NT_STRING_ARRAY:
+      return a.GetStringArray().data() == b.GetStringArray().data() &&
+             a.GetStringArray().size() == b.GetStringArray().size();
+    default:
+      return false;
+  }
+}
+
+std::span<const uint8_t> ServerTopic::GetEncodedValue(const Value& value) {
+  if (encodedBytes.empty() || !IsSameValue(value, encodedValue)) {
+    encodedBytes.clear();
+    wpi::raw_uvector_ostream os{encodedBytes};
+    net::WireEncodeBinary(os, id, value.time(), value);
+    encodedValue = value;
+  }
+  return encodedBytes;
+}
+
 bool ServerTopic::SetProperties(const wpi::json& update) {
   if (!update.is_object()) {
     return false;
@@ -31,6 +94,7 @@ void ServerTopic::RefreshProperties() {
   persistent = false;
   retained = false;
   cached = true;
+  delta = false;
 
   auto persistentIt = properties.find("persistent");
   if (persistentIt != properties.end()) {
@@ -53,6 +117,13 @@ void ServerTopic::RefreshProperties() {
     }
   }
 
+  auto deltaIt = properties.find("delta");
+  if (deltaIt != properties.end()) {
+    if (auto val = deltaIt->get_ptr<bool*>()) {
+      delta = *val;
+    }
+  }
+
   if (!cached) {
     lastValue = {};
     lastValueClient = nullptr;
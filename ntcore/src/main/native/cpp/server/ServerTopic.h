@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <wpi/DenseMap.h>
 #include <wpi/SmallPtrSet.h>
@@ -68,6 +72,11 @@ struct ServerTopic {
   void RefreshProperties();
   bool SetFlags(unsigned int flags_);
 
+  // Returns the binary message encoding of value. The encoding of the most
+  // recent value is kept, so sending the same value to multiple clients only
+  // encodes it once.
+  std::span<const uint8_t> GetEncodedValue(const Value& value);
+
   wpi::Logger& m_logger;  // Must be m_logger for WARN macro to work
   std::string name;
   unsigned int id;
@@ -80,6 +89,13 @@ struct ServerTopic {
   bool retained{false};
   bool cached{true};
   bool special{false};
+  // send array values as deltas to clients that support it
+  bool delta{false};
+  // value last encoded by GetEncodedValue(), and its encoding
+  Value encodedValue;
+  std::vector<uint8_t> encodedBytes;
+  // name is in ServerStorage's list of changed persistent topics
+  bool persistentDirty{false};
   int localTopic{0};
 
   void AddPublisher(ServerClient* client, ServerPublisher* pub) {
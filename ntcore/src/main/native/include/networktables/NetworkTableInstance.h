@@ -608,7 +608,9 @@ class NetworkTableInstance final {
    * Starts a server using the specified filename, listening address, and port.
    *
    * @param persist_filename  the name of the persist file to use (UTF-8 string,
-   *                          null terminated)
+   *                          null terminated); if it ends in ".msgpack", a
+   *                          compact binary format with incremental saves is
+   *                          used (existing JSON files are still loaded)
    * @param listen_address    the address to listen on, or null to listen on any
    *                          address (UTF-8 string, null terminated)
    * @param port3             port to communicate over (NT3)
@@ -729,6 +731,21 @@ class NetworkTableInstance final {
    */
   void Flush() const { ::nt::Flush(m_handle); }
 
+  /**
+   * Begins a batch of value updates on the calling thread.  Values set by
+   * publishers and entries of this instance on the calling thread are held
+   * until CommitBatch() and then applied together.
+   */
+  void BeginBatch() const { ::nt::BeginBatch(m_handle); }
+
+  /**
+   * Commits a batch of value updates started by BeginBatch() on the calling
+   * thread.
+   *
+   * @return False if there is no open batch on this thread
+   */
+  bool CommitBatch() const { return ::nt::CommitBatch(m_handle); }
+
   /**
    * Get information on the currently established network connections.
    * If operating as a client, this will return either zero or one values.
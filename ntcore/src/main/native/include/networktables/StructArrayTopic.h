@@ -133,16 +133,11 @@ class StructArraySubscriber : public Subscriber {
       return {0, 0, std::forward<U>(defaultValue)};
     }
     TimestampedValueType rv{view.time, view.serverTime, {}};
-    rv.value.reserve(view.value.size() / size);
-    for (auto in = view.value.begin(), end = view.value.end(); in != end;
-         in += size) {
-      std::apply(
-          [&](const I&... info) {
-            rv.value.emplace_back(S::Unpack(
-                std::span<const uint8_t>{std::to_address(in), size}, info...));
-          },
-          m_info);
-    }
+    std::apply(
+        [&](const I&... info) {
+          wpi::UnpackStructs(&rv.value, view.value, info...);
+        },
+        m_info);
     return rv;
   }
 
@@ -162,16 +157,11 @@ class StructArraySubscriber : public Subscriber {
       return {0, 0, {defaultValue.begin(), defaultValue.end()}};
     }
     TimestampedValueType rv{view.time, view.serverTime, {}};
-    rv.value.reserve(view.value.size() / size);
-    for (auto in = view.value.begin(), end = view.value.end(); in != end;
-         in += size) {
-      std::apply(
-          [&](const I&... info) {
-            rv.value.emplace_back(S::Unpack(
-                std::span<const uint8_t>{std::to_address(in), size}, info...));
-          },
-          m_info);
-    }
+    std::apply(
+        [&](const I&... info) {
+          wpi::UnpackStructs(&rv.value, view.value, info...);
+        },
+        m_info);
     return rv;
   }
 
@@ -196,17 +186,11 @@ class StructArraySubscriber : public Subscriber {
         continue;
       }
       std::vector<T> values;
-      values.reserve(r.value.size() / size);
-      for (auto in = r.value.begin(), end = r.value.end(); in != end;
-           in += size) {
-        std::apply(
-            [&](const I&... info) {
-              values.emplace_back(
-                  S::Unpack(std::span<const uint8_t>{std::to_address(in), size},
-                            info...));
-            },
-            m_info);
-      }
+      std::apply(
+          [&](const I&... info) {
+            wpi::UnpackStructs(&values, r.value, info...);
+          },
+          m_info);
       rv.emplace_back(r.time, r.serverTime, std::move(values));
     }
     return rv;
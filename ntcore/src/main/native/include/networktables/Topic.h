@@ -389,7 +389,12 @@ class Subscriber {
   void anchor();
 };
 
-/** NetworkTables publisher. */
+/**
+ * NetworkTables publisher.
+ *
+ * Values set between NetworkTableInstance::BeginBatch() and CommitBatch() on
+ * the same thread are applied together when the batch is committed.
+ */
 class Publisher {
  public:
   virtual ~Publisher() { ::nt::Release(m_pubHandle); }
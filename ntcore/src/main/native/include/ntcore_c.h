@@ -125,6 +125,12 @@ enum NT_EventFlags {
   NT_EVENT_LOGMESSAGE = 0x100,
   /** Time synchronized with server. */
   NT_EVENT_TIMESYNC = 0x200,
+  /**
+   * Only deliver the latest value.  Combine with NT_EVENT_VALUE_* flags; if a
+   * value event for the same topic has not yet been read from the queue, it is
+   * replaced rather than a new event being queued.
+   */
+  NT_EVENT_VALUE_LATEST = 0x400,
 };
 
 /*
@@ -213,6 +219,61 @@ struct NT_ConnectionInfo {
   unsigned int protocol_version;
 };
 
+/** NetworkTables Connection Traffic Statistics */
+struct NT_NetworkTrafficStats {
+  /**
+   * The remote identifier (as set on the remote node by NT_StartClient4().
+   */
+  struct WPI_String remote_id;
+
+  /** The number of bytes sent to the remote node. */
+  uint64_t sent_bytes;
+
+  /**
+   * The number of bytes held back because the connection's bandwidth limit
+   * (see NT_SetNetworkBandwidthLimit()) was reached.  Deferred bytes are
+   * sent later, so they may also be counted in sent_bytes.
+   */
+  uint64_t deferred_bytes;
+
+  /**
+   * The number of bytes never sent because a newer value replaced a queued
+   * value before it could be sent.
+   */
+  uint64_t dropped_bytes;
+};
+
+/** NetworkTables listener dispatch statistics. */
+struct NT_ListenerStats {
+  /** The number of events read from listener queues. */
+  uint64_t dispatched_events;
+
+  /**
+   * The number of value events replaced by a newer value before being read
+   * (see NT_EVENT_VALUE_LATEST).
+   */
+  uint64_t coalesced_events;
+
+  /** The number of events currently waiting to be read. */
+  uint64_t queue_depth;
+
+  /** The largest number of events read from a queue at once. */
+  uint64_t max_queue_depth;
+
+  /**
+   * The average time, in microseconds, from an event being queued until it is
+   * read, over every dispatched event.  A coalesced value event is timed from
+   * when the event it replaced was queued.
+   */
+  int64_t avg_dispatch_latency;
+
+  /**
+   * The maximum time, in microseconds, from an event being queued until it is
+   * read.
+   */
+  int64_t max_dispatch_latency;
+};
+
 /** NetworkTables value event data. */
 struct NT_ValueEventData {
   /** Topic handle. */
@@ -360,6 +421,23 @@ struct NT_PubSubOptions {
    * will not appear in metatopics.
    */
   NT_Bool hidden;
+
+  /**
+   * For subscriptions, only the latest value is of interest. Enables a
+   * lock-free, allocation-free Get() for boolean, integer, float, and double
+   * subscribers, for reading many topics per loop iteration. Has no effect on
+   * entries.
+   */
+  NT_Bool latestOnly;
+
+  /**
+   * Network send priority. When a connection's bandwidth is limited (see
+   * NT_SetNetworkBandwidthLimit()), value updates for higher priority
+   * publishers and subscriptions are sent before lower priority ones. For
+   * subscriptions, this is the priority the server uses when sending to this
+   * client. The default is 0.
+   */
+  int priority;
 };
 
 /**
@@ -499,6 +577,30 @@ NT_Bool NT_SetDefaultEntryValue(NT_Entry entry,
  */
 NT_Bool NT_SetEntryValue(NT_Entry entry, const struct NT_Value* value);
 
+/**
+ * Begins a batch of value updates on the calling thread.
+ *
+ * Until the matching NT_CommitBatch() call, values set on this instance by the
+ * calling thread are held rather than applied.  NT_CommitBatch() then applies
+ * all of them with a single lock acquisition, wakes listeners once, and
+ * signals the network once.  Set calls made during a batch return true if the
+ * value is non-empty; errors such as type mismatches are silently ignored at
+ * commit.  Batches may be nested; only the outermost NT_CommitBatch() applies
+ * the values.
+ *
+ * @param inst      instance handle
+ */
+void NT_BeginBatch(NT_Inst inst);
+
+/**
+ * Commits a batch of value updates started by NT_BeginBatch() on the calling
+ * thread.
+ *
+ * @param inst      instance handle
+ * @return 0 if there is no open batch on this thread, 1 otherwise
+ */
+NT_Bool NT_CommitBatch(NT_Inst inst);
+
 /**
  * Set Entry Flags.
  *
@@ -969,6 +1071,26 @@ void NT_RemoveListener(NT_Listener listener);
  */
 NT_Bool NT_WaitForListenerQueue(NT_Handle handle, double timeout);
 
+/**
+ * Sets the number of threads used to call listener callbacks.  Callback
+ * listeners are assigned to threads round-robin as they are created, and all
+ * events for a listener are delivered on a single thread, so events for each
+ * listener are still delivered in order.  This only affects listeners created
+ * after this call.  The default is 1.
+ *
+ * @param inst    instance handle
+ * @param count   number of threads (minimum 1)
+ */
+void NT_SetListenerDispatchThreads(NT_Inst inst, int count);
+
+/**
+ * Gets listener dispatch statistics.
+ *
+ * @param inst    instance handle
+ * @param stats   statistics (output)
+ */
+void NT_GetListenerStats(NT_Inst inst, struct NT_ListenerStats* stats);
+
 /**
  * Create a listener for changes to topics with names that start with
  * the given prefix. This creates a corresponding internal subscriber with the
@@ -1116,7 +1238,9 @@ void NT_StopLocal(NT_Inst inst);
  *
  * @param inst              instance handle
  * @param persist_filename  the name of the persist file to use (UTF-8 string,
- *                          null terminated)
+ *                          null terminated); if it ends in ".msgpack", a
+ *                          compact binary format with incremental saves is
+ *                          used (existing JSON files are still loaded)
  * @param listen_address    the address to listen on, or null to listen on any
  *                          address. (UTF-8 string, null terminated)
  * @param port3             port to communicate over (NT3)
@@ -1281,6 +1405,35 @@ NT_Bool NT_IsConnected(NT_Inst inst);
  */
 int64_t NT_GetServerTimeOffset(NT_Inst inst, NT_Bool* valid);
 
+/**
+ * Limits the average rate at which data is sent on each network connection.
+ * When the limit is reached, updates for topics subscribed with a higher
+ * priority (see NT_PubSubOptions.priority) are sent first and the remainder
+ * are deferred to later sends.  The limit applies to each connection
+ * separately and only to NT4 connections.
+ *
+ * @param inst instance handle
+ * @param bytesPerSecond maximum average send rate, in bytes per second; 0
+ *                       (the default) is unlimited
+ */
+void NT_SetNetworkBandwidthLimit(NT_Inst inst, double bytesPerSecond);
+
+/**
+ * Get traffic statistics for the currently established network connections.
+ * Statistics are updated periodically (roughly every 100 ms), and are
+ * cumulative for the lifetime of each connection.
+ *
+ * @param inst  instance handle
+ * @param count returns the number of elements in the array
+ * @return      array of traffic statistics, one per connection (NT3
+ *              connections are not tracked and always report zero)
+ *
+ * It is the caller's responsibility to free the array. The
+ * NT_DisposeNetworkTrafficStatsArray function is useful for this purpose.
+ */
+struct NT_NetworkTrafficStats* NT_GetNetworkTrafficStats(NT_Inst inst,
+                                                         size_t* count);
+
 /** @} */
 
 /**
@@ -1323,6 +1476,15 @@ void NT_DisposeValueArray(struct NT_Value* arr, size_t count);
  */
 void NT_DisposeConnectionInfoArray(struct NT_ConnectionInfo* arr, size_t count);
 
+/**
+ * Disposes a network traffic statistics array.
+ *
+ * @param arr   pointer to the array to dispose
+ * @param count number of elements in the array
+ */
+void NT_DisposeNetworkTrafficStatsArray(struct NT_NetworkTrafficStats* arr,
+                                        size_t count);
+
 /**
  * Disposes a topic info array.
  *
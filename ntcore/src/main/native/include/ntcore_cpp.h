@@ -84,6 +84,12 @@ struct EventFlags {
   static constexpr unsigned int kLogMessage = NT_EVENT_LOGMESSAGE;
   /** Time synchronized with server. */
   static constexpr unsigned int kTimeSync = NT_EVENT_TIMESYNC;
+  /**
+   * Only deliver the latest value.  Combine with kValueRemote, kValueLocal,
+   * or kValueAll; if a value event for the same topic has not yet been read
+   * from the queue, it is replaced rather than a new event being queued.
+   */
+  static constexpr unsigned int kValueLatest = NT_EVENT_VALUE_LATEST;
 };
 
 /** NetworkTables Topic Information */
@@ -152,6 +158,62 @@ struct ConnectionInfo {
   }
 };
 
+/** NetworkTables Connection Traffic Statistics */
+struct NetworkTrafficStats {
+  /**
+   * The remote identifier (as set on the remote node by
+   * NetworkTableInstance::StartClient4() or nt::StartClient4()).
+   */
+  std::string remote_id;
+
+  /** The number of bytes sent to the remote node. */
+  uint64_t sent_bytes{0};
+
+  /**
+   * The number of bytes held back because the connection's bandwidth limit
+   * (see nt::SetNetworkBandwidthLimit()) was reached.  Deferred bytes are
+   * sent later, so they may also be counted in sent_bytes.
+   */
+  uint64_t deferred_bytes{0};
+
+  /**
+   * The number of bytes never sent because a newer value replaced a queued
+   * value before it could be sent.
+   */
+  uint64_t dropped_bytes{0};
+};
+
+/** NetworkTables Listener Dispatch Statistics */
+struct ListenerStats {
+  /** The number of events read from listener queues. */
+  uint64_t dispatched_events{0};
+
+  /**
+   * The number of value events replaced by a newer value before being read
+   * (see EventFlags::kValueLatest).
+   */
+  uint64_t coalesced_events{0};
+
+  /** The number of events currently waiting to be read. */
+  uint64_t queue_depth{0};
+
+  /** The largest number of events read from a queue at once. */
+  uint64_t max_queue_depth{0};
+
+  /**
+   * The average time, in microseconds, from an event being queued until it is
+   * read, over every dispatched event.  A coalesced value event is timed from
+   * when the event it replaced was queued.
+   */
+  int64_t avg_dispatch_latency{0};
+
+  /**
+   * The maximum time, in microseconds, from an event being queued until it is
+   * read.
+   */
+  int64_t max_dispatch_latency{0};
+};
+
 /** NetworkTables Value Event Data */
 class ValueEventData {
  public:
@@ -382,6 +444,23 @@ struct PubSubOptions {
    * will not appear in metatopics.
    */
   bool hidden = false;
+
+  /**
+   * For subscriptions, only the latest value is of interest. Enables a
+   * lock-free, allocation-free Get() for boolean, integer, float, and double
+   * subscribers, for reading many topics per loop iteration. Has no effect on
+   * entries.
+   */
+  bool latestOnly = false;
+
+  /**
+   * Network send priority. When a connection's bandwidth is limited (see
+   * SetNetworkBandwidthLimit()), value updates for higher priority publishers
+   * and subscriptions are sent before lower priority ones. For subscriptions,
+   * this is the priority the server uses when sending to this client. The
+   * default is 0.
+   */
+  int priority = 0;
 };
 
 /**
@@ -510,6 +589,32 @@ bool SetDefaultEntryValue(NT_Entry entry, const Value& value);
  */
 bool SetEntryValue(NT_Entry entry, const Value& value);
 
+/**
+ * Begins a batch of value updates on the calling thread.
+ *
+ * Until the matching CommitBatch() call, values set on this instance by the
+ * calling thread (with SetEntryValue(), the typed Set functions, or Publisher
+ * classes) are held rather than applied.  CommitBatch() then applies all of
+ * them with a single lock acquisition, wakes listeners once, and signals the
+ * network once.  Set calls made during a batch return true if the value is
+ * non-empty; errors such as type mismatches are silently ignored at commit.
+ * Values set during a batch are not visible (even to the calling thread) until
+ * the batch is committed.  Batches may be nested; only the outermost
+ * CommitBatch() applies the values.
+ *
+ * @param inst      instance handle
+ */
+void BeginBatch(NT_Inst inst);
+
+/**
+ * Commits a batch of value updates started by BeginBatch() on the calling
+ * thread.
+ *
+ * @param inst      instance handle
+ * @return False if there is no open batch on this thread, True otherwise
+ */
+bool CommitBatch(NT_Inst inst);
+
 /**
  * Set Entry Flags.
  *
@@ -548,6 +653,22 @@ std::vector<Value> ReadQueueValue(NT_Handle subentry);
  */
 std::vector<Value> ReadQueueValue(NT_Handle subentry, unsigned int types);
 
+/**
+ * Read Entry Queue into a caller-provided buffer.
+ *
+ * Moves new entry values since last call into out, reusing its storage, so
+ * no array is allocated. Values that do not fit remain queued for the next
+ * call.
+ *
+ * @param subentry     subscriber or entry handle
+ * @param out          buffer to fill
+ * @param types        bitmask of NT_Type values; 0 is treated specially
+ *                     as a "don't care"
+ * @return the filled portion of out
+ */
+std::span<Value> ReadQueueValue(NT_Handle subentry, std::span<Value> out,
+                                unsigned int types = 0);
+
 /** @} */
 
 /**
@@ -947,6 +1068,26 @@ void RemoveListener(NT_Listener listener);
  */
 bool WaitForListenerQueue(NT_Handle handle, double timeout);
 
+/**
+ * Sets the number of threads used to call listener callbacks.  Callback
+ * listeners are assigned to threads round-robin as they are created, and all
+ * events for a listener are delivered on a single thread, so events for each
+ * listener are still delivered in order.  This only affects listeners created
+ * after this call.  The default is 1.
+ *
+ * @param inst    instance handle
+ * @param count   number of threads (minimum 1)
+ */
+void SetListenerDispatchThreads(NT_Inst inst, int count);
+
+/**
+ * Gets listener dispatch statistics.
+ *
+ * @param inst    instance handle
+ * @return Statistics
+ */
+ListenerStats GetListenerStats(NT_Inst inst);
+
 /**
  * Create a listener for changes to topics with names that start with any of
  * the given prefixes. This creates a corresponding internal subscriber with the
@@ -1054,7 +1195,9 @@ void StopLocal(NT_Inst inst);
  *
  * @param inst              instance handle
  * @param persist_filename  the name of the persist file to use (UTF-8 string,
- *                          null terminated)
+ *                          null terminated); if it ends in ".msgpack", a
+ *                          compact binary format with incremental saves is
+ *                          used (existing JSON files are still loaded)
  * @param listen_address    the address to listen on, or null to listen on any
  *                          address. (UTF-8 string)
  * @param port3             port to communicate over (NT3)
@@ -1208,6 +1351,30 @@ bool IsConnected(NT_Inst inst);
  */
 std::optional<int64_t> GetServerTimeOffset(NT_Inst inst);
 
+/**
+ * Limits the average rate at which data is sent on each network connection.
+ * When the limit is reached, updates for topics subscribed with a higher
+ * priority (see PubSubOptions::priority) are sent first and the remainder are
+ * deferred to later sends.  The limit applies to each connection separately
+ * and only to NT4 connections.
+ *
+ * @param inst instance handle
+ * @param bytesPerSecond maximum average send rate, in bytes per second; 0
+ *                       (the default) is unlimited
+ */
+void SetNetworkBandwidthLimit(NT_Inst inst, double bytesPerSecond);
+
+/**
+ * Get traffic statistics for the currently established network connections.
+ * Statistics are updated periodically (roughly every 100 ms), and are
+ * cumulative for the lifetime of each connection.
+ *
+ * @param inst  instance handle
+ * @return      array of traffic statistics, one per connection (NT3
+ *              connections are not tracked and always report zero)
+ */
+std::vector<NetworkTrafficStats> GetNetworkTrafficStats(NT_Inst inst);
+
 /** @} */
 
 /**
@@ -0,0 +1,90 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ListenerStorage.h"  // NOLINT(build/include_order)
+
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <wpi/Synchronization.h>
+
+#include "ntcore_c.h"
+
+namespace nt {
+
+class ListenerStorageTest : public ::testing::Test {
+ public:
+  ListenerStorageTest() {
+    listener = storage.AddListener(poller);
+    storage.Activate(listener, NT_EVENT_VALUE_LOCAL);
+  }
+
+  void Notify(double value) {
+    storage.Notify({&listener, 1}, NT_EVENT_VALUE_LOCAL, 0, 0,
+                   Value::MakeDouble(value));
+  }
+
+  bool IsSignaled(double timeout) {
+    bool timedOut = false;
+    return wpi::WaitForObject(poller, timeout, &timedOut) && !timedOut;
+  }
+
+ protected:
+  // handles embed the instance number, and signal objects are global; use an
+  // instance number the other tests don't so the handles don't collide
+  ListenerStorage storage{15};
+  NT_ListenerPoller poller{storage.CreateListenerPoller()};
+  NT_Listener listener;
+};
+
+TEST_F(ListenerStorageTest, NotifyBatch) {
+  storage.BeginNotifyBatch();
+  storage.BeginNotifyBatch();
+  Notify(1.0);
+  Notify(2.0);
+  storage.EndNotifyBatch();
+  EXPECT_FALSE(IsSignaled(0));
+  storage.EndNotifyBatch();
+  EXPECT_TRUE(IsSignaled(0));
+  EXPECT_EQ(storage.ReadListenerQueue(poller).size(), 2u);
+
+  // unbalanced end has no effect
+  storage.EndNotifyBatch();
+  Notify(3.0);
+  EXPECT_TRUE(IsSignaled(0));
+}
+
+TEST_F(ListenerStorageTest, NotifyBatchPerThread) {
+  wpi::Event begun;
+  wpi::Event notify;
+  wpi::Event notified;
+  wpi::Event end;
+  std::thread thr{[&] {
+    storage.BeginNotifyBatch();
+    wpi::SetEvent(begun.GetHandle());
+    wpi::WaitForObject(notify.GetHandle());
+    Notify(1.0);
+    wpi::SetEvent(notified.GetHandle());
+    wpi::WaitForObject(end.GetHandle());
+    storage.EndNotifyBatch();
+  }};
+  ASSERT_TRUE(wpi::WaitForObject(begun.GetHandle(), 1.0, nullptr));
+
+  // another thread's open batch does not defer this thread's notifications,
+  // and this thread can't end it
+  Notify(0.0);
+  EXPECT_TRUE(IsSignaled(0));
+  storage.EndNotifyBatch();
+
+  wpi::SetEvent(notify.GetHandle());
+  ASSERT_TRUE(wpi::WaitForObject(notified.GetHandle(), 1.0, nullptr));
+  EXPECT_FALSE(IsSignaled(0));
+
+  wpi::SetEvent(end.GetHandle());
+  EXPECT_TRUE(IsSignaled(1.0));
+  thr.join();
+  EXPECT_EQ(storage.ReadListenerQueue(poller).size(), 2u);
+}
+
+}  // namespace nt
@@ -2,7 +2,10 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <array>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -22,6 +25,7 @@
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::AnyNumber;
 using ::testing::ElementsAre;
 using ::testing::Field;
 using ::testing::IsEmpty;
@@ -1079,4 +1083,156 @@ TEST_F(LocalStorageTest, ReadQueueInitialRemote) {
   EXPECT_THAT(storage.ReadQueue<double>(subLocal), IsEmpty());
 }
 
+TEST_F(LocalStorageTest, ReadQueueIntoSpan) {
+  EXPECT_CALL(network, ClientPublish(_, _, _, _, _));
+  EXPECT_CALL(network, ClientSubscribe(_, _, _));
+  EXPECT_CALL(network, ClientSetValue(_, _)).Times(3);
+
+  auto pub = storage.Publish(fooTopic, NT_DOUBLE_ARRAY, "double[]", {}, {});
+  auto sub = storage.Subscribe(fooTopic, NT_DOUBLE_ARRAY, "double[]",
+                               {.pollStorage = 10});
+  storage.SetEntryValue(pub, Value::MakeDoubleArray({1.0, 2.0}, 50));
+  storage.SetEntryValue(pub, Value::MakeDoubleArray({3.0}, 60));
+  storage.SetEntryValue(pub, Value::MakeDoubleArray({4.0, 5.0, 6.0}, 70));
+
+  // values that don't fit remain queued
+  std::array<TimestampedDoubleArray, 2> buf;
+  auto vals = storage.ReadQueue<double[]>(sub, buf);
+  ASSERT_EQ(vals.size(), 2u);
+  EXPECT_EQ(vals[0].time, 50);
+  EXPECT_EQ(vals[0].value, (std::vector<double>{1.0, 2.0}));
+  EXPECT_EQ(vals[1].time, 60);
+  EXPECT_EQ(vals[1].value, (std::vector<double>{3.0}));
+
+  // element storage is reused
+  buf[0].value.reserve(4);
+  const double* data = buf[0].value.data();
+  vals = storage.ReadQueue<double[]>(sub, buf);
+  ASSERT_EQ(vals.size(), 1u);
+  EXPECT_EQ(vals[0].time, 70);
+  EXPECT_EQ(vals[0].value, (std::vector<double>{4.0, 5.0, 6.0}));
+  EXPECT_EQ(buf[0].value.data(), data);
+
+  EXPECT_TRUE(storage.ReadQueue<double[]>(sub, buf).empty());
+}
+
+TEST_F(LocalStorageTest, LatestOnlySubscriber) {
+  EXPECT_CALL(network, ClientPublish(_, _, _, _, _));
+  EXPECT_CALL(network, ClientUnpublish(_));
+  EXPECT_CALL(network, ClientSubscribe(_, _, _)).Times(2);
+  EXPECT_CALL(network, ClientUnsubscribe(_));
+  EXPECT_CALL(network, ClientSetValue(_, _)).Times(2);
+
+  auto pub = storage.Publish(fooTopic, NT_DOUBLE, "double", {}, {});
+  storage.SetEntryValue(pub, Value::MakeDouble(1.0, 50));
+
+  // initial value is visible
+  auto sub = storage.Subscribe(fooTopic, NT_DOUBLE, "double",
+                               {.latestOnly = true});
+  auto val = storage.GetAtomic<double>(sub, 0);
+  EXPECT_EQ(val.value, 1.0);
+  EXPECT_EQ(val.time, 50);
+
+  // as are updates, including numeric conversions
+  auto intSub = storage.Subscribe(fooTopic, NT_INTEGER, "int",
+                                  {.latestOnly = true});
+  storage.SetEntryValue(pub, Value::MakeDouble(2.5, 60));
+  val = storage.GetAtomic<double>(sub, 0);
+  EXPECT_EQ(val.value, 2.5);
+  EXPECT_EQ(val.time, 60);
+  EXPECT_EQ(storage.GetAtomic<int64_t>(intSub, 0).value, 2);
+  EXPECT_EQ(storage.GetAtomic<bool>(sub, true).value, true);
+
+  // unpublish clears the value
+  storage.Unpublish(pub);
+  EXPECT_EQ(storage.GetAtomic<double>(sub, 5.0).value, 5.0);
+
+  // released subscribers read as default
+  storage.Unsubscribe(sub);
+  EXPECT_EQ(storage.GetAtomic<double>(sub, 3.0).value, 3.0);
+}
+
+TEST_F(LocalStorageTest, ConcurrentSetDifferentTopics) {
+  EXPECT_CALL(network, ClientPublish(_, _, _, _, _)).Times(3);
+  EXPECT_CALL(network, ClientSubscribe(_, _, _)).Times(3);
+  EXPECT_CALL(network, ClientSetValue(_, _)).Times(AnyNumber());
+
+  NT_Topic topics[] = {fooTopic, barTopic, bazTopic};
+  NT_Publisher pubs[3];
+  NT_Subscriber subs[3];
+  for (int i = 0; i < 3; ++i) {
+    pubs[i] = storage.Publish(topics[i], NT_DOUBLE, "double", {}, {});
+    subs[i] = storage.Subscribe(topics[i], NT_DOUBLE, "double",
+                                {.pollStorage = 1000, .keepDuplicates = true});
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 1; j <= 1000; ++j) {
+        storage.SetEntryValue(pubs[i], Value::MakeDouble(j, j));
+        storage.GetAtomic<double>(subs[i], 0);
+      }
+    });
+  }
+  for (auto&& thr : threads) {
+    thr.join();
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    auto values = storage.ReadQueue<double>(subs[i]);
+    ASSERT_EQ(values.size(), 1000u);
+    EXPECT_EQ(values.back().value, 1000.0);
+    EXPECT_EQ(storage.GetAtomic<double>(subs[i], 0).value, 1000.0);
+  }
+}
+
+TEST_F(LocalStorageTest, BatchSetValues) {
+  EXPECT_CALL(network, ClientPublish(_, _, _, _, _)).Times(2);
+  EXPECT_CALL(network, ClientSubscribe(_, _, _)).Times(2);
+  EXPECT_CALL(listenerStorage, BeginNotifyBatch());
+  EXPECT_CALL(listenerStorage, EndNotifyBatch());
+
+  auto fooPub = storage.Publish(fooTopic, NT_DOUBLE, "double", {}, {});
+  auto barEntry = storage.GetEntry("bar");
+  auto fooSub =
+      storage.Subscribe(fooTopic, NT_DOUBLE, "double", {.pollStorage = 10});
+
+  storage.BeginBatch();
+  storage.BeginBatch();
+  EXPECT_TRUE(storage.SetEntryValue(fooPub, Value::MakeDouble(1.0, 50)));
+  EXPECT_TRUE(storage.SetEntryValue(fooPub, Value::MakeDouble(2.0, 60)));
+  // entry is published at commit
+  EXPECT_TRUE(storage.SetEntryValue(barEntry, Value::MakeInteger(5, 70)));
+
+  // nothing is applied until the outermost commit
+  EXPECT_TRUE(storage.CommitBatch());
+  EXPECT_FALSE(storage.GetEntryValue(fooSub));
+  EXPECT_FALSE(storage.GetEntryValue(barEntry));
+
+  EXPECT_CALL(network, ClientSetValue(_, _)).Times(3);
+  EXPECT_TRUE(storage.CommitBatch());
+  EXPECT_EQ(storage.GetEntryValue(fooSub), Value::MakeDouble(2.0, 60));
+  EXPECT_EQ(storage.GetEntryValue(barEntry), Value::MakeInteger(5, 70));
+  auto values = storage.ReadQueue<double>(fooSub);
+  ASSERT_EQ(values.size(), 2u);
+  EXPECT_EQ(values[0].value, 1.0);
+  EXPECT_EQ(values[1].value, 2.0);
+
+  // no open batch
+  EXPECT_FALSE(storage.CommitBatch());
+}
+
+TEST_F(LocalStorageTest, BatchDestroyedInstance) {
+  std::optional<LocalStorage> other;
+  other.emplace(0, listenerStorage, logger);
+  auto entry = other->GetEntry("foo");
+  other->BeginBatch();
+  EXPECT_TRUE(other->SetEntryValue(entry, Value::MakeDouble(1.0, 50)));
+
+  // a new instance (at the same address) must not see the old open batch
+  other.emplace(0, listenerStorage, logger);
+  EXPECT_FALSE(other->CommitBatch());
+}
+
 }  // namespace nt
@@ -16,6 +16,10 @@ class MockConnectionList : public IConnectionList {
   MOCK_METHOD(int, AddConnection, (const ConnectionInfo& info), (override));
   MOCK_METHOD(void, RemoveConnection, (int handle), (override));
   MOCK_METHOD(void, ClearConnections, (), (override));
+  MOCK_METHOD(void, SetTrafficStats,
+              (int handle, uint64_t sentBytes, uint64_t deferredBytes,
+               uint64_t droppedBytes),
+              (override));
   MOCK_METHOD(std::vector<ConnectionInfo>, GetConnections, (),
               (const, override));
   MOCK_METHOD(bool, IsConnected, (), (const, override));
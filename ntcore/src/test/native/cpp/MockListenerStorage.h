@@ -40,6 +40,8 @@ class MockListenerStorage : public IListenerStorage {
               (std::span<const NT_Listener> handles, unsigned int flags,
                int64_t serverTimeOffset, int64_t rtt2, bool valid),
               (override));
+  MOCK_METHOD(void, BeginNotifyBatch, (), (override));
+  MOCK_METHOD(void, EndNotifyBatch, (), (override));
 };
 
 }  // namespace nt
@@ -28,6 +28,10 @@ bool PubSubOptionsMatcher::MatchAndExplain(
     *listener << "keepDuplicates mismatch ";
     match = false;
   }
+  if (val.priority != good.priority) {
+    *listener << "priority mismatch ";
+    match = false;
+  }
   return match;
 }
 
@@ -7,6 +7,7 @@
 #include <wpi/struct/Struct.h>
 
 #include "networktables/NetworkTableInstance.h"
+#include "networktables/RawTopic.h"
 #include "networktables/StructArrayTopic.h"
 #include "networktables/StructTopic.h"
 
@@ -42,6 +43,12 @@ struct ThingB {
 struct Info1 {
   int info = 0;
 };
+
+struct Packed {
+  int32_t a = 0;
+  int32_t b = 0;
+  double c = 0;
+};
 }  // namespace
 
 template <>
@@ -152,6 +159,34 @@ struct wpi::Struct<ThingB, Info1> {
   }
 };
 
+template <>
+struct wpi::Struct<Packed> {
+  static constexpr bool kTriviallyPackable = true;
+  static constexpr std::string_view GetTypeName() { return "Packed"; }
+  static constexpr size_t GetSize() { return 16; }
+  static constexpr std::string_view GetSchema() {
+    return "int32 a; int32 b; double c";
+  }
+  static Packed Unpack(std::span<const uint8_t> data) {
+    return {wpi::UnpackStruct<int32_t, 0>(data),
+            wpi::UnpackStruct<int32_t, 4>(data),
+            wpi::UnpackStruct<double, 8>(data)};
+  }
+  static void Pack(std::span<uint8_t> data, const Packed& value) {
+    wpi::PackStruct<0>(data, value.a);
+    wpi::PackStruct<4>(data, value.b);
+    wpi::PackStruct<8>(data, value.c);
+  }
+};
+
+static_assert(wpi::TriviallyPackableStruct<Packed>);
+static_assert(wpi::TriviallyPackableStruct<std::array<Packed, 2>>);
+static_assert(wpi::TriviallyPackableStruct<double>);
+static_assert(!wpi::TriviallyPackableStruct<bool>);
+static_assert(!wpi::TriviallyPackableStruct<Inner>);
+static_assert(!wpi::TriviallyPackableStruct<Inner2>);
+static_assert(!wpi::TriviallyPackableStruct<ThingB, Info1>);
+
 namespace nt {
 
 class StructTest : public ::testing::Test {
@@ -447,4 +482,41 @@ TEST_F(StructTest, StructFixedArrayB) {
   entry.Get(arr);
 }
 
+TEST_F(StructTest, StructArrayPacked) {
+  nt::StructArrayTopic<Packed> topic = inst.GetStructArrayTopic<Packed>("p");
+  nt::StructArrayPublisher<Packed> pub = topic.Publish();
+  nt::StructArraySubscriber<Packed> sub = topic.Subscribe({});
+  std::vector<Packed> values{{1, -2, 3.5}, {4, 5, -6.25}};
+  pub.Set(values);
+
+  std::vector<uint8_t> expected(32);
+  for (size_t i = 0; i < values.size(); ++i) {
+    wpi::PackStruct(std::span{expected}.subspan(i * 16), values[i]);
+  }
+  auto raw = inst.GetRawTopic("p").Subscribe("", {});
+  EXPECT_EQ(raw.Get(), expected);
+
+  auto rv = sub.Get();
+  ASSERT_EQ(rv.size(), 2u);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(rv[i].a, values[i].a);
+    EXPECT_EQ(rv[i].b, values[i].b);
+    EXPECT_EQ(rv[i].c, values[i].c);
+  }
+  auto queue = sub.ReadQueue();
+  ASSERT_EQ(queue.size(), 1u);
+  ASSERT_EQ(queue[0].value.size(), 2u);
+  EXPECT_EQ(queue[0].value[1].c, -6.25);
+}
+
+TEST_F(StructTest, StructFixedArrayPacked) {
+  std::array<Packed, 2> arr{{{1, 2, 3}, {4, 5, 6}}};
+  uint8_t buf[32];
+  wpi::PackStruct(buf, arr);
+  EXPECT_EQ(wpi::UnpackStruct<int32_t>(std::span{buf}.subspan(16)), 4);
+  auto unpacked = wpi::UnpackStruct<std::array<Packed, 2>>(buf);
+  EXPECT_EQ(unpacked[0].b, 2);
+  EXPECT_EQ(unpacked[1].c, 6);
+}
+
 }  // namespace nt
@@ -156,7 +156,8 @@ void PrintTo(const PubSubOptionsImpl& options, std::ostream* os) {
   *os << "PubSubOptions{periodicMs=" << options.periodicMs
       << ", pollStorage=" << options.pollStorage
       << ", sendAll=" << options.sendAll
-      << ", keepDuplicates=" << options.keepDuplicates << '}';
+      << ", keepDuplicates=" << options.keepDuplicates
+      << ", priority=" << options.priority << '}';
 }
 
 }  // namespace nt
@@ -2,9 +2,13 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <atomic>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <wpi/StringExtras.h>
 #include <wpi/Synchronization.h>
+#include <wpi/timestamp.h>
 
 #include "TestPrinters.h"
 #include "ValueMatcher.h"
@@ -406,4 +410,117 @@ TEST_F(ValueListenerTest, TwoSubOneMultiListener) {
   EXPECT_EQ(valueData->value, nt::Value::MakeDouble(0.0));
 }
 
+TEST_F(ValueListenerTest, PollLatest) {
+  auto topic1 = nt::GetTopic(m_inst, "foo");
+  auto topic2 = nt::GetTopic(m_inst, "bar");
+  auto pub1 = nt::Publish(topic1, NT_DOUBLE, "double");
+  auto pub2 = nt::Publish(topic2, NT_DOUBLE, "double");
+  auto sub = nt::SubscribeMultiple(m_inst, {{""}});
+
+  auto poller = nt::CreateListenerPoller(m_inst);
+  auto h = nt::AddPolledListener(
+      poller, sub, nt::EventFlags::kValueLocal | nt::EventFlags::kValueLatest);
+
+  nt::SetDouble(pub1, 0);
+  nt::SetDouble(pub2, 1);
+  nt::SetDouble(pub1, 2);
+  nt::SetDouble(pub1, 3);
+
+  bool timedOut = false;
+  ASSERT_TRUE(wpi::WaitForObject(poller, 1.0, &timedOut));
+  ASSERT_FALSE(timedOut);
+  auto results = nt::ReadListenerQueue(poller);
+
+  // only the latest value of each topic, in order of first update
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0].listener, h);
+  auto valueData = results[0].GetValueEventData();
+  ASSERT_TRUE(valueData);
+  EXPECT_EQ(valueData->topic, topic1);
+  EXPECT_EQ(valueData->value, nt::Value::MakeDouble(3.0));
+  valueData = results[1].GetValueEventData();
+  ASSERT_TRUE(valueData);
+  EXPECT_EQ(valueData->topic, topic2);
+  EXPECT_EQ(valueData->value, nt::Value::MakeDouble(1.0));
+
+  auto stats = nt::GetListenerStats(m_inst);
+  EXPECT_EQ(stats.dispatched_events, 2u);
+  EXPECT_EQ(stats.coalesced_events, 2u);
+  EXPECT_EQ(stats.queue_depth, 0u);
+  EXPECT_EQ(stats.max_queue_depth, 2u);
+
+  // once read, the next value is queued again
+  nt::SetDouble(pub1, 4);
+  results = nt::ReadListenerQueue(poller);
+  ASSERT_EQ(results.size(), 1u);
+  valueData = results[0].GetValueEventData();
+  ASSERT_TRUE(valueData);
+  EXPECT_EQ(valueData->value, nt::Value::MakeDouble(4.0));
+}
+
+static uint64_t gFakeNow;
+
+TEST_F(ValueListenerTest, DispatchLatency) {
+  auto topic = nt::GetTopic(m_inst, "foo");
+  auto pub = nt::Publish(topic, NT_DOUBLE, "double");
+  auto sub = nt::Subscribe(topic, NT_DOUBLE, "double");
+  auto poller = nt::CreateListenerPoller(m_inst);
+  nt::AddPolledListener(poller, sub, nt::EventFlags::kValueLocal);
+
+  wpi::SetNowImpl([] { return gFakeNow; });
+  gFakeNow = 1000;
+  nt::SetDouble(pub, 1, 1);
+  gFakeNow = 1200;
+  nt::SetDouble(pub, 2, 2);
+  gFakeNow = 1300;
+  auto results = nt::ReadListenerQueue(poller);
+  wpi::SetNowImpl(nullptr);
+  ASSERT_EQ(results.size(), 2u);
+
+  // every event is timed, not only the oldest
+  auto stats = nt::GetListenerStats(m_inst);
+  EXPECT_EQ(stats.dispatched_events, 2u);
+  EXPECT_EQ(stats.avg_dispatch_latency, 200);
+  EXPECT_EQ(stats.max_dispatch_latency, 300);
+}
+
+TEST_F(ValueListenerTest, ThreadedDispatch) {
+  nt::SetListenerDispatchThreads(m_inst, 4);
+
+  constexpr int kNumTopics = 8;
+  constexpr int kNumValues = 100;
+  std::vector<NT_Publisher> pubs;
+  std::vector<std::vector<int64_t>> received(kNumTopics);
+  std::atomic_int count{0};
+  for (int i = 0; i < kNumTopics; ++i) {
+    auto topic = nt::GetTopic(m_inst, fmt::format("foo{}", i));
+    pubs.emplace_back(nt::Publish(topic, NT_INTEGER, "int"));
+    nt::AddListener(topic, nt::EventFlags::kValueLocal,
+                    [&received, &count, i](const nt::Event& event) {
+                      if (auto valueData = event.GetValueEventData()) {
+                        received[i].emplace_back(
+                            valueData->value.GetInteger());
+                        ++count;
+                      }
+                    });
+  }
+
+  for (int j = 0; j < kNumValues; ++j) {
+    for (auto pub : pubs) {
+      nt::SetInteger(pub, j);
+    }
+  }
+
+  ASSERT_TRUE(nt::WaitForListenerQueue(m_inst, 1.0));
+  ASSERT_EQ(count, kNumTopics * kNumValues);
+
+  // each listener sees its events in order
+  for (auto&& values : received) {
+    ASSERT_EQ(values.size(), static_cast<size_t>(kNumValues));
+    for (int j = 0; j < kNumValues; ++j) {
+      EXPECT_EQ(values[j], j);
+    }
+  }
+}
+
 }  // namespace nt
@@ -0,0 +1,107 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../TestPrinters.h"
+#include "MockWireConnection.h"
+#include "gmock/gmock.h"
+#include "net/Message.h"
+#include "net/NetworkOutgoingQueue.h"
+#include "networktables/NetworkTableValue.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace nt {
+
+class NetworkOutgoingQueueTest : public ::testing::Test {
+ public:
+  NetworkOutgoingQueueTest() {
+    EXPECT_CALL(wire, Ready()).WillRepeatedly(Return(true));
+    EXPECT_CALL(wire, Flush()).WillRepeatedly(Return(0));
+    EXPECT_CALL(wire, DoWriteBinary(_))
+        .WillRepeatedly(Invoke([this](std::span<const uint8_t> data) {
+          // value messages are a 4-element array starting with the id
+          EXPECT_GE(data.size(), 2u);
+          EXPECT_EQ(data[0], 0x94);
+          sentIds.emplace_back(data[1]);
+          return 0;
+        }));
+  }
+
+  static Value MakeValue(size_t size, int64_t time) {
+    return Value::MakeRaw(std::vector<uint8_t>(size), time);
+  }
+
+  ::testing::StrictMock<net::MockWireConnection> wire;
+  net::NetworkOutgoingQueue<net::ClientMessage> queue{wire, false};
+  std::vector<int> sentIds;
+};
+
+TEST_F(NetworkOutgoingQueueTest, Unlimited) {
+  queue.SetPeriod(1, 100, 10);
+  queue.SetPeriod(2, 100, 0);
+  queue.SendValue(2, MakeValue(1000, 1), net::ValueSendMode::kNormal);
+  queue.SendValue(1, MakeValue(1000, 1), net::ValueSendMode::kNormal);
+  queue.SendOutgoing(1000, false);
+  EXPECT_EQ(sentIds, (std::vector<int>{1, 2}));
+  EXPECT_EQ(queue.GetStats().deferredBytes, 0u);
+}
+
+TEST_F(NetworkOutgoingQueueTest, BandwidthLimitPriority) {
+  // 10 bytes/ms; the bucket holds 1500 bytes
+  queue.SetBandwidthLimit(10000);
+  queue.SetPeriod(1, 100, 10);  // high priority
+  queue.SetPeriod(2, 100, 0);   // low priority
+
+  // the high priority value uses up the budget, so the low priority value
+  // (queued first) is deferred
+  queue.SendValue(2, MakeValue(1000, 1), net::ValueSendMode::kNormal);
+  queue.SendValue(1, MakeValue(1600, 1), net::ValueSendMode::kNormal);
+  queue.SendOutgoing(1000, false);
+  EXPECT_EQ(sentIds, (std::vector<int>{1}));
+  EXPECT_GE(queue.GetStats().deferredBytes, 1000u);
+
+  // still over budget shortly after
+  sentIds.clear();
+  queue.SendOutgoing(1005, false);
+  EXPECT_TRUE(sentIds.empty());
+
+  // after the bucket refills, a new high priority value still goes first,
+  // followed by the deferred low priority value
+  queue.SendValue(1, MakeValue(100, 2), net::ValueSendMode::kNormal);
+  queue.SendOutgoing(1100, false);
+  EXPECT_EQ(sentIds, (std::vector<int>{1, 2}));
+
+  // nothing left
+  sentIds.clear();
+  queue.SendOutgoing(1300, true);
+  EXPECT_TRUE(sentIds.empty());
+}
+
+TEST_F(NetworkOutgoingQueueTest, BandwidthLimitCoalesce) {
+  queue.SetBandwidthLimit(10000);
+  queue.SetPeriod(1, 100, 10);
+  queue.SetPeriod(2, 100, 0);
+  queue.SendValue(1, MakeValue(1600, 1), net::ValueSendMode::kNormal);
+  queue.SendValue(2, MakeValue(1000, 1), net::ValueSendMode::kNormal);
+  queue.SendOutgoing(1000, false);
+  EXPECT_EQ(sentIds, (std::vector<int>{1}));
+
+  // a newer value replaces the deferred one, so only one is sent
+  queue.SendValue(2, MakeValue(1000, 2), net::ValueSendMode::kNormal);
+  EXPECT_GE(queue.GetStats().droppedBytes, 1000u);
+  sentIds.clear();
+  queue.SendOutgoing(1200, false);
+  EXPECT_EQ(sentIds, (std::vector<int>{2}));
+}
+
+}  // namespace nt
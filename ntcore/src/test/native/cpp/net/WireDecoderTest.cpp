@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 #include <wpi/SmallString.h>
+#include <wpi/SpanMatcher.h>
 #include <wpi/raw_ostream.h>
 
 #include "../MockLogger.h"
@@ -20,6 +21,7 @@
 
 using namespace std::string_view_literals;
 using testing::_;
+using testing::ElementsAre;
 using testing::MockFunction;
 using testing::StrictMock;
 
@@ -192,4 +194,108 @@ TEST_F(WireDecodeTextClientTest, UnpublishError) {
       logger);
 }
 
+TEST_F(WireDecodeTextClientTest, ParamsBeforeMethod) {
+  EXPECT_CALL(handler, ClientUnpublish(5));
+  net::WireDecodeText(
+      "[{\"params\":{\"extra\":[{}],\"pubuid\":5},\"method\":\"unpublish\"}]",
+      handler, logger);
+}
+
+TEST_F(WireDecodeTextClientTest, Subscribe) {
+  PubSubOptionsImpl options;
+  options.periodic = 0.5;
+  options.periodicMs = 500;
+  options.prefixMatch = true;
+  EXPECT_CALL(handler, ClientSubscribe(3, ElementsAre("a", "b"),
+                                       PubSubOptionsEq(options)));
+  net::WireDecodeText(
+      "[{\"method\":\"subscribe\",\"params\":{\"options\":{"
+      "\"periodic\":0.5,\"prefix\":true},\"subuid\":3,"
+      "\"topics\":[\"a\",\"b\"]}}]",
+      handler, logger);
+}
+
+TEST_F(WireDecodeTextClientTest, SubscribePriority) {
+  PubSubOptionsImpl options;
+  options.priority = -3;
+  EXPECT_CALL(handler, ClientSubscribe(3, ElementsAre("a"),
+                                       PubSubOptionsEq(options)));
+  net::WireDecodeText(
+      "[{\"method\":\"subscribe\",\"params\":{\"options\":{"
+      "\"priority\":-3},\"subuid\":3,\"topics\":[\"a\"]}}]",
+      handler, logger);
+}
+
+TEST_F(WireDecodeTextClientTest, SubscribeError) {
+  EXPECT_CALL(logger, Call(_, _, _, "0: topics/1 must be a string"sv));
+  net::WireDecodeText(
+      "[{\"method\":\"subscribe\",\"params\":{\"subuid\":3,"
+      "\"topics\":[\"a\",5]}}]",
+      handler, logger);
+
+  EXPECT_CALL(logger, Call(_, _, _, "0: all value must be a boolean"sv));
+  net::WireDecodeText(
+      "[{\"method\":\"subscribe\",\"params\":{\"options\":{\"all\":1},"
+      "\"subuid\":3,\"topics\":[]}}]",
+      handler, logger);
+}
+
+TEST_F(WireDecodeTextServerTest, Announce) {
+  wpi::json props = {{"persistent", true}, {"x", {1, {{"y", nullptr}}}}};
+  EXPECT_CALL(handler, ServerAnnounce(std::string_view{"test"}, 5,
+                                      std::string_view{"double"}, props,
+                                      std::optional<int>{2}));
+  EXPECT_CALL(handler, ServerAnnounce(std::string_view{"test2"}, 6,
+                                      std::string_view{"int"},
+                                      wpi::json::object(),
+                                      std::optional<int>{}));
+  net::WireDecodeText(
+      "[{\"method\":\"announce\",\"params\":{\"id\":5,\"name\":\"test\","
+      "\"properties\":{\"persistent\":true,\"x\":[1,{\"y\":null}]},"
+      "\"pubuid\":2,\"type\":\"double\"}},"
+      "{\"method\":\"announce\",\"params\":{\"id\":6,\"name\":\"test2\","
+      "\"properties\":{},\"type\":\"int\"}}]",
+      handler, logger);
+}
+
+TEST(WireDecodeBinaryTest, ArrayDelta) {
+  auto base = Value::MakeIntegerArray({0, 1, 2, 3, 4, 5});
+  auto data = "\x94\x05\x06\x32\x95\x07\x01\x92\x0a\x0b\x06\x91\x0c"_us;
+  int id;
+  Value value;
+  std::string error;
+  ASSERT_TRUE(net::WireDecodeBinary(
+      &data, &id, &value, &error, 0,
+      [&](int id) -> const Value* { return id == 5 ? &base : nullptr; }))
+      << error;
+  EXPECT_EQ(id, 5);
+  EXPECT_EQ(value, Value::MakeIntegerArray({0, 10, 11, 3, 4, 5, 12}));
+  EXPECT_TRUE(data.empty());
+}
+
+TEST(WireDecodeBinaryTest, ArrayDeltaErrors) {
+  int id;
+  Value value;
+  std::string error;
+
+  // no previous value
+  auto data = "\x94\x05\x06\x32\x91\x00"_us;
+  ASSERT_FALSE(net::WireDecodeBinary(&data, &id, &value, &error, 0));
+  EXPECT_EQ(error, "delta for id 5 without previous value");
+
+  // previous value of the wrong type
+  auto base = Value::MakeDoubleArray({1, 2});
+  auto getBase = [&](int) -> const Value* { return &base; };
+  ASSERT_FALSE(net::WireDecodeBinary(&data, &id, &value, &error, 0, getBase));
+
+  // range past the new length
+  base = Value::MakeIntegerArray({1, 2});
+  data = "\x94\x05\x06\x32\x93\x02\x01\x92\x03\x04"_us;
+  ASSERT_FALSE(net::WireDecodeBinary(&data, &id, &value, &error, 0, getBase));
+
+  // new elements not covered by a range
+  data = "\x94\x05\x06\x32\x91\x03"_us;
+  ASSERT_FALSE(net::WireDecodeBinary(&data, &id, &value, &error, 0, getBase));
+}
+
 }  // namespace nt
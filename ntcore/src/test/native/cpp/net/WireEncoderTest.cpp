@@ -2,6 +2,7 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <numeric>
 #include <span>
 #include <string>
 #include <string_view>
@@ -107,6 +108,17 @@ TEST_F(WireEncoderTextTest, SubscribeAllOptions) {
             "\"topics\":[\"a\",\"b\"],\"subuid\":5}}");
 }
 
+TEST_F(WireEncoderTextTest, SubscribePriority) {
+  PubSubOptionsImpl options;
+  options.priority = 2;
+  net::WireEncodeSubscribe(os, 5, std::span<const std::string_view>{{"a", "b"}},
+                           options);
+  ASSERT_EQ(os.str(),
+            "{\"method\":\"subscribe\",\"params\":{"
+            "\"options\":{\"priority\":2},\"topics\":[\"a\",\"b\"],"
+            "\"subuid\":5}}");
+}
+
 TEST_F(WireEncoderTextTest, Unsubscribe) {
   net::WireEncodeUnsubscribe(os, 5);
   ASSERT_EQ(os.str(), "{\"method\":\"unsubscribe\",\"params\":{\"subuid\":5}}");
@@ -286,4 +298,27 @@ TEST_F(WireEncoderBinaryTest, StringArray) {
                                "bye"_us));
 }
 
+TEST_F(WireEncoderBinaryTest, IntegerArrayDelta) {
+  std::vector<int64_t> prev(20);
+  std::iota(prev.begin(), prev.end(), 0);
+  auto cur = prev;
+  cur[3] = 100;
+  cur.push_back(20);
+  ASSERT_TRUE(net::WireEncodeBinaryDelta(
+      os, 5, 6, Value::MakeIntegerArray(cur), Value::MakeIntegerArray(prev)));
+  ASSERT_THAT(out, wpi::SpanEq("\x94\x05\x06\x32\x95\x15"
+                               "\x03\x91\x64"
+                               "\x14\x91\x14"_us));
+}
+
+TEST_F(WireEncoderBinaryTest, ArrayDeltaNotSmaller) {
+  ASSERT_FALSE(net::WireEncodeBinaryDelta(os, 5, 6,
+                                          Value::MakeDoubleArray({1, 2, 3}),
+                                          Value::MakeDoubleArray({4, 5, 6})));
+  ASSERT_FALSE(net::WireEncodeBinaryDelta(os, 5, 6,
+                                          Value::MakeDoubleArray({1, 2, 3}),
+                                          Value::MakeIntegerArray({1, 2, 3})));
+  ASSERT_TRUE(out.empty());
+}
+
 }  // namespace nt
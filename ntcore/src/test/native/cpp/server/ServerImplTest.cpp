@@ -12,6 +12,8 @@
 
 #include <gtest/gtest.h>
 #include <wpi/SpanMatcher.h>
+#include <wpi/json.h>
+#include <wpi/raw_ostream.h>
 
 #include "../MockLogger.h"
 #include "../PubSubOptionsMatcher.h"
@@ -27,9 +29,11 @@
 #include "ntcore_c.h"
 #include "ntcore_cpp.h"
 #include "server/ServerImpl.h"
+#include "server/ServerTopic.h"
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::AnyNumber;
 using ::testing::ElementsAre;
 using ::testing::Field;
 using ::testing::IsEmpty;
@@ -423,4 +427,93 @@ TEST_F(ServerImplTest, ZeroTimestampNegativeTime) {
   }
 }
 
+TEST_F(ServerImplTest, PersistentBinaryIncremental) {
+  server.SetLocal(&local, &queue);
+  server.SetPersistentIncremental(true);
+  EXPECT_CALL(local, ServerAnnounce(_, _, _, _, _)).Times(AnyNumber());
+  EXPECT_CALL(local, ServerPropertiesUpdate(_, _, _)).Times(AnyNumber());
+
+  wpi::json props = {{"persistent", true}};
+  queue.msgs.emplace_back(
+      net::ClientMessage{net::PublishMsg{1, "a", "double", props, {}}});
+  queue.msgs.emplace_back(
+      net::ClientMessage{net::PublishMsg{2, "b", "string", props, {}}});
+  queue.msgs.emplace_back(
+      net::ClientMessage{net::ClientValueMsg{1, Value::MakeDouble(1.0, 10)}});
+  queue.msgs.emplace_back(
+      net::ClientMessage{net::ClientValueMsg{2, Value::MakeString("x", 10)}});
+  EXPECT_FALSE(server.ProcessLocalMessages(UINT_MAX));
+  EXPECT_TRUE(server.PersistentChanged());
+
+  size_t count;
+  std::string full = server.DumpPersistentBinary(true, &count);
+  EXPECT_EQ(count, 2u);
+  EXPECT_TRUE(server.DumpPersistentBinary(false, &count).empty());
+  EXPECT_EQ(count, 0u);
+
+  // only the changed topic is appended
+  queue.msgs.emplace_back(
+      net::ClientMessage{net::ClientValueMsg{1, Value::MakeDouble(2.0, 20)}});
+  EXPECT_FALSE(server.ProcessLocalMessages(UINT_MAX));
+  std::string update = server.DumpPersistentBinary(false, &count);
+  EXPECT_EQ(count, 1u);
+
+  // removing persistence appends a removal record
+  queue.msgs.emplace_back(net::ClientMessage{
+      net::SetPropertiesMsg{"b", {{"persistent", wpi::json::object()}}}});
+  EXPECT_FALSE(server.ProcessLocalMessages(UINT_MAX));
+  std::string removal = server.DumpPersistentBinary(false, &count);
+  EXPECT_EQ(count, 1u);
+
+  // replaying the records gives the same result as a JSON dump
+  server::ServerImpl server2{logger};
+  EXPECT_EQ(server2.LoadPersistent(full + update + removal), "");
+  EXPECT_EQ(server2.DumpPersistent(), server.DumpPersistent());
+
+  // a truncated final record is reported but earlier records are kept
+  server::ServerImpl server3{logger};
+  server::ServerImpl server4{logger};
+  EXPECT_NE(server3.LoadPersistent(full + update.substr(0, update.size() - 1)),
+            "");
+  EXPECT_EQ(server4.LoadPersistent(full), "");
+  EXPECT_EQ(server3.DumpPersistent(), server4.DumpPersistent());
+
+  // a record whose type string does not match its value is skipped
+  std::string mismatched = full;
+  auto pos = mismatched.find("\xa6" "double");
+  ASSERT_NE(pos, std::string::npos);
+  mismatched.replace(pos + 1, 6, "string");
+  server::ServerImpl server5{logger};
+  EXPECT_NE(server5.LoadPersistent(mismatched), "");
+  auto dump = wpi::json::parse(server5.DumpPersistent());
+  ASSERT_EQ(dump.size(), 1u);
+  EXPECT_EQ(dump[0]["name"], "b");
+}
+
+TEST_F(ServerImplTest, TopicEncodedValueShared) {
+  server::ServerTopic topic{logger, "a", "double[]"};
+  topic.id = 5;
+  auto value = Value::MakeDoubleArray({1.0, 2.0, 3.0}, 10);
+  std::vector<uint8_t> expected;
+  wpi::raw_uvector_ostream os{expected};
+  net::WireEncodeBinary(os, 5, 10, value);
+
+  // copies of the same value share one encoding
+  auto encoded = topic.GetEncodedValue(value);
+  EXPECT_THAT(encoded, wpi::SpanEq(std::span<const uint8_t>{expected}));
+  Value copy = value;
+  EXPECT_EQ(topic.GetEncodedValue(copy).data(), encoded.data());
+
+  // an equal but distinct value is encoded again with the same result
+  auto value2 = Value::MakeDoubleArray({1.0, 2.0, 3.0}, 10);
+  EXPECT_THAT(topic.GetEncodedValue(value2),
+              wpi::SpanEq(std::span<const uint8_t>{expected}));
+
+  auto value3 = Value::MakeDoubleArray({4.0}, 20);
+  expected.clear();
+  net::WireEncodeBinary(os, 5, 20, value3);
+  EXPECT_THAT(topic.GetEncodedValue(value3),
+              wpi::SpanEq(std::span<const uint8_t>{expected}));
+}
+
 }  // namespace nt
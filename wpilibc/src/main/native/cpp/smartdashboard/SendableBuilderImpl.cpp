@@ -4,8 +4,11 @@
 
 #include "frc/smartdashboard/SendableBuilderImpl.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include <networktables/BooleanArrayTopic.h>
@@ -28,13 +31,37 @@ template <typename Topic>
 void SendableBuilderImpl::PropertyImpl<Topic>::Update(bool controllable,
                                                       int64_t time) {
   if (controllable && sub && updateLocal) {
-    updateLocal(sub);
+    // republish even if unchanged, as the network value was overwritten
+    if (updateLocal(sub)) {
+      hasLastValue = false;
+    }
   }
-  if (pub && updateNetwork) {
-    updateNetwork(pub, time);
+  if (pub && updateNetwork && time >= nextUpdate) {
+    nextUpdate = time + period;
+    updateNetwork(*this, time);
   }
 }
 
+template <typename Topic>
+template <typename T>
+void SendableBuilderImpl::PropertyImpl<Topic>::Publish(const T& value,
+                                                       int64_t time) {
+  // reuse the last value storage so steady-state updates don't allocate
+  if constexpr (std::is_arithmetic_v<T>) {
+    if (hasLastValue && lastValue == value) {
+      return;
+    }
+    lastValue = value;
+  } else {
+    if (hasLastValue && std::ranges::equal(lastValue, value)) {
+      return;
+    }
+    lastValue.assign(std::begin(value), std::end(value));
+  }
+  hasLastValue = true;
+  pub.Set(value, time);
+}
+
 void SendableBuilderImpl::SetTable(std::shared_ptr<nt::NetworkTable> table) {
   m_table = table;
   m_controllablePublisher = table->GetBooleanTopic(".controllable").Publish();
@@ -123,23 +150,37 @@ nt::Topic SendableBuilderImpl::GetTopic(std::string_view key) {
   return m_table->GetTopic(key);
 }
 
+void SendableBuilderImpl::SetUpdatePeriod(std::string_view key,
+                                          double period) {
+  NT_Topic topic = m_table->GetTopic(key).GetHandle();
+  for (auto&& property : m_properties) {
+    if (property->topic == topic) {
+      property->period = std::llround(period * 1e6);
+      property->nextUpdate = 0;
+    }
+  }
+}
+
 template <typename Topic, typename Getter, typename Setter>
 void SendableBuilderImpl::AddPropertyImpl(Topic topic, Getter getter,
                                           Setter setter) {
   auto prop = std::make_unique<PropertyImpl<Topic>>();
+  prop->topic = topic.GetHandle();
   if (getter) {
     prop->pub = topic.Publish();
-    prop->updateNetwork = [=](auto& pub, int64_t time) {
-      pub.Set(getter(), time);
+    prop->updateNetwork = [=](auto& property, int64_t time) {
+      property.Publish(getter(), time);
     };
   }
   if (setter) {
     prop->sub =
         topic.Subscribe({}, {.excludePublisher = prop->pub.GetHandle()});
     prop->updateLocal = [=](auto& sub) {
-      for (auto&& val : sub.ReadQueue()) {
+      auto values = sub.ReadQueue();
+      for (auto&& val : values) {
         setter(val.value);
       }
+      return !values.empty();
     };
   }
   m_properties.emplace_back(std::move(prop));
@@ -278,19 +319,22 @@ void SendableBuilderImpl::AddRawProperty(
     std::function<void(std::span<const uint8_t>)> setter) {
   auto topic = m_table->GetRawTopic(key);
   auto prop = std::make_unique<PropertyImpl<nt::RawTopic>>();
+  prop->topic = topic.GetHandle();
   if (getter) {
     prop->pub = topic.Publish(typeString);
-    prop->updateNetwork = [=](auto& pub, int64_t time) {
-      pub.Set(getter(), time);
+    prop->updateNetwork = [=](auto& property, int64_t time) {
+      property.Publish(getter(), time);
     };
   }
   if (setter) {
     prop->sub = topic.Subscribe(typeString, {},
                                 {.excludePublisher = prop->pub.GetHandle()});
     prop->updateLocal = [=](auto& sub) {
-      for (auto&& val : sub.ReadQueue()) {
+      auto values = sub.ReadQueue();
+      for (auto&& val : values) {
         setter(val.value);
       }
+      return !values.empty();
     };
   }
   m_properties.emplace_back(std::move(prop));
@@ -311,20 +355,23 @@ template <typename T, size_t Size, typename Topic, typename Getter,
 void SendableBuilderImpl::AddSmallPropertyImpl(Topic topic, Getter getter,
                                                Setter setter) {
   auto prop = std::make_unique<PropertyImpl<Topic>>();
+  prop->topic = topic.GetHandle();
   if (getter) {
     prop->pub = topic.Publish();
-    prop->updateNetwork = [=](auto& pub, int64_t time) {
+    prop->updateNetwork = [=](auto& property, int64_t time) {
       wpi::SmallVector<T, Size> buf;
-      pub.Set(getter(buf), time);
+      property.Publish(getter(buf), time);
     };
   }
   if (setter) {
     prop->sub =
         topic.Subscribe({}, {.excludePublisher = prop->pub.GetHandle()});
     prop->updateLocal = [=](auto& sub) {
-      for (auto&& val : sub.ReadQueue()) {
+      auto values = sub.ReadQueue();
+      for (auto&& val : values) {
         setter(val.value);
       }
+      return !values.empty();
     };
   }
   m_properties.emplace_back(std::move(prop));
@@ -390,20 +437,23 @@ void SendableBuilderImpl::AddSmallRawProperty(
     std::function<void(std::span<const uint8_t>)> setter) {
   auto topic = m_table->GetRawTopic(key);
   auto prop = std::make_unique<PropertyImpl<nt::RawTopic>>();
+  prop->topic = topic.GetHandle();
   if (getter) {
     prop->pub = topic.Publish(typeString);
-    prop->updateNetwork = [=](auto& pub, int64_t time) {
+    prop->updateNetwork = [=](auto& property, int64_t time) {
       wpi::SmallVector<uint8_t, 128> buf;
-      pub.Set(getter(buf), time);
+      property.Publish(getter(buf), time);
     };
   }
   if (setter) {
     prop->sub = topic.Subscribe(typeString, {},
                                 {.excludePublisher = prop->pub.GetHandle()});
     prop->updateLocal = [=](auto& sub) {
-      for (auto&& val : sub.ReadQueue()) {
+      auto values = sub.ReadQueue();
+      for (auto&& val : values) {
         setter(val.value);
       }
+      return !values.empty();
     };
   }
   m_properties.emplace_back(std::move(prop));
@@ -12,6 +12,7 @@
 #include <hal/FRCUsageReporting.h>
 #include <networktables/NetworkTable.h>
 #include <networktables/NetworkTableInstance.h>
+#include <wpi/SmallVector.h>
 #include <wpi/StringMap.h>
 #include <wpi/mutex.h>
 #include <wpi/sendable/SendableRegistry.h>
@@ -252,8 +253,12 @@ void SmartDashboard::PostListenerTask(std::function<void()> task) {
 void SmartDashboard::UpdateValues() {
   auto& inst = GetInstance();
   inst.listenerExecutor.RunListenerTasks();
-  std::scoped_lock lock(inst.tablesToDataMutex);
-  for (auto& i : inst.tablesToData) {
-    wpi::SendableRegistry::Update(i.second);
+  wpi::SmallVector<wpi::SendableRegistry::UID, 128> uids;
+  {
+    std::scoped_lock lock(inst.tablesToDataMutex);
+    for (auto& i : inst.tablesToData) {
+      uids.emplace_back(i.second);
+    }
   }
+  wpi::SendableRegistry::UpdateAll(uids);
 }
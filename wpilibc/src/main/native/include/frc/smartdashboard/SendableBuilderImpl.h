@@ -95,6 +95,7 @@ class SendableBuilderImpl : public nt::NTSendableBuilder {
   void SetSafeState(std::function<void()> func) override;
   void SetUpdateTable(wpi::unique_function<void()> func) override;
   nt::Topic GetTopic(std::string_view key) override;
+  void SetUpdatePeriod(std::string_view key, double period) override;
 
   void AddBooleanProperty(std::string_view key, std::function<bool()> getter,
                           std::function<void(bool)> setter) override;
@@ -213,18 +214,30 @@ class SendableBuilderImpl : public nt::NTSendableBuilder {
   struct Property {
     virtual ~Property() = default;
     virtual void Update(bool controllable, int64_t time) = 0;
+
+    NT_Topic topic = 0;
+    // minimum time between getter calls, in microseconds
+    int64_t period = 0;
+    int64_t nextUpdate = 0;
   };
 
   template <typename Topic>
   struct PropertyImpl : public Property {
     void Update(bool controllable, int64_t time) override;
 
+    // publishes the value only if it differs from the last published value
+    template <typename T>
+    void Publish(const T& value, int64_t time);
+
     using Publisher = typename Topic::PublisherType;
     using Subscriber = typename Topic::SubscriberType;
     Publisher pub;
     Subscriber sub;
-    std::function<void(Publisher& pub, int64_t time)> updateNetwork;
-    std::function<void(Subscriber& sub)> updateLocal;
+    typename Subscriber::ValueType lastValue{};
+    bool hasLastValue = false;
+    std::function<void(PropertyImpl& prop, int64_t time)> updateNetwork;
+    // returns true if any values were received
+    std::function<bool(Subscriber& sub)> updateLocal;
   };
 
   template <typename Topic, typename Getter, typename Setter>
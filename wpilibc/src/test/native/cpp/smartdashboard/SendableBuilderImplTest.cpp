@@ -0,0 +1,71 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <gtest/gtest.h>
+#include <networktables/DoubleTopic.h>
+#include <networktables/NetworkTableInstance.h>
+
+#include "frc/smartdashboard/SendableBuilderImpl.h"
+
+using namespace frc;
+
+class SendableBuilderImplTest : public ::testing::Test {
+ public:
+  SendableBuilderImplTest() {
+    m_inst = nt::NetworkTableInstance::Create();
+    m_builder.SetTable(m_inst.GetTable("Test"));
+  }
+
+  ~SendableBuilderImplTest() override {
+    nt::NetworkTableInstance::Destroy(m_inst);
+  }
+
+  nt::NetworkTableInstance m_inst;
+  SendableBuilderImpl m_builder;
+};
+
+TEST_F(SendableBuilderImplTest, UpdatePeriod) {
+  int count = 0;
+  m_builder.AddDoubleProperty(
+      "x",
+      [&] {
+        ++count;
+        return 1.0;
+      },
+      nullptr);
+  auto sub = m_inst.GetDoubleTopic("/Test/x").Subscribe(0.0);
+
+  m_builder.Update();
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(sub.Get(), 1.0);
+  m_builder.Update();
+  EXPECT_EQ(count, 2);
+
+  // the first update after setting the period still calls the getter
+  m_builder.SetUpdatePeriod("x", 10.0);
+  m_builder.Update();
+  EXPECT_EQ(count, 3);
+  m_builder.Update();
+  m_builder.Update();
+  EXPECT_EQ(count, 3);
+}
+
+TEST_F(SendableBuilderImplTest, RepublishAfterRemoteSet) {
+  double received = 0;
+  m_builder.AddDoubleProperty(
+      "x", [] { return 1.0; }, [&](double value) { received = value; });
+  m_builder.StartListeners();
+  auto sub = m_inst.GetDoubleTopic("/Test/x").Subscribe(0.0);
+
+  m_builder.Update();
+  EXPECT_EQ(sub.Get(), 1.0);
+
+  // the setter ignores the value, so the unchanged local value is republished
+  auto pub = m_inst.GetDoubleTopic("/Test/x").Publish();
+  pub.Set(5.0);
+  EXPECT_EQ(sub.Get(), 5.0);
+  m_builder.Update();
+  EXPECT_EQ(received, 5.0);
+  EXPECT_EQ(sub.Get(), 1.0);
+}
@@ -11,6 +11,7 @@
 
 template <>
 struct WPILIB_DLLEXPORT wpi::Struct<frc::Quaternion> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "Quaternion"; }
   static constexpr size_t GetSize() { return 32; }
   static constexpr std::string_view GetSchema() {
@@ -22,3 +23,4 @@ struct WPILIB_DLLEXPORT wpi::Struct<frc::Quaternion> {
 };
 
 static_assert(wpi::StructSerializable<frc::Quaternion>);
+static_assert(wpi::TriviallyPackableStruct<frc::Quaternion>);
@@ -11,6 +11,7 @@
 
 template <>
 struct WPILIB_DLLEXPORT wpi::Struct<frc::Translation2d> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "Translation2d"; }
   static constexpr size_t GetSize() { return 16; }
   static constexpr std::string_view GetSchema() { return "double x;double y"; }
@@ -20,3 +21,4 @@ struct WPILIB_DLLEXPORT wpi::Struct<frc::Translation2d> {
 };
 
 static_assert(wpi::StructSerializable<frc::Translation2d>);
+static_assert(wpi::TriviallyPackableStruct<frc::Translation2d>);
@@ -11,6 +11,7 @@
 
 template <>
 struct WPILIB_DLLEXPORT wpi::Struct<frc::Twist2d> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "Twist2d"; }
   static constexpr size_t GetSize() { return 24; }
   static constexpr std::string_view GetSchema() {
@@ -22,3 +23,4 @@ struct WPILIB_DLLEXPORT wpi::Struct<frc::Twist2d> {
 };
 
 static_assert(wpi::StructSerializable<frc::Twist2d>);
+static_assert(wpi::TriviallyPackableStruct<frc::Twist2d>);
@@ -11,6 +11,7 @@
 
 template <>
 struct WPILIB_DLLEXPORT wpi::Struct<frc::ChassisSpeeds> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "ChassisSpeeds"; }
   static constexpr size_t GetSize() { return 24; }
   static constexpr std::string_view GetSchema() {
@@ -22,3 +23,4 @@ struct WPILIB_DLLEXPORT wpi::Struct<frc::ChassisSpeeds> {
 };
 
 static_assert(wpi::StructSerializable<frc::ChassisSpeeds>);
+static_assert(wpi::TriviallyPackableStruct<frc::ChassisSpeeds>);
@@ -11,6 +11,7 @@
 
 template <>
 struct WPILIB_DLLEXPORT wpi::Struct<frc::MecanumDriveWheelSpeeds> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() {
     return "MecanumDriveWheelSpeeds";
   }
@@ -26,3 +27,4 @@ struct WPILIB_DLLEXPORT wpi::Struct<frc::MecanumDriveWheelSpeeds> {
 };
 
 static_assert(wpi::StructSerializable<frc::MecanumDriveWheelSpeeds>);
+static_assert(wpi::TriviallyPackableStruct<frc::MecanumDriveWheelSpeeds>);
@@ -6,8 +6,8 @@ package edu.wpi.first.util.datalog;
 
 /**
  * A data log background writer that periodically flushes the data log on a background thread. The
- * data log file is created immediately upon construction with a temporary filename. The file may be
- * renamed at any time using the setFilename() function.
+ * data log file is created with a temporary filename when data is first written to it (at the first
+ * flush after construction). The file may be renamed at any time using the setFilename() function.
  *
  * <p>The data log is periodically flushed to disk. It can also be explicitly flushed to disk by
  * using the flush() function. This operation is, however, non-blocking.
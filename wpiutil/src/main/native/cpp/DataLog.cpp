@@ -9,6 +9,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "wpi/Endian.h"
 #include "wpi/Logger.h"
 #include "wpi/SmallString.h"
+#include "wpi/SmallVector.h"
 #include "wpi/print.h"
 #include "wpi/timestamp.h"
 
@@ -63,6 +65,18 @@ static unsigned int WriteRecordHeader(uint8_t* buf, uint32_t entry,
   return buf - origbuf;
 }
 
+DataLog::~DataLog() {
+  std::scoped_lock lock{m_mutex};
+  for (auto&& tb : m_threadBufs) {
+    tb->detached = true;
+  }
+}
+
+uint64_t DataLog::NextInstanceId() {
+  static std::atomic<uint64_t> nextId{1};
+  return nextId++;
+}
+
 void DataLog::StartFile() {
   std::scoped_lock lock{m_mutex};
   if (m_active) {
@@ -103,6 +117,7 @@ void DataLog::StartFile() {
 
 void DataLog::FlushBufs(std::vector<Buffer>* writeBufs) {
   std::scoped_lock lock{m_mutex};
+  DrainThreadBufs();
   writeBufs->swap(m_outgoing);
   DoReleaseBufs(&m_outgoing);
 }
@@ -238,6 +253,8 @@ void DataLog::Finish(int entry, int64_t timestamp) {
   if (!m_active) {
     [[unlikely]] return;
   }
+  // data records for the entry must precede the finish record
+  DrainThreadBufs();
   uint8_t* buf = StartRecord(0, timestamp, 5, 5);
   *buf++ = impl::kControlFinish;
   wpi::support::endian::write32le(buf, entry);
@@ -253,6 +270,7 @@ void DataLog::SetMetadata(int entry, std::string_view metadata,
   if (!m_active) {
     [[unlikely]] return;
   }
+  DrainThreadBufs();
   uint8_t* buf = StartRecord(0, timestamp, 5 + 4 + metadata.size(), 5);
   *buf++ = impl::kControlSetMetadata;
   wpi::support::endian::write32le(buf, entry);
@@ -262,25 +280,174 @@ void DataLog::SetMetadata(int entry, std::string_view metadata,
 uint8_t* DataLog::Reserve(size_t size) {
   assert(size <= kBlockSize);
   if (m_outgoing.empty() || size > m_outgoing.back().GetRemaining()) {
-    if (m_outgoing.size() == kMaxBufferCount / 2) {
-      [[unlikely]] BufferHalfFull();
-    }
     if (m_free.empty()) {
-      if (m_outgoing.size() >= kMaxBufferCount) {
-        [[unlikely]]
-        if (BufferFull()) {
-          m_paused = true;
-        }
-      }
-      m_outgoing.emplace_back();
+      QueueBuffer(Buffer{});
     } else {
-      m_outgoing.emplace_back(std::move(m_free.back()));
+      QueueBuffer(std::move(m_free.back()));
       m_free.pop_back();
     }
   }
   return m_outgoing.back().Reserve(size);
 }
 
+void DataLog::QueueBuffer(Buffer&& buf) {
+  if (m_outgoing.size() == kMaxBufferCount / 2) {
+    [[unlikely]] BufferHalfFull();
+  }
+  if (m_outgoing.size() >= kMaxBufferCount) {
+    [[unlikely]]
+    if (BufferFull()) {
+      m_paused = true;
+    }
+  }
+  m_outgoing.emplace_back(std::move(buf));
+}
+
+DataLog::ThreadBuffer* DataLog::GetThreadBuffer(bool create) {
+  // keyed by DataLog instance id
+  thread_local std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>>
+      threadBufs;
+  for (auto&& [id, tb] : threadBufs) {
+    if (id == m_instanceId) {
+      [[likely]] return tb.get();
+    }
+  }
+  if (!create) {
+    return nullptr;
+  }
+  // drop buffers for logs that no longer exist
+  std::erase_if(threadBufs,
+                [](auto& elem) { return elem.second->detached.load(); });
+  auto tb = std::make_shared<ThreadBuffer>();
+  {
+    std::scoped_lock lock{m_mutex};
+    m_threadBufs.emplace_back(tb);
+  }
+  return threadBufs.emplace_back(m_instanceId, std::move(tb)).second.get();
+}
+
+uint8_t* DataLog::StartThreadRecord(ThreadBuffer& tb,
+                                    std::unique_lock<wpi::spinlock>& lock,
+                                    uint32_t entry, uint64_t timestamp,
+                                    uint32_t payloadSize) {
+  if (timestamp == 0) {
+    timestamp = wpi::Now();
+  }
+  size_t size = kRecordMaxHeaderSize + payloadSize;
+  if (size > tb.buf.GetRemaining()) {
+    // swap in an empty buffer; lock order is m_mutex, then the thread buffer
+    lock.unlock();
+    std::scoped_lock sharedLock{m_mutex};
+    lock.lock();
+    if (!tb.buf.GetData().empty()) {
+      QueueBuffer(std::move(tb.buf));
+    }
+    if (m_free.empty()) {
+      tb.buf = Buffer{};
+    } else {
+      tb.buf = std::move(m_free.back());
+      m_free.pop_back();
+    }
+  }
+  uint8_t* buf = tb.buf.Reserve(size);
+  auto headerLen = WriteRecordHeader(buf, entry, timestamp, payloadSize);
+  tb.buf.Unreserve(kRecordMaxHeaderSize - headerLen);
+  return buf + headerLen;
+}
+
+// Reads the timestamp of the record at the start of data, and returns the
+// total length of the record.  Records in thread buffers are always complete.
+static size_t ReadRecordHeader(std::span<const uint8_t> data,
+                               int64_t* timestamp) {
+  unsigned int entryLen = (data[0] & 0x3) + 1;
+  unsigned int sizeLen = ((data[0] >> 2) & 0x3) + 1;
+  unsigned int timestampLen = ((data[0] >> 4) & 0x7) + 1;
+  const uint8_t* buf = data.data() + 1 + entryLen;
+  uint32_t size = 0;
+  for (unsigned int i = 0; i < sizeLen; ++i) {
+    size |= static_cast<uint32_t>(*buf++) << (8 * i);
+  }
+  uint64_t ts = 0;
+  for (unsigned int i = 0; i < timestampLen; ++i) {
+    ts |= static_cast<uint64_t>(*buf++) << (8 * i);
+  }
+  *timestamp = static_cast<int64_t>(ts);
+  return 1 + entryLen + sizeLen + timestampLen + size;
+}
+
+void DataLog::DrainThreadBufs() {
+  struct Pending {
+    Buffer buf;
+    size_t pos = 0;
+    // timestamp and length of the record at pos
+    int64_t timestamp = 0;
+    size_t len = 0;
+  };
+  wpi::SmallVector<Pending, 8> pending;
+  std::erase_if(m_threadBufs, [&](auto& tb) {
+    std::scoped_lock lock{tb->lock};
+    if (tb->buf.GetData().empty()) {
+      // the owning thread has exited
+      return tb.use_count() == 1;
+    }
+    pending.emplace_back(Pending{std::move(tb->buf)});
+    return false;
+  });
+  if (pending.size() == 1) {
+    QueueBuffer(std::move(pending[0].buf));
+    return;
+  }
+
+  // merge the records by timestamp; records from each thread stay in the
+  // order they were appended, and are copied whole so they are never split
+  // across buffers
+  for (auto&& p : pending) {
+    p.len = ReadRecordHeader(p.buf.GetData(), &p.timestamp);
+  }
+  while (!pending.empty()) {
+    // find the earliest record, and the earliest record of any other thread
+    auto first = pending.begin();
+    int64_t limit = INT64_MAX;
+    for (auto it = pending.begin() + 1; it != pending.end(); ++it) {
+      if (it->timestamp < first->timestamp) {
+        limit = first->timestamp;
+        first = it;
+      } else if (it->timestamp < limit) {
+        limit = it->timestamp;
+      }
+    }
+
+    // copy records from that thread until another thread's record is earlier
+    auto data = first->buf.GetData();
+    do {
+      std::memcpy(Reserve(first->len), &data[first->pos], first->len);
+      first->pos += first->len;
+      if (first->pos >= data.size()) {
+        break;
+      }
+      first->len =
+          ReadRecordHeader(data.subspan(first->pos), &first->timestamp);
+    } while (first->timestamp <= limit);
+
+    if (first->pos >= data.size()) {
+      first->buf.Clear();
+      if (m_free.size() < kMaxFreeCount) {
+        m_free.emplace_back(std::move(first->buf));
+      }
+      pending.erase(first);
+    }
+  }
+}
+
+void DataLog::DrainCurrentThreadBuf() {
+  if (auto tb = GetThreadBuffer(false)) {
+    std::scoped_lock lock{tb->lock};
+    if (!tb->buf.GetData().empty()) {
+      QueueBuffer(std::move(tb->buf));
+    }
+  }
+}
+
 uint8_t* DataLog::StartRecord(uint32_t entry, uint64_t timestamp,
                               uint32_t payloadSize, size_t reserveSize) {
   uint8_t* buf = Reserve(kRecordMaxHeaderSize + reserveSize);
@@ -313,12 +480,56 @@ void DataLog::AppendRaw(int entry, std::span<const uint8_t> data,
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  StartRecord(entry, timestamp, data.size(), 0);
-  AppendImpl(data);
+  if (data.size() > kMaxThreadRecordSize) {
+    std::scoped_lock lock{m_mutex};
+    if (m_paused) {
+      [[unlikely]] return;
+    }
+    DrainCurrentThreadBuf();
+    StartRecord(entry, timestamp, data.size(), 0);
+    AppendImpl(data);
+    return;
+  }
+  auto tb = GetThreadBuffer(true);
+  std::unique_lock lock{tb->lock};
+  uint8_t* buf = StartThreadRecord(*tb, lock, entry, timestamp, data.size());
+  if (!data.empty()) {
+    std::memcpy(buf, data.data(), data.size());
+  }
+}
+
+void DataLog::AppendRawInPlace(
+    int entry, size_t size,
+    wpi::function_ref<void(std::span<uint8_t> data)> fill, int64_t timestamp) {
+  if (entry <= 0) {
+    return;
+  }
+  if (m_paused) {
+    [[unlikely]] return;
+  }
+  if (size > kMaxThreadRecordSize) {
+    std::scoped_lock lock{m_mutex};
+    if (m_paused) {
+      [[unlikely]] return;
+    }
+    DrainCurrentThreadBuf();
+    if (size <= kBlockSize - kRecordMaxHeaderSize) {
+      fill({StartRecord(entry, timestamp, size, size), size});
+    } else {
+      // too large to be contiguous in a single buffer
+      std::vector<uint8_t> buf(size);
+      fill(buf);
+      StartRecord(entry, timestamp, size, 0);
+      AppendImpl(buf);
+    }
+    return;
+  }
+  auto tb = GetThreadBuffer(true);
+  std::unique_lock lock{tb->lock};
+  fill({StartThreadRecord(*tb, lock, entry, timestamp, size), size});
 }
 
 void DataLog::AppendRaw2(int entry,
@@ -327,7 +538,6 @@ void DataLog::AppendRaw2(int entry,
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
@@ -335,9 +545,26 @@ void DataLog::AppendRaw2(int entry,
   for (auto&& chunk : data) {
     size += chunk.size();
   }
-  StartRecord(entry, timestamp, size, 0);
+  if (size > kMaxThreadRecordSize) {
+    std::scoped_lock lock{m_mutex};
+    if (m_paused) {
+      [[unlikely]] return;
+    }
+    DrainCurrentThreadBuf();
+    StartRecord(entry, timestamp, size, 0);
+    for (auto chunk : data) {
+      AppendImpl(chunk);
+    }
+    return;
+  }
+  auto tb = GetThreadBuffer(true);
+  std::unique_lock lock{tb->lock};
+  uint8_t* buf = StartThreadRecord(*tb, lock, entry, timestamp, size);
   for (auto chunk : data) {
-    AppendImpl(chunk);
+    if (!chunk.empty()) {
+      std::memcpy(buf, chunk.data(), chunk.size());
+      buf += chunk.size();
+    }
   }
 }
 
@@ -345,11 +572,12 @@ void DataLog::AppendBoolean(int entry, bool value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 1, 1);
+  auto tb = GetThreadBuffer(true);
+  std::unique_lock lock{tb->lock};
+  uint8_t* buf = StartThreadRecord(*tb, lock, entry, timestamp, 1);
   buf[0] = value ? 1 : 0;
 }
 
@@ -357,11 +585,12 @@ void DataLog::AppendInteger(int entry, int64_t value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 8, 8);
+  auto tb = GetThreadBuffer(true);
+  std::unique_lock lock{tb->lock};
+  uint8_t* buf = StartThreadRecord(*tb, lock, entry, timestamp, 8);
   wpi::support::endian::write64le(buf, value);
 }
 
@@ -369,11 +598,12 @@ void DataLog::AppendFloat(int entry, float value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 4, 4);
+  auto tb = GetThreadBuffer(true);
+  std::unique_lock lock{tb->lock};
+  uint8_t* buf = StartThreadRecord(*tb, lock, entry, timestamp, 4);
   if constexpr (std::endian::native == std::endian::little) {
     std::memcpy(buf, &value, 4);
   } else {
@@ -385,11 +615,12 @@ void DataLog::AppendDouble(int entry, double value, int64_t timestamp) {
   if (entry <= 0) {
     return;
   }
-  std::scoped_lock lock{m_mutex};
   if (m_paused) {
     [[unlikely]] return;
   }
-  uint8_t* buf = StartRecord(entry, timestamp, 8, 8);
+  auto tb = GetThreadBuffer(true);
+  std::unique_lock lock{tb->lock};
+  uint8_t* buf = StartThreadRecord(*tb, lock, entry, timestamp, 8);
   if constexpr (std::endian::native == std::endian::little) {
     std::memcpy(buf, &value, 8);
   } else {
@@ -413,6 +644,7 @@ void DataLog::AppendBooleanArray(int entry, std::span<const bool> arr,
   if (m_paused) {
     [[unlikely]] return;
   }
+  DrainCurrentThreadBuf();
   StartRecord(entry, timestamp, arr.size(), 0);
   uint8_t* buf;
   while (arr.size() > kBlockSize) {
@@ -437,6 +669,7 @@ void DataLog::AppendBooleanArray(int entry, std::span<const int> arr,
   if (m_paused) {
     [[unlikely]] return;
   }
+  DrainCurrentThreadBuf();
   StartRecord(entry, timestamp, arr.size(), 0);
   uint8_t* buf;
   while (arr.size() > kBlockSize) {
@@ -471,6 +704,7 @@ void DataLog::AppendIntegerArray(int entry, std::span<const int64_t> arr,
     if (m_paused) {
       [[unlikely]] return;
     }
+    DrainCurrentThreadBuf();
     StartRecord(entry, timestamp, arr.size() * 8, 0);
     uint8_t* buf;
     while ((arr.size() * 8) > kBlockSize) {
@@ -503,6 +737,7 @@ void DataLog::AppendFloatArray(int entry, std::span<const float> arr,
     if (m_paused) {
       [[unlikely]] return;
     }
+    DrainCurrentThreadBuf();
     StartRecord(entry, timestamp, arr.size() * 4, 0);
     uint8_t* buf;
     while ((arr.size() * 4) > kBlockSize) {
@@ -535,6 +770,7 @@ void DataLog::AppendDoubleArray(int entry, std::span<const double> arr,
     if (m_paused) {
       [[unlikely]] return;
     }
+    DrainCurrentThreadBuf();
     StartRecord(entry, timestamp, arr.size() * 8, 0);
     uint8_t* buf;
     while ((arr.size() * 8) > kBlockSize) {
@@ -568,6 +804,7 @@ void DataLog::AppendStringArray(int entry, std::span<const std::string> arr,
   if (m_paused) {
     [[unlikely]] return;
   }
+  DrainCurrentThreadBuf();
   uint8_t* buf = StartRecord(entry, timestamp, size, 4);
   wpi::support::endian::write32le(buf, arr.size());
   for (auto&& str : arr) {
@@ -591,6 +828,7 @@ void DataLog::AppendStringArray(int entry,
   if (m_paused) {
     [[unlikely]] return;
   }
+  DrainCurrentThreadBuf();
   uint8_t* buf = StartRecord(entry, timestamp, size, 4);
   wpi::support::endian::write32le(buf, arr.size());
   for (auto&& sv : arr) {
@@ -614,6 +852,7 @@ void DataLog::AppendStringArray(int entry,
   if (m_paused) {
     [[unlikely]] return;
   }
+  DrainCurrentThreadBuf();
   uint8_t* buf = StartRecord(entry, timestamp, size, 4);
   wpi::support::endian::write32le(buf, arr.size());
   for (auto&& sv : arr) {
@@ -622,40 +861,45 @@ void DataLog::AppendStringArray(int entry,
 }
 
 template <typename V1, typename V2>
-inline bool UpdateImpl(std::optional<std::vector<V1>>& lastValue,
-                       std::span<const V2> data) {
-  if (!lastValue || !std::equal(data.begin(), data.end(), lastValue->begin(),
-                                lastValue->end())) {
-    if (lastValue) {
-      lastValue->assign(data.begin(), data.end());
-    } else {
-      lastValue = std::vector<V1>{data.begin(), data.end()};
-    }
-    return true;
-  }
-  return false;
+inline bool IsChanged(const std::optional<std::vector<V1>>& lastValue,
+                      std::span<const V2> data) {
+  return !lastValue || !std::equal(data.begin(), data.end(), lastValue->begin(),
+                                   lastValue->end());
 }
 
 template <typename V1>
-inline bool UpdateImpl(std::optional<std::vector<V1>>& lastValue,
-                       std::span<const bool> data) {
-  if (!lastValue || !std::equal(data.begin(), data.end(), lastValue->begin(),
-                                lastValue->end(), [](auto a, auto b) {
-                                  return a == static_cast<bool>(b);
-                                })) {
-    if (lastValue) {
-      lastValue->assign(data.begin(), data.end());
-    } else {
-      lastValue = std::vector<V1>{data.begin(), data.end()};
-    }
-    return true;
+inline bool IsChanged(const std::optional<std::vector<V1>>& lastValue,
+                      std::span<const bool> data) {
+  return !lastValue ||
+         !std::equal(
+             data.begin(), data.end(), lastValue->begin(), lastValue->end(),
+             [](auto a, auto b) { return a == static_cast<bool>(b); });
+}
+
+template <typename V>
+inline bool IsChanged(const std::optional<std::vector<V>>& lastValue,
+                      std::span<const V> data, double deadband) {
+  return !lastValue ||
+         !std::equal(data.begin(), data.end(), lastValue->begin(),
+                     lastValue->end(), [&](auto a, auto b) {
+                       return !impl::ExceedsDeadband(a, b, deadband);
+                     });
+}
+
+template <typename V1, typename V2>
+inline void SetLastValue(std::optional<std::vector<V1>>& lastValue,
+                         std::span<const V2> data) {
+  if (lastValue) {
+    lastValue->assign(data.begin(), data.end());
+  } else {
+    lastValue = std::vector<V1>{data.begin(), data.end()};
   }
-  return false;
 }
 
 void RawLogEntry::Update(std::span<const uint8_t> data, int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, data)) {
+  if (ShouldAppend(IsChanged(m_lastValue, data), timestamp)) {
+    SetLastValue(m_lastValue, data);
     Append(data, timestamp);
   }
 }
@@ -663,14 +907,16 @@ void RawLogEntry::Update(std::span<const uint8_t> data, int64_t timestamp) {
 void BooleanArrayLogEntry::Update(std::span<const bool> arr,
                                   int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
 
 void BooleanArrayLogEntry::Update(std::span<const int> arr, int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
@@ -678,7 +924,8 @@ void BooleanArrayLogEntry::Update(std::span<const int> arr, int64_t timestamp) {
 void BooleanArrayLogEntry::Update(std::span<const uint8_t> arr,
                                   int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
@@ -686,14 +933,16 @@ void BooleanArrayLogEntry::Update(std::span<const uint8_t> arr,
 void IntegerArrayLogEntry::Update(std::span<const int64_t> arr,
                                   int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr, m_deadband), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
 
 void FloatArrayLogEntry::Update(std::span<const float> arr, int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr, m_deadband), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
@@ -701,7 +950,8 @@ void FloatArrayLogEntry::Update(std::span<const float> arr, int64_t timestamp) {
 void DoubleArrayLogEntry::Update(std::span<const double> arr,
                                  int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr, m_deadband), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
@@ -709,7 +959,8 @@ void DoubleArrayLogEntry::Update(std::span<const double> arr,
 void StringArrayLogEntry::Update(std::span<const std::string> arr,
                                  int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
@@ -717,7 +968,8 @@ void StringArrayLogEntry::Update(std::span<const std::string> arr,
 void StringArrayLogEntry::Update(std::span<const std::string_view> arr,
                                  int64_t timestamp) {
   std::scoped_lock lock{m_mutex};
-  if (UpdateImpl(m_lastValue, arr)) {
+  if (ShouldAppend(IsChanged(m_lastValue, arr), timestamp)) {
+    SetLastValue(m_lastValue, arr);
     Append(arr, timestamp);
   }
 }
@@ -17,6 +17,11 @@
 
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <optional>
 #include <random>
 #include <string>
 #include <utility>
@@ -24,12 +29,22 @@
 
 #include <fmt/format.h>
 
+#include "wpi/Endian.h"
 #include "wpi/Logger.h"
+#include "wpi/SmallVector.h"
 #include "wpi/fs.h"
+#include "wpi/lz4.h"
 
 using namespace wpi::log;
 
 static constexpr uintmax_t kMinFreeSpace = 5 * 1024 * 1024;
+static constexpr uintmax_t kMaxFileSize = 1800000000ull;
+
+// compressed container header: "WPILZ4", then version (1.0)
+static constexpr uint8_t kCompressedHeader[8] = {'W', 'P', 'I', 'L',
+                                                 'Z', '4', 0x00, 0x01};
+// maximum uncompressed size of each compressed block; the LZ4 window is 64 KB
+static constexpr size_t kCompressedBlockSize = 64 * 1024;
 
 static std::string FormatBytesSize(uintmax_t value) {
   static constexpr uintmax_t kKiB = 1024;
@@ -49,32 +64,36 @@ static std::string FormatBytesSize(uintmax_t value) {
 DataLogBackgroundWriter::DataLogBackgroundWriter(std::string_view dir,
                                                  std::string_view filename,
                                                  double period,
-                                                 std::string_view extraHeader)
-    : DataLogBackgroundWriter{s_defaultMessageLog, dir, filename, period,
-                              extraHeader} {}
+                                                 std::string_view extraHeader,
+                                                 bool compress)
+    : DataLogBackgroundWriter{s_defaultMessageLog, dir,         filename,
+                              period,              extraHeader, compress} {}
 
 DataLogBackgroundWriter::DataLogBackgroundWriter(wpi::Logger& msglog,
                                                  std::string_view dir,
                                                  std::string_view filename,
                                                  double period,
-                                                 std::string_view extraHeader)
+                                                 std::string_view extraHeader,
+                                                 bool compress)
     : DataLog{msglog, extraHeader},
       m_period{period},
+      m_compress{compress},
       m_newFilename{filename},
       m_thread{[this, dir = std::string{dir}] { WriterThreadMain(dir); }} {}
 
 DataLogBackgroundWriter::DataLogBackgroundWriter(
     std::function<void(std::span<const uint8_t> data)> write, double period,
-    std::string_view extraHeader)
+    std::string_view extraHeader, bool compress)
     : DataLogBackgroundWriter{s_defaultMessageLog, std::move(write), period,
-                              extraHeader} {}
+                              extraHeader, compress} {}
 
 DataLogBackgroundWriter::DataLogBackgroundWriter(
     wpi::Logger& msglog,
     std::function<void(std::span<const uint8_t> data)> write, double period,
-    std::string_view extraHeader)
+    std::string_view extraHeader, bool compress)
     : DataLog{msglog, extraHeader},
       m_period{period},
+      m_compress{compress},
       m_thread{[this, write = std::move(write)] {
         WriterThreadMain(std::move(write));
       }} {}
@@ -97,6 +116,31 @@ void DataLogBackgroundWriter::SetFilename(std::string_view filename) {
   m_cond.notify_all();
 }
 
+void DataLogBackgroundWriter::SetRotation(uintmax_t maxSize, double maxAge,
+                                          int maxFiles) {
+  std::scoped_lock lock{m_mutex};
+  m_maxFileSize = maxSize;
+  m_maxFileAge = maxAge;
+  m_maxFiles = maxFiles;
+}
+
+void DataLogBackgroundWriter::SetFlightRecorder(size_t maxSize) {
+  {
+    std::scoped_lock lock{m_mutex};
+    m_flightRecorderSize = maxSize;
+  }
+  m_cond.notify_all();
+}
+
+void DataLogBackgroundWriter::TriggerFlightRecorder() {
+  {
+    std::scoped_lock lock{m_mutex};
+    m_doFlush = true;
+    m_doTrigger = true;
+  }
+  m_cond.notify_all();
+}
+
 void DataLogBackgroundWriter::Flush() {
   {
     std::scoped_lock lock{m_mutex};
@@ -105,6 +149,14 @@ void DataLogBackgroundWriter::Flush() {
   m_cond.notify_all();
 }
 
+void DataLogBackgroundWriter::FlushAndWait() {
+  std::unique_lock lock{m_mutex};
+  m_doFlush = true;
+  uint64_t request = ++m_flushRequested;
+  m_cond.notify_all();
+  m_flushedCond.wait(lock, [&] { return m_flushCompleted >= request; });
+}
+
 void DataLogBackgroundWriter::Pause() {
   DataLog::Pause();
   std::scoped_lock lock{m_mutex};
@@ -175,6 +227,149 @@ static std::string MakeRandomFilename() {
   return filename;
 }
 
+namespace {
+// Keeps the most recent data log records, up to a size limit, for flight
+// recorder mode.  Records dropped off the front are summarized so the contents
+// are always a complete log: the file header, plus the start record, latest
+// metadata record, and latest data record of every entry that is still
+// started.
+class RecordRing {
+ public:
+  explicit RecordRing(size_t maxSize) : m_maxSize{maxSize} {}
+
+  void SetMaxSize(size_t maxSize) {
+    m_maxSize = maxSize;
+    Trim(m_maxSize);
+  }
+
+  void Clear() {
+    m_header.clear();
+    m_data.clear();
+    m_start = 0;
+    m_entries.clear();
+  }
+
+  void Append(std::span<const uint8_t> data);
+
+  // Gets the log contents, then discards all but the summary
+  void Take(std::vector<uint8_t>& out);
+
+ private:
+  struct Entry {
+    std::vector<uint8_t> start;
+    std::vector<uint8_t> metadata;
+    std::vector<uint8_t> value;
+  };
+
+  void Trim(size_t size);
+
+  size_t m_maxSize;
+  std::vector<uint8_t> m_header;
+  std::vector<uint8_t> m_data;
+  size_t m_start = 0;  // offset of first record in m_data
+  std::map<int, Entry> m_entries;
+};
+}  // namespace
+
+void RecordRing::Append(std::span<const uint8_t> data) {
+  m_data.insert(m_data.end(), data.begin(), data.end());
+  // the data starts with the file header
+  if (m_header.empty()) {
+    if (m_data.size() < 12) {
+      return;
+    }
+    size_t headerLen = 12 + wpi::support::endian::read32le(&m_data[8]);
+    if (m_data.size() < headerLen) {
+      return;
+    }
+    m_header.assign(m_data.begin(), m_data.begin() + headerLen);
+    m_start = headerLen;
+  }
+  Trim(m_maxSize);
+}
+
+void RecordRing::Take(std::vector<uint8_t>& out) {
+  out = m_header;
+  for (auto&& entry : m_entries) {
+    out.insert(out.end(), entry.second.start.begin(),
+               entry.second.start.end());
+    out.insert(out.end(), entry.second.metadata.begin(),
+               entry.second.metadata.end());
+    out.insert(out.end(), entry.second.value.begin(),
+               entry.second.value.end());
+  }
+  out.insert(out.end(), m_data.begin() + m_start, m_data.end());
+  Trim(0);
+}
+
+void RecordRing::Trim(size_t size) {
+  if (m_header.empty()) {
+    return;
+  }
+  while (m_data.size() - m_start > size) {
+    // parse record header (see DataLogReader::GetRecord)
+    std::span<const uint8_t> buf{m_data.data() + m_start,
+                                 m_data.size() - m_start};
+    unsigned int entryLen = (buf[0] & 0x3) + 1;
+    unsigned int sizeLen = ((buf[0] >> 2) & 0x3) + 1;
+    unsigned int timestampLen = ((buf[0] >> 4) & 0x7) + 1;
+    size_t headerLen = 1 + entryLen + sizeLen + timestampLen;
+    if (buf.size() < headerLen) {
+      break;  // partial record
+    }
+    int entry = 0;
+    for (unsigned int i = 0; i < entryLen; ++i) {
+      entry |= buf[1 + i] << (8 * i);
+    }
+    uint32_t recordSize = 0;
+    for (unsigned int i = 0; i < sizeLen; ++i) {
+      recordSize |= buf[1 + entryLen + i] << (8 * i);
+    }
+    if (buf.size() - headerLen < recordSize) {
+      break;  // partial record
+    }
+    auto record = buf.first(headerLen + recordSize);
+    auto payload = record.subspan(headerLen);
+
+    if (entry != 0) {
+      auto it = m_entries.find(entry);
+      if (it != m_entries.end()) {
+        it->second.value.assign(record.begin(), record.end());
+      }
+    } else if (payload.size() >= 5) {
+      int id = wpi::support::endian::read32le(&payload[1]);
+      switch (payload[0]) {
+        case impl::kControlStart: {
+          auto& e = m_entries[id];
+          e.start.assign(record.begin(), record.end());
+          e.metadata.clear();
+          e.value.clear();
+          break;
+        }
+        case impl::kControlFinish:
+          m_entries.erase(id);
+          break;
+        case impl::kControlSetMetadata: {
+          auto it = m_entries.find(id);
+          if (it != m_entries.end()) {
+            it->second.metadata.assign(record.begin(), record.end());
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    m_start += record.size();
+  }
+
+  // reclaim space once more than half of the buffer has been trimmed
+  if (m_start > m_data.size() / 2) {
+    m_data.erase(m_data.begin(), m_data.begin() + m_start);
+    m_start = 0;
+  }
+}
+
 struct DataLogBackgroundWriter::WriterThreadState {
   explicit WriterThreadState(std::string_view dir)
       : dirPath{dir.empty() ? "." : dir} {}
@@ -183,6 +378,7 @@ struct DataLogBackgroundWriter::WriterThreadState {
   ~WriterThreadState() { Close(); }
 
   void Close() {
+    openPending = false;
     if (f != fs::kInvalidFile) {
       fs::CloseFile(f);
       f = fs::kInvalidFile;
@@ -208,8 +404,26 @@ struct DataLogBackgroundWriter::WriterThreadState {
   std::string filename;
   fs::path path;
   fs::file_t f = fs::kInvalidFile;
+  // the log has been started, but the file is not created until data is first
+  // written to it
+  bool openPending = false;
   uintmax_t freeSpace = UINTMAX_MAX;
   int segmentCount = 1;
+  int freeSpaceCount = 0;
+  bool blocked = false;
+  uintmax_t written = 0;
+  std::chrono::steady_clock::time_point startTime;
+  std::vector<uint8_t> compressed;
+
+  // settings (copied from the writer each loop iteration)
+  uintmax_t maxFileSize = kMaxFileSize;
+  int maxFiles = 0;
+
+  // files written, oldest first, for deleting old files
+  std::deque<fs::path> files;
+
+  // flight recorder mode
+  std::optional<RecordRing> ring;
 };
 
 void DataLogBackgroundWriter::BufferHalfFull() {
@@ -223,7 +437,7 @@ bool DataLogBackgroundWriter::BufferFull() {
   return true;
 }
 
-void DataLogBackgroundWriter::StartLogFile(WriterThreadState& state) {
+bool DataLogBackgroundWriter::OpenLogFile(WriterThreadState& state) {
   std::error_code ec;
 
   if (state.filename.empty()) {
@@ -241,40 +455,194 @@ void DataLogBackgroundWriter::StartLogFile(WriterThreadState& state) {
     WPI_ERROR(m_msglog,
               "Insufficient free space ({} available), no log being saved",
               FormatBytesSize(state.freeSpace));
-    m_state = kStopped;
-  } else {
-    // try preferred filename, or randomize it a few times, before giving up
-    for (int i = 0; i < 5; ++i) {
-      // open file for append
+    return false;
+  }
+
+  // try preferred filename, or randomize it a few times, before giving up
+  for (int i = 0; i < 5; ++i) {
+    // open file for append
 #ifdef _WIN32
-      // WIN32 doesn't allow combination of CreateNew and Append
-      state.f =
-          fs::OpenFileForWrite(state.path, ec, fs::CD_CreateNew, fs::OF_None);
+    // WIN32 doesn't allow combination of CreateNew and Append
+    state.f =
+        fs::OpenFileForWrite(state.path, ec, fs::CD_CreateNew, fs::OF_None);
 #else
-      state.f =
-          fs::OpenFileForWrite(state.path, ec, fs::CD_CreateNew, fs::OF_Append);
+    state.f =
+        fs::OpenFileForWrite(state.path, ec, fs::CD_CreateNew, fs::OF_Append);
 #endif
-      if (ec) {
-        WPI_ERROR(m_msglog, "Could not open log file '{}': {}",
-                  state.path.string(), ec.message());
-        // try again with random filename
-        state.SetFilename(MakeRandomFilename());
-      } else {
+    if (ec) {
+      WPI_ERROR(m_msglog, "Could not open log file '{}': {}",
+                state.path.string(), ec.message());
+      // try again with random filename
+      state.SetFilename(MakeRandomFilename());
+    } else {
+      break;
+    }
+  }
+
+  if (state.f == fs::kInvalidFile) {
+    WPI_ERROR(m_msglog, "Could not open log file, no log being saved");
+    return false;
+  }
+  WPI_INFO(m_msglog, "Logging to '{}' ({} free space)", state.path.string(),
+           FormatBytesSize(state.freeSpace));
+  state.written = 0;
+  state.startTime = std::chrono::steady_clock::now();
+
+  // delete the oldest files if over the limit
+  state.files.emplace_back(state.path);
+  while (state.maxFiles > 0 &&
+         state.files.size() > static_cast<size_t>(state.maxFiles)) {
+    if (fs::remove(state.files.front(), ec)) {
+      WPI_INFO(m_msglog, "Deleted old log file '{}'",
+               state.files.front().string());
+    }
+    state.files.pop_front();
+  }
+  return true;
+}
+
+void DataLogBackgroundWriter::StartLogFile(WriterThreadState& state) {
+  // in flight recorder mode, the log is kept in memory
+  if (state.ring) {
+    state.ring->Clear();
+    StartFile();
+    return;
+  }
+
+  // the file is opened on the first write
+  state.openPending = true;
+  StartFile();
+}
+
+void DataLogBackgroundWriter::WriteBufs(WriterThreadState& state,
+                                        std::span<const Buffer> bufs) {
+  if (state.ring) {
+    for (auto&& buf : bufs) {
+      state.ring->Append(buf.GetData());
+    }
+    return;
+  }
+
+  if (state.openPending) {
+    state.openPending = false;
+    if (!OpenLogFile(state)) {
+      if (state.freeSpace < kMinFreeSpace) {
+        state.blocked = true;
+      }
+      return;
+    }
+    if (m_compress) {
+      WriteToFile(state.f, kCompressedHeader, state.filename, m_msglog);
+    }
+  }
+
+  if (state.f == fs::kInvalidFile || state.blocked) {
+    return;
+  }
+
+  // update free space every 10 flushes (in case other things are writing)
+  if (++state.freeSpaceCount >= 10) {
+    state.freeSpaceCount = 0;
+    std::error_code ec;
+    auto freeSpaceInfo = fs::space(state.dirPath, ec);
+    if (!ec) {
+      state.freeSpace = freeSpaceInfo.available;
+    } else {
+      state.freeSpace = UINTMAX_MAX;
+    }
+  }
+
+  // write buffers to file
+  auto writeData = [&](std::span<const uint8_t> data) {
+    // stop writing when we go below the minimum free space
+    state.freeSpace -= data.size();
+    state.written += data.size();
+    if (state.freeSpace < kMinFreeSpace) {
+      [[unlikely]] WPI_ERROR(
+          m_msglog, "Stopped logging due to low free space ({} available)",
+          FormatBytesSize(state.freeSpace));
+      state.blocked = true;
+      return;
+    }
+    WriteToFile(state.f, data, state.filename, m_msglog);
+  };
+  if (m_compress) {
+    CompressBufs(bufs, state.compressed);
+    writeData(state.compressed);
+  } else {
+    for (auto&& buf : bufs) {
+      writeData(buf.GetData());
+      if (state.blocked) {
         break;
       }
     }
+  }
 
-    if (state.f == fs::kInvalidFile) {
-      WPI_ERROR(m_msglog, "Could not open log file, no log being saved");
+  // sync to storage
+#if defined(__linux__)
+  ::fdatasync(state.f);
+#elif defined(__APPLE__)
+  ::fsync(state.f);
+#endif
+}
+
+void DataLogBackgroundWriter::SaveFlightRecorder(WriterThreadState& state) {
+  std::vector<uint8_t> data;
+  state.ring->Take(data);
+  if (!OpenLogFile(state)) {
+    return;
+  }
+  if (state.freeSpace - kMinFreeSpace < data.size()) {
+    WPI_ERROR(m_msglog,
+              "Insufficient free space ({} available) to save flight "
+              "recorder log",
+              FormatBytesSize(state.freeSpace));
+  } else {
+    if (m_compress) {
+      WriteToFile(state.f, kCompressedHeader, state.filename, m_msglog);
+      CompressData(data, state.compressed);
+      WriteToFile(state.f, state.compressed, state.filename, m_msglog);
     } else {
-      WPI_INFO(m_msglog, "Logging to '{}' ({} free space)", state.path.string(),
-               FormatBytesSize(state.freeSpace));
+      WriteToFile(state.f, data, state.filename, m_msglog);
     }
+    WPI_INFO(m_msglog, "Saved flight recorder log to '{}'",
+             state.path.string());
   }
+  state.Close();
+  state.IncrementFilename();
+}
 
-  // start file
-  if (state.f != fs::kInvalidFile) {
-    StartFile();
+void DataLogBackgroundWriter::CompressBufs(std::span<const Buffer> bufs,
+                                           std::vector<uint8_t>& out) {
+  // concatenate so blocks are full size regardless of buffer boundaries
+  m_compressScratch.clear();
+  for (auto&& buf : bufs) {
+    auto data = buf.GetData();
+    m_compressScratch.insert(m_compressScratch.end(), data.begin(),
+                             data.end());
+  }
+  CompressData(m_compressScratch, out);
+}
+
+void DataLogBackgroundWriter::CompressData(std::span<const uint8_t> data,
+                                           std::vector<uint8_t>& out) {
+  // each block: uint32 uncompressed size, uint32 stored size, data; data is
+  // stored uncompressed if compression would not make it smaller
+  wpi::SmallVector<uint8_t, 128> compressed;
+  out.clear();
+  while (!data.empty()) {
+    auto block = data.first((std::min)(data.size(), kCompressedBlockSize));
+    data = data.subspan(block.size());
+    compressed.clear();
+    std::span<const uint8_t> stored = wpi::Lz4Compress(block, compressed);
+    if (stored.size() >= block.size()) {
+      stored = block;
+    }
+    uint8_t header[8];
+    wpi::support::endian::write32le(header, block.size());
+    wpi::support::endian::write32le(header + 4, stored.size());
+    out.insert(out.end(), header, header + 8);
+    out.insert(out.end(), stored.begin(), stored.end());
   }
 }
 
@@ -286,33 +654,80 @@ void DataLogBackgroundWriter::WriterThreadMain(std::string_view dir) {
     std::scoped_lock lock{m_mutex};
     state.SetFilename(m_newFilename);
     m_newFilename.clear();
+    state.maxFiles = m_maxFiles;
   }
   StartLogFile(state);
 
   std::error_code ec;
   std::vector<DataLog::Buffer> toWrite;
-  int freeSpaceCount = 0;
   int checkExistCount = 0;
-  bool blocked = false;
-  uintmax_t written = 0;
+  uint64_t flushRequested = 0;
 
   std::unique_lock lock{m_mutex};
   do {
+    // the previous iteration processed all requests made before it started
+    if (m_flushCompleted != flushRequested) {
+      m_flushCompleted = flushRequested;
+      m_flushedCond.notify_all();
+    }
+
+    // don't wait if a flush was requested while the previous iteration ran
     bool doFlush = false;
     auto timeoutTime = std::chrono::steady_clock::now() + periodTime;
-    if (m_cond.wait_until(lock, timeoutTime) == std::cv_status::timeout) {
+    if (!m_doFlush && m_flushRequested == flushRequested &&
+        m_cond.wait_until(lock, timeoutTime) == std::cv_status::timeout) {
       doFlush = true;
     }
+    flushRequested = m_flushRequested;
 
     if (m_state == kStopped) {
       state.Close();
       continue;
     }
 
+    state.maxFileSize = (m_maxFileSize == 0 || m_maxFileSize > kMaxFileSize)
+                            ? kMaxFileSize
+                            : m_maxFileSize;
+    state.maxFiles = m_maxFiles;
+
     bool doStart = false;
 
+    // switch to or from flight recorder mode; data already logged goes to the
+    // previous destination, unless the log file has not been created yet, in
+    // which case the flight recorder continues the log instead
+    if ((m_flightRecorderSize != 0) != state.ring.has_value()) {
+      bool continueLog = m_flightRecorderSize != 0 && state.openPending;
+      if (continueLog) {
+        state.openPending = false;
+        state.ring.emplace(m_flightRecorderSize);
+      }
+      DataLog::FlushBufs(&toWrite);
+      lock.unlock();
+      WriteBufs(state, toWrite);
+      ReleaseBufs(&toWrite);
+      lock.lock();
+      if (continueLog) {
+        WPI_INFO(m_msglog, "Started flight recorder ({} max)",
+                 FormatBytesSize(m_flightRecorderSize));
+      } else if (m_flightRecorderSize != 0) {
+        if (state.f != fs::kInvalidFile) {
+          state.Close();
+          state.IncrementFilename();
+        }
+        state.ring.emplace(m_flightRecorderSize);
+        WPI_INFO(m_msglog, "Started flight recorder ({} max)",
+                 FormatBytesSize(m_flightRecorderSize));
+        doStart = true;
+      } else {
+        state.ring.reset();
+        doStart = true;
+      }
+    } else if (state.ring) {
+      state.ring->SetMaxSize(m_flightRecorderSize);
+    }
+
     // if file was deleted, recreate it with the same name
-    if (++checkExistCount >= 10) {
+    if (++checkExistCount >= 10 && state.f != fs::kInvalidFile) {
       checkExistCount = 0;
       lock.unlock();
       bool exists = fs::exists(state.path, ec);
@@ -326,13 +741,23 @@ void DataLogBackgroundWriter::WriterThreadMain(std::string_view dir) {
       }
     }
 
-    // start new file if file exceeds 1.8 GB
-    if (written > 1800000000ull) {
-      state.Close();
-      state.IncrementFilename();
-      WPI_INFO(m_msglog, "Log file reached 1.8 GB, starting new file '{}'",
-               state.filename);
-      doStart = true;
+    // start new file if file exceeds the size or age limit
+    if (state.f != fs::kInvalidFile) {
+      if (state.written > state.maxFileSize) {
+        state.Close();
+        state.IncrementFilename();
+        WPI_INFO(m_msglog, "Log file reached {}, starting new file '{}'",
+                 FormatBytesSize(state.maxFileSize), state.filename);
+        doStart = true;
+      } else if (m_maxFileAge > 0 &&
+                 std::chrono::steady_clock::now() - state.startTime >=
+                     std::chrono::duration<double>{m_maxFileAge}) {
+        state.Close();
+        state.IncrementFilename();
+        WPI_INFO(m_msglog, "Log file reached {} s, starting new file '{}'",
+                 m_maxFileAge, state.filename);
+        doStart = true;
+      }
     }
 
     if (m_state == kStart || doStart) {
@@ -344,10 +769,13 @@ void DataLogBackgroundWriter::WriterThreadMain(std::string_view dir) {
         continue;
       }
       m_state = kActive;
-      written = 0;
     }
 
-    if (!m_newFilename.empty() && state.f != fs::kInvalidFile) {
+    if (!m_newFilename.empty() && (state.ring || state.openPending)) {
+      // used for the next flight recorder file or the file not yet created
+      state.SetFilename(m_newFilename);
+      m_newFilename.clear();
+    } else if (!m_newFilename.empty() && state.f != fs::kInvalidFile) {
       auto newFilename = std::move(m_newFilename);
       m_newFilename.clear();
       // rename
@@ -364,79 +792,70 @@ void DataLogBackgroundWriter::WriterThreadMain(std::string_view dir) {
                  newFilename);
       }
       state.SetFilename(newFilename);
+      if (!ec && !state.files.empty()) {
+        state.files.back() = state.path;
+      }
     }
 
     if (doFlush || m_doFlush) {
       // flush to file
       m_doFlush = false;
       DataLog::FlushBufs(&toWrite);
-      if (toWrite.empty()) {
-        continue;
-      }
-
-      if (state.f != fs::kInvalidFile && !blocked) {
+      if (!toWrite.empty()) {
         lock.unlock();
-
-        // update free space every 10 flushes (in case other things are writing)
-        if (++freeSpaceCount >= 10) {
-          freeSpaceCount = 0;
-          auto freeSpaceInfo = fs::space(state.dirPath, ec);
-          if (!ec) {
-            state.freeSpace = freeSpaceInfo.available;
-          } else {
-            state.freeSpace = UINTMAX_MAX;
-          }
-        }
-
-        // write buffers to file
-        for (auto&& buf : toWrite) {
-          // stop writing when we go below the minimum free space
-          state.freeSpace -= buf.GetData().size();
-          written += buf.GetData().size();
-          if (state.freeSpace < kMinFreeSpace) {
-            [[unlikely]] WPI_ERROR(
-                m_msglog,
-                "Stopped logging due to low free space ({} available)",
-                FormatBytesSize(state.freeSpace));
-            blocked = true;
-            break;
-          }
-          WriteToFile(state.f, buf.GetData(), state.filename, m_msglog);
-        }
-
-        // sync to storage
-#if defined(__linux__)
-        ::fdatasync(state.f);
-#elif defined(__APPLE__)
-        ::fsync(state.f);
-#endif
+        WriteBufs(state, toWrite);
         lock.lock();
-        if (blocked) {
+        if (state.blocked) {
           [[unlikely]] m_state = kPaused;
         }
+
+        // release buffers back to free list
+        ReleaseBufs(&toWrite);
       }
+    }
 
-      // release buffers back to free list
-      ReleaseBufs(&toWrite);
+    if (m_doTrigger) {
+      m_doTrigger = false;
+      if (state.ring) {
+        lock.unlock();
+        SaveFlightRecorder(state);
+        lock.lock();
+      }
     }
   } while (!m_shutdown);
+  m_flushCompleted = flushRequested;
+  m_flushedCond.notify_all();
 }
 
 void DataLogBackgroundWriter::WriterThreadMain(
     std::function<void(std::span<const uint8_t> data)> write) {
   std::chrono::duration<double> periodTime{m_period};
 
+  if (m_compress) {
+    write(kCompressedHeader);
+  }
   StartFile();
 
   std::vector<DataLog::Buffer> toWrite;
+  std::vector<uint8_t> compressed;
+  uint64_t flushRequested = 0;
 
   std::unique_lock lock{m_mutex};
   do {
+    // the previous iteration processed all requests made before it started
+    if (m_flushCompleted != flushRequested) {
+      m_flushCompleted = flushRequested;
+      m_flushedCond.notify_all();
+    }
+
+    // don't wait if a flush was requested while the previous iteration ran
     bool doFlush = false;
     auto timeoutTime = std::chrono::steady_clock::now() + periodTime;
-    if (m_cond.wait_until(lock, timeoutTime) == std::cv_status::timeout) {
+    if (!m_doFlush && m_flushRequested == flushRequested &&
+        m_cond.wait_until(lock, timeoutTime) == std::cv_status::timeout) {
       doFlush = true;
     }
+    flushRequested = m_flushRequested;
 
     if (doFlush || m_doFlush) {
       // flush to file
@@ -448,9 +867,16 @@ void DataLogBackgroundWriter::WriterThreadMain(
 
       lock.unlock();
       // write buffers
-      for (auto&& buf : toWrite) {
-        if (!buf.GetData().empty()) {
-          write(buf.GetData());
+      if (m_compress) {
+        CompressBufs(toWrite, compressed);
+        if (!compressed.empty()) {
+          write(compressed);
+        }
+      } else {
+        for (auto&& buf : toWrite) {
+          if (!buf.GetData().empty()) {
+            write(buf.GetData());
+          }
         }
       }
       lock.lock();
@@ -459,6 +885,8 @@ void DataLogBackgroundWriter::WriterThreadMain(
       ReleaseBufs(&toWrite);
     }
   } while (!m_shutdown);
+  m_flushCompleted = flushRequested;
+  m_flushedCond.notify_all();
 
   write({});  // indicate EOF
 }
@@ -0,0 +1,250 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/DataLogIndex.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "wpi/DataLogParallelReader.h"
+#include "wpi/DataLogReader.h"
+#include "wpi/DenseMap.h"
+#include "wpi/Endian.h"
+#include "wpi/fs.h"
+#include "wpi/raw_ostream.h"
+
+using namespace wpi::log;
+
+// "WPILOGIX" read as a little endian integer
+static constexpr uint64_t kMagic = 0x5849474f4c495057ull;
+static constexpr uint64_t kVersion = 1;
+
+namespace {
+struct IndexChunk {
+  wpi::DenseMap<int, std::vector<uint64_t>> entryOffsets;
+  std::vector<std::pair<int64_t, uint64_t>> times;
+  uint64_t count = 0;
+};
+}  // namespace
+
+DataLogIndex::DataLogIndex(const DataLogReader& reader, uint32_t timeInterval,
+                           unsigned int numThreads) {
+  if (!reader || timeInterval == 0) {
+    return;
+  }
+
+  // scan chunks in parallel; time samples restart at each chunk boundary and
+  // only hold the maximum timestamp within the chunk until merged
+  DataLogParallelReader parallel{reader, numThreads};
+  auto chunks = parallel.ReadChunks<IndexChunk>(
+      [&](IndexChunk& chunk, DataLogIterator it) {
+        uint64_t pos = it.GetPosition();
+        chunk.entryOffsets[it->GetEntry()].emplace_back(pos);
+        int64_t timestamp = it->GetTimestamp();
+        if ((chunk.count % timeInterval) == 0) {
+          chunk.times.emplace_back(timestamp, pos);
+        } else {
+          chunk.times.back().first =
+              (std::max)(chunk.times.back().first, timestamp);
+        }
+        ++chunk.count;
+      });
+
+  // merge in file order
+  wpi::DenseMap<int, std::vector<uint64_t>> entryOffsets;
+  std::vector<std::pair<int64_t, uint64_t>> times;
+  uint64_t count = 0;
+  int64_t maxTimestamp = INT64_MIN;
+  for (auto&& chunk : chunks) {
+    for (auto&& [entry, offsets] : chunk.entryOffsets) {
+      auto& dest = entryOffsets[entry];
+      dest.insert(dest.end(), offsets.begin(), offsets.end());
+    }
+    for (auto&& [timestamp, pos] : chunk.times) {
+      maxTimestamp = (std::max)(maxTimestamp, timestamp);
+      times.emplace_back(maxTimestamp, pos);
+    }
+    count += chunk.count;
+  }
+
+  std::vector<int> entries;
+  entries.reserve(entryOffsets.size());
+  for (auto&& [entry, offsets] : entryOffsets) {
+    entries.emplace_back(entry);
+  }
+  std::sort(entries.begin(), entries.end());
+
+  m_owned.reserve(kHeaderWords + entries.size() * 3 + count +
+                  times.size() * 2);
+  m_owned.insert(m_owned.end(),
+                 {kMagic, kVersion, reader.m_buf->size(), entries.size(),
+                  count, times.size()});
+  uint64_t first = 0;
+  for (auto entry : entries) {
+    uint64_t n = entryOffsets[entry].size();
+    m_owned.insert(m_owned.end(), {static_cast<uint64_t>(entry), first, n});
+    first += n;
+  }
+  for (auto entry : entries) {
+    auto& offsets = entryOffsets[entry];
+    m_owned.insert(m_owned.end(), offsets.begin(), offsets.end());
+  }
+  for (auto&& [timestamp, pos] : times) {
+    m_owned.insert(m_owned.end(), {static_cast<uint64_t>(timestamp), pos});
+  }
+
+  m_data = m_owned;
+  Parse(reader.m_buf->size());
+}
+
+DataLogIndex::DataLogIndex(std::string_view filename,
+                           const DataLogReader& reader, std::error_code& ec) {
+  if constexpr (std::endian::native != std::endian::little) {
+    // the index is mapped directly, so it can only be used on little endian
+    ec = std::make_error_code(std::errc::not_supported);
+    return;
+  }
+  if (!reader) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return;
+  }
+  fs::file_t f = fs::OpenFileForRead(fs::path{filename}, ec);
+  if (ec) {
+    return;
+  }
+  uint64_t size = fs::file_size(fs::path{filename}, ec);
+  if (!ec) {
+    m_region = MappedFileRegion{f, size, 0, MappedFileRegion::kReadOnly, ec};
+  }
+  fs::CloseFile(f);
+  if (ec) {
+    return;
+  }
+  m_data = {reinterpret_cast<const uint64_t*>(m_region.const_data()),
+            static_cast<size_t>(size / 8)};
+  if (!Parse(reader.m_buf->size())) {
+    m_region.Unmap();
+    ec = std::make_error_code(std::errc::invalid_argument);
+  }
+}
+
+DataLogIndex DataLogIndex::LoadOrBuild(std::string_view filename,
+                                       const DataLogReader& reader) {
+  std::error_code ec;
+  DataLogIndex index{filename, reader, ec};
+  if (!ec) {
+    return index;
+  }
+  index = DataLogIndex{reader};
+  index.Save(filename, ec);
+  return index;
+}
+
+void DataLogIndex::Save(std::string_view filename, std::error_code& ec) const {
+  if (m_data.empty()) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return;
+  }
+  wpi::raw_fd_ostream os{filename, ec, fs::OF_None};
+  if (ec) {
+    return;
+  }
+  for (auto word : m_data) {
+    uint8_t buf[8];
+    wpi::support::endian::write64le(buf, word);
+    os.write(buf, 8);
+  }
+  os.close();
+  if (os.has_error()) {
+    ec = os.error();
+  }
+}
+
+bool DataLogIndex::Parse(uint64_t logSize) {
+  auto data = m_data;
+  m_data = {};
+  if (data.size() < kHeaderWords || data[0] != kMagic ||
+      data[1] != kVersion || data[2] != logSize) {
+    return false;
+  }
+  uint64_t numEntries = data[3];
+  uint64_t numOffsets = data[4];
+  uint64_t numTimes = data[5];
+  // check this way to avoid overflow
+  uint64_t avail = data.size() - kHeaderWords;
+  if (numEntries > avail / 3 || numOffsets > avail - numEntries * 3 ||
+      numTimes > (avail - numEntries * 3 - numOffsets) / 2) {
+    return false;
+  }
+  auto entries = data.subspan(kHeaderWords, numEntries * 3);
+  auto offsets = data.subspan(kHeaderWords + numEntries * 3, numOffsets);
+  auto times =
+      data.subspan(kHeaderWords + numEntries * 3 + numOffsets, numTimes * 2);
+  for (size_t i = 0; i < entries.size(); i += 3) {
+    if (entries[i + 1] > numOffsets ||
+        entries[i + 2] > numOffsets - entries[i + 1]) {
+      return false;
+    }
+  }
+  m_data = data;
+  m_entries = entries;
+  m_offsets = offsets;
+  m_times = times;
+  m_logSize = logSize;
+  return true;
+}
+
+std::vector<int> DataLogIndex::GetEntries() const {
+  std::vector<int> rv;
+  rv.reserve(m_entries.size() / 3);
+  for (size_t i = 0; i < m_entries.size(); i += 3) {
+    rv.emplace_back(static_cast<int>(m_entries[i]));
+  }
+  return rv;
+}
+
+std::span<const uint64_t> DataLogIndex::GetRecordOffsets(int entry) const {
+  // entries are sorted by id; binary search on every third word
+  size_t lo = 0;
+  size_t hi = m_entries.size() / 3;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    auto id = static_cast<int>(m_entries[mid * 3]);
+    if (id == entry) {
+      return m_offsets.subspan(m_entries[mid * 3 + 1], m_entries[mid * 3 + 2]);
+    } else if (id < entry) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return {};
+}
+
+uint64_t DataLogIndex::FindTimestamp(int64_t timestamp) const {
+  // each sample is the maximum timestamp through the end of its block of
+  // records, so samples are sorted by timestamp
+  size_t lo = 0;
+  size_t hi = m_times.size() / 2;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (static_cast<int64_t>(m_times[mid * 2]) < timestamp) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == m_times.size() / 2) {
+    return m_logSize;
+  }
+  return m_times[lo * 2 + 1];
+}
+
+uint64_t DataLogIndex::GetRecordCount() const {
+  return m_offsets.size();
+}
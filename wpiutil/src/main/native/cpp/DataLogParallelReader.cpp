@@ -0,0 +1,213 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/DataLogParallelReader.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace wpi::log;
+
+// chunks smaller than this aren't worth splitting
+static constexpr size_t kMinChunkSize = 256 * 1024;
+// chunks per thread, to balance load when record density varies
+static constexpr size_t kChunksPerThread = 4;
+// number of consecutive plausible record headers needed to resynchronize
+static constexpr int kResyncRecords = 8;
+
+namespace {
+struct ChunkState {
+  size_t start;  // SIZE_MAX if no record start was found
+  size_t limit;  // records starting at or after this belong to the next chunk
+  size_t end{SIZE_MAX};  // position after the last record read
+  bool stopped{false};   // reached the end of the log (or invalid data)
+};
+}  // namespace
+
+// Checks that the header at buf[0] could have been written by DataLog, and
+// returns its total record length (0 if implausible).  DataLog always writes
+// minimal-length integers and never sets the top bit of the length byte.
+static size_t CheckHeader(std::span<const uint8_t> buf) {
+  if (buf.size() < 4 || (buf[0] & 0x80) != 0) {
+    return 0;
+  }
+  unsigned int entryLen = (buf[0] & 0x3) + 1;
+  unsigned int sizeLen = ((buf[0] >> 2) & 0x3) + 1;
+  unsigned int timestampLen = ((buf[0] >> 4) & 0x7) + 1;
+  unsigned int headerLen = 1 + entryLen + sizeLen + timestampLen;
+  if (buf.size() < headerLen) {
+    return 0;
+  }
+  if ((entryLen > 1 && buf[entryLen] == 0) ||
+      (sizeLen > 1 && buf[entryLen + sizeLen] == 0) ||
+      (timestampLen > 1 && buf[headerLen - 1] == 0)) {
+    return 0;
+  }
+  uint32_t size = 0;
+  for (unsigned int i = 0; i < sizeLen; ++i) {
+    size |= static_cast<uint32_t>(buf[1 + entryLen + i]) << (8 * i);
+  }
+  if (size > buf.size() - headerLen) {
+    return 0;
+  }
+  return headerLen + size;
+}
+
+DataLogParallelReader::DataLogParallelReader(const DataLogReader& reader,
+                                             unsigned int numThreads)
+    : m_reader{reader}, m_numThreads{numThreads} {
+  if (m_numThreads == 0) {
+    m_numThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+  }
+  size_t size = m_reader.m_buf ? m_reader.m_buf->size() : 0;
+  m_numChunks = std::clamp<size_t>(size / kMinChunkSize, 1,
+                                   m_numThreads * kChunksPerThread);
+}
+
+size_t DataLogParallelReader::Resync(size_t pos, size_t limit) const {
+  auto buf = m_reader.m_buf->GetBuffer();
+  for (; pos < limit; ++pos) {
+    size_t cur = pos;
+    int count = 0;
+    for (; count < kResyncRecords && cur < buf.size(); ++count) {
+      size_t len = CheckHeader(buf.subspan(cur));
+      if (len == 0) {
+        break;
+      }
+      cur += len;
+    }
+    if (count == kResyncRecords || cur == buf.size()) {
+      return pos;
+    }
+  }
+  return SIZE_MAX;
+}
+
+bool DataLogParallelReader::ForEachRecord(
+    function_ref<void(size_t chunk)> resetChunk,
+    function_ref<bool(size_t chunk, DataLogIterator it)> func,
+    function_ref<void(size_t chunk)> chunkDone) const {
+  auto begin = m_reader.begin();
+  if (begin == m_reader.end()) {
+    return true;
+  }
+  size_t first = begin.GetPosition();
+  size_t size = m_reader.m_buf->size();
+
+  std::vector<ChunkState> chunks(m_numChunks);
+  for (size_t i = 0; i < m_numChunks; ++i) {
+    chunks[i].limit = first + (size - first) * (i + 1) / m_numChunks;
+  }
+  chunks[0].start = first;
+
+  // set when func returns false; checked between records and chunks
+  std::atomic_bool stopped{false};
+
+  auto readChunk = [&](size_t i, size_t start) {
+    auto& chunk = chunks[i];
+    auto it = m_reader.Seek(start);
+    auto end = m_reader.end();
+    for (; it != end && it.GetPosition() < chunk.limit; ++it) {
+      if (stopped || !func(i, it)) {
+        stopped = true;
+        return;
+      }
+    }
+    if (it == end) {
+      chunk.stopped = true;
+    } else {
+      chunk.end = it.GetPosition();
+    }
+  };
+
+  // verifies a chunk started where the previous one ended; if not, discards
+  // it and reads it again from the right place
+  auto verifyChunk = [&](size_t i) {
+    auto& prev = chunks[i - 1];
+    auto& chunk = chunks[i];
+    if (prev.stopped) {
+      if (chunk.start != SIZE_MAX) {
+        resetChunk(i);
+      }
+      chunk.stopped = true;
+    } else if (chunk.start != prev.end) {
+      if (chunk.start != SIZE_MAX) {
+        resetChunk(i);
+      }
+      chunk.start = prev.end;
+      chunk.stopped = false;
+      chunk.end = SIZE_MAX;
+      if (chunk.start < chunk.limit) {
+        readChunk(i, chunk.start);
+      } else {
+        // the previous chunk's last record extends past this entire chunk
+        chunk.end = chunk.start;
+      }
+    }
+  };
+
+  // chunks are verified in order as soon as they and all previous chunks
+  // have been read, by whichever thread finishes the next chunk in order
+  std::mutex mutex;
+  std::vector<bool> read(m_numChunks);
+  size_t numDone = 0;
+  bool verifying = false;
+  auto finishChunk = [&](size_t i) {
+    std::unique_lock lock{mutex};
+    read[i] = true;
+    if (verifying) {
+      return;
+    }
+    verifying = true;
+    while (!stopped && numDone < m_numChunks && read[numDone]) {
+      size_t j = numDone;
+      lock.unlock();
+      if (j != 0) {
+        verifyChunk(j);
+      }
+      if (!stopped) {
+        chunkDone(j);
+      }
+      lock.lock();
+      ++numDone;
+    }
+    verifying = false;
+  };
+
+  // read chunks in parallel, each from its guessed start
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (;;) {
+      size_t i = next++;
+      if (i >= m_numChunks || stopped) {
+        return;
+      }
+      auto& chunk = chunks[i];
+      if (i != 0) {
+        chunk.start = Resync(chunks[i - 1].limit, chunk.limit);
+      }
+      if (chunk.start != SIZE_MAX) {
+        readChunk(i, chunk.start);
+      }
+      finishChunk(i);
+    }
+  };
+  unsigned int numThreads = (std::min)(
+      m_numThreads, static_cast<unsigned int>(m_numChunks));
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  return !stopped;
+}
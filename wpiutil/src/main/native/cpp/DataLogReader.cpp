@@ -4,11 +4,15 @@
 
 #include "wpi/DataLogReader.h"
 
+#include <algorithm>
 #include <bit>
+#include <string_view>
 #include <utility>
 
 #include "wpi/DataLog.h"
 #include "wpi/Endian.h"
+#include "wpi/MemoryBuffer.h"
+#include "wpi/lz4.h"
 
 using namespace wpi::log;
 
@@ -189,8 +193,58 @@ bool DataLogRecord::GetStringArray(std::vector<std::string_view>* arr) const {
   return true;
 }
 
+// Decompresses a log written by DataLogBackgroundWriter with compression
+// enabled.  The container is an 8-byte header ("WPILZ4" and a 16-bit version)
+// followed by blocks, each a 32-bit uncompressed size, a 32-bit stored size,
+// and the stored data (raw if the sizes are equal).  A truncated or corrupt
+// tail (e.g. from a power loss mid-write) is dropped.
+static std::unique_ptr<wpi::MemoryBuffer> Decompress(
+    std::unique_ptr<wpi::MemoryBuffer> buffer) {
+  auto in = buffer->GetBuffer();
+  if (in.size() < 8 ||
+      std::string_view{reinterpret_cast<const char*>(in.data()), 6} !=
+          "WPILZ4" ||
+      wpi::support::endian::read16le(&in[6]) < 0x0100) {
+    return buffer;
+  }
+  in = in.subspan(8);
+
+  // determine the total size of the complete blocks
+  size_t total = 0;
+  for (auto blocks = in; blocks.size() >= 8;) {
+    uint32_t size = wpi::support::endian::read32le(&blocks[0]);
+    uint32_t stored = wpi::support::endian::read32le(&blocks[4]);
+    if (stored > size || stored > blocks.size() - 8) {
+      break;
+    }
+    total += size;
+    blocks = blocks.subspan(8 + stored);
+  }
+
+  auto out = wpi::WritableMemoryBuffer::GetNewUninitMemBuffer(
+      total, buffer->GetBufferIdentifier());
+  auto outBuf = out->GetBuffer();
+  size_t pos = 0;
+  while (pos < total) {
+    uint32_t size = wpi::support::endian::read32le(&in[0]);
+    uint32_t stored = wpi::support::endian::read32le(&in[4]);
+    auto data = in.subspan(8, stored);
+    auto dest = outBuf.subspan(pos, size);
+    if (stored == size) {
+      std::copy(data.begin(), data.end(), dest.begin());
+    } else if (!wpi::Lz4Decompress(data, dest)) {
+      // keep only the data decompressed so far
+      return wpi::MemoryBuffer::GetMemBufferCopy(outBuf.first(pos),
+                                                 buffer->GetBufferIdentifier());
+    }
+    pos += size;
+    in = in.subspan(8 + stored);
+  }
+  return out;
+}
+
 DataLogReader::DataLogReader(std::unique_ptr<MemoryBuffer> buffer)
-    : m_buf{std::move(buffer)} {}
+    : m_buf{buffer ? Decompress(std::move(buffer)) : nullptr} {}
 
 bool DataLogReader::IsValid() const {
   if (!m_buf) {
@@ -243,6 +297,13 @@ DataLogReader::iterator DataLogReader::begin() const {
   return DataLogIterator{this, 12 + size};
 }
 
+DataLogReader::iterator DataLogReader::Seek(size_t pos) const {
+  if (!m_buf || pos >= m_buf->size()) {
+    return end();
+  }
+  return DataLogIterator{this, pos};
+}
+
 static uint64_t ReadVarInt(std::span<const uint8_t> buf) {
   uint64_t val = 0;
   int shift = 0;
@@ -0,0 +1,178 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/lz4.h"
+
+#include <cstring>
+
+#include "wpi/SmallVector.h"
+
+// LZ4 block format: a series of sequences, each consisting of a token byte
+// (high nibble literal length, low nibble match length - 4), optional literal
+// length extension bytes, the literals, a 2-byte little endian match offset,
+// and optional match length extension bytes.  The final sequence has only
+// literals.
+
+static constexpr size_t kMinMatch = 4;
+// the last 5 bytes are always literals
+static constexpr size_t kLastLiterals = 5;
+// the last match must start at least 12 bytes before the end
+static constexpr size_t kMatchFindLimit = 12;
+static constexpr size_t kMaxOffset = 65535;
+static constexpr int kHashLog = 12;
+
+static inline uint32_t Read32(const uint8_t* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t Hash(uint32_t v) {
+  return (v * 2654435761u) >> (32 - kHashLog);
+}
+
+static void WriteLength(uint8_t* out, size_t* pos, size_t len) {
+  for (; len >= 255; len -= 255) {
+    out[(*pos)++] = 255;
+  }
+  out[(*pos)++] = static_cast<uint8_t>(len);
+}
+
+static void WriteSequence(uint8_t* out, size_t* pos, const uint8_t* literals,
+                          size_t numLiterals, size_t offset, size_t matchLen) {
+  uint8_t& token = out[(*pos)++];
+  if (numLiterals >= 15) {
+    token = 15 << 4;
+    WriteLength(out, pos, numLiterals - 15);
+  } else {
+    token = numLiterals << 4;
+  }
+  std::memcpy(out + *pos, literals, numLiterals);
+  *pos += numLiterals;
+  if (matchLen == 0) {
+    return;  // last sequence
+  }
+  out[(*pos)++] = offset & 0xff;
+  out[(*pos)++] = (offset >> 8) & 0xff;
+  matchLen -= kMinMatch;
+  if (matchLen >= 15) {
+    token |= 15;
+    WriteLength(out, pos, matchLen - 15);
+  } else {
+    token |= matchLen;
+  }
+}
+
+std::span<uint8_t> wpi::Lz4Compress(std::span<const uint8_t> in,
+                                    SmallVectorImpl<uint8_t>& out) {
+  size_t start = out.size();
+  out.resize_for_overwrite(start + Lz4CompressBound(in.size()));
+  uint8_t* dest = out.data() + start;
+  size_t destPos = 0;
+
+  const uint8_t* src = in.data();
+  size_t anchor = 0;
+  if (in.size() > kMatchFindLimit) {
+    uint32_t table[1 << kHashLog] = {};
+    size_t matchLimit = in.size() - kLastLiterals;
+    size_t findLimit = in.size() - kMatchFindLimit;
+    size_t pos = 0;
+    while (pos < findLimit) {
+      uint32_t v = Read32(src + pos);
+      uint32_t& slot = table[Hash(v)];
+      size_t candidate = slot;
+      slot = pos;
+      if (candidate >= pos || pos - candidate > kMaxOffset ||
+          Read32(src + candidate) != v) {
+        // skip faster through incompressible data
+        pos += 1 + ((pos - anchor) >> 6);
+        continue;
+      }
+      size_t len = kMinMatch;
+      while (pos + len < matchLimit && src[candidate + len] == src[pos + len]) {
+        ++len;
+      }
+      WriteSequence(dest, &destPos, src + anchor, pos - anchor,
+                    pos - candidate, len);
+      pos += len;
+      anchor = pos;
+    }
+  }
+  WriteSequence(dest, &destPos, src + anchor, in.size() - anchor, 0, 0);
+
+  out.truncate(start + destPos);
+  return {out.data() + start, destPos};
+}
+
+// reads a length extension; returns false on truncated input
+static bool ReadLength(std::span<const uint8_t> in, size_t* pos, size_t* len,
+                       size_t max) {
+  uint8_t b;
+  do {
+    if (*pos >= in.size()) {
+      return false;
+    }
+    b = in[(*pos)++];
+    *len += b;
+    if (*len > max) {
+      return false;
+    }
+  } while (b == 255);
+  return true;
+}
+
+bool wpi::Lz4Decompress(std::span<const uint8_t> in, std::span<uint8_t> out) {
+  size_t inPos = 0;
+  size_t outPos = 0;
+  while (inPos < in.size()) {
+    uint8_t token = in[inPos++];
+
+    // literals
+    size_t numLiterals = token >> 4;
+    if (numLiterals == 15 &&
+        !ReadLength(in, &inPos, &numLiterals, out.size())) {
+      return false;
+    }
+    if (numLiterals > in.size() - inPos ||
+        numLiterals > out.size() - outPos) {
+      return false;
+    }
+    std::memcpy(out.data() + outPos, in.data() + inPos, numLiterals);
+    inPos += numLiterals;
+    outPos += numLiterals;
+    if (inPos == in.size()) {
+      return outPos == out.size();  // last sequence
+    }
+
+    // match
+    if (in.size() - inPos < 2) {
+      return false;
+    }
+    size_t offset = in[inPos] | (in[inPos + 1] << 8);
+    inPos += 2;
+    if (offset == 0 || offset > outPos) {
+      return false;
+    }
+    size_t matchLen = token & 0xf;
+    if (matchLen == 15 && !ReadLength(in, &inPos, &matchLen, out.size())) {
+      return false;
+    }
+    matchLen += kMinMatch;
+    if (matchLen > out.size() - outPos) {
+      return false;
+    }
+    uint8_t* dest = out.data() + outPos;
+    const uint8_t* src = dest - offset;
+    if (offset >= matchLen) {
+      std::memcpy(dest, src, matchLen);
+    } else {
+      // overlapping copy repeats the last offset bytes
+      for (size_t i = 0; i < matchLen; ++i) {
+        dest[i] = src[i];
+      }
+    }
+    outPos += matchLen;
+  }
+  return false;
+}
@@ -0,0 +1,369 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/protobuf/DynamicProtobufDecoder.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include <google/protobuf/descriptor.h>
+
+#include "wpi/DenseMap.h"
+#include "wpi/Endian.h"
+#include "wpi/bit.h"
+
+using namespace wpi;
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using FieldType = DynamicProtobufDecoder::FieldType;
+
+// same as the protobuf library default
+static constexpr int kMaxDepth = 100;
+
+// field numbers above this are looked up by searching instead of indexing
+static constexpr uint32_t kMaxIndexedNumber = 1024;
+
+namespace {
+enum WireType : uint8_t {
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+  kFixed32 = 5,
+};
+}  // namespace
+
+static bool ToFieldType(FieldDescriptor::Type type, FieldType* out) {
+  switch (type) {
+    case FieldDescriptor::TYPE_DOUBLE:
+      *out = FieldType::kDouble;
+      return true;
+    case FieldDescriptor::TYPE_FLOAT:
+      *out = FieldType::kFloat;
+      return true;
+    case FieldDescriptor::TYPE_INT32:
+      *out = FieldType::kInt32;
+      return true;
+    case FieldDescriptor::TYPE_INT64:
+      *out = FieldType::kInt64;
+      return true;
+    case FieldDescriptor::TYPE_UINT32:
+      *out = FieldType::kUint32;
+      return true;
+    case FieldDescriptor::TYPE_UINT64:
+      *out = FieldType::kUint64;
+      return true;
+    case FieldDescriptor::TYPE_SINT32:
+      *out = FieldType::kSint32;
+      return true;
+    case FieldDescriptor::TYPE_SINT64:
+      *out = FieldType::kSint64;
+      return true;
+    case FieldDescriptor::TYPE_FIXED32:
+      *out = FieldType::kFixed32;
+      return true;
+    case FieldDescriptor::TYPE_FIXED64:
+      *out = FieldType::kFixed64;
+      return true;
+    case FieldDescriptor::TYPE_SFIXED32:
+      *out = FieldType::kSfixed32;
+      return true;
+    case FieldDescriptor::TYPE_SFIXED64:
+      *out = FieldType::kSfixed64;
+      return true;
+    case FieldDescriptor::TYPE_BOOL:
+      *out = FieldType::kBool;
+      return true;
+    case FieldDescriptor::TYPE_ENUM:
+      *out = FieldType::kEnum;
+      return true;
+    case FieldDescriptor::TYPE_STRING:
+      *out = FieldType::kString;
+      return true;
+    case FieldDescriptor::TYPE_BYTES:
+      *out = FieldType::kBytes;
+      return true;
+    case FieldDescriptor::TYPE_MESSAGE:
+      *out = FieldType::kMessage;
+      return true;
+    default:
+      // groups are not supported
+      return false;
+  }
+}
+
+static WireType GetWireType(FieldType type) {
+  switch (type) {
+    case FieldType::kDouble:
+    case FieldType::kFixed64:
+    case FieldType::kSfixed64:
+      return kFixed64;
+    case FieldType::kFloat:
+    case FieldType::kFixed32:
+    case FieldType::kSfixed32:
+      return kFixed32;
+    case FieldType::kString:
+    case FieldType::kBytes:
+    case FieldType::kMessage:
+      return kLengthDelimited;
+    default:
+      return kVarint;
+  }
+}
+
+DynamicProtobufDecoder::DynamicProtobufDecoder(const Descriptor* desc) {
+  // compile the message and all referenced message types breadth-first; a
+  // message type that references itself (directly or indirectly) refers back
+  // to the same compiled message
+  wpi::DenseMap<const Descriptor*, int> indices;
+  std::vector<const Descriptor*> descs;
+  indices[desc] = 0;
+  descs.emplace_back(desc);
+  for (size_t i = 0; i < descs.size(); ++i) {
+    const Descriptor* msgDesc = descs[i];
+    Message msg;
+    msg.name = msgDesc->full_name();
+    uint32_t maxNumber = 0;
+    for (int j = 0; j < msgDesc->field_count(); ++j) {
+      const FieldDescriptor* fieldDesc = msgDesc->field(j);
+      Field field;
+      if (!ToFieldType(fieldDesc->type(), &field.type)) {
+        continue;
+      }
+      field.name = fieldDesc->name();
+      field.number = fieldDesc->number();
+      field.repeated = fieldDesc->is_repeated();
+      field.message = -1;
+      if (field.type == FieldType::kMessage) {
+        auto [it, isNew] = indices.try_emplace(fieldDesc->message_type(),
+                                               static_cast<int>(descs.size()));
+        if (isNew) {
+          descs.emplace_back(fieldDesc->message_type());
+        }
+        field.message = it->second;
+      } else if (field.type == FieldType::kEnum) {
+        auto enumDesc = fieldDesc->enum_type();
+        for (int k = 0; k < enumDesc->value_count(); ++k) {
+          auto valueDesc = enumDesc->value(k);
+          field.enumValues.emplace_back(valueDesc->number(),
+                                        std::string{valueDesc->name()});
+        }
+      }
+      if (field.number <= kMaxIndexedNumber) {
+        maxNumber = (std::max)(maxNumber, field.number);
+      }
+      msg.fields.emplace_back(std::move(field));
+    }
+    msg.fieldsByNumber.resize(maxNumber + 1, -1);
+    for (size_t j = 0; j < msg.fields.size(); ++j) {
+      if (msg.fields[j].number <= kMaxIndexedNumber) {
+        msg.fieldsByNumber[msg.fields[j].number] = j;
+      }
+    }
+    m_messages.emplace_back(std::move(msg));
+  }
+}
+
+static bool ReadVarint(std::span<const uint8_t>* data, uint64_t* value) {
+  uint64_t result = 0;
+  size_t i = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    if (i >= data->size()) {
+      [[unlikely]] return false;
+    }
+    uint8_t byte = (*data)[i++];
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *data = data->subspan(i);
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool ReadLength(std::span<const uint8_t>* data,
+                       std::span<const uint8_t>* out) {
+  uint64_t len;
+  if (!ReadVarint(data, &len) || len > data->size()) {
+    [[unlikely]] return false;
+  }
+  *out = data->first(len);
+  *data = data->subspan(len);
+  return true;
+}
+
+static bool SkipField(std::span<const uint8_t>* data, unsigned int wireType) {
+  switch (wireType) {
+    case kVarint: {
+      uint64_t value;
+      return ReadVarint(data, &value);
+    }
+    case kFixed64:
+      if (data->size() < 8) {
+        [[unlikely]] return false;
+      }
+      *data = data->subspan(8);
+      return true;
+    case kLengthDelimited: {
+      std::span<const uint8_t> value;
+      return ReadLength(data, &value);
+    }
+    case kFixed32:
+      if (data->size() < 4) {
+        [[unlikely]] return false;
+      }
+      *data = data->subspan(4);
+      return true;
+    default:
+      // groups are not supported
+      return false;
+  }
+}
+
+// decodes a single non-length-delimited value
+static bool DecodeScalar(const DynamicProtobufDecoder::Field& field,
+                         std::span<const uint8_t>* data,
+                         DynamicProtobufDecoder::Visitor& visitor) {
+  switch (GetWireType(field.type)) {
+    case kVarint: {
+      uint64_t value;
+      if (!ReadVarint(data, &value)) {
+        [[unlikely]] return false;
+      }
+      switch (field.type) {
+        case FieldType::kInt32:
+        case FieldType::kEnum:
+          visitor.Int(field, static_cast<int32_t>(value));
+          break;
+        case FieldType::kInt64:
+          visitor.Int(field, static_cast<int64_t>(value));
+          break;
+        case FieldType::kUint32:
+          visitor.Uint(field, static_cast<uint32_t>(value));
+          break;
+        case FieldType::kSint32:
+          visitor.Int(field, static_cast<int32_t>((value >> 1) ^
+                                                  -(value & 1)));
+          break;
+        case FieldType::kSint64:
+          visitor.Int(field, static_cast<int64_t>((value >> 1) ^
+                                                  -(value & 1)));
+          break;
+        case FieldType::kBool:
+          visitor.Bool(field, value != 0);
+          break;
+        default:
+          visitor.Uint(field, value);
+          break;
+      }
+      return true;
+    }
+    case kFixed64: {
+      if (data->size() < 8) {
+        [[unlikely]] return false;
+      }
+      uint64_t value = support::endian::read64le(data->data());
+      *data = data->subspan(8);
+      if (field.type == FieldType::kDouble) {
+        visitor.Double(field, bit_cast<double>(value));
+      } else if (field.type == FieldType::kSfixed64) {
+        visitor.Int(field, static_cast<int64_t>(value));
+      } else {
+        visitor.Uint(field, value);
+      }
+      return true;
+    }
+    case kFixed32: {
+      if (data->size() < 4) {
+        [[unlikely]] return false;
+      }
+      uint32_t value = support::endian::read32le(data->data());
+      *data = data->subspan(4);
+      if (field.type == FieldType::kFloat) {
+        visitor.Float(field, bit_cast<float>(value));
+      } else if (field.type == FieldType::kSfixed32) {
+        visitor.Int(field, static_cast<int32_t>(value));
+      } else {
+        visitor.Uint(field, value);
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+bool DynamicProtobufDecoder::DecodeMessage(const Message& msg,
+                                           std::span<const uint8_t> data,
+                                           Visitor& visitor, int depth) const {
+  if (depth > kMaxDepth) {
+    [[unlikely]] return false;
+  }
+  while (!data.empty()) {
+    uint64_t tag;
+    if (!ReadVarint(&data, &tag)) {
+      [[unlikely]] return false;
+    }
+    unsigned int wireType = tag & 7;
+    uint64_t number = tag >> 3;
+
+    // look up field
+    const Field* field = nullptr;
+    if (number < msg.fieldsByNumber.size()) {
+      int index = msg.fieldsByNumber[number];
+      if (index >= 0) {
+        field = &msg.fields[index];
+      }
+    } else if (number > kMaxIndexedNumber) {
+      auto it = std::find_if(msg.fields.begin(), msg.fields.end(),
+                             [&](auto& f) { return f.number == number; });
+      if (it != msg.fields.end()) {
+        field = &*it;
+      }
+    }
+
+    WireType expected = field ? GetWireType(field->type) : kVarint;
+    if (field && wireType == expected) {
+      if (expected != kLengthDelimited) {
+        if (!DecodeScalar(*field, &data, visitor)) {
+          [[unlikely]] return false;
+        }
+        continue;
+      }
+      std::span<const uint8_t> value;
+      if (!ReadLength(&data, &value)) {
+        [[unlikely]] return false;
+      }
+      if (field->type == FieldType::kString) {
+        visitor.String(*field, {reinterpret_cast<const char*>(value.data()),
+                                value.size()});
+      } else if (field->type == FieldType::kBytes) {
+        visitor.Bytes(*field, value);
+      } else {
+        visitor.StartMessage(*field);
+        if (!DecodeMessage(m_messages[field->message], value, visitor,
+                           depth + 1)) {
+          [[unlikely]] return false;
+        }
+        visitor.EndMessage(*field);
+      }
+    } else if (field && field->repeated && wireType == kLengthDelimited) {
+      // packed repeated scalars
+      std::span<const uint8_t> values;
+      if (!ReadLength(&data, &values)) {
+        [[unlikely]] return false;
+      }
+      while (!values.empty()) {
+        if (!DecodeScalar(*field, &values, visitor)) {
+          [[unlikely]] return false;
+        }
+      }
+    } else if (!SkipField(&data, wireType)) {
+      [[unlikely]] return false;
+    }
+  }
+  return true;
+}
@@ -25,6 +25,7 @@ bool ProtobufMessageDatabase::Add(std::string_view filename,
     file.complete = false;
 
     m_msgs.clear();
+    m_decoders.clear();
     m_factory.reset();
 
     // rebuild the pool EXCEPT for this descriptor
@@ -87,6 +88,23 @@ Message* ProtobufMessageDatabase::Find(std::string_view name) const {
   return msg.get();
 }
 
+const DynamicProtobufDecoder* ProtobufMessageDatabase::FindDecoder(
+    std::string_view name) const {
+  // cached
+  auto& decoder = m_decoders[name];
+  if (decoder) {
+    return decoder.get();
+  }
+
+  // need to create it
+  auto desc = m_pool->FindMessageTypeByName(std::string{name});
+  if (!desc) {
+    return nullptr;
+  }
+  decoder = std::make_unique<DynamicProtobufDecoder>(desc);
+  return decoder.get();
+}
+
 void ProtobufMessageDatabase::Build(std::string_view filename,
                                     ProtoFile& file) {
   if (file.complete) {
@@ -4,9 +4,11 @@
 
 #include "wpi/sendable/SendableRegistry.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -20,15 +22,25 @@
 using namespace wpi;
 
 namespace {
+// Metadata is protected by the registry mutex. The builder is protected by
+// builderMutex, which is held while the builder is used, so the registry lock
+// is never held while calling into a Sendable or builder. builderMutex is
+// recursive so a Sendable callback can Remove() or Move() its own component;
+// changes to the builder are deferred until the builder is no longer in use.
 struct Component {
-  Sendable* sendable = nullptr;
-  std::unique_ptr<SendableBuilder> builder;
+  std::atomic<Sendable*> sendable = nullptr;
   std::string name;
   std::string subsystem = "Ungrouped";
   Sendable* parent = nullptr;
   bool liveWindow = false;
   wpi::SmallVector<std::shared_ptr<void>, 2> data;
 
+  wpi::recursive_mutex builderMutex;
+  std::unique_ptr<SendableBuilder> builder;
+  bool removed = false;
+  int builderUseCount = 0;
+  bool rebuild = false;
+
   void SetName(std::string_view moduleType, int channel) {
     name = fmt::format("{}[{}]", moduleType, channel);
   }
@@ -38,29 +50,112 @@ struct Component {
   }
 };
 
+// Copy of a LiveWindow component's metadata, so the callback can run without
+// the registry lock
+struct LiveWindowEntry {
+  std::shared_ptr<Component> comp;
+  std::string name;
+  std::string subsystem;
+  Sendable* parent;
+  std::shared_ptr<void> data;
+};
+
 struct SendableRegistryInst {
-  wpi::recursive_mutex mutex;
+  wpi::mutex mutex;
 
   std::function<std::unique_ptr<SendableBuilder>()> liveWindowFactory;
-  wpi::UidVector<std::unique_ptr<Component>, 32> components;
+  wpi::UidVector<std::shared_ptr<Component>, 32> components;
   wpi::DenseMap<void*, SendableRegistry::UID> componentMap;
   int nextDataHandle = 0;
 
-  Component& GetOrAdd(void* sendable, SendableRegistry::UID* uid = nullptr);
+  // serializes ForeachLiveWindow() so the entries can be reused
+  wpi::mutex liveWindowMutex;
+  std::vector<LiveWindowEntry> liveWindowEntries;
+
+  std::shared_ptr<Component>& GetOrAdd(void* sendable,
+                                       SendableRegistry::UID* uid = nullptr);
+  std::shared_ptr<Component> Get(SendableRegistry::UID uid);
+  void AddLW(Sendable* sendable,
+             wpi::function_ref<void(Component& comp)> setName);
+};
+
+// Marks the builder as in use while calling into it; builderMutex must be held
+class BuilderUse {
+ public:
+  explicit BuilderUse(Component& comp) : m_comp{comp} {
+    ++comp.builderUseCount;
+  }
+  ~BuilderUse();
+
+  BuilderUse(const BuilderUse&) = delete;
+  BuilderUse& operator=(const BuilderUse&) = delete;
+
+ private:
+  Component& m_comp;
 };
 }  // namespace
 
-Component& SendableRegistryInst::GetOrAdd(void* sendable,
-                                          SendableRegistry::UID* uid) {
+// rebuild builder, as lambda captures can point to the old sendable;
+// builderMutex must be held and the builder must not be in use
+static void RebuildBuilder(Component& comp) {
+  comp.rebuild = false;
+  if (comp.builder && comp.builder->IsPublished()) {
+    BuilderUse use{comp};
+    comp.builder->ClearProperties();
+    comp.sendable.load()->InitSendable(*comp.builder);
+  }
+}
+
+BuilderUse::~BuilderUse() {
+  if (--m_comp.builderUseCount != 0) {
+    return;
+  }
+  // apply a Remove() or Move() made from within a callback
+  if (m_comp.removed) {
+    m_comp.builder.reset();
+  } else if (m_comp.rebuild) {
+    RebuildBuilder(m_comp);
+  }
+}
+
+std::shared_ptr<Component>& SendableRegistryInst::GetOrAdd(
+    void* sendable, SendableRegistry::UID* uid) {
   SendableRegistry::UID& compUid = componentMap[sendable];
   if (compUid == 0) {
-    compUid = components.emplace_back(std::make_unique<Component>()) + 1;
+    compUid = components.emplace_back(std::make_shared<Component>()) + 1;
   }
   if (uid) {
     *uid = compUid;
   }
 
-  return *components[compUid - 1];
+  return components[compUid - 1];
+}
+
+std::shared_ptr<Component> SendableRegistryInst::Get(
+    SendableRegistry::UID uid) {
+  if (uid == 0 || (uid - 1) >= components.size()) {
+    return nullptr;
+  }
+  return components[uid - 1];
+}
+
+void SendableRegistryInst::AddLW(
+    Sendable* sendable, wpi::function_ref<void(Component& comp)> setName) {
+  std::shared_ptr<Component> comp;
+  std::function<std::unique_ptr<SendableBuilder>()> factory;
+  {
+    std::scoped_lock lock(mutex);
+    comp = GetOrAdd(sendable);
+    comp->sendable = sendable;
+    comp->liveWindow = true;
+    setName(*comp);
+    factory = liveWindowFactory;
+  }
+  if (factory) {
+    auto builder = factory();
+    std::scoped_lock lock(comp->builderMutex);
+    comp->builder = std::move(builder);
+  }
 }
 
 static std::unique_ptr<SendableRegistryInst>& GetInstanceHolder() {
@@ -87,13 +182,15 @@ void SendableRegistry::EnsureInitialized() {
 
 void SendableRegistry::SetLiveWindowBuilderFactory(
     std::function<std::unique_ptr<SendableBuilder>()> factory) {
-  GetInstance().liveWindowFactory = std::move(factory);
+  auto& inst = GetInstance();
+  std::scoped_lock lock(inst.mutex);
+  inst.liveWindowFactory = std::move(factory);
 }
 
 void SendableRegistry::Add(Sendable* sendable, std::string_view name) {
   auto& inst = GetInstance();
   std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
+  auto& comp = *inst.GetOrAdd(sendable);
   comp.sendable = sendable;
   comp.name = name;
 }
@@ -102,7 +199,7 @@ void SendableRegistry::Add(Sendable* sendable, std::string_view moduleType,
                            int channel) {
   auto& inst = GetInstance();
   std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
+  auto& comp = *inst.GetOrAdd(sendable);
   comp.sendable = sendable;
   comp.SetName(moduleType, channel);
 }
@@ -111,7 +208,7 @@ void SendableRegistry::Add(Sendable* sendable, std::string_view moduleType,
                            int moduleNumber, int channel) {
   auto& inst = GetInstance();
   std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
+  auto& comp = *inst.GetOrAdd(sendable);
   comp.sendable = sendable;
   comp.SetName(moduleType, moduleNumber, channel);
 }
@@ -120,92 +217,77 @@ void SendableRegistry::Add(Sendable* sendable, std::string_view subsystem,
                            std::string_view name) {
   auto& inst = GetInstance();
   std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
+  auto& comp = *inst.GetOrAdd(sendable);
   comp.sendable = sendable;
   comp.name = name;
   comp.subsystem = subsystem;
 }
 
 void SendableRegistry::AddLW(Sendable* sendable, std::string_view name) {
-  auto& inst = GetInstance();
-  std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
-  comp.sendable = sendable;
-  if (inst.liveWindowFactory) {
-    comp.builder = inst.liveWindowFactory();
-  }
-  comp.liveWindow = true;
-  comp.name = name;
+  GetInstance().AddLW(sendable, [&](Component& comp) { comp.name = name; });
 }
 
 void SendableRegistry::AddLW(Sendable* sendable, std::string_view moduleType,
                              int channel) {
-  auto& inst = GetInstance();
-  std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
-  comp.sendable = sendable;
-  if (inst.liveWindowFactory) {
-    comp.builder = inst.liveWindowFactory();
-  }
-  comp.liveWindow = true;
-  comp.SetName(moduleType, channel);
+  GetInstance().AddLW(sendable, [&](Component& comp) {
+    comp.SetName(moduleType, channel);
+  });
 }
 
 void SendableRegistry::AddLW(Sendable* sendable, std::string_view moduleType,
                              int moduleNumber, int channel) {
-  auto& inst = GetInstance();
-  std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
-  comp.sendable = sendable;
-  if (inst.liveWindowFactory) {
-    comp.builder = inst.liveWindowFactory();
-  }
-  comp.liveWindow = true;
-  comp.SetName(moduleType, moduleNumber, channel);
+  GetInstance().AddLW(sendable, [&](Component& comp) {
+    comp.SetName(moduleType, moduleNumber, channel);
+  });
 }
 
 void SendableRegistry::AddLW(Sendable* sendable, std::string_view subsystem,
                              std::string_view name) {
-  auto& inst = GetInstance();
-  std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(sendable);
-  comp.sendable = sendable;
-  if (inst.liveWindowFactory) {
-    comp.builder = inst.liveWindowFactory();
-  }
-  comp.liveWindow = true;
-  comp.name = name;
-  comp.subsystem = subsystem;
+  GetInstance().AddLW(sendable, [&](Component& comp) {
+    comp.name = name;
+    comp.subsystem = subsystem;
+  });
 }
 
 void SendableRegistry::AddChild(Sendable* parent, Sendable* child) {
   auto& inst = GetInstance();
   std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(child);
+  auto& comp = *inst.GetOrAdd(child);
   comp.parent = parent;
 }
 
 void SendableRegistry::AddChild(Sendable* parent, void* child) {
   auto& inst = GetInstance();
   std::scoped_lock lock(inst.mutex);
-  auto& comp = inst.GetOrAdd(child);
+  auto& comp = *inst.GetOrAdd(child);
   comp.parent = parent;
 }
 
 bool SendableRegistry::Remove(Sendable* sendable) {
   auto& inst = GetInstance();
-  std::scoped_lock lock(inst.mutex);
-  auto it = inst.componentMap.find(sendable);
-  if (it == inst.componentMap.end()) {
-    return false;
-  }
-  UID compUid = it->getSecond();
-  inst.components.erase(compUid - 1);
-  inst.componentMap.erase(it);
-  // update any parent pointers
-  for (auto&& comp : inst.components) {
-    if (comp->parent == sendable) {
-      comp->parent = nullptr;
+  std::shared_ptr<Component> removed;
+  {
+    std::scoped_lock lock(inst.mutex);
+    auto it = inst.componentMap.find(sendable);
+    if (it == inst.componentMap.end()) {
+      return false;
+    }
+    UID compUid = it->getSecond();
+    removed = inst.components.erase(compUid - 1);
+    inst.componentMap.erase(it);
+    // update any parent pointers
+    for (auto&& comp : inst.components) {
+      if (comp->parent == sendable) {
+        comp->parent = nullptr;
+      }
+    }
+  }
+  if (removed) {
+    // wait for any in-progress update to finish before the sendable is gone
+    std::scoped_lock lock(removed->builderMutex);
+    removed->removed = true;
+    if (removed->builderUseCount == 0) {
+      removed->builder.reset();
     }
   }
   return true;
@@ -213,26 +295,31 @@ bool SendableRegistry::Remove(Sendable* sendable) {
 
 void SendableRegistry::Move(Sendable* to, Sendable* from) {
   auto& inst = GetInstance();
-  std::scoped_lock lock(inst.mutex);
-  auto it = inst.componentMap.find(from);
-  if (it == inst.componentMap.end() || !inst.components[it->getSecond() - 1]) {
-    return;
-  }
-  UID compUid = it->getSecond();
-  inst.componentMap.erase(it);
-  inst.componentMap[to] = compUid;
-  auto& comp = *inst.components[compUid - 1];
-  comp.sendable = to;
-  if (comp.builder && comp.builder->IsPublished()) {
-    // rebuild builder, as lambda captures can point to "from"
-    comp.builder->ClearProperties();
-    to->InitSendable(*comp.builder);
-  }
-  // update any parent pointers
-  for (auto&& comp : inst.components) {
-    if (comp->parent == from) {
-      comp->parent = to;
+  std::shared_ptr<Component> moved;
+  {
+    std::scoped_lock lock(inst.mutex);
+    auto it = inst.componentMap.find(from);
+    if (it == inst.componentMap.end() ||
+        !inst.components[it->getSecond() - 1]) {
+      return;
     }
+    UID compUid = it->getSecond();
+    inst.componentMap.erase(it);
+    inst.componentMap[to] = compUid;
+    moved = inst.components[compUid - 1];
+    // update any parent pointers
+    for (auto&& comp : inst.components) {
+      if (comp->parent == from) {
+        comp->parent = to;
+      }
+    }
+  }
+  std::scoped_lock lock(moved->builderMutex);
+  moved->sendable = to;
+  if (moved->builderUseCount == 0) {
+    RebuildBuilder(*moved);
+  } else {
+    moved->rebuild = true;
   }
 }
 
@@ -385,7 +472,7 @@ SendableRegistry::UID SendableRegistry::GetUniqueId(Sendable* sendable) {
   auto& inst = GetInstance();
   std::scoped_lock lock(inst.mutex);
   UID uid;
-  auto& comp = inst.GetOrAdd(sendable, &uid);
+  auto& comp = *inst.GetOrAdd(sendable, &uid);
   comp.sendable = sendable;
   return uid;
 }
@@ -405,29 +492,63 @@ Sendable* SendableRegistry::GetSendable(UID uid) {
 void SendableRegistry::Publish(UID sendableUid,
                                std::unique_ptr<SendableBuilder> builder) {
   auto& inst = GetInstance();
-  std::scoped_lock lock(inst.mutex);
-  if (sendableUid == 0 || (sendableUid - 1) >= inst.components.size() ||
-      !inst.components[sendableUid - 1]) {
+  std::shared_ptr<Component> comp;
+  {
+    std::scoped_lock lock(inst.mutex);
+    comp = inst.Get(sendableUid);
+  }
+  if (!comp) {
     return;
   }
-  auto& comp = *inst.components[sendableUid - 1];
-  comp.builder = std::move(builder);  // clear any current builder
-  comp.sendable->InitSendable(*comp.builder);
-  comp.builder->Update();
+  std::scoped_lock lock(comp->builderMutex);
+  if (comp->removed) {
+    return;
+  }
+  if (comp->builderUseCount != 0) {
+    return;  // the current builder is being used by a callback
+  }
+  comp->builder = std::move(builder);  // clear any current builder
+  BuilderUse use{*comp};
+  comp->sendable.load()->InitSendable(*comp->builder);
+  comp->builder->Update();
+}
+
+static void UpdateComponent(Component& comp) {
+  std::scoped_lock lock(comp.builderMutex);
+  if (comp.builder && !comp.removed) {
+    BuilderUse use{comp};
+    comp.builder->Update();
+  }
 }
 
 void SendableRegistry::Update(UID sendableUid) {
   auto& inst = GetInstance();
-  if (sendableUid == 0) {
-    return;
+  std::shared_ptr<Component> comp;
+  {
+    std::scoped_lock lock(inst.mutex);
+    comp = inst.Get(sendableUid);
   }
-  std::scoped_lock lock(inst.mutex);
-  if ((sendableUid - 1) >= inst.components.size() ||
-      !inst.components[sendableUid - 1]) {
-    return;
+  if (comp) {
+    UpdateComponent(*comp);
+  }
+}
+
+void SendableRegistry::UpdateAll(std::span<const UID> sendableUids) {
+  auto& inst = GetInstance();
+  // take one snapshot of the components; registration from other threads
+  // can proceed while the builders are updated
+  wpi::SmallVector<std::shared_ptr<Component>, 128> components;
+  components.reserve(sendableUids.size());
+  {
+    std::scoped_lock lock(inst.mutex);
+    for (auto uid : sendableUids) {
+      if (auto comp = inst.Get(uid)) {
+        components.emplace_back(std::move(comp));
+      }
+    }
   }
-  if (inst.components[sendableUid - 1]->builder) {
-    inst.components[sendableUid - 1]->builder->Update();
+  for (auto&& comp : components) {
+    UpdateComponent(*comp);
   }
 }
 
@@ -435,20 +556,55 @@ void SendableRegistry::ForeachLiveWindow(
     int dataHandle, wpi::function_ref<void(CallbackData& data)> callback) {
   auto& inst = GetInstance();
   assert(dataHandle >= 0);
-  std::scoped_lock lock(inst.mutex);
-  wpi::SmallVector<Component*, 128> components;
-  for (auto&& comp : inst.components) {
-    components.emplace_back(comp.get());
-  }
-  for (auto comp : components) {
-    if (comp && comp->builder && comp->sendable && comp->liveWindow) {
-      if (static_cast<size_t>(dataHandle) >= comp->data.size()) {
-        comp->data.resize(dataHandle + 1);
+  std::scoped_lock foreachLock(inst.liveWindowMutex);
+
+  // snapshot the LiveWindow components; the entries are reused between calls
+  // so the names usually don't need to be reallocated
+  auto& entries = inst.liveWindowEntries;
+  size_t numEntries = 0;
+  {
+    std::scoped_lock lock(inst.mutex);
+    for (auto&& comp : inst.components) {
+      if (!comp->liveWindow || !comp->sendable) {
+        continue;
+      }
+      if (numEntries >= entries.size()) {
+        entries.emplace_back();
+      }
+      auto& entry = entries[numEntries++];
+      entry.comp = comp;
+      entry.name = comp->name;
+      entry.subsystem = comp->subsystem;
+      entry.parent = comp->parent;
+      if (static_cast<size_t>(dataHandle) < comp->data.size()) {
+        entry.data = comp->data[dataHandle];
+      } else {
+        entry.data.reset();
+      }
+    }
+  }
+
+  for (size_t i = 0; i < numEntries; ++i) {
+    auto& entry = entries[i];
+    auto& comp = *entry.comp;
+    auto origData = entry.data;
+    {
+      std::scoped_lock lock(comp.builderMutex);
+      if (comp.builder && !comp.removed) {
+        BuilderUse use{comp};
+        CallbackData cbdata{comp.sendable, entry.name, entry.subsystem,
+                            entry.parent,  entry.data, *comp.builder};
+        callback(cbdata);
+      }
+    }
+    if (entry.data != origData) {
+      std::scoped_lock lock(inst.mutex);
+      if (static_cast<size_t>(dataHandle) >= comp.data.size()) {
+        comp.data.resize(dataHandle + 1);
       }
-      CallbackData cbdata{comp->sendable,         comp->name,
-                          comp->subsystem,        comp->parent,
-                          comp->data[dataHandle], *comp->builder};
-      callback(cbdata);
+      comp.data[dataHandle] = std::move(entry.data);
     }
+    entry.comp.reset();
+    entry.data.reset();
   }
 }
@@ -0,0 +1,344 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/struct/DynamicStructDecoder.h"
+
+#include <algorithm>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "wpi/Endian.h"
+#include "wpi/bit.h"
+
+using namespace wpi;
+
+// records are decoded in blocks so each column loop stays in cache
+static constexpr size_t kBlockRecords = 256;
+
+DynamicStructDecoder::DynamicStructDecoder(const StructDescriptor* desc)
+    : m_desc{desc}, m_size{desc->GetSize()} {
+  AddFields(desc, "", 0);
+}
+
+void DynamicStructDecoder::AddFields(const StructDescriptor* desc,
+                                     std::string_view prefix, size_t offset) {
+  for (auto&& field : desc->GetFields()) {
+    std::string name = fmt::format("{}{}", prefix, field.GetName());
+    if (field.GetType() == StructFieldType::kStruct) {
+      size_t structSize = field.GetStruct()->GetSize();
+      for (size_t i = 0; i < field.GetArraySize(); ++i) {
+        AddFields(field.GetStruct(),
+                  field.IsArray() ? fmt::format("{}[{}].", name, i)
+                                  : fmt::format("{}.", name),
+                  offset + field.GetOffset() + i * structSize);
+      }
+      continue;
+    }
+
+    Op op;
+    op.type = field.GetType();
+    op.size = field.GetSize();
+    op.shift = field.GetBitShift();
+    op.mask = field.GetBitMask();
+    op.parentOffset = offset;
+    if (field.IsBitField()) {
+      op.kind = OpKind::kBitField;
+    } else {
+      switch (field.GetType()) {
+        case StructFieldType::kBool:
+          op.kind = OpKind::kBool;
+          break;
+        case StructFieldType::kChar:
+          op.kind = OpKind::kString;
+          break;
+        case StructFieldType::kInt8:
+          op.kind = OpKind::kInt8;
+          break;
+        case StructFieldType::kInt16:
+          op.kind = OpKind::kInt16;
+          break;
+        case StructFieldType::kInt32:
+          op.kind = OpKind::kInt32;
+          break;
+        case StructFieldType::kInt64:
+          op.kind = OpKind::kInt64;
+          break;
+        case StructFieldType::kUint8:
+          op.kind = OpKind::kUint8;
+          break;
+        case StructFieldType::kUint16:
+          op.kind = OpKind::kUint16;
+          break;
+        case StructFieldType::kUint32:
+          op.kind = OpKind::kUint32;
+          break;
+        case StructFieldType::kUint64:
+          op.kind = OpKind::kUint64;
+          break;
+        case StructFieldType::kFloat:
+          op.kind = OpKind::kFloat;
+          break;
+        case StructFieldType::kDouble:
+          op.kind = OpKind::kDouble;
+          break;
+        default:
+          continue;
+      }
+    }
+
+    // a char array is a single string column
+    size_t arraySize = op.kind == OpKind::kString ? 1 : field.GetArraySize();
+    for (size_t i = 0; i < arraySize; ++i) {
+      op.offset = offset + field.GetOffset() + i * field.GetSize();
+      op.column = m_columns.size();
+      m_ops.emplace_back(op);
+      auto& column = m_columns.emplace_back(
+          Column{field.IsArray() && op.kind != OpKind::kString
+                     ? fmt::format("{}[{}]", name, i)
+                     : name,
+                 &field, i});
+      m_columnsByName.try_emplace(column.name, op.column);
+    }
+  }
+}
+
+int DynamicStructDecoder::FindColumn(std::string_view name) const {
+  auto it = m_columnsByName.find(name);
+  if (it == m_columnsByName.end()) {
+    return -1;
+  }
+  return it->second;
+}
+
+// the per-column loops have a fixed stride and no type dispatch, so the
+// compiler can unroll and vectorize them
+template <typename T, typename F>
+static inline void DecodeLoop(const uint8_t* src, size_t stride, size_t count,
+                              T* dst, F&& read) {
+  for (size_t i = 0; i < count; ++i, src += stride) {
+    dst[i] = read(src);
+  }
+}
+
+static inline uint64_t ReadRaw(const uint8_t* src, size_t size) {
+  switch (size) {
+    case 1:
+      return *src;
+    case 2:
+      return support::endian::read16le(src);
+    case 4:
+      return support::endian::read32le(src);
+    case 8:
+      return support::endian::read64le(src);
+    default:
+      return 0;
+  }
+}
+
+static inline int64_t SignExtend(uint64_t raw, size_t size) {
+  switch (size) {
+    case 1:
+      return static_cast<int8_t>(raw);
+    case 2:
+      return static_cast<int16_t>(raw);
+    case 4:
+      return static_cast<int32_t>(raw);
+    default:
+      return raw;
+  }
+}
+
+size_t DynamicStructDecoder::Decode(std::span<const uint8_t> data,
+                                    DynamicStructColumns* out) const {
+  if (m_size == 0) {
+    return 0;
+  }
+  size_t count = data.size() / m_size;
+  size_t start = out->m_size;
+  size_t numColumns = m_columns.size();
+  out->m_bools.resize(numColumns);
+  out->m_ints.resize(numColumns);
+  out->m_uints.resize(numColumns);
+  out->m_floats.resize(numColumns);
+  out->m_doubles.resize(numColumns);
+  out->m_strings.resize(numColumns);
+
+  // size the columns up front and get the destination pointers
+  std::vector<void*> dsts(m_ops.size());
+  for (size_t i = 0; i < m_ops.size(); ++i) {
+    auto& op = m_ops[i];
+    auto resize = [&](auto& column) {
+      column.resize(start + count);
+      dsts[i] = column.data() + start;
+    };
+    switch (op.kind) {
+      case OpKind::kBool:
+        resize(out->m_bools[op.column]);
+        break;
+      case OpKind::kInt8:
+      case OpKind::kInt16:
+      case OpKind::kInt32:
+      case OpKind::kInt64:
+        resize(out->m_ints[op.column]);
+        break;
+      case OpKind::kUint8:
+      case OpKind::kUint16:
+      case OpKind::kUint32:
+      case OpKind::kUint64:
+        resize(out->m_uints[op.column]);
+        break;
+      case OpKind::kFloat:
+        resize(out->m_floats[op.column]);
+        break;
+      case OpKind::kDouble:
+        resize(out->m_doubles[op.column]);
+        break;
+      case OpKind::kBitField:
+        if (op.type == StructFieldType::kBool) {
+          resize(out->m_bools[op.column]);
+        } else if (op.type == StructFieldType::kInt8 ||
+                   op.type == StructFieldType::kInt16 ||
+                   op.type == StructFieldType::kInt32 ||
+                   op.type == StructFieldType::kInt64) {
+          resize(out->m_ints[op.column]);
+        } else {
+          resize(out->m_uints[op.column]);
+        }
+        break;
+      case OpKind::kString:
+        resize(out->m_strings[op.column]);
+        break;
+    }
+  }
+
+  size_t stride = m_size;
+  for (size_t block = 0; block < count; block += kBlockRecords) {
+    size_t n = (std::min)(kBlockRecords, count - block);
+    const uint8_t* records = data.data() + block * stride;
+    for (size_t i = 0; i < m_ops.size(); ++i) {
+      auto& op = m_ops[i];
+      const uint8_t* src = records + op.offset;
+      switch (op.kind) {
+        case OpKind::kBool:
+          DecodeLoop(src, stride, n, static_cast<uint8_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) { return *p != 0 ? 1 : 0; });
+          break;
+        case OpKind::kInt8:
+          DecodeLoop(src, stride, n, static_cast<int64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) { return static_cast<int8_t>(*p); });
+          break;
+        case OpKind::kInt16:
+          DecodeLoop(src, stride, n, static_cast<int64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return static_cast<int16_t>(
+                           support::endian::read16le(p));
+                     });
+          break;
+        case OpKind::kInt32:
+          DecodeLoop(src, stride, n, static_cast<int64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return static_cast<int32_t>(
+                           support::endian::read32le(p));
+                     });
+          break;
+        case OpKind::kInt64:
+          DecodeLoop(src, stride, n, static_cast<int64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return static_cast<int64_t>(
+                           support::endian::read64le(p));
+                     });
+          break;
+        case OpKind::kUint8:
+          DecodeLoop(src, stride, n, static_cast<uint64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) { return *p; });
+          break;
+        case OpKind::kUint16:
+          DecodeLoop(src, stride, n, static_cast<uint64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return support::endian::read16le(p);
+                     });
+          break;
+        case OpKind::kUint32:
+          DecodeLoop(src, stride, n, static_cast<uint64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return support::endian::read32le(p);
+                     });
+          break;
+        case OpKind::kUint64:
+          DecodeLoop(src, stride, n, static_cast<uint64_t*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return support::endian::read64le(p);
+                     });
+          break;
+        case OpKind::kFloat:
+          DecodeLoop(src, stride, n, static_cast<float*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return bit_cast<float>(support::endian::read32le(p));
+                     });
+          break;
+        case OpKind::kDouble:
+          DecodeLoop(src, stride, n, static_cast<double*>(dsts[i]) + block,
+                     [](const uint8_t* p) {
+                       return bit_cast<double>(support::endian::read64le(p));
+                     });
+          break;
+        case OpKind::kBitField: {
+          auto read = [&](const uint8_t* p) {
+            return (ReadRaw(p, op.size) >> op.shift) & op.mask;
+          };
+          if (op.type == StructFieldType::kBool) {
+            DecodeLoop(src, stride, n, static_cast<uint8_t*>(dsts[i]) + block,
+                       [&](const uint8_t* p) { return read(p) != 0 ? 1 : 0; });
+          } else if (m_columns[op.column].field->IsInt()) {
+            DecodeLoop(src, stride, n, static_cast<int64_t*>(dsts[i]) + block,
+                       [&](const uint8_t* p) {
+                         return SignExtend(read(p), op.size);
+                       });
+          } else {
+            DecodeLoop(src, stride, n,
+                       static_cast<uint64_t*>(dsts[i]) + block, read);
+          }
+          break;
+        }
+        case OpKind::kString: {
+          auto field = m_columns[op.column].field;
+          auto dst = static_cast<std::string*>(dsts[i]) + block;
+          const uint8_t* parent = records + op.parentOffset;
+          for (size_t j = 0; j < n; ++j, parent += stride) {
+            dst[j] = DynamicStruct{field->GetParent(),
+                                   {parent, field->GetParent()->GetSize()}}
+                         .GetStringField(field);
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  out->m_size += count;
+  return count;
+}
+
+void DynamicStructColumns::clear() {
+  m_size = 0;
+  for (auto&& column : m_bools) {
+    column.clear();
+  }
+  for (auto&& column : m_ints) {
+    column.clear();
+  }
+  for (auto&& column : m_uints) {
+    column.clear();
+  }
+  for (auto&& column : m_floats) {
+    column.clear();
+  }
+  for (auto&& column : m_doubles) {
+    column.clear();
+  }
+  for (auto&& column : m_strings) {
+    column.clear();
+  }
+}
@@ -7,8 +7,12 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <concepts>
 #include <initializer_list>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
 #include <span>
@@ -23,8 +27,10 @@
 #include "wpi/DenseMap.h"
 #include "wpi/SmallVector.h"
 #include "wpi/StringMap.h"
+#include "wpi/function_ref.h"
 #include "wpi/mutex.h"
 #include "wpi/protobuf/Protobuf.h"
+#include "wpi/spinlock.h"
 #include "wpi/string.h"
 #include "wpi/struct/Struct.h"
 #include "wpi/timestamp.h"
@@ -61,15 +67,20 @@ enum ControlRecordType {
  *
  * DataLog calls are thread safe.  DataLog uses a typical multiple-supplier,
  * single-consumer setup.  Writes to the log are atomic, but there is no
- * guaranteed order in the log when multiple threads are writing to it;
- * whichever thread grabs the write mutex first will get written first.
- * For this reason (as well as the fact that timestamps can be set to
- * arbitrary values), records in the log are not guaranteed to be sorted by
- * timestamp.
+ * guaranteed order in the log when multiple threads are writing to it.
+ * Small data records are appended to a per-thread buffer without taking the
+ * shared write mutex; when the log is flushed or an entry is finished or has
+ * its metadata changed, the pending records of all threads are merged into the
+ * log in timestamp order.  Records from a single thread are always written in
+ * the order they were appended, and records are only merged with the records
+ * of other threads that are pending at the same time (larger records are
+ * written directly).  Because of this (as well as the fact that timestamps can
+ * be set to arbitrary values), records in the log are not guaranteed to be
+ * sorted by timestamp.
  */
 class DataLog {
  public:
-  virtual ~DataLog() = default;
+  virtual ~DataLog();
 
   DataLog(const DataLog&) = delete;
   DataLog& operator=(const DataLog&) = delete;
@@ -244,6 +255,23 @@ class DataLog {
   void AppendRaw2(int entry, std::span<const std::span<const uint8_t>> data,
                   int64_t timestamp);
 
+  /**
+   * Appends a raw record to the log, with the data written in place.  Rather
+   * than copying from a caller-provided buffer, space for the record data is
+   * reserved in the log's buffers and the fill function writes directly into
+   * it (e.g. by packing a struct).
+   *
+   * @param entry Entry index, as returned by Start()
+   * @param size Size of the record data, in bytes
+   * @param fill Function that fills in the record data; called with a span of
+   *             exactly size bytes.  It is called with internal locks held, so
+   *             it must not call other DataLog functions.
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void AppendRawInPlace(int entry, size_t size,
+                        wpi::function_ref<void(std::span<uint8_t> data)> fill,
+                        int64_t timestamp);
+
   /**
    * Appends a boolean record to the log.
    *
@@ -442,7 +470,9 @@ class DataLog {
    * @param extraHeader extra header metadata
    */
   explicit DataLog(wpi::Logger& msglog, std::string_view extraHeader = "")
-      : m_msglog{msglog}, m_extraHeader{extraHeader} {}
+      : m_msglog{msglog},
+        m_instanceId{NextInstanceId()},
+        m_extraHeader{extraHeader} {}
 
   /**
    * Starts the log.  Appends file header and Start records and schema data
@@ -489,8 +519,32 @@ class DataLog {
  private:
   static constexpr size_t kMaxBufferCount = 1024 * 1024 / kBlockSize;
   static constexpr size_t kMaxFreeCount = 256 * 1024 / kBlockSize;
+  // larger records are written directly to the shared buffers
+  static constexpr size_t kMaxThreadRecordSize = kBlockSize / 4;
+
+  // pending records appended by a single thread
+  struct ThreadBuffer {
+    wpi::spinlock lock;
+    Buffer buf{0};
+    // set when the owning DataLog is destroyed
+    std::atomic_bool detached{false};
+  };
+
+  static uint64_t NextInstanceId();
+
+  // returns nullptr if create is false and the calling thread has no buffer
+  // for this log
+  ThreadBuffer* GetThreadBuffer(bool create);
+  // starts a record in the thread buffer; lock must hold tb.lock
+  uint8_t* StartThreadRecord(ThreadBuffer& tb,
+                             std::unique_lock<wpi::spinlock>& lock,
+                             uint32_t entry, uint64_t timestamp,
+                             uint32_t payloadSize);
 
   // must be called with m_mutex held
+  void DrainThreadBufs();
+  void DrainCurrentThreadBuf();
+  void QueueBuffer(Buffer&& buf);
   int StartImpl(std::string_view name, std::string_view type,
                 std::string_view metadata, int64_t timestamp);
   uint8_t* StartRecord(uint32_t entry, uint64_t timestamp, uint32_t payloadSize,
@@ -506,12 +560,14 @@ class DataLog {
   wpi::Logger& m_msglog;
 
  private:
+  uint64_t m_instanceId;
   mutable wpi::mutex m_mutex;
   bool m_active = false;
-  bool m_paused = false;
+  std::atomic_bool m_paused = false;
   std::string m_extraHeader;
   std::vector<Buffer> m_free;
   std::vector<Buffer> m_outgoing;
+  std::vector<std::shared_ptr<ThreadBuffer>> m_threadBufs;
   struct EntryInfo {
     std::string type;
     std::vector<uint8_t> schemaData;  // only set for schema entries
@@ -540,7 +596,11 @@ class DataLogEntry {
   DataLogEntry(const DataLogEntry&) = delete;
   DataLogEntry& operator=(const DataLogEntry&) = delete;
 
-  DataLogEntry(DataLogEntry&& rhs) : m_log{rhs.m_log}, m_entry{rhs.m_entry} {
+  DataLogEntry(DataLogEntry&& rhs)
+      : m_log{rhs.m_log},
+        m_entry{rhs.m_entry},
+        m_keyframeInterval{rhs.m_keyframeInterval.load()},
+        m_lastAppendTime{rhs.m_lastAppendTime} {
     rhs.m_log = nullptr;
   }
   DataLogEntry& operator=(DataLogEntry&& rhs) {
@@ -550,6 +610,8 @@ class DataLogEntry {
     m_log = rhs.m_log;
     rhs.m_log = nullptr;
     m_entry = rhs.m_entry;
+    m_keyframeInterval = rhs.m_keyframeInterval.load();
+    m_lastAppendTime = rhs.m_lastAppendTime;
     return *this;
   }
 
@@ -572,11 +634,92 @@ class DataLogEntry {
    */
   void Finish(int64_t timestamp = 0) { m_log->Finish(m_entry, timestamp); }
 
+  /**
+   * Sets the maximum time between records appended by Update().  Update() only
+   * appends a record when the value changes; with a keyframe interval set, it
+   * also appends the value if this much time has passed since the last record,
+   * so a held value is distinguishable from a value that is no longer logged.
+   *
+   * @note C++ only; the Java entries' update() appends on every change.
+   *
+   * @param interval Maximum interval, in microseconds; 0 (the default) to only
+   *                 append on changes
+   */
+  void SetKeyframeInterval(int64_t interval) { m_keyframeInterval = interval; }
+
  protected:
+  /**
+   * Determines whether Update() should append a record, and if so, records the
+   * time of the record.  Must be called with the entry's mutex held.
+   *
+   * @param changed True if the value has changed
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   * @return True if a record should be appended
+   */
+  bool ShouldAppend(bool changed, int64_t timestamp) {
+    int64_t interval = m_keyframeInterval;
+    if (interval == 0) {
+      return changed;
+    }
+    if (timestamp == 0) {
+      timestamp = wpi::Now();
+    }
+    if (!changed && timestamp - m_lastAppendTime < interval) {
+      return false;
+    }
+    m_lastAppendTime = timestamp;
+    return true;
+  }
+
   DataLog* m_log = nullptr;
   int m_entry = 0;
+  std::atomic<int64_t> m_keyframeInterval{0};
+  int64_t m_lastAppendTime = 0;
 };
 
+namespace impl {
+/**
+ * Determines whether a numeric value differs from the last value by more than
+ * a deadband.  With a zero deadband, any change counts.
+ */
+template <typename T>
+inline bool ExceedsDeadband(T value, T last, double deadband) {
+  if (value == last) {
+    return false;
+  }
+  if (deadband == 0) {
+    return true;
+  }
+  // NaN differences count as changes
+  return !(std::abs(static_cast<double>(value) - static_cast<double>(last)) <=
+           deadband);
+}
+
+/**
+ * Integer version of ExceedsDeadband().  The difference is computed exactly,
+ * as large values don't convert to double without rounding.
+ */
+inline bool ExceedsDeadband(int64_t value, int64_t last, double deadband) {
+  if (value == last) {
+    return false;
+  }
+  // zero, negative, or NaN deadband: any change counts
+  if (!(deadband > 0)) {
+    return true;
+  }
+  // 2^64; no difference can exceed this
+  if (deadband >= 18446744073709551616.0) {
+    return false;
+  }
+  // the unsigned difference can't overflow
+  uint64_t diff =
+      value > last ? static_cast<uint64_t>(value) - static_cast<uint64_t>(last)
+                   : static_cast<uint64_t>(last) - static_cast<uint64_t>(value);
+  // for an integer difference, exceeding the deadband is exceeding its floor
+  return diff > static_cast<uint64_t>(deadband);
+}
+}  // namespace impl
+
 template <typename T>
 class DataLogValueEntryImpl : public DataLogEntry {
  protected:
@@ -591,11 +734,13 @@ class DataLogValueEntryImpl : public DataLogEntry {
       : DataLogEntry{std::move(rhs)} {
     std::scoped_lock lock{rhs.m_mutex};
     m_lastValue = std::move(rhs.m_lastValue);
+    m_deadband = rhs.m_deadband;
   }
   DataLogValueEntryImpl& operator=(DataLogValueEntryImpl&& rhs) {
     DataLogEntry::operator=(std::move(rhs));
     std::scoped_lock lock{m_mutex, rhs.m_mutex};
     m_lastValue = std::move(rhs.m_lastValue);
+    m_deadband = rhs.m_deadband;
     return *this;
   }
 
@@ -623,8 +768,24 @@ class DataLogValueEntryImpl : public DataLogEntry {
   }
 
  protected:
+  /**
+   * Sets the deadband for Update().  Update() only appends a record when the
+   * value (or any array element) differs from the last recorded value by more
+   * than the deadband, or the array size changes.  Only applies to numeric
+   * entries.  Integer values are compared exactly.
+   *
+   * @note C++ only; the Java entries' update() appends on every change.
+   *
+   * @param deadband Deadband; 0 (the default) to append on any change
+   */
+  void SetDeadband(double deadband) {
+    std::scoped_lock lock{m_mutex};
+    m_deadband = deadband;
+  }
+
   mutable wpi::mutex m_mutex;
   std::optional<T> m_lastValue;
+  double m_deadband = 0;
 };
 
 /**
@@ -703,7 +864,7 @@ class BooleanLogEntry : public DataLogValueEntryImpl<bool> {
    */
   void Update(bool value, int64_t timestamp = 0) {
     std::scoped_lock lock{m_mutex};
-    if (m_lastValue != value) {
+    if (ShouldAppend(m_lastValue != value, timestamp)) {
       m_lastValue = value;
       Append(value, timestamp);
     }
@@ -717,6 +878,8 @@ class IntegerLogEntry : public DataLogValueEntryImpl<int64_t> {
  public:
   static constexpr std::string_view kDataType = "int64";
 
+  using DataLogValueEntryImpl::SetDeadband;
+
   IntegerLogEntry() = default;
   IntegerLogEntry(DataLog& log, std::string_view name, int64_t timestamp = 0)
       : IntegerLogEntry{log, name, {}, timestamp} {}
@@ -746,7 +909,10 @@ class IntegerLogEntry : public DataLogValueEntryImpl<int64_t> {
    */
   void Update(int64_t value, int64_t timestamp = 0) {
     std::scoped_lock lock{m_mutex};
-    if (m_lastValue != value) {
+    if (ShouldAppend(
+            !m_lastValue ||
+                impl::ExceedsDeadband(value, *m_lastValue, m_deadband),
+            timestamp)) {
       m_lastValue = value;
       Append(value, timestamp);
     }
@@ -760,6 +926,8 @@ class FloatLogEntry : public DataLogValueEntryImpl<float> {
  public:
   static constexpr std::string_view kDataType = "float";
 
+  using DataLogValueEntryImpl::SetDeadband;
+
   FloatLogEntry() = default;
   FloatLogEntry(DataLog& log, std::string_view name, int64_t timestamp = 0)
       : FloatLogEntry{log, name, {}, timestamp} {}
@@ -789,7 +957,10 @@ class FloatLogEntry : public DataLogValueEntryImpl<float> {
    */
   void Update(float value, int64_t timestamp = 0) {
     std::scoped_lock lock{m_mutex};
-    if (m_lastValue != value) {
+    if (ShouldAppend(
+            !m_lastValue ||
+                impl::ExceedsDeadband(value, *m_lastValue, m_deadband),
+            timestamp)) {
       m_lastValue = value;
       Append(value, timestamp);
     }
@@ -803,6 +974,8 @@ class DoubleLogEntry : public DataLogValueEntryImpl<double> {
  public:
   static constexpr std::string_view kDataType = "double";
 
+  using DataLogValueEntryImpl::SetDeadband;
+
   DoubleLogEntry() = default;
   DoubleLogEntry(DataLog& log, std::string_view name, int64_t timestamp = 0)
       : DoubleLogEntry{log, name, {}, timestamp} {}
@@ -832,7 +1005,10 @@ class DoubleLogEntry : public DataLogValueEntryImpl<double> {
    */
   void Update(double value, int64_t timestamp = 0) {
     std::scoped_lock lock{m_mutex};
-    if (m_lastValue != value) {
+    if (ShouldAppend(
+            !m_lastValue ||
+                impl::ExceedsDeadband(value, *m_lastValue, m_deadband),
+            timestamp)) {
       m_lastValue = value;
       Append(value, timestamp);
     }
@@ -878,7 +1054,7 @@ class StringLogEntry : public DataLogValueEntryImpl<std::string> {
    */
   void Update(std::string_view value, int64_t timestamp = 0) {
     std::scoped_lock lock{m_mutex};
-    if (m_lastValue != value) {
+    if (ShouldAppend(m_lastValue != value, timestamp)) {
       m_lastValue = value;
       Append(value, timestamp);
     }
@@ -1024,6 +1200,8 @@ class IntegerArrayLogEntry
  public:
   static constexpr const char* kDataType = "int64[]";
 
+  using DataLogValueEntryImpl::SetDeadband;
+
   IntegerArrayLogEntry() = default;
   IntegerArrayLogEntry(DataLog& log, std::string_view name,
                        int64_t timestamp = 0)
@@ -1086,6 +1264,8 @@ class FloatArrayLogEntry : public DataLogValueEntryImpl<std::vector<float>> {
  public:
   static constexpr const char* kDataType = "float[]";
 
+  using DataLogValueEntryImpl::SetDeadband;
+
   FloatArrayLogEntry() = default;
   FloatArrayLogEntry(DataLog& log, std::string_view name, int64_t timestamp = 0)
       : FloatArrayLogEntry{log, name, {}, timestamp} {}
@@ -1147,6 +1327,8 @@ class DoubleArrayLogEntry : public DataLogValueEntryImpl<std::vector<double>> {
  public:
   static constexpr const char* kDataType = "double[]";
 
+  using DataLogValueEntryImpl::SetDeadband;
+
   DoubleArrayLogEntry() = default;
   DoubleArrayLogEntry(DataLog& log, std::string_view name,
                       int64_t timestamp = 0)
@@ -1333,18 +1515,14 @@ class StructLogEntry : public DataLogEntry {
    * @param timestamp Time stamp (may be 0 to indicate now)
    */
   void Append(const T& data, int64_t timestamp = 0) {
-    if constexpr (sizeof...(I) == 0) {
-      if constexpr (wpi::is_constexpr([] { S::GetSize(); })) {
-        uint8_t buf[S::GetSize()];
-        S::Pack(buf, data);
-        m_log->AppendRaw(m_entry, buf, timestamp);
-        return;
-      }
-    }
-    wpi::SmallVector<uint8_t, 128> buf;
-    buf.resize_for_overwrite(std::apply(S::GetSize, m_info));
-    std::apply([&](const I&... info) { S::Pack(buf, data, info...); }, m_info);
-    m_log->AppendRaw(m_entry, buf, timestamp);
+    // pack directly into the log buffer
+    m_log->AppendRawInPlace(
+        m_entry, std::apply(S::GetSize, m_info),
+        [&](std::span<uint8_t> buf) {
+          std::apply([&](const I&... info) { S::Pack(buf, data, info...); },
+                     m_info);
+        },
+        timestamp);
   }
 
   /**
@@ -1363,9 +1541,11 @@ class StructLogEntry : public DataLogEntry {
         uint8_t buf[S::GetSize()];
         S::Pack(buf, data);
         std::scoped_lock lock{m_mutex};
-        if (m_lastValue.empty() ||
-            !std::equal(buf, buf + S::GetSize(), m_lastValue.begin(),
-                        m_lastValue.end())) {
+        if (ShouldAppend(m_lastValue.empty() ||
+                             !std::equal(buf, buf + S::GetSize(),
+                                         m_lastValue.begin(),
+                                         m_lastValue.end()),
+                         timestamp)) {
           m_lastValue.assign(buf, buf + S::GetSize());
           m_log->AppendRaw(m_entry, buf, timestamp);
         }
@@ -1376,9 +1556,10 @@ class StructLogEntry : public DataLogEntry {
     buf.resize_for_overwrite(std::apply(S::GetSize, m_info));
     std::apply([&](const I&... info) { S::Pack(buf, data, info...); }, m_info);
     std::scoped_lock lock{m_mutex};
-    if (m_lastValue.empty() ||
-        !std::equal(buf.begin(), buf.end(), m_lastValue.begin(),
-                    m_lastValue.end())) {
+    if (ShouldAppend(m_lastValue.empty() ||
+                         !std::equal(buf.begin(), buf.end(),
+                                     m_lastValue.begin(), m_lastValue.end()),
+                     timestamp)) {
       m_lastValue.assign(buf.begin(), buf.end());
       m_log->AppendRaw(m_entry, buf, timestamp);
     }
@@ -1471,14 +1652,7 @@ class StructArrayLogEntry : public DataLogEntry {
              std::convertible_to<std::ranges::range_value_t<U>, T>
 #endif
   void Append(U&& data, int64_t timestamp = 0) {
-    std::apply(
-        [&](const I&... info) {
-          m_buf.Write(
-              std::forward<U>(data),
-              [&](auto bytes) { m_log->AppendRaw(m_entry, bytes, timestamp); },
-              info...);
-        },
-        m_info);
+    AppendInPlace(data, timestamp);
   }
 
   /**
@@ -1488,14 +1662,7 @@ class StructArrayLogEntry : public DataLogEntry {
    * @param timestamp Time stamp (may be 0 to indicate now)
    */
   void Append(std::span<const T> data, int64_t timestamp = 0) {
-    std::apply(
-        [&](const I&... info) {
-          m_buf.Write(
-              data,
-              [&](auto bytes) { m_log->AppendRaw(m_entry, bytes, timestamp); },
-              info...);
-        },
-        m_info);
+    AppendInPlace(data, timestamp);
   }
 
   /**
@@ -1515,15 +1682,19 @@ class StructArrayLogEntry : public DataLogEntry {
               data,
               [&](auto bytes) {
                 std::scoped_lock lock{m_mutex};
+                if (!ShouldAppend(!m_lastValue.has_value() ||
+                                      !std::equal(bytes.begin(), bytes.end(),
+                                                  m_lastValue->begin(),
+                                                  m_lastValue->end()),
+                                  timestamp)) {
+                  return;
+                }
                 if (!m_lastValue.has_value()) {
                   m_lastValue = std::vector(bytes.begin(), bytes.end());
-                  m_log->AppendRaw(m_entry, bytes, timestamp);
-                } else if (!std::equal(bytes.begin(), bytes.end(),
-                                       m_lastValue->begin(),
-                                       m_lastValue->end())) {
+                } else {
                   m_lastValue->assign(bytes.begin(), bytes.end());
-                  m_log->AppendRaw(m_entry, bytes, timestamp);
                 }
+                m_log->AppendRaw(m_entry, bytes, timestamp);
               },
               info...);
         },
@@ -1553,23 +1724,30 @@ class StructArrayLogEntry : public DataLogEntry {
     if (!m_lastValue.has_value()) {
       return std::nullopt;
     }
-    auto& lastValue = m_lastValue.value();
-    size_t size = std::apply(S::GetSize, m_info);
     std::vector<T> rv;
-    rv.reserve(lastValue.size() / size);
-    for (auto in = lastValue.begin(), end = lastValue.end(); in < end;
-         in += size) {
-      std::apply(
-          [&](const I&... info) {
-            rv.emplace_back(S::Unpack(
-                std::span<const uint8_t>{std::to_address(in), size}, info...));
-          },
-          m_info);
-    }
+    std::apply(
+        [&](const I&... info) {
+          UnpackStructs(&rv, m_lastValue.value(), info...);
+        },
+        m_info);
     return rv;
   }
 
  private:
+  // packs each element directly into the log buffer
+  template <typename U>
+  void AppendInPlace(U& data, int64_t timestamp) {
+    size_t size = std::apply(S::GetSize, m_info);
+    m_log->AppendRawInPlace(
+        m_entry, std::size(data) * size,
+        [&](std::span<uint8_t> buf) {
+          std::apply(
+              [&](const I&... info) { PackStructs<T>(buf, data, info...); },
+              m_info);
+        },
+        timestamp);
+  }
+
   mutable wpi::mutex m_mutex;
   StructArrayBuffer<T, I...> m_buf;
   std::optional<std::vector<uint8_t>> m_lastValue;
@@ -1624,14 +1802,18 @@ class ProtobufLogEntry : public DataLogEntry {
     std::scoped_lock lock{m_mutex};
     wpi::SmallVector<uint8_t, 128> buf;
     m_msg.Pack(buf, data);
+    if (!ShouldAppend(!m_lastValue.has_value() ||
+                          !std::equal(buf.begin(), buf.end(),
+                                      m_lastValue->begin(), m_lastValue->end()),
+                      timestamp)) {
+      return;
+    }
     if (!m_lastValue.has_value()) {
       m_lastValue = std::vector(buf.begin(), buf.end());
-      m_log->AppendRaw(m_entry, buf, timestamp);
-    } else if (!std::equal(buf.begin(), buf.end(), m_lastValue->begin(),
-                           m_lastValue->end())) {
+    } else {
       m_lastValue->assign(buf.begin(), buf.end());
-      m_log->AppendRaw(m_entry, buf, timestamp);
     }
+    m_log->AppendRaw(m_entry, buf, timestamp);
   }
 
   /**
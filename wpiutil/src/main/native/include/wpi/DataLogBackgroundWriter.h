@@ -11,6 +11,7 @@
 #include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 #include "wpi/DataLog.h"
 #include "wpi/condition_variable.h"
@@ -24,9 +25,9 @@ namespace wpi::log {
 
 /**
  * A data log background writer that periodically flushes the data log on a
- * background thread.  The data log file is created immediately upon
- * construction with a temporary filename.  The file may be renamed at any time
- * using the SetFilename() function.
+ * background thread.  The data log file is created with a temporary filename
+ * when data is first written to it (at the first flush after construction).
+ * The file may be renamed at any time using the SetFilename() function.
  *
  * The lifetime of this object must be longer than any data log entry objects
  * that refer to it.
@@ -34,6 +35,16 @@ namespace wpi::log {
  * The data log is periodically flushed to disk.  It can also be explicitly
  * flushed to disk by using the Flush() function.  This operation is, however,
  * non-blocking.
+ *
+ * Optionally, the output can be compressed.  Compressed logs are written as a
+ * series of LZ4 compressed blocks of the normal data log format, prefixed with
+ * a "WPILZ4" header; compression is performed on the background thread.
+ * DataLogReader reads compressed logs transparently.
+ *
+ * When logging to a file, the file can be rotated based on size or age, with
+ * a limit on the number of files kept (see SetRotation()).  Alternatively, in
+ * flight recorder mode, only the most recent data is kept in memory and it is
+ * only written to a file when triggered (see SetFlightRecorder()).
  */
 class DataLogBackgroundWriter final : public DataLog {
  public:
@@ -47,11 +58,13 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic flushes to disk, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the output
    */
   explicit DataLogBackgroundWriter(std::string_view dir = "",
                                    std::string_view filename = "",
                                    double period = 0.25,
-                                   std::string_view extraHeader = "");
+                                   std::string_view extraHeader = "",
+                                   bool compress = false);
 
   /**
    * Construct a new Data Log.  The log will be initially created with a
@@ -64,12 +77,14 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic flushes to disk, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the output
    */
   explicit DataLogBackgroundWriter(wpi::Logger& msglog,
                                    std::string_view dir = "",
                                    std::string_view filename = "",
                                    double period = 0.25,
-                                   std::string_view extraHeader = "");
+                                   std::string_view extraHeader = "",
+                                   bool compress = false);
 
   /**
    * Construct a new Data Log that passes its output to the provided function
@@ -81,10 +96,12 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic calls to write, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the output
    */
   explicit DataLogBackgroundWriter(
       std::function<void(std::span<const uint8_t> data)> write,
-      double period = 0.25, std::string_view extraHeader = "");
+      double period = 0.25, std::string_view extraHeader = "",
+      bool compress = false);
 
   /**
    * Construct a new Data Log that passes its output to the provided function
@@ -97,11 +114,13 @@ class DataLogBackgroundWriter final : public DataLog {
    * @param period time between automatic calls to write, in seconds;
    *               this is a time/storage tradeoff
    * @param extraHeader extra header data
+   * @param compress compress the output
    */
   explicit DataLogBackgroundWriter(
       wpi::Logger& msglog,
       std::function<void(std::span<const uint8_t> data)> write,
-      double period = 0.25, std::string_view extraHeader = "");
+      double period = 0.25, std::string_view extraHeader = "",
+      bool compress = false);
 
   ~DataLogBackgroundWriter() final;
   DataLogBackgroundWriter(const DataLogBackgroundWriter&) = delete;
@@ -116,11 +135,60 @@ class DataLogBackgroundWriter final : public DataLog {
    */
   void SetFilename(std::string_view filename);
 
+  /**
+   * Sets the limits at which the log file is closed and a new file is started.
+   * New files are named by adding a sequence number to the filename (e.g.
+   * "log.2.wpilog").  Only applies when logging to a file.
+   *
+   * @param maxSize maximum file size, in bytes; sizes over 1.8 GB (or 0) are
+   *                limited to 1.8 GB
+   * @param maxAge maximum time to write to a single file, in seconds; 0 for no
+   *               limit
+   * @param maxFiles maximum number of files to keep; when exceeded, the oldest
+   *                 file written by this object is deleted. 0 for no limit.
+   */
+  void SetRotation(uintmax_t maxSize, double maxAge = 0, int maxFiles = 0);
+
+  /**
+   * Enables or disables flight recorder mode.  In flight recorder mode, no
+   * file is written; instead the most recent log data is kept in memory, and
+   * it is only written to a file when TriggerFlightRecorder() is called.  The
+   * data kept is always a complete log: the start record, metadata, and last
+   * value of each entry are kept even once older data is discarded.  Only
+   * applies when logging to a file.
+   *
+   * Enabling flight recorder mode closes the current log file; if it is
+   * enabled before anything has been written to the file (e.g. immediately
+   * after construction), no file is created and the data logged so far is
+   * kept in memory instead.  Disabling it discards any data not yet written and
+   * starts a new log file.
+   *
+   * @param maxSize maximum amount of data to keep, in bytes; 0 to disable
+   */
+  void SetFlightRecorder(size_t maxSize);
+
+  /**
+   * Writes the data kept in flight recorder mode to a new log file (e.g. on an
+   * error or at the end of a match).  Subsequent triggers write only the data
+   * logged after the previous trigger (plus the latest value of each entry),
+   * each to a new file.  This operation is non-blocking; has no effect if not
+   * in flight recorder mode.
+   */
+  void TriggerFlightRecorder();
+
   /**
    * Explicitly flushes the log data to disk.
    */
   void Flush() final;
 
+  /**
+   * Flushes the log data to disk (as Flush() does), and waits for the
+   * background thread to finish writing it.  Any pending filename, rotation,
+   * or flight recorder changes and triggers requested before this call are
+   * also processed before this returns.
+   */
+  void FlushAndWait();
+
   /**
    * Pauses appending of data records to the log.  While paused, no data records
    * are saved (e.g. AppendX is a no-op).  Has no effect on entry starts /
@@ -147,14 +215,24 @@ class DataLogBackgroundWriter final : public DataLog {
   void BufferHalfFull() final;
   bool BufferFull() final;
 
+  bool OpenLogFile(WriterThreadState& state);
   void StartLogFile(WriterThreadState& state);
+  void WriteBufs(WriterThreadState& state, std::span<const Buffer> bufs);
+  void SaveFlightRecorder(WriterThreadState& state);
+  void CompressBufs(std::span<const Buffer> bufs, std::vector<uint8_t>& out);
+  void CompressData(std::span<const uint8_t> data, std::vector<uint8_t>& out);
   void WriterThreadMain(std::string_view dir);
   void WriterThreadMain(
       std::function<void(std::span<const uint8_t> data)> write);
 
   mutable wpi::mutex m_mutex;
   wpi::condition_variable m_cond;
+  wpi::condition_variable m_flushedCond;
   bool m_doFlush{false};
+  // FlushAndWait() requests, and the number processed by the writer thread
+  uint64_t m_flushRequested{0};
+  uint64_t m_flushCompleted{0};
+  bool m_doTrigger{false};
   bool m_shutdown{false};
   enum State {
     kStart,
@@ -163,6 +241,12 @@ class DataLogBackgroundWriter final : public DataLog {
     kStopped,
   } m_state = kActive;
   double m_period;
+  bool m_compress;
+  std::vector<uint8_t> m_compressScratch;
+  uintmax_t m_maxFileSize = 0;
+  double m_maxFileAge = 0;
+  int m_maxFiles = 0;
+  size_t m_flightRecorderSize = 0;
   std::string m_newFilename;
   std::thread m_thread;
 };
@@ -0,0 +1,157 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "wpi/MappedFileRegion.h"
+
+namespace wpi::log {
+
+class DataLogReader;
+
+/**
+ * Index of the records in a data log, to allow random access without scanning
+ * the entire log.
+ *
+ * The index contains the byte offset of every record, grouped by entry ID (the
+ * offsets of control records are listed under entry 0), and a sparse index
+ * from timestamp to offset.  The offsets can be passed to
+ * DataLogReader::Seek().
+ *
+ * An index is built once by scanning the log, and can be saved to a sidecar
+ * file (conventionally the log filename with ".idx" appended).  Loading a
+ * saved index memory-maps the file, so opening a large log only needs to read
+ * the parts of the index that are used.
+ */
+class DataLogIndex {
+ public:
+  /** Default number of records between time index samples. */
+  static constexpr uint32_t kDefaultTimeInterval = 1024;
+
+  /** Constructs an empty (invalid) index. */
+  DataLogIndex() = default;
+
+  /**
+   * Builds an index by scanning all records in a data log.  Large logs are
+   * scanned in parallel with DataLogParallelReader.
+   *
+   * @param reader data log reader
+   * @param timeInterval maximum number of records between time index samples
+   * @param numThreads number of threads to scan with (0 to use the hardware
+   *                   concurrency)
+   */
+  explicit DataLogIndex(const DataLogReader& reader,
+                        uint32_t timeInterval = kDefaultTimeInterval,
+                        unsigned int numThreads = 0);
+
+  /**
+   * Loads an index previously saved with Save() by memory-mapping it.
+   *
+   * @param filename index filename
+   * @param reader data log reader for the log the index was built from; used
+   *               to detect an index that does not match the log
+   * @param ec error code output; set if the file could not be opened or does
+   *           not match the log
+   */
+  DataLogIndex(std::string_view filename, const DataLogReader& reader,
+               std::error_code& ec);
+
+  DataLogIndex(const DataLogIndex&) = delete;
+  DataLogIndex& operator=(const DataLogIndex&) = delete;
+  DataLogIndex(DataLogIndex&&) = default;
+  DataLogIndex& operator=(DataLogIndex&&) = default;
+
+  /**
+   * Loads the sidecar index for a data log, building and saving it if it does
+   * not exist or does not match the log.  Failure to save the index is not an
+   * error.
+   *
+   * @param filename index filename
+   * @param reader data log reader
+   * @return Index
+   */
+  static DataLogIndex LoadOrBuild(std::string_view filename,
+                                  const DataLogReader& reader);
+
+  /**
+   * Gets the conventional sidecar index filename for a data log.
+   *
+   * @param logFilename data log filename
+   * @return Index filename
+   */
+  static std::string GetFilename(std::string_view logFilename) {
+    return std::string{logFilename} + ".idx";
+  }
+
+  /**
+   * Saves the index to a file.
+   *
+   * @param filename index filename
+   * @param ec error code output
+   */
+  void Save(std::string_view filename, std::error_code& ec) const;
+
+  /** Returns true if the index is valid. */
+  explicit operator bool() const { return !m_data.empty(); }
+
+  /**
+   * Gets the entry IDs present in the log, in ascending order.  Includes 0 if
+   * the log has any control records.
+   *
+   * @return Entry IDs
+   */
+  std::vector<int> GetEntries() const;
+
+  /**
+   * Gets the byte offsets of all records for an entry, in file order.
+   *
+   * @param entry entry ID (0 for control records)
+   * @return Record offsets; empty if the entry has no records
+   */
+  std::span<const uint64_t> GetRecordOffsets(int entry) const;
+
+  /**
+   * Finds the offset to start reading from to see every record with a
+   * timestamp at or after the given time.  Because records are not
+   * guaranteed to be sorted by timestamp, records before the given time may
+   * still be returned when reading from this offset.
+   *
+   * @param timestamp timestamp, in integer microseconds
+   * @return Record offset; the end of the log if all records are earlier
+   */
+  uint64_t FindTimestamp(int64_t timestamp) const;
+
+  /**
+   * Gets the number of records in the log.
+   *
+   * @return Number of records
+   */
+  uint64_t GetRecordCount() const;
+
+ private:
+  // index file layout (all little endian uint64):
+  //   header (kHeaderWords), entries (3 words each: id, first, count),
+  //   offsets, time samples (2 words each: max timestamp, offset)
+  static constexpr size_t kHeaderWords = 6;
+
+  bool Parse(uint64_t logSize);
+
+  std::vector<uint64_t> m_owned;
+  MappedFileRegion m_region;
+  std::span<const uint64_t> m_data;
+  std::span<const uint64_t> m_entries;
+  std::span<const uint64_t> m_offsets;
+  std::span<const uint64_t> m_times;
+  uint64_t m_logSize = 0;
+};
+
+}  // namespace wpi::log
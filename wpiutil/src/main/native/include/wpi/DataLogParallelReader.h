@@ -0,0 +1,120 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include "wpi/DataLogReader.h"
+#include "wpi/function_ref.h"
+
+namespace wpi::log {
+
+/**
+ * Reads the records of a data log using multiple threads.
+ *
+ * The log is split into contiguous chunks of records which are read in
+ * parallel.  Chunk boundaries are found by resynchronizing on record headers
+ * near each split point.  Because the data log format has no sync markers,
+ * each boundary is verified once the preceding chunk has been read; a chunk
+ * that started at the wrong position is reset and read again, so the records
+ * seen are always exactly those seen by iterating the DataLogReader.
+ *
+ * Results are typically accumulated per chunk and then merged in chunk order,
+ * which is file order; see ReadChunks().
+ */
+class DataLogParallelReader {
+ public:
+  /**
+   * Constructs a parallel reader.
+   *
+   * @param reader data log reader; must outlive this object
+   * @param numThreads number of threads (0 to use the hardware concurrency)
+   */
+  explicit DataLogParallelReader(const DataLogReader& reader,
+                                 unsigned int numThreads = 0);
+
+  /**
+   * Gets the number of chunks the log is split into.
+   *
+   * @return Number of chunks
+   */
+  size_t GetNumChunks() const { return m_numChunks; }
+
+  /**
+   * Calls a function for every record in the log.  Calls for the same chunk
+   * are made on a single thread in file order; calls for different chunks are
+   * made concurrently.
+   *
+   * @param resetChunk called with a chunk index before that chunk is read
+   *                   again; any results accumulated for the chunk must be
+   *                   discarded
+   * @param func called with the chunk index and an iterator to each record
+   */
+  void ForEachRecord(function_ref<void(size_t chunk)> resetChunk,
+                     function_ref<void(size_t chunk, DataLogIterator it)> func)
+      const {
+    ForEachRecord(
+        resetChunk,
+        [&](size_t chunk, DataLogIterator it) {
+          func(chunk, it);
+          return true;
+        },
+        [](size_t) {});
+  }
+
+  /**
+   * Calls a function for every record in the log, and another for each chunk
+   * once its records are final.  This allows results to be merged in file
+   * order while later chunks are still being read.
+   *
+   * Reading can be stopped early by returning false from func; the remaining
+   * records are skipped and chunkDone is not called again.  Calls already in
+   * progress on other threads are allowed to complete.
+   *
+   * @param resetChunk called with a chunk index before that chunk is read
+   *                   again; any results accumulated for the chunk must be
+   *                   discarded
+   * @param func called with the chunk index and an iterator to each record;
+   *             returns false to stop reading
+   * @param chunkDone called with each chunk index, in chunk order, once that
+   *                  chunk will not be reset or read again; calls are not
+   *                  made concurrently
+   * @return False if reading was stopped by func
+   */
+  bool ForEachRecord(function_ref<void(size_t chunk)> resetChunk,
+                     function_ref<bool(size_t chunk, DataLogIterator it)> func,
+                     function_ref<void(size_t chunk)> chunkDone) const;
+
+  /**
+   * Reads the log, accumulating a result for each chunk.
+   *
+   * @tparam T result type; must be default constructible
+   * @param func called as func(T& result, DataLogIterator it) for each record
+   * @return Results, one per chunk, in file order
+   */
+  template <typename T, typename F>
+  std::vector<T> ReadChunks(F&& func) const {
+    std::vector<T> results(m_numChunks);
+    ForEachRecord([&](size_t chunk) { results[chunk] = T(); },
+                  [&](size_t chunk, DataLogIterator it) {
+                    func(results[chunk], it);
+                  });
+    return results;
+  }
+
+ private:
+  // finds the first position in [pos, limit) that looks like the start of a
+  // record; returns SIZE_MAX if none
+  size_t Resync(size_t pos, size_t limit) const;
+
+  const DataLogReader& m_reader;
+  unsigned int m_numThreads;
+  size_t m_numChunks;
+};
+
+}  // namespace wpi::log
@@ -288,6 +288,14 @@ class DataLogIterator {
 
   pointer operator->() const { return &this->operator*(); }
 
+  /**
+   * Gets the byte offset of the current record in the log.  The offset can be
+   * passed to DataLogReader::Seek().
+   *
+   * @return Byte offset
+   */
+  size_t GetPosition() const { return m_pos; }
+
  protected:
   const DataLogReader* m_reader;
   size_t m_pos;
@@ -295,14 +303,33 @@ class DataLogIterator {
   mutable DataLogRecord m_value;
 };
 
-/** Data log reader (reads logs written by the DataLog class). */
+/**
+ * Data log reader (reads logs written by the DataLog class).
+ *
+ * Compressed logs (as written by DataLogBackgroundWriter with compression
+ * enabled) are transparently decompressed into memory on construction; the
+ * positions and record data returned are relative to the decompressed log.
+ */
 class DataLogReader {
   friend class DataLogIterator;
+  friend class DataLogIndex;
+  friend class DataLogParallelReader;
 
  public:
   using iterator = DataLogIterator;
 
-  /** Constructs from a memory buffer. */
+  /**
+   * Constructs from a memory buffer.
+   *
+   * If the buffer contains a compressed log, the entire log is decompressed
+   * into a newly allocated heap buffer before this returns, and the input
+   * buffer is released.  The memory cost is therefore the full uncompressed
+   * size of the log (typically several times the file size) rather than a
+   * memory-mapped view of the file, and the decompression time is paid up
+   * front.  Uncompressed logs use the passed buffer directly.
+   *
+   * @param buffer log data
+   */
   explicit DataLogReader(std::unique_ptr<MemoryBuffer> buffer);
 
   /** Returns true if the data log is valid (e.g. has a valid header). */
@@ -341,6 +368,16 @@ class DataLogReader {
   /** Returns end iterator. */
   iterator end() const { return DataLogIterator{this, SIZE_MAX}; }
 
+  /**
+   * Returns iterator to the record at a byte offset, e.g. as returned by
+   * DataLogIterator::GetPosition() or DataLogIndex.  The offset must be the
+   * start of a record.
+   *
+   * @param pos byte offset
+   * @return Iterator; end iterator if the offset is past the end of the log
+   */
+  iterator Seek(size_t pos) const;
+
  private:
   std::unique_ptr<MemoryBuffer> m_buf;
 
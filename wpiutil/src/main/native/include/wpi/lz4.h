@@ -0,0 +1,59 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_LZ4_H_
+#define WPIUTIL_WPI_LZ4_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <span>
+
+namespace wpi {
+template <typename T>
+class SmallVectorImpl;
+
+/**
+ * Get the maximum size of LZ4 compressed data.
+ *
+ * Incompressible data expands slightly when compressed; this is the worst
+ * case compressed size for an input of the given size.
+ *
+ * @param size uncompressed size, in bytes
+ * @return Maximum compressed size, in bytes
+ */
+constexpr size_t Lz4CompressBound(size_t size) {
+  return size + size / 255 + 16;
+}
+
+/**
+ * Compress data in the LZ4 block format.
+ *
+ * This is a fast, single pass compressor intended for compressing data as it
+ * is produced (e.g. while logging); the output can be decompressed by any LZ4
+ * block decompressor.  The uncompressed size is not stored in the output, so
+ * it must be stored separately by the caller.
+ *
+ * @param in uncompressed data
+ * @param out output buffer; compressed data is appended to it
+ * @return Span of the compressed data within out
+ */
+std::span<uint8_t> Lz4Compress(std::span<const uint8_t> in,
+                               SmallVectorImpl<uint8_t>& out);
+
+/**
+ * Decompress data in the LZ4 block format.
+ *
+ * The input is fully validated, so this is safe to use on untrusted data.
+ *
+ * @param in compressed data
+ * @param out output buffer; must be exactly the uncompressed size
+ * @return False if the input is invalid or does not decompress to exactly
+ *         out.size() bytes
+ */
+bool Lz4Decompress(std::span<const uint8_t> in, std::span<uint8_t> out);
+
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_LZ4_H_
@@ -0,0 +1,241 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace google::protobuf {
+class Descriptor;
+}  // namespace google::protobuf
+
+namespace wpi {
+
+/**
+ * Lightweight reflective protobuf decoder. The message descriptor (and the
+ * descriptors of all nested message types) are compiled once into flat field
+ * tables indexed by field number. Decode() then walks the wire format directly
+ * and reports each field to a visitor, without constructing protobuf Message
+ * objects or allocating memory.
+ *
+ * Only fields present in the serialized data are reported; proto3 default
+ * values are not synthesized. Unknown fields and fields with an unexpected
+ * wire type are skipped.
+ */
+class DynamicProtobufDecoder {
+ public:
+  /**
+   * Field types.
+   */
+  enum class FieldType : uint8_t {
+    /// double.
+    kDouble,
+    /// float.
+    kFloat,
+    /// int32.
+    kInt32,
+    /// int64.
+    kInt64,
+    /// uint32.
+    kUint32,
+    /// uint64.
+    kUint64,
+    /// sint32.
+    kSint32,
+    /// sint64.
+    kSint64,
+    /// fixed32.
+    kFixed32,
+    /// fixed64.
+    kFixed64,
+    /// sfixed32.
+    kSfixed32,
+    /// sfixed64.
+    kSfixed64,
+    /// bool.
+    kBool,
+    /// enum.
+    kEnum,
+    /// string.
+    kString,
+    /// bytes.
+    kBytes,
+    /// message.
+    kMessage
+  };
+
+  /**
+   * Compiled field descriptor.
+   */
+  struct Field {
+    /// Field name.
+    std::string name;
+    /// Field number.
+    uint32_t number;
+    /// Field type.
+    FieldType type;
+    /// True if the field is repeated.
+    bool repeated;
+    /// Index of the message type in GetMessages() for message fields, or -1.
+    int message;
+    /// Enum value numbers and names for enum fields, in declaration order.
+    std::vector<std::pair<int32_t, std::string>> enumValues;
+
+    /**
+     * Gets the name of an enum value.
+     *
+     * @param value enum value
+     * @return value name, or empty if the value is not declared
+     */
+    std::string_view GetEnumName(int64_t value) const {
+      for (auto&& [number, name] : enumValues) {
+        if (number == value) {
+          return name;
+        }
+      }
+      return {};
+    }
+  };
+
+  /**
+   * Compiled message descriptor.
+   */
+  struct Message {
+    /// Full message type name.
+    std::string name;
+    /// Fields, in declaration order.
+    std::vector<Field> fields;
+    /// Index into fields by field number, or -1 if no such field.
+    std::vector<int> fieldsByNumber;
+  };
+
+  /**
+   * Visitor for decoded fields. Repeated fields are reported once per
+   * element. Integer-typed fields (including enums) are reported through
+   * Int() or Uint() depending on signedness.
+   */
+  class Visitor {
+   public:
+    virtual ~Visitor() = default;
+
+    /**
+     * Called for signed integer and enum fields.
+     *
+     * @param field field descriptor
+     * @param value field value
+     */
+    virtual void Int(const Field& field, int64_t value) {}
+
+    /**
+     * Called for unsigned integer fields.
+     *
+     * @param field field descriptor
+     * @param value field value
+     */
+    virtual void Uint(const Field& field, uint64_t value) {}
+
+    /**
+     * Called for float fields.
+     *
+     * @param field field descriptor
+     * @param value field value
+     */
+    virtual void Float(const Field& field, float value) {}
+
+    /**
+     * Called for double fields.
+     *
+     * @param field field descriptor
+     * @param value field value
+     */
+    virtual void Double(const Field& field, double value) {}
+
+    /**
+     * Called for bool fields.
+     *
+     * @param field field descriptor
+     * @param value field value
+     */
+    virtual void Bool(const Field& field, bool value) {}
+
+    /**
+     * Called for string fields. The value refers to the decoded data.
+     *
+     * @param field field descriptor
+     * @param value field value
+     */
+    virtual void String(const Field& field, std::string_view value) {}
+
+    /**
+     * Called for bytes fields. The value refers to the decoded data.
+     *
+     * @param field field descriptor
+     * @param value field value
+     */
+    virtual void Bytes(const Field& field, std::span<const uint8_t> value) {}
+
+    /**
+     * Called before the fields of a nested message.
+     *
+     * @param field field descriptor
+     */
+    virtual void StartMessage(const Field& field) {}
+
+    /**
+     * Called after the fields of a nested message.
+     *
+     * @param field field descriptor
+     */
+    virtual void EndMessage(const Field& field) {}
+  };
+
+  /**
+   * Constructs a decoder for a message type. The descriptor is only used
+   * during construction.
+   *
+   * @param desc message descriptor
+   */
+  explicit DynamicProtobufDecoder(const google::protobuf::Descriptor* desc);
+
+  /**
+   * Gets the full name of the decoded message type.
+   *
+   * @return message type name
+   */
+  const std::string& GetName() const { return m_messages[0].name; }
+
+  /**
+   * Gets the compiled message descriptors. The first message is the decoded
+   * message type; the others are the nested message types it references.
+   *
+   * @return compiled messages
+   */
+  std::span<const Message> GetMessages() const { return m_messages; }
+
+  /**
+   * Decodes a serialized message.
+   *
+   * @param data serialized message
+   * @param visitor visitor called for each decoded field
+   * @return False if the data is malformed; fields decoded before the error
+   *         have already been reported to the visitor
+   */
+  bool Decode(std::span<const uint8_t> data, Visitor& visitor) const {
+    return DecodeMessage(m_messages[0], data, visitor, 0);
+  }
+
+ private:
+  bool DecodeMessage(const Message& msg, std::span<const uint8_t> data,
+                     Visitor& visitor, int depth) const;
+
+  std::vector<Message> m_messages;
+};
+
+}  // namespace wpi
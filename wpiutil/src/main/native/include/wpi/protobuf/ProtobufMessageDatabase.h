@@ -15,6 +15,7 @@
 #include <google/protobuf/dynamic_message.h>
 
 #include "wpi/StringMap.h"
+#include "wpi/protobuf/DynamicProtobufDecoder.h"
 
 namespace wpi {
 
@@ -45,6 +46,16 @@ class ProtobufMessageDatabase {
    */
   google::protobuf::Message* Find(std::string_view name) const;
 
+  /**
+   * Finds a lightweight decoder for a message in the database by name. This
+   * is faster than parsing into the message returned by Find() when the
+   * fields only need to be visited once.
+   *
+   * @param name type name
+   * @return decoder, or nullptr if not found
+   */
+  const DynamicProtobufDecoder* FindDecoder(std::string_view name) const;
+
   /**
    * Gets message factory.
    *
@@ -72,6 +83,8 @@ class ProtobufMessageDatabase {
   wpi::StringMap<ProtoFile> m_files;  // indexed by filename
   // indexed by type string
   mutable wpi::StringMap<std::unique_ptr<google::protobuf::Message>> m_msgs;
+  // indexed by type string
+  mutable wpi::StringMap<std::unique_ptr<DynamicProtobufDecoder>> m_decoders;
 };
 
 }  // namespace wpi
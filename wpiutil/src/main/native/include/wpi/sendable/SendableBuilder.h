@@ -56,6 +56,17 @@ class SendableBuilder {
    */
   virtual void SetSafeState(std::function<void()> func) = 0;
 
+  /**
+   * Set the minimum period between calls to a property's getter. By default
+   * the getter is called on every update; slowly changing or expensive
+   * properties can use this to skip work. This does not affect the setter.
+   * Must be called after the property is added.
+   *
+   * @param key     property name
+   * @param period  minimum update period, in seconds
+   */
+  virtual void SetUpdatePeriod(std::string_view key, double period) {}
+
   /**
    * Add a boolean property.
    *
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 
@@ -302,6 +303,16 @@ class SendableRegistry final {
    */
   static void Update(UID sendableUid);
 
+  /**
+   * Updates published information from multiple objects. This is more
+   * efficient than calling Update() for each object, as the registry is only
+   * locked once; other threads can add or remove objects while the updates
+   * are running.
+   *
+   * @param sendableUids sendable unique ids
+   */
+  static void UpdateAll(std::span<const UID> sendableUids);
+
   /**
    * Data passed to ForeachLiveWindow() callback function
    */
@@ -326,8 +337,9 @@ class SendableRegistry final {
 
   /**
    * Iterates over LiveWindow-enabled objects in the registry.
-   * It is *not* safe to call other SendableRegistry functions from the
-   * callback (this will likely deadlock).
+   * The registry is not locked while the callback runs, but it is *not* safe
+   * to call Remove(), Move(), Publish(), or Update() for the object passed to
+   * the callback (this will deadlock).
    *
    * @param dataHandle data handle to get data pointer passed to callback
    * @param callback function to call for each object
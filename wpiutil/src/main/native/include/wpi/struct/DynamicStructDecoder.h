@@ -0,0 +1,224 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cassert>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "wpi/StringMap.h"
+#include "wpi/struct/DynamicStruct.h"
+
+namespace wpi {
+
+class DynamicStructColumns;
+
+/**
+ * Bulk decoder for arrays of serialized raw structs. The struct descriptor is
+ * "compiled" once into a flat list of scalar columns (one per leaf field and
+ * array element, with nested structs flattened), each with a precomputed
+ * offset, width, and conversion. Decode() then converts any number of
+ * records into one typed column per leaf field, without per-access name
+ * lookups or type dispatch.
+ *
+ * Column names are the field names, with nested struct fields separated by
+ * "." and array elements suffixed by "[index]" (e.g. "pose.translation.x" or
+ * "modules[2].angle"). Char arrays are decoded as a single string column.
+ */
+class DynamicStructDecoder {
+ public:
+  /**
+   * Column information.
+   */
+  struct Column {
+    /// Column name.
+    std::string name;
+    /// Leaf field descriptor (never a struct).
+    const StructFieldDescriptor* field;
+    /// Array index within the field (always 0 for char arrays).
+    size_t arrIndex;
+  };
+
+  /**
+   * Constructs a decoder. The descriptor must be valid, and must outlive the
+   * decoder.
+   *
+   * @param desc struct descriptor
+   */
+  explicit DynamicStructDecoder(const StructDescriptor* desc);
+
+  /**
+   * Gets the struct descriptor.
+   *
+   * @return struct descriptor
+   */
+  const StructDescriptor* GetDescriptor() const { return m_desc; }
+
+  /**
+   * Gets the columns produced by this decoder.
+   *
+   * @return columns
+   */
+  std::span<const Column> GetColumns() const { return m_columns; }
+
+  /**
+   * Finds a column by name.
+   *
+   * @param name column name
+   * @return column index, or -1 if not found
+   */
+  int FindColumn(std::string_view name) const;
+
+  /**
+   * Decodes an array of serialized structs, appending one value per record to
+   * each column. Trailing data shorter than a full struct is ignored.
+   *
+   * @param data serialized structs
+   * @param out columns to append to; must only be used with this decoder
+   * @return number of records decoded
+   */
+  size_t Decode(std::span<const uint8_t> data, DynamicStructColumns* out) const;
+
+ private:
+  enum class OpKind : uint8_t {
+    kBool,
+    kInt8,
+    kInt16,
+    kInt32,
+    kInt64,
+    kUint8,
+    kUint16,
+    kUint32,
+    kUint64,
+    kFloat,
+    kDouble,
+    kBitField,
+    kString
+  };
+
+  struct Op {
+    OpKind kind;
+    StructFieldType type;
+    uint8_t size;
+    uint8_t shift;
+    uint64_t mask;
+    size_t offset;
+    size_t column;
+    // for strings: offset of the parent struct within the record
+    size_t parentOffset;
+  };
+
+  void AddFields(const StructDescriptor* desc, std::string_view prefix,
+                 size_t offset);
+
+  const StructDescriptor* m_desc;
+  size_t m_size;
+  std::vector<Column> m_columns;
+  std::vector<Op> m_ops;
+  StringMap<size_t> m_columnsByName;
+};
+
+/**
+ * Typed column storage for DynamicStructDecoder. Each column is only
+ * populated in the storage for its field type; the getters assert the type
+ * matches.
+ */
+class DynamicStructColumns {
+  friend class DynamicStructDecoder;
+
+ public:
+  /**
+   * Gets the number of records.
+   *
+   * @return number of records
+   */
+  size_t size() const { return m_size; }
+
+  /**
+   * Removes all values, keeping allocated storage.
+   */
+  void clear();
+
+  /**
+   * Gets a boolean column (values are 0 or 1).
+   *
+   * @param column column index
+   * @return values
+   */
+  std::span<const uint8_t> GetBoolColumn(size_t column) const {
+    assert(column < m_bools.size());
+    return m_bools[column];
+  }
+
+  /**
+   * Gets a signed integer column.
+   *
+   * @param column column index
+   * @return values
+   */
+  std::span<const int64_t> GetIntColumn(size_t column) const {
+    assert(column < m_ints.size());
+    return m_ints[column];
+  }
+
+  /**
+   * Gets an unsigned integer column.
+   *
+   * @param column column index
+   * @return values
+   */
+  std::span<const uint64_t> GetUintColumn(size_t column) const {
+    assert(column < m_uints.size());
+    return m_uints[column];
+  }
+
+  /**
+   * Gets a float column.
+   *
+   * @param column column index
+   * @return values
+   */
+  std::span<const float> GetFloatColumn(size_t column) const {
+    assert(column < m_floats.size());
+    return m_floats[column];
+  }
+
+  /**
+   * Gets a double column.
+   *
+   * @param column column index
+   * @return values
+   */
+  std::span<const double> GetDoubleColumn(size_t column) const {
+    assert(column < m_doubles.size());
+    return m_doubles[column];
+  }
+
+  /**
+   * Gets a string (char array) column.
+   *
+   * @param column column index
+   * @return values
+   */
+  std::span<const std::string> GetStringColumn(size_t column) const {
+    assert(column < m_strings.size());
+    return m_strings[column];
+  }
+
+ private:
+  size_t m_size = 0;
+  std::vector<std::vector<uint8_t>> m_bools;
+  std::vector<std::vector<int64_t>> m_ints;
+  std::vector<std::vector<uint64_t>> m_uints;
+  std::vector<std::vector<float>> m_floats;
+  std::vector<std::vector<double>> m_doubles;
+  std::vector<std::vector<std::string>> m_strings;
+};
+
+}  // namespace wpi
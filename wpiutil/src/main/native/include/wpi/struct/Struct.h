@@ -6,7 +6,10 @@
 
 #include <stdint.h>
 
+#include <bit>
 #include <concepts>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <span>
 #include <string>
@@ -125,6 +128,42 @@ concept HasNestedStruct =
              typename std::remove_cvref_t<I>...>::ForEachNested(fn, info...);
     };
 
+/**
+ * Specifies that a struct type's in-memory representation is identical to its
+ * serialized representation, so arrays of it can be packed and unpacked with a
+ * single memcpy instead of element by element.
+ *
+ * Implementations opt in by defining a wpi::Struct<T> static member
+ * `static constexpr bool kTriviallyPackable = true`. This must only be set if
+ * T consists of exactly the schema fields, in schema order, each stored with
+ * its serialized type (or a trivial wrapper of it, like a units type), and
+ * Pack() and Unpack() copy the fields without transforming them (e.g. no
+ * normalization). The size, trivial copyability, and host byte order are
+ * checked by this concept.
+ */
+template <typename T, typename... I>
+concept TriviallyPackableStruct =
+    StructSerializable<T, I...> && sizeof...(I) == 0 &&
+    std::endian::native == std::endian::little &&
+    std::is_trivially_copyable_v<std::remove_cvref_t<T>> &&
+    requires {
+      requires Struct<std::remove_cvref_t<T>>::kTriviallyPackable;
+    } &&
+    (sizeof(std::remove_cvref_t<T>) ==
+     Struct<std::remove_cvref_t<T>>::GetSize());
+
+namespace detail {
+// contiguous range whose elements are exactly T
+template <typename R, typename T>
+concept ContiguousRangeOf =
+    requires(R& r) {
+      std::data(r);
+      { std::size(r) } -> std::convertible_to<size_t>;
+    } &&
+    std::same_as<
+        std::remove_cvref_t<decltype(*std::data(std::declval<R&>()))>, T>;
+}  // namespace detail
+
 /**
  * Unpack a serialized struct.
  *
@@ -288,6 +327,89 @@ inline void UnpackStructInto(T* out, std::span<const uint8_t> data,
   }
 }
 
+/**
+ * Pack a range of structs into contiguous serialized storage. If T is
+ * TriviallyPackableStruct and the range is contiguous, this is a single
+ * memcpy.
+ *
+ * @tparam T object type
+ * @param data struct storage (mutable, output); must be at least
+ *             std::size(values) * GetStructSize<T>(info...) bytes
+ * @param values objects
+ * @param info optional struct type info
+ */
+template <typename T, typename U, typename... I>
+  requires StructSerializable<T, I...>
+inline void PackStructs(std::span<uint8_t> data, U&& values,
+                        const I&... info) {
+  using S = Struct<T, typename std::remove_cvref_t<I>...>;
+  if constexpr (TriviallyPackableStruct<T, I...> &&
+                detail::ContiguousRangeOf<std::remove_reference_t<U>, T>) {
+    std::memcpy(data.data(), std::data(values), std::size(values) * sizeof(T));
+  } else {
+    auto size = S::GetSize(info...);
+    auto out = data.begin();
+    for (auto&& val : values) {
+      S::Pack(std::span<uint8_t>{std::to_address(out), size}, val, info...);
+      out += size;
+    }
+  }
+}
+
+/**
+ * Unpack contiguous serialized structs into existing objects, overwriting
+ * their contents. If T is TriviallyPackableStruct, this is a single memcpy.
+ *
+ * @param out objects (output)
+ * @param data raw struct data; must be at least
+ *             out.size() * GetStructSize<T>(info...) bytes
+ * @param info optional struct type info
+ */
+template <typename T, size_t N = std::dynamic_extent, typename... I>
+  requires StructSerializable<T, I...>
+inline void UnpackStructsInto(std::span<T, N> out,
+                              std::span<const uint8_t> data,
+                              const I&... info) {
+  using S = Struct<T, typename std::remove_cvref_t<I>...>;
+  if constexpr (TriviallyPackableStruct<T, I...>) {
+    std::memcpy(out.data(), data.data(), out.size() * sizeof(T));
+  } else {
+    auto size = S::GetSize(info...);
+    for (auto&& val : out) {
+      UnpackStructInto(&val, data, info...);
+      data = data.subspan(size);
+    }
+  }
+}
+
+/**
+ * Unpack contiguous serialized structs, appending them to a vector. If T is
+ * TriviallyPackableStruct, this is a single memcpy.
+ *
+ * @param out vector (output)
+ * @param data raw struct data; trailing partial structs are ignored
+ * @param info optional struct type info
+ */
+template <typename T, typename... I>
+  requires StructSerializable<T, I...>
+inline void UnpackStructs(std::vector<T>* out, std::span<const uint8_t> data,
+                          const I&... info) {
+  using S = Struct<T, typename std::remove_cvref_t<I>...>;
+  auto size = S::GetSize(info...);
+  size_t count = data.size() / size;
+  if constexpr (TriviallyPackableStruct<T, I...> &&
+                std::default_initializable<T>) {
+    size_t start = out->size();
+    out->resize(start + count);
+    std::memcpy(out->data() + start, data.data(), count * sizeof(T));
+  } else {
+    out->reserve(out->size() + count);
+    for (size_t i = 0; i < count; ++i) {
+      out->emplace_back(UnpackStruct<T>(data.subspan(i * size), info...));
+    }
+  }
+}
+
 /**
  * Get the type name for a raw struct serializable type
  *
@@ -455,26 +577,22 @@ class StructArrayBuffer {
 #endif
       std::invocable<F, std::span<const uint8_t>>
     void Write(U&& data, F&& func, const I&... info) {
-    auto size = S::GetSize(info...);
-    if ((std::size(data) * size) < 256) {
+    if constexpr (TriviallyPackableStruct<T, I...> &&
+                  detail::ContiguousRangeOf<std::remove_reference_t<U>, T>) {
+      // already in serialized form
+      func(std::span<const uint8_t>{
+          reinterpret_cast<const uint8_t*>(std::data(data)),
+          std::size(data) * sizeof(T)});
+    } else if (auto size = S::GetSize(info...);
+               (std::size(data) * size) < 256) {
       // use the stack
       uint8_t buf[256];
-      auto out = buf;
-      for (auto&& val : data) {
-        S::Pack(std::span<uint8_t>{std::to_address(out), size},
-                std::forward<decltype(val)>(val), info...);
-        out += size;
-      }
-      func(std::span<uint8_t>{buf, out});
+      PackStructs<T>(buf, data, info...);
+      func(std::span<uint8_t>{buf, std::size(data) * size});
     } else {
       std::scoped_lock lock{m_mutex};
       m_buf.resize(std::size(data) * size);
-      auto out = m_buf.begin();
-      for (auto&& val : data) {
-        S::Pack(std::span<uint8_t>{std::to_address(out), size},
-                std::forward<decltype(val)>(val), info...);
-        out += size;
-      }
+      PackStructs<T>(m_buf, data, info...);
       func(m_buf);
     }
   }
@@ -490,6 +608,7 @@ class StructArrayBuffer {
 template <typename T, size_t N, typename... I>
   requires StructSerializable<T, I...>
 struct Struct<std::array<T, N>, I...> {
+  static constexpr bool kTriviallyPackable = TriviallyPackableStruct<T, I...>;
   static constexpr auto GetTypeName(const I&... info) {
     return MakeStructArrayTypeName<T, N>(info...);
   }
@@ -501,22 +620,13 @@ struct Struct<std::array<T, N>, I...> {
   }
   static std::array<T, N> Unpack(std::span<const uint8_t> data,
                                  const I&... info) {
-    auto size = GetStructSize<T>(info...);
     std::array<T, N> result;
-    for (size_t i = 0; i < N; ++i) {
-      result[i] = UnpackStruct<T, 0>(data, info...);
-      data = data.subspan(size);
-    }
+    UnpackStructsInto(std::span{result}, data, info...);
     return result;
   }
   static void Pack(std::span<uint8_t> data, std::span<const T, N> values,
                    const I&... info) {
-    auto size = GetStructSize<T>(info...);
-    std::span<uint8_t> unsizedData = data;
-    for (auto&& val : values) {
-      PackStruct(unsizedData, val, info...);
-      unsizedData = unsizedData.subspan(size);
-    }
+    PackStructs<T>(data, values, info...);
   }
   static void UnpackInto(std::array<T, N>* out, std::span<const uint8_t> data,
                          const I&... info) {
@@ -525,12 +635,7 @@ struct Struct<std::array<T, N>, I...> {
   // alternate span-based function
   static void UnpackInto(std::span<T, N> out, std::span<const uint8_t> data,
                          const I&... info) {
-    auto size = GetStructSize<T>(info...);
-    std::span<const uint8_t> unsizedData = data;
-    for (size_t i = 0; i < N; ++i) {
-      UnpackStructInto(&out[i], unsizedData, info...);
-      unsizedData = unsizedData.subspan(size);
-    }
+    UnpackStructsInto(out, data, info...);
   }
 };
 
@@ -555,6 +660,7 @@ struct Struct<bool> {
  */
 template <>
 struct Struct<uint8_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "uint8"; }
   static constexpr size_t GetSize() { return 1; }
   static constexpr std::string_view GetSchema() { return "uint8 value"; }
@@ -568,6 +674,7 @@ struct Struct<uint8_t> {
  */
 template <>
 struct Struct<int8_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "int8"; }
   static constexpr size_t GetSize() { return 1; }
   static constexpr std::string_view GetSchema() { return "int8 value"; }
@@ -581,6 +688,7 @@ struct Struct<int8_t> {
  */
 template <>
 struct Struct<uint16_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "uint16"; }
   static constexpr size_t GetSize() { return 2; }
   static constexpr std::string_view GetSchema() { return "uint16 value"; }
@@ -598,6 +706,7 @@ struct Struct<uint16_t> {
  */
 template <>
 struct Struct<int16_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "int16"; }
   static constexpr size_t GetSize() { return 2; }
   static constexpr std::string_view GetSchema() { return "int16 value"; }
@@ -615,6 +724,7 @@ struct Struct<int16_t> {
  */
 template <>
 struct Struct<uint32_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "uint32"; }
   static constexpr size_t GetSize() { return 4; }
   static constexpr std::string_view GetSchema() { return "uint32 value"; }
@@ -632,6 +742,7 @@ struct Struct<uint32_t> {
  */
 template <>
 struct Struct<int32_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "int32"; }
   static constexpr size_t GetSize() { return 4; }
   static constexpr std::string_view GetSchema() { return "int32 value"; }
@@ -649,6 +760,7 @@ struct Struct<int32_t> {
  */
 template <>
 struct Struct<uint64_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "uint64"; }
   static constexpr size_t GetSize() { return 8; }
   static constexpr std::string_view GetSchema() { return "uint64 value"; }
@@ -666,6 +778,7 @@ struct Struct<uint64_t> {
  */
 template <>
 struct Struct<int64_t> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "int64"; }
   static constexpr size_t GetSize() { return 8; }
   static constexpr std::string_view GetSchema() { return "int64 value"; }
@@ -683,6 +796,7 @@ struct Struct<int64_t> {
  */
 template <>
 struct Struct<float> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "float"; }
   static constexpr size_t GetSize() { return 4; }
   static constexpr std::string_view GetSchema() { return "float value"; }
@@ -700,6 +814,7 @@ struct Struct<float> {
  */
 template <>
 struct Struct<double> {
+  static constexpr bool kTriviallyPackable = true;
   static constexpr std::string_view GetTypeName() { return "double"; }
   static constexpr size_t GetSize() { return 8; }
   static constexpr std::string_view GetSchema() { return "double value"; }
@@ -0,0 +1,248 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wpi/DataLogBackgroundWriter.h"
+#include "wpi/DataLogReader.h"
+#include "wpi/Logger.h"
+#include "wpi/MemoryBuffer.h"
+#include "wpi/fs.h"
+
+namespace {
+class DataLogBackgroundWriterTest : public ::testing::Test {
+ public:
+  // writes a log with an integer entry and a string entry; count is kept small
+  // enough that the outgoing buffers never fill
+  void WriteLog(bool compress, int count) {
+    wpi::log::DataLogBackgroundWriter log{
+        msglog,
+        [this](std::span<const uint8_t> d) {
+          data.insert(data.end(), d.begin(), d.end());
+        },
+        0.25, "", compress};
+    int entryInt = log.Start("int", "int64");
+    int entryStr = log.Start("str", "string");
+    for (int i = 0; i < count; ++i) {
+      log.AppendInteger(entryInt, i, i * 20 + 1);
+      if ((i % 7) == 0) {
+        log.AppendString(entryStr, "value", i * 20 + 1);
+      }
+    }
+  }
+
+  // returns the number of integer records read back in order from the start
+  int CheckLog(std::span<const uint8_t> buf) {
+    wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(buf)};
+    EXPECT_TRUE(reader.IsValid());
+    int entryInt = -1;
+    int count = 0;
+    for (auto&& record : reader) {
+      wpi::log::StartRecordData start;
+      if (record.GetStartData(&start) && start.name == "int") {
+        entryInt = start.entry;
+      } else if (!record.IsControl() && record.GetEntry() == entryInt) {
+        int64_t val;
+        if (!record.GetInteger(&val) || val != count ||
+            record.GetTimestamp() != count * 20 + 1) {
+          break;
+        }
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  std::vector<uint8_t> data;
+  wpi::Logger msglog;
+};
+}  // namespace
+
+TEST_F(DataLogBackgroundWriterTest, Uncompressed) {
+  WriteLog(false, 30000);
+  ASSERT_GE(data.size(), 6u);
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(data.data()), 6),
+            "WPILOG");
+  EXPECT_EQ(CheckLog(data), 30000);
+}
+
+TEST_F(DataLogBackgroundWriterTest, Compressed) {
+  WriteLog(true, 30000);
+  ASSERT_GE(data.size(), 6u);
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(data.data()), 6),
+            "WPILZ4");
+  EXPECT_EQ(CheckLog(data), 30000);
+
+  // should be smaller than the uncompressed log
+  std::vector<uint8_t> compressed = std::move(data);
+  data.clear();
+  WriteLog(false, 30000);
+  EXPECT_LT(compressed.size(), data.size() * 3 / 4);
+}
+
+TEST_F(DataLogBackgroundWriterTest, CompressedTruncated) {
+  WriteLog(true, 30000);
+  // drop the end of the last block; the complete blocks are still readable
+  data.resize(data.size() - 10);
+  int count = CheckLog(data);
+  EXPECT_GT(count, 0);
+  EXPECT_LT(count, 30000);
+}
+
+namespace {
+class DataLogBackgroundWriterFileTest : public ::testing::Test {
+ public:
+  DataLogBackgroundWriterFileTest() {
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir, ec);
+  }
+  ~DataLogBackgroundWriterFileTest() override { fs::remove_all(dir, ec); }
+
+  // gets the sorted names of the files in the directory
+  std::vector<std::string> GetFiles() {
+    std::vector<std::string> files;
+    for (auto&& entry : fs::directory_iterator{dir}) {
+      files.emplace_back(entry.path().filename().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+  }
+
+  // gets the values of the "int" entry in a file
+  std::vector<int64_t> ReadFile(std::string_view filename) {
+    auto buf = wpi::MemoryBuffer::GetFile((dir / filename).string());
+    EXPECT_TRUE(buf);
+    if (!buf) {
+      return {};
+    }
+    wpi::log::DataLogReader reader{std::move(*buf)};
+    EXPECT_TRUE(reader.IsValid());
+    std::vector<int64_t> values;
+    int entryInt = -1;
+    for (auto&& record : reader) {
+      wpi::log::StartRecordData start;
+      if (record.GetStartData(&start) && start.name == "int") {
+        entryInt = start.entry;
+      } else if (!record.IsControl() && record.GetEntry() == entryInt) {
+        int64_t val;
+        EXPECT_TRUE(record.GetInteger(&val));
+        values.emplace_back(val);
+      }
+    }
+    return values;
+  }
+
+  fs::path dir = fs::temp_directory_path() / "datalogbackgroundwritertest";
+  std::error_code ec;
+  wpi::Logger msglog;
+};
+}  // namespace
+
+TEST_F(DataLogBackgroundWriterFileTest, RotateSize) {
+  {
+    // long period so only explicit flushes write
+    wpi::log::DataLogBackgroundWriter log{msglog, dir.string(), "log.wpilog",
+                                          10.0};
+    log.SetRotation(10000, 0, 3);
+    int entryInt = log.Start("int", "int64");
+    for (int i = 0; i < 10; ++i) {
+      for (int j = 0; j < 1000; ++j) {
+        log.AppendInteger(entryInt, i * 1000 + j, 0);
+      }
+      log.FlushAndWait();
+    }
+  }
+
+  // only the newest 3 files are kept; together they have the last values
+  auto files = GetFiles();
+  ASSERT_EQ(files.size(), 3u);
+  std::sort(files.begin(), files.end(), [](auto& a, auto& b) {
+    return a.size() < b.size() || (a.size() == b.size() && a < b);
+  });
+  EXPECT_EQ(files.front().substr(0, 4), "log.");
+  std::vector<int64_t> values;
+  for (auto&& file : files) {
+    auto fileValues = ReadFile(file);
+    values.insert(values.end(), fileValues.begin(), fileValues.end());
+  }
+  ASSERT_FALSE(values.empty());
+  EXPECT_LT(values.size(), 10000u);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], static_cast<int64_t>(10000 - values.size() + i));
+  }
+}
+
+TEST_F(DataLogBackgroundWriterFileTest, FlightRecorder) {
+  {
+    // long period so only explicit flushes write
+    wpi::log::DataLogBackgroundWriter log{msglog, dir.string(), "log.wpilog",
+                                          10.0};
+    log.SetFlightRecorder(16 * 1024);
+    int entryInt = log.Start("int", "int64");
+    for (int i = 0; i < 10000; ++i) {
+      log.AppendInteger(entryInt, i, 0);
+      if ((i % 1000) == 0) {
+        log.FlushAndWait();
+      }
+    }
+    log.TriggerFlightRecorder();
+    log.FlushAndWait();
+    for (int i = 10000; i < 10010; ++i) {
+      log.AppendInteger(entryInt, i, 0);
+    }
+    log.TriggerFlightRecorder();
+  }
+
+  // no file is created before the first trigger, then one per trigger
+  auto files = GetFiles();
+  ASSERT_EQ(files.size(), 2u);
+  EXPECT_EQ(files[0], "log.2.wpilog");
+  EXPECT_EQ(files[1], "log.wpilog");
+
+  // only the most recent values are kept, starting with the last value that
+  // was discarded
+  auto values = ReadFile("log.wpilog");
+  ASSERT_FALSE(values.empty());
+  EXPECT_LT(values.size(), 2000u);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], static_cast<int64_t>(10000 - values.size() + i));
+  }
+
+  // the second trigger has the last value before it, then the new values
+  values = ReadFile("log.2.wpilog");
+  ASSERT_EQ(values.size(), 11u);
+  EXPECT_EQ(values.front(), 9999);
+  EXPECT_EQ(values.back(), 10009);
+}
+
+TEST_F(DataLogBackgroundWriterFileTest, FlightRecorderAfterWrite) {
+  {
+    wpi::log::DataLogBackgroundWriter log{msglog, dir.string(), "log.wpilog",
+                                          10.0};
+    int entryInt = log.Start("int", "int64");
+    log.AppendInteger(entryInt, 1, 0);
+    log.FlushAndWait();
+    log.SetFlightRecorder(16 * 1024);
+    log.FlushAndWait();
+    log.AppendInteger(entryInt, 2, 0);
+    log.FlushAndWait();
+    log.TriggerFlightRecorder();
+  }
+
+  // the file written before flight recorder mode, then the trigger
+  auto files = GetFiles();
+  ASSERT_EQ(files.size(), 2u);
+  EXPECT_EQ(files[0], "log.2.wpilog");
+  EXPECT_EQ(files[1], "log.wpilog");
+  EXPECT_EQ(ReadFile("log.wpilog"), std::vector<int64_t>{1});
+  EXPECT_EQ(ReadFile("log.2.wpilog"), std::vector<int64_t>{2});
+}
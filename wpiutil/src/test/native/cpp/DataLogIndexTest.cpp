@@ -0,0 +1,120 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wpi/DataLogIndex.h"
+#include "wpi/DataLogReader.h"
+#include "wpi/DataLogWriter.h"
+#include "wpi/Logger.h"
+#include "wpi/MemoryBuffer.h"
+#include "wpi/fs.h"
+#include "wpi/raw_ostream.h"
+
+class DataLogIndexTest : public ::testing::Test {
+ public:
+  DataLogIndexTest() {
+    wpi::Logger msglog;
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+    entryA = log.Start("a", "int64", "", 1);
+    entryB = log.Start("b", "int64", "", 1);
+    for (int i = 0; i < 100; ++i) {
+      log.AppendInteger(entryA, i, 100 + i * 10);
+      if ((i % 4) == 0) {
+        log.AppendInteger(entryB, i, 100 + i * 10);
+      }
+    }
+    log.Flush();
+  }
+
+  wpi::log::DataLogReader MakeReader() {
+    return wpi::log::DataLogReader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  }
+
+  std::vector<uint8_t> data;
+  int entryA;
+  int entryB;
+};
+
+TEST_F(DataLogIndexTest, RecordOffsets) {
+  auto reader = MakeReader();
+  wpi::log::DataLogIndex index{reader, 16};
+  ASSERT_TRUE(index);
+  EXPECT_EQ(index.GetEntries(), (std::vector<int>{0, entryA, entryB}));
+  EXPECT_EQ(index.GetRecordCount(), 127u);
+  EXPECT_EQ(index.GetRecordOffsets(0).size(), 2u);
+  EXPECT_TRUE(index.GetRecordOffsets(99).empty());
+
+  auto offsets = index.GetRecordOffsets(entryB);
+  ASSERT_EQ(offsets.size(), 25u);
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    auto it = reader.Seek(offsets[i]);
+    ASSERT_NE(it, reader.end());
+    EXPECT_EQ(it->GetEntry(), entryB);
+    int64_t value;
+    ASSERT_TRUE(it->GetInteger(&value));
+    EXPECT_EQ(value, static_cast<int64_t>(i * 4));
+  }
+}
+
+TEST_F(DataLogIndexTest, FindTimestamp) {
+  auto reader = MakeReader();
+  wpi::log::DataLogIndex index{reader, 16};
+  ASSERT_TRUE(index);
+
+  EXPECT_EQ(index.FindTimestamp(0), index.GetRecordOffsets(0)[0]);
+  EXPECT_EQ(reader.Seek(index.FindTimestamp(2000)), reader.end());
+
+  // every record at or after the timestamp is found from the offset
+  int64_t timestamp = 600;
+  auto it = reader.Seek(index.FindTimestamp(timestamp));
+  ASSERT_NE(it, reader.end());
+  EXPECT_LE(it->GetTimestamp(), timestamp);
+  int count = 0;
+  for (; it != reader.end(); ++it) {
+    if (it->GetTimestamp() >= timestamp) {
+      ++count;
+    }
+  }
+  // 50 records of a, 12 of b
+  EXPECT_EQ(count, 62);
+}
+
+TEST_F(DataLogIndexTest, SaveLoad) {
+  auto reader = MakeReader();
+  wpi::log::DataLogIndex built{reader, 16};
+  auto filename =
+      (fs::temp_directory_path() / "datalogindextest.wpilog.idx").string();
+
+  std::error_code ec;
+  built.Save(filename, ec);
+  ASSERT_FALSE(ec);
+
+  wpi::log::DataLogIndex loaded{filename, reader, ec};
+  ASSERT_FALSE(ec);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(loaded.GetEntries(), built.GetEntries());
+  EXPECT_EQ(loaded.GetRecordCount(), built.GetRecordCount());
+  auto builtOffsets = built.GetRecordOffsets(entryA);
+  auto loadedOffsets = loaded.GetRecordOffsets(entryA);
+  EXPECT_TRUE(std::equal(builtOffsets.begin(), builtOffsets.end(),
+                         loadedOffsets.begin(), loadedOffsets.end()));
+  EXPECT_EQ(loaded.FindTimestamp(600), built.FindTimestamp(600));
+
+  // an index for a different log is rejected
+  data.resize(data.size() - 1);
+  auto reader2 = MakeReader();
+  wpi::log::DataLogIndex stale{filename, reader2, ec};
+  EXPECT_TRUE(ec);
+  EXPECT_FALSE(stale);
+
+  fs::remove(filename, ec);
+}
@@ -0,0 +1,181 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wpi/DataLogParallelReader.h"
+#include "wpi/DataLogReader.h"
+#include "wpi/DataLogWriter.h"
+#include "wpi/Logger.h"
+#include "wpi/MemoryBuffer.h"
+#include "wpi/raw_ostream.h"
+
+namespace {
+class DataLogParallelReaderTest : public ::testing::Test {
+ public:
+  wpi::log::DataLogReader MakeReader() {
+    return wpi::log::DataLogReader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  }
+
+  // positions of all records, read sequentially
+  std::vector<size_t> ReadSequential() {
+    auto reader = MakeReader();
+    std::vector<size_t> rv;
+    for (auto it = reader.begin(), end = reader.end(); it != end; ++it) {
+      rv.emplace_back(it.GetPosition());
+    }
+    return rv;
+  }
+
+  // positions of all records, read in parallel
+  std::vector<size_t> ReadParallel(unsigned int numThreads,
+                                   size_t* numChunks = nullptr) {
+    auto reader = MakeReader();
+    wpi::log::DataLogParallelReader parallel{reader, numThreads};
+    if (numChunks) {
+      *numChunks = parallel.GetNumChunks();
+    }
+    auto chunks = parallel.ReadChunks<std::vector<size_t>>(
+        [](auto& chunk, wpi::log::DataLogIterator it) {
+          chunk.emplace_back(it.GetPosition());
+        });
+    std::vector<size_t> rv;
+    for (auto&& chunk : chunks) {
+      rv.insert(rv.end(), chunk.begin(), chunk.end());
+    }
+    return rv;
+  }
+
+  // enough records to be split into multiple chunks
+  void WriteLargeLog() {
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+    int entryInt = log.Start("int", "int64");
+    int entryStr = log.Start("str", "string");
+    for (int i = 0; i < 200000; ++i) {
+      log.AppendInteger(entryInt, i, i * 20);
+      if ((i % 7) == 0) {
+        log.AppendString(entryStr, "value", i * 20);
+      }
+      if ((i % 10000) == 0) {
+        log.Flush();
+      }
+    }
+  }
+
+  // raw payloads consisting of valid-looking records (entry 1, 8 bytes of
+  // data, timestamp 1), so split points inside them resync incorrectly
+  void WriteFalseResyncLog() {
+    std::vector<uint8_t> fake;
+    for (int i = 0; i < 10000; ++i) {
+      fake.insert(fake.end(), {0x00, 0x01, 0x08, 0x01, 0, 0, 0, 0, 0, 0, 0, 0});
+    }
+    {
+      wpi::log::DataLogWriter log{
+          msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+      int entryRaw = log.Start("raw", "raw");
+      int entryInt = log.Start("int", "int64");
+      for (int i = 0; i < 20; ++i) {
+        log.AppendRaw(entryRaw, fake, i * 20);
+        log.AppendInteger(entryInt, i, i * 20);
+        log.Flush();
+      }
+    }
+  }
+
+  std::vector<uint8_t> data;
+  wpi::Logger msglog;
+};
+}  // namespace
+
+TEST_F(DataLogParallelReaderTest, Empty) {
+  {
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+  }
+  size_t numChunks;
+  EXPECT_TRUE(ReadParallel(4, &numChunks).empty());
+  EXPECT_EQ(numChunks, 1u);
+}
+
+TEST_F(DataLogParallelReaderTest, MatchesSequential) {
+  WriteLargeLog();
+  auto expected = ReadSequential();
+  for (unsigned int numThreads : {1u, 2u, 4u}) {
+    size_t numChunks;
+    auto actual = ReadParallel(numThreads, &numChunks);
+    EXPECT_GT(numChunks, 1u);
+    EXPECT_EQ(actual, expected);
+  }
+}
+
+TEST_F(DataLogParallelReaderTest, FalseResync) {
+  WriteFalseResyncLog();
+  auto expected = ReadSequential();
+  ASSERT_EQ(expected.size(), 42u);
+  size_t numChunks;
+  auto actual = ReadParallel(4, &numChunks);
+  EXPECT_GT(numChunks, 1u);
+  EXPECT_EQ(actual, expected);
+}
+
+TEST_F(DataLogParallelReaderTest, ChunkDone) {
+  WriteFalseResyncLog();
+  auto expected = ReadSequential();
+  auto reader = MakeReader();
+  wpi::log::DataLogParallelReader parallel{reader, 4};
+  ASSERT_GT(parallel.GetNumChunks(), 1u);
+  std::vector<std::vector<size_t>> chunks(parallel.GetNumChunks());
+  std::vector<std::atomic_bool> done(parallel.GetNumChunks());
+  // merged as each chunk is done
+  std::vector<size_t> actual;
+  std::vector<size_t> doneOrder;
+  EXPECT_TRUE(parallel.ForEachRecord(
+      [&](size_t i) {
+        EXPECT_FALSE(done[i]);
+        chunks[i].clear();
+      },
+      [&](size_t i, wpi::log::DataLogIterator it) {
+        EXPECT_FALSE(done[i]);
+        chunks[i].emplace_back(it.GetPosition());
+        return true;
+      },
+      [&](size_t i) {
+        done[i] = true;
+        doneOrder.emplace_back(i);
+        actual.insert(actual.end(), chunks[i].begin(), chunks[i].end());
+      }));
+  std::vector<size_t> expectedOrder(parallel.GetNumChunks());
+  for (size_t i = 0; i < expectedOrder.size(); ++i) {
+    expectedOrder[i] = i;
+  }
+  EXPECT_EQ(doneOrder, expectedOrder);
+  EXPECT_EQ(actual, expected);
+}
+
+TEST_F(DataLogParallelReaderTest, Stop) {
+  WriteLargeLog();
+  auto total = ReadSequential().size();
+  auto reader = MakeReader();
+  wpi::log::DataLogParallelReader parallel{reader, 4};
+  ASSERT_GT(parallel.GetNumChunks(), 1u);
+  std::atomic<size_t> numRecords{0};
+  std::vector<size_t> doneOrder;
+  EXPECT_FALSE(parallel.ForEachRecord(
+      [](size_t) {},
+      [&](size_t, wpi::log::DataLogIterator) { return ++numRecords < 1000; },
+      [&](size_t i) { doneOrder.emplace_back(i); }));
+  // each thread stops at its next record
+  EXPECT_LT(numRecords, 1000u + 4u);
+  EXPECT_LT(numRecords, total);
+  // chunks are only reported done in order, and not all of them
+  EXPECT_LT(doneOrder.size(), parallel.GetNumChunks());
+  for (size_t i = 0; i < doneOrder.size(); ++i) {
+    EXPECT_EQ(doneOrder[i], i);
+  }
+}
@@ -2,15 +2,22 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <stdint.h>
+
 #include <array>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <fmt/format.h>
 #include <gtest/gtest.h>
 
+#include "wpi/DataLogReader.h"
 #include "wpi/DataLogWriter.h"
+#include "wpi/DenseMap.h"
 #include "wpi/Logger.h"
+#include "wpi/MemoryBuffer.h"
 #include "wpi/raw_ostream.h"
 
 namespace {
@@ -142,6 +149,78 @@ TEST_F(DataLogTest, SimpleInt) {
   ASSERT_EQ(data.size(), 54u);
 }
 
+TEST_F(DataLogTest, MultiThreadAppend) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumValues = 10000;
+  std::vector<int> entries;
+  for (int i = 0; i < kNumThreads; ++i) {
+    entries.emplace_back(log.Start(fmt::format("test{}", i), "int64", "", 1));
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, entry = entries[i]] {
+      for (int j = 0; j < kNumValues; ++j) {
+        log.AppendInteger(entry, j, j + 1);
+      }
+    });
+  }
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  log.Finish(entries[0], kNumValues + 1);
+  log.Flush();
+
+  // each entry has every value in order, and all precede the finish record
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  ASSERT_TRUE(reader);
+  wpi::DenseMap<int, int64_t> next;
+  bool finished = false;
+  for (auto&& record : reader) {
+    if (record.IsFinish()) {
+      finished = true;
+    } else if (!record.IsControl()) {
+      EXPECT_FALSE(finished && record.GetEntry() == entries[0]);
+      int64_t value;
+      ASSERT_TRUE(record.GetInteger(&value));
+      EXPECT_EQ(value, next[record.GetEntry()]++);
+    }
+  }
+  EXPECT_TRUE(finished);
+  for (auto entry : entries) {
+    EXPECT_EQ(next[entry], kNumValues);
+  }
+}
+
+TEST_F(DataLogTest, MultiThreadTimestampOrder) {
+  // two threads append to the same entry with interleaved timestamps; the
+  // thread buffers are merged by record timestamp
+  constexpr int kNumValues = 100;
+  int entry = log.Start("test", "int64", "", 1);
+  std::thread thread0{[&] {
+    for (int j = 0; j < kNumValues; ++j) {
+      log.AppendInteger(entry, j, 100 + j * 2);
+    }
+  }};
+  std::thread thread1{[&] {
+    for (int j = 0; j < kNumValues; ++j) {
+      log.AppendInteger(entry, j, 101 + j * 2);
+    }
+  }};
+  thread0.join();
+  thread1.join();
+  log.Flush();
+
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  ASSERT_TRUE(reader);
+  int64_t expected = 100;
+  for (auto&& record : reader) {
+    if (!record.IsControl()) {
+      EXPECT_EQ(record.GetTimestamp(), expected++);
+    }
+  }
+  EXPECT_EQ(expected, 100 + kNumValues * 2);
+}
+
 TEST_F(DataLogTest, BooleanAppend) {
   wpi::log::BooleanLogEntry entry{log, "a", 5};
   entry.Append(false, 7);
@@ -242,6 +321,73 @@ TEST_F(DataLogTest, DoubleUpdate) {
   ASSERT_EQ(entry.GetLastValue().value(), 0.1);
 }
 
+TEST_F(DataLogTest, DoubleUpdateDeadband) {
+  wpi::log::DoubleLogEntry entry{log, "a", 5};
+  entry.SetDeadband(0.5);
+  entry.Update(1.0, 7);
+  log.Flush();
+  ASSERT_EQ(data.size(), 52u);
+  // changes within the deadband of the last recorded value are not recorded
+  entry.Update(1.4, 8);
+  entry.Update(0.6, 9);
+  log.Flush();
+  ASSERT_EQ(data.size(), 52u);
+  ASSERT_EQ(entry.GetLastValue().value(), 1.0);
+  entry.Update(1.6, 10);
+  log.Flush();
+  ASSERT_EQ(data.size(), 64u);
+  ASSERT_EQ(entry.GetLastValue().value(), 1.6);
+}
+
+TEST_F(DataLogTest, IntegerUpdateDeadband) {
+  // above 2^53, where not every integer is representable as a double
+  constexpr int64_t kBase = int64_t{1} << 53;
+  wpi::log::IntegerLogEntry entry{log, "a", 5};
+  entry.SetDeadband(1);
+  entry.Update(kBase + 1, 7);
+  entry.Update(kBase + 2, 8);
+  ASSERT_EQ(entry.GetLastValue().value(), kBase + 1);
+  entry.Update(kBase + 3, 9);
+  ASSERT_EQ(entry.GetLastValue().value(), kBase + 3);
+
+  // the difference doesn't fit in int64_t
+  entry.SetDeadband(1e18);
+  entry.Update(INT64_MIN, 10);
+  ASSERT_EQ(entry.GetLastValue().value(), INT64_MIN);
+  entry.Update(INT64_MAX, 11);
+  ASSERT_EQ(entry.GetLastValue().value(), INT64_MAX);
+  entry.Update(INT64_MAX - 1000, 12);
+  ASSERT_EQ(entry.GetLastValue().value(), INT64_MAX);
+
+  // larger than any difference
+  entry.SetDeadband(1e20);
+  entry.Update(INT64_MIN, 13);
+  ASSERT_EQ(entry.GetLastValue().value(), INT64_MAX);
+}
+
+TEST_F(DataLogTest, IntegerUpdateKeyframe) {
+  wpi::log::IntegerLogEntry entry{log, "a", 5};
+  entry.SetKeyframeInterval(100);
+  entry.Update(1, 10);
+  log.Flush();
+  ASSERT_EQ(data.size(), 51u);
+  entry.Update(1, 50);
+  log.Flush();
+  ASSERT_EQ(data.size(), 51u);
+  // unchanged value is recorded once the interval has passed
+  entry.Update(1, 110);
+  log.Flush();
+  ASSERT_EQ(data.size(), 63u);
+  entry.Update(1, 150);
+  log.Flush();
+  ASSERT_EQ(data.size(), 63u);
+  // a change restarts the interval
+  entry.Update(2, 160);
+  entry.Update(2, 250);
+  log.Flush();
+  ASSERT_EQ(data.size(), 75u);
+}
+
 TEST_F(DataLogTest, StringAppend) {
   wpi::log::StringLogEntry entry{log, "a", 5};
   entry.Append("x", 7);
@@ -289,6 +435,38 @@ TEST_F(DataLogTest, RawAppend) {
   ASSERT_EQ(data.size(), 42u);
 }
 
+TEST_F(DataLogTest, RawAppendInPlace) {
+  int entry = log.Start("a", "raw", "", 5);
+  // thread buffer, shared buffer, and larger than a buffer
+  for (size_t size : {10u, 8000u, 40000u}) {
+    log.AppendRawInPlace(
+        entry, size,
+        [&](std::span<uint8_t> buf) {
+          ASSERT_EQ(buf.size(), size);
+          for (size_t i = 0; i < size; ++i) {
+            buf[i] = i % 251;
+          }
+        },
+        size);
+  }
+  log.Flush();
+
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  int count = 0;
+  for (auto&& record : reader) {
+    if (record.IsControl()) {
+      continue;
+    }
+    auto raw = record.GetRaw();
+    ASSERT_EQ(raw.size(), static_cast<size_t>(record.GetTimestamp()));
+    for (size_t i = 0; i < raw.size(); ++i) {
+      ASSERT_EQ(raw[i], i % 251);
+    }
+    ++count;
+  }
+  ASSERT_EQ(count, 3);
+}
+
 TEST_F(DataLogTest, RawUpdate) {
   wpi::log::RawLogEntry entry{log, "a", 5};
   ASSERT_FALSE(entry.HasLastValue());
@@ -433,6 +611,26 @@ TEST_F(DataLogTest, DoubleArrayUpdate) {
   ASSERT_EQ(entry.GetLastValue().value(), std::vector<double>{});
 }
 
+TEST_F(DataLogTest, DoubleArrayUpdateDeadband) {
+  wpi::log::DoubleArrayLogEntry entry{log, "a", 5};
+  entry.SetDeadband(0.5);
+  entry.Update({1.0, 2.0}, 7);
+  log.Flush();
+  ASSERT_EQ(data.size(), 62u);
+  entry.Update({1.2, 1.7}, 8);
+  log.Flush();
+  ASSERT_EQ(data.size(), 62u);
+  // any element outside the deadband records the whole array
+  entry.Update({1.2, 2.6}, 9);
+  log.Flush();
+  ASSERT_EQ(data.size(), 82u);
+  ASSERT_EQ(entry.GetLastValue().value(), (std::vector<double>{1.2, 2.6}));
+  // size changes are always recorded
+  entry.Update({1.2}, 10);
+  log.Flush();
+  ASSERT_EQ(data.size(), 94u);
+}
+
 TEST_F(DataLogTest, FloatArrayAppendEmpty) {
   wpi::log::FloatArrayLogEntry entry{log, "a", 5};
   entry.Append(std::span<const float>{}, 7);
@@ -537,6 +735,18 @@ TEST_F(DataLogTest, StructUpdate) {
   ASSERT_EQ(entry.GetLastValue().value(), ThingA{.x = 1});
 }
 
+TEST_F(DataLogTest, StructUpdateKeyframe) {
+  wpi::log::StructLogEntry<ThingA> entry{log, "a", 5};
+  entry.SetKeyframeInterval(100);
+  entry.Update(ThingA{}, 7);
+  entry.Update(ThingA{}, 8);
+  log.Flush();
+  ASSERT_EQ(data.size(), 122u);
+  entry.Update(ThingA{}, 107);
+  log.Flush();
+  ASSERT_EQ(data.size(), 127u);
+}
+
 TEST_F(DataLogTest, StructArrayA) {
   [[maybe_unused]]
   wpi::log::StructArrayLogEntry<ThingA> entry0;
@@ -0,0 +1,240 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "wpi/DataLog.h"
+#include "wpi/DataLogBackgroundWriter.h"
+#include "wpi/DataLogReader.h"
+#include "wpi/DataLogWriter.h"
+#include "wpi/Logger.h"
+#include "wpi/MemoryBuffer.h"
+#include "wpi/SmallVector.h"
+#include "wpi/lz4.h"
+#include "wpi/mutex.h"
+#include "wpi/print.h"
+#include "wpi/raw_ostream.h"
+
+namespace {
+// discards all data
+class NullDataLog final : public wpi::log::DataLog {
+ public:
+  explicit NullDataLog(wpi::Logger& msglog) : DataLog{msglog} { StartFile(); }
+
+  void Flush() final {
+    std::vector<Buffer> bufs;
+    FlushBufs(&bufs);
+    ReleaseBufs(&bufs);
+  }
+
+ private:
+  bool BufferFull() final { return false; }
+};
+}  // namespace
+
+// Measures append throughput with several threads logging at once.  The
+// "contended" runs additionally hold a single shared mutex around every
+// append; this approximates the contention of a single log-wide lock, but it
+// still goes through the per-thread append path, so it is not a measurement
+// of the implementation before per-thread append buffers were added.
+static void RunAppendBenchmark(int numThreads, bool contended) {
+  using std::chrono::duration_cast;
+  using std::chrono::high_resolution_clock;
+  using std::chrono::microseconds;
+
+  constexpr int kNumAppends = 200000;
+
+  wpi::Logger msglog;
+  NullDataLog log{msglog};
+  wpi::mutex sharedMutex;
+
+  std::vector<int> entries;
+  for (int i = 0; i < numThreads; ++i) {
+    entries.emplace_back(log.Start(fmt::format("bench{}", i), "double"));
+  }
+
+  // keep the buffers drained, as the background writer would
+  std::atomic_bool done{false};
+  std::thread flusher([&] {
+    while (!done) {
+      log.Flush();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  auto start = high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&, entry = entries[i]] {
+      for (int j = 0; j < kNumAppends; ++j) {
+        if (contended) {
+          std::scoped_lock lock{sharedMutex};
+          log.AppendDouble(entry, j, 0);
+        } else {
+          log.AppendDouble(entry, j, 0);
+        }
+      }
+    });
+  }
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  auto stop = high_resolution_clock::now();
+
+  done = true;
+  flusher.join();
+
+  auto us = duration_cast<microseconds>(stop - start).count();
+  wpi::print("{} threads {}: time: {} us, {:.1f} appends/us\n", numThreads,
+             contended ? "per-thread + shared mutex" : "per-thread", us,
+             static_cast<double>(numThreads) * kNumAppends /
+                 (us == 0 ? 1 : us));
+}
+
+TEST(DataLogBenchmark, MultiThreadAppend) {
+  for (int numThreads : {1, 2, 4}) {
+    RunAppendBenchmark(numThreads, true);
+    RunAppendBenchmark(numThreads, false);
+  }
+}
+
+// Appends a typical mix of robot telemetry: slowly varying doubles, counters,
+// and occasional status strings.
+static void AppendTelemetry(wpi::log::DataLog& log,
+                            std::span<const int> entries, int i) {
+  int64_t timestamp = 1000 + i * 20000;
+  for (size_t j = 0; j < entries.size() - 2; ++j) {
+    log.AppendDouble(entries[j], std::sin(i * 0.01 + j) * 12.0, timestamp);
+  }
+  log.AppendInteger(entries[entries.size() - 2], i, timestamp);
+  if ((i % 50) == 0) {
+    log.AppendString(entries.back(), fmt::format("mode {}", i / 1000),
+                     timestamp);
+  }
+}
+
+static std::vector<int> StartTelemetry(wpi::log::DataLog& log) {
+  std::vector<int> entries;
+  for (int i = 0; i < 8; ++i) {
+    entries.emplace_back(log.Start(fmt::format("/drive/value{}", i), "double"));
+  }
+  entries.emplace_back(log.Start("/loopCount", "int64"));
+  entries.emplace_back(log.Start("/status", "string"));
+  return entries;
+}
+
+// Measures compression throughput of the compressed log format.  This must
+// stay well above the rate robot code logs at so the background writer
+// thread keeps up.  The throughput is only reported, as timing on shared test
+// machines is too noisy to assert on.
+TEST(DataLogBenchmark, Lz4Compress) {
+  using std::chrono::duration_cast;
+  using std::chrono::high_resolution_clock;
+  using std::chrono::microseconds;
+
+  wpi::Logger msglog;
+  std::vector<uint8_t> data;
+  {
+    wpi::log::DataLogWriter log{
+        msglog, std::make_unique<wpi::raw_uvector_ostream>(data)};
+    auto entries = StartTelemetry(log);
+    for (int i = 0; i < 20000; ++i) {
+      AppendTelemetry(log, entries, i);
+      if ((i % 1000) == 0) {
+        log.Flush();
+      }
+    }
+  }
+
+  constexpr size_t kBlockSize = 64 * 1024;
+  wpi::SmallVector<uint8_t, 128> out;
+  size_t compressedSize = 0;
+  auto start = high_resolution_clock::now();
+  for (size_t pos = 0; pos < data.size(); pos += kBlockSize) {
+    out.clear();
+    compressedSize +=
+        wpi::Lz4Compress(std::span{data}.subspan(pos).first(
+                             (std::min)(kBlockSize, data.size() - pos)),
+                         out)
+            .size();
+  }
+  auto stop = high_resolution_clock::now();
+
+  auto us = duration_cast<microseconds>(stop - start).count();
+  double mbPerSec = static_cast<double>(data.size()) / (us == 0 ? 1 : us);
+  wpi::print("compress {} bytes to {} ({:.1f}%): time: {} us, {:.1f} MB/s\n",
+             data.size(), compressedSize, 100.0 * compressedSize / data.size(),
+             us, mbPerSec);
+  EXPECT_LT(compressedSize, data.size());
+}
+
+// Logs at a fixed rate through a compressing background writer and checks
+// that no data is dropped.
+TEST(DataLogBenchmark, CompressedBackgroundWriter) {
+  using std::chrono::duration_cast;
+  using std::chrono::high_resolution_clock;
+  using std::chrono::microseconds;
+
+  // kept short as this runs with the unit tests; increase kNumLoops for a
+  // longer run
+  constexpr int kNumLoops = 100;
+  constexpr auto kLoopPeriod = std::chrono::milliseconds(1);
+  // each loop appends about 1 KB, so the log rate is about 1 MB/s
+  constexpr int kRecordsPerLoop = 8;
+
+  wpi::Logger msglog;
+  std::vector<uint8_t> data;
+  {
+    wpi::log::DataLogBackgroundWriter log{
+        msglog,
+        [&](std::span<const uint8_t> d) {
+          data.insert(data.end(), d.begin(), d.end());
+        },
+        0.1, "", true};
+    auto entries = StartTelemetry(log);
+
+    auto start = high_resolution_clock::now();
+    auto next = start;
+    for (int i = 0; i < kNumLoops; ++i) {
+      for (int j = 0; j < kRecordsPerLoop; ++j) {
+        AppendTelemetry(log, entries, i * kRecordsPerLoop + j);
+      }
+      next += kLoopPeriod;
+      std::this_thread::sleep_until(next);
+    }
+    auto stop = high_resolution_clock::now();
+    auto us = duration_cast<microseconds>(stop - start).count();
+    wpi::print("background writer: time: {} us\n", us);
+  }
+
+  // every loop count record should be present
+  wpi::log::DataLogReader reader{wpi::MemoryBuffer::GetMemBuffer(data)};
+  ASSERT_TRUE(reader.IsValid());
+  int64_t expected = 0;
+  int loopEntry = -1;
+  for (auto&& record : reader) {
+    wpi::log::StartRecordData startData;
+    if (record.GetStartData(&startData) && startData.name == "/loopCount") {
+      loopEntry = startData.entry;
+    } else if (!record.IsControl() && record.GetEntry() == loopEntry) {
+      int64_t val;
+      ASSERT_TRUE(record.GetInteger(&val));
+      ASSERT_EQ(val, expected);
+      ++expected;
+    }
+  }
+  wpi::print("background writer: {} bytes written\n", data.size());
+  EXPECT_EQ(expected, kNumLoops * kRecordsPerLoop);
+}
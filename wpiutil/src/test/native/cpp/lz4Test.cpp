@@ -0,0 +1,99 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wpi/SmallVector.h"
+#include "wpi/lz4.h"
+
+namespace {
+void RoundTrip(const std::vector<uint8_t>& data) {
+  wpi::SmallVector<uint8_t, 64> buf{0xaa};  // compressed data is appended
+  auto compressed = wpi::Lz4Compress(data, buf);
+  EXPECT_EQ(buf[0], 0xaa);
+  EXPECT_EQ(compressed.size(), buf.size() - 1);
+  EXPECT_LE(compressed.size(), wpi::Lz4CompressBound(data.size()));
+
+  std::vector<uint8_t> out(data.size());
+  ASSERT_TRUE(wpi::Lz4Decompress(compressed, out));
+  EXPECT_EQ(out, data);
+}
+}  // namespace
+
+TEST(Lz4Test, Empty) {
+  RoundTrip({});
+}
+
+TEST(Lz4Test, Short) {
+  RoundTrip({1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4});
+}
+
+TEST(Lz4Test, Repeated) {
+  std::vector<uint8_t> data(100000, 5);
+  RoundTrip(data);
+
+  wpi::SmallVector<uint8_t, 64> buf;
+  EXPECT_LT(wpi::Lz4Compress(data, buf).size(), 1000u);
+}
+
+TEST(Lz4Test, Random) {
+  std::mt19937 gen{1234};
+  std::vector<uint8_t> data(100000);
+  for (auto&& b : data) {
+    b = gen();
+  }
+  RoundTrip(data);
+}
+
+TEST(Lz4Test, Mixed) {
+  // random runs of repeated and random data, with long literal and match
+  // lengths
+  std::mt19937 gen{5678};
+  std::vector<uint8_t> data;
+  for (int i = 0; i < 50; ++i) {
+    size_t len = gen() % 2000;
+    if ((i % 2) == 0) {
+      data.insert(data.end(), len, static_cast<uint8_t>(i));
+    } else {
+      for (size_t j = 0; j < len; ++j) {
+        data.push_back(gen());
+      }
+    }
+  }
+  RoundTrip(data);
+}
+
+TEST(Lz4Test, DecompressInvalid) {
+  std::vector<uint8_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i % 37;
+  }
+  wpi::SmallVector<uint8_t, 64> buf;
+  auto compressed = wpi::Lz4Compress(data, buf);
+  std::vector<uint8_t> out(data.size());
+
+  // wrong output size
+  std::vector<uint8_t> shortOut(data.size() - 1);
+  EXPECT_FALSE(wpi::Lz4Decompress(compressed, shortOut));
+  std::vector<uint8_t> longOut(data.size() + 1);
+  EXPECT_FALSE(wpi::Lz4Decompress(compressed, longOut));
+
+  // truncated input
+  EXPECT_FALSE(wpi::Lz4Decompress(compressed.first(compressed.size() - 1), out));
+
+  // offset before the start of the output
+  const uint8_t badOffset[] = {0x10, 'a', 0x05, 0x00, 0x00};
+  std::vector<uint8_t> out2(5);
+  EXPECT_FALSE(wpi::Lz4Decompress(badOffset, out2));
+
+  // every truncation of valid data is rejected without reading out of bounds
+  for (size_t i = 0; i < compressed.size(); ++i) {
+    EXPECT_FALSE(wpi::Lz4Decompress(compressed.first(i), out));
+  }
+}
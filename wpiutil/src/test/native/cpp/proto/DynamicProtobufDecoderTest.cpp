@@ -0,0 +1,240 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/protobuf/DynamicProtobufDecoder.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/message.h>
+#include <gtest/gtest.h>
+
+#include "wpi/protobuf/ProtobufMessageDatabase.h"
+#include "wpiutil.npb.h"
+
+using namespace wpi;
+
+namespace {
+// records each visited field as a string
+class RecordingVisitor : public DynamicProtobufDecoder::Visitor {
+ public:
+  using Field = DynamicProtobufDecoder::Field;
+
+  void Int(const Field& field, int64_t value) override {
+    Add(field, fmt::format("{}", value));
+  }
+  void Uint(const Field& field, uint64_t value) override {
+    Add(field, fmt::format("{}u", value));
+  }
+  void Float(const Field& field, float value) override {
+    Add(field, fmt::format("{}f", value));
+  }
+  void Double(const Field& field, double value) override {
+    Add(field, fmt::format("{}", value));
+  }
+  void Bool(const Field& field, bool value) override {
+    Add(field, fmt::format("{}", value));
+  }
+  void String(const Field& field, std::string_view value) override {
+    Add(field, fmt::format("\"{}\"", value));
+  }
+  void Bytes(const Field& field, std::span<const uint8_t> value) override {
+    Add(field, fmt::format("{}", value));
+  }
+  void StartMessage(const Field& field) override { Add(field, "{"); }
+  void EndMessage(const Field& field) override { values.emplace_back("}"); }
+
+  void Add(const Field& field, std::string_view value) {
+    values.emplace_back(fmt::format("{}={}", field.name, value));
+  }
+
+  std::vector<std::string> values;
+};
+}  // namespace
+
+class DynamicProtobufDecoderTest : public ::testing::Test {
+ protected:
+  DynamicProtobufDecoderTest() {
+    auto file = wpi_proto_TestProto::file_descriptor();
+    db.Add(file.file_name, file.file_descriptor);
+  }
+
+  ProtobufMessageDatabase db;
+};
+
+TEST_F(DynamicProtobufDecoderTest, Compile) {
+  auto decoder = db.FindDecoder("wpi.proto.TestProto");
+  ASSERT_TRUE(decoder);
+  EXPECT_EQ(db.FindDecoder("wpi.proto.TestProto"), decoder);
+  EXPECT_FALSE(db.FindDecoder("wpi.proto.Unknown"));
+  EXPECT_EQ(decoder->GetName(), "wpi.proto.TestProto");
+  auto messages = decoder->GetMessages();
+  ASSERT_EQ(messages.size(), 2u);
+  ASSERT_EQ(messages[0].fields.size(), 16u);
+  auto& inner = messages[0].fields[15];
+  EXPECT_EQ(inner.name, "TestProtoInner_msg");
+  EXPECT_EQ(inner.number, 16u);
+  EXPECT_EQ(inner.type, DynamicProtobufDecoder::FieldType::kMessage);
+  EXPECT_FALSE(inner.repeated);
+  EXPECT_EQ(inner.message, 1);
+  EXPECT_EQ(messages[1].name, "wpi.proto.TestProtoInner");
+}
+
+TEST_F(DynamicProtobufDecoderTest, Scalars) {
+  auto msg = db.Find("wpi.proto.TestProto");
+  ASSERT_TRUE(msg);
+  auto desc = msg->GetDescriptor();
+  auto refl = msg->GetReflection();
+  refl->SetDouble(msg, desc->FindFieldByName("double_msg"), 1.5);
+  refl->SetFloat(msg, desc->FindFieldByName("float_msg"), -2.5f);
+  refl->SetInt32(msg, desc->FindFieldByName("int32_msg"), -3);
+  refl->SetInt64(msg, desc->FindFieldByName("int64_msg"), -4000000000000);
+  refl->SetUInt32(msg, desc->FindFieldByName("uint32_msg"), 4000000000u);
+  refl->SetUInt64(msg, desc->FindFieldByName("uint64_msg"), UINT64_MAX);
+  refl->SetInt32(msg, desc->FindFieldByName("sint32_msg"), INT32_MIN);
+  refl->SetInt64(msg, desc->FindFieldByName("sint64_msg"), -8);
+  refl->SetUInt32(msg, desc->FindFieldByName("fixed32_msg"), 9);
+  refl->SetUInt64(msg, desc->FindFieldByName("fixed64_msg"), 10);
+  refl->SetInt32(msg, desc->FindFieldByName("sfixed32_msg"), -11);
+  refl->SetInt64(msg, desc->FindFieldByName("sfixed64_msg"), -12);
+  refl->SetBool(msg, desc->FindFieldByName("bool_msg"), true);
+  refl->SetString(msg, desc->FindFieldByName("string_msg"), "hello");
+  refl->SetString(msg, desc->FindFieldByName("bytes_msg"),
+                  std::string{"\x01\x02", 2});
+  auto inner = refl->MutableMessage(
+      msg, desc->FindFieldByName("TestProtoInner_msg"), db.GetMessageFactory());
+  inner->GetReflection()->SetString(
+      inner, inner->GetDescriptor()->FindFieldByName("msg"), "inner");
+  std::string data = msg->SerializeAsString();
+
+  auto decoder = db.FindDecoder("wpi.proto.TestProto");
+  ASSERT_TRUE(decoder);
+  RecordingVisitor visitor;
+  ASSERT_TRUE(decoder->Decode(
+      {reinterpret_cast<const uint8_t*>(data.data()), data.size()}, visitor));
+  std::vector<std::string> expected{"double_msg=1.5",
+                                    "float_msg=-2.5f",
+                                    "int32_msg=-3",
+                                    "int64_msg=-4000000000000",
+                                    "uint32_msg=4000000000u",
+                                    "uint64_msg=18446744073709551615u",
+                                    "sint32_msg=-2147483648",
+                                    "sint64_msg=-8",
+                                    "fixed32_msg=9u",
+                                    "fixed64_msg=10u",
+                                    "sfixed32_msg=-11",
+                                    "sfixed64_msg=-12",
+                                    "bool_msg=true",
+                                    "string_msg=\"hello\"",
+                                    "bytes_msg=[1, 2]",
+                                    "TestProtoInner_msg={",
+                                    "msg=\"inner\"",
+                                    "}"};
+  EXPECT_EQ(visitor.values, expected);
+}
+
+TEST_F(DynamicProtobufDecoderTest, Repeated) {
+  auto msg = db.Find("wpi.proto.RepeatedTestProto");
+  ASSERT_TRUE(msg);
+  auto desc = msg->GetDescriptor();
+  auto refl = msg->GetReflection();
+  refl->AddDouble(msg, desc->FindFieldByName("double_msg"), 1);
+  refl->AddDouble(msg, desc->FindFieldByName("double_msg"), 2);
+  refl->AddInt32(msg, desc->FindFieldByName("sint32_msg"), -1);
+  refl->AddInt32(msg, desc->FindFieldByName("sint32_msg"), 1);
+  refl->AddBool(msg, desc->FindFieldByName("bool_msg"), false);
+  refl->AddString(msg, desc->FindFieldByName("string_msg"), "a");
+  refl->AddString(msg, desc->FindFieldByName("string_msg"), "b");
+  auto innerField = desc->FindFieldByName("TestProtoInner_msg");
+  refl->AddMessage(msg, innerField, db.GetMessageFactory());
+  std::string data = msg->SerializeAsString();
+
+  auto decoder = db.FindDecoder("wpi.proto.RepeatedTestProto");
+  ASSERT_TRUE(decoder);
+  RecordingVisitor visitor;
+  ASSERT_TRUE(decoder->Decode(
+      {reinterpret_cast<const uint8_t*>(data.data()), data.size()}, visitor));
+  std::vector<std::string> expected{
+      "double_msg=1",     "double_msg=2",      "sint32_msg=-1",
+      "sint32_msg=1",     "bool_msg=false",    "string_msg=\"a\"",
+      "string_msg=\"b\"", "TestProtoInner_msg={", "}"};
+  EXPECT_EQ(visitor.values, expected);
+}
+
+TEST_F(DynamicProtobufDecoderTest, UnpackedAndUnknown) {
+  auto decoder = db.FindDecoder("wpi.proto.RepeatedTestProto");
+  ASSERT_TRUE(decoder);
+  // unpacked int32_msg (3), unknown field 100, int32_msg as fixed32 (skipped)
+  const uint8_t data[] = {0x18, 0x05, 0x18, 0x7f, 0xa0, 0x06, 0x01,
+                          0x1d, 0x01, 0x02, 0x03, 0x04, 0x18, 0x02};
+  RecordingVisitor visitor;
+  ASSERT_TRUE(decoder->Decode(data, visitor));
+  std::vector<std::string> expected{"int32_msg=5", "int32_msg=127",
+                                    "int32_msg=2"};
+  EXPECT_EQ(visitor.values, expected);
+}
+
+TEST_F(DynamicProtobufDecoderTest, Malformed) {
+  auto decoder = db.FindDecoder("wpi.proto.TestProto");
+  ASSERT_TRUE(decoder);
+  RecordingVisitor visitor;
+  // truncated varint
+  const uint8_t data1[] = {0x18, 0x80};
+  EXPECT_FALSE(decoder->Decode(data1, visitor));
+  // truncated double
+  const uint8_t data2[] = {0x09, 0x00, 0x00};
+  EXPECT_FALSE(decoder->Decode(data2, visitor));
+  // length past end of data
+  const uint8_t data3[] = {0x72, 0x05, 'a'};
+  EXPECT_FALSE(decoder->Decode(data3, visitor));
+  EXPECT_TRUE(visitor.values.empty());
+}
+
+TEST(DynamicProtobufDecoderEnumTest, EnumNames) {
+  using google::protobuf::FieldDescriptorProto;
+  google::protobuf::FileDescriptorProto file;
+  file.set_name("enum.proto");
+  file.set_package("test");
+  file.set_syntax("proto3");
+  auto enumType = file.add_enum_type();
+  enumType->set_name("Color");
+  auto value = enumType->add_value();
+  value->set_name("RED");
+  value->set_number(0);
+  value = enumType->add_value();
+  value->set_name("BLUE");
+  value->set_number(2);
+  auto msg = file.add_message_type();
+  msg->set_name("Paint");
+  auto field = msg->add_field();
+  field->set_name("color");
+  field->set_number(1);
+  field->set_type(FieldDescriptorProto::TYPE_ENUM);
+  field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+  field->set_type_name(".test.Color");
+  std::string fileData = file.SerializeAsString();
+
+  ProtobufMessageDatabase db;
+  ASSERT_TRUE(db.Add("enum.proto",
+                     {reinterpret_cast<const uint8_t*>(fileData.data()),
+                      fileData.size()}));
+  auto decoder = db.FindDecoder("test.Paint");
+  ASSERT_TRUE(decoder);
+  auto& color = decoder->GetMessages()[0].fields[0];
+  EXPECT_EQ(color.type, DynamicProtobufDecoder::FieldType::kEnum);
+  EXPECT_EQ(color.GetEnumName(0), "RED");
+  EXPECT_EQ(color.GetEnumName(2), "BLUE");
+  EXPECT_EQ(color.GetEnumName(1), "");
+
+  const uint8_t data[] = {0x08, 0x02};
+  RecordingVisitor visitor;
+  ASSERT_TRUE(decoder->Decode(data, visitor));
+  EXPECT_EQ(visitor.values, std::vector<std::string>{"color=2"});
+}
@@ -0,0 +1,189 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/message.h>
+#include <gtest/gtest.h>
+
+#include "wpi/protobuf/DynamicProtobufDecoder.h"
+#include "wpi/protobuf/ProtobufMessageDatabase.h"
+#include "wpi/print.h"
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::FieldDescriptorProto;
+using google::protobuf::FileDescriptorProto;
+using google::protobuf::Message;
+
+namespace {
+struct FieldSpec {
+  std::string_view name;
+  FieldDescriptorProto::Type type;
+  std::string_view typeName = {};
+  bool repeated = false;
+};
+
+// same layout as the wpimath geometry and trajectory protos
+void AddMessage(FileDescriptorProto& file, std::string_view name,
+                std::initializer_list<FieldSpec> fields) {
+  auto msg = file.add_message_type();
+  msg->set_name(std::string{name});
+  int number = 1;
+  for (auto&& spec : fields) {
+    auto field = msg->add_field();
+    field->set_name(std::string{spec.name});
+    field->set_number(number++);
+    field->set_type(spec.type);
+    field->set_label(spec.repeated ? FieldDescriptorProto::LABEL_REPEATED
+                                   : FieldDescriptorProto::LABEL_OPTIONAL);
+    if (!spec.typeName.empty()) {
+      field->set_type_name(std::string{spec.typeName});
+    }
+  }
+}
+
+std::string MakeFile() {
+  constexpr auto kDouble = FieldDescriptorProto::TYPE_DOUBLE;
+  constexpr auto kMessage = FieldDescriptorProto::TYPE_MESSAGE;
+  FileDescriptorProto file;
+  file.set_name("bench.proto");
+  file.set_package("bench");
+  file.set_syntax("proto3");
+  AddMessage(file, "Translation3d",
+             {{"x", kDouble}, {"y", kDouble}, {"z", kDouble}});
+  AddMessage(file, "Quaternion",
+             {{"w", kDouble}, {"x", kDouble}, {"y", kDouble}, {"z", kDouble}});
+  AddMessage(file, "Rotation3d", {{"q", kMessage, ".bench.Quaternion"}});
+  AddMessage(file, "Pose3d",
+             {{"translation", kMessage, ".bench.Translation3d"},
+              {"rotation", kMessage, ".bench.Rotation3d"}});
+  AddMessage(file, "Translation2d", {{"x", kDouble}, {"y", kDouble}});
+  AddMessage(file, "Rotation2d", {{"value", kDouble}});
+  AddMessage(file, "Pose2d",
+             {{"translation", kMessage, ".bench.Translation2d"},
+              {"rotation", kMessage, ".bench.Rotation2d"}});
+  AddMessage(file, "TrajectoryState",
+             {{"time", kDouble},
+              {"velocity", kDouble},
+              {"acceleration", kDouble},
+              {"pose", kMessage, ".bench.Pose2d"},
+              {"curvature", kDouble}});
+  AddMessage(file, "Trajectory",
+             {{"states", kMessage, ".bench.TrajectoryState", true}});
+  return file.SerializeAsString();
+}
+
+// fills every double field (recursively) with increasing values
+void Fill(Message* msg, google::protobuf::MessageFactory* factory,
+          double* value, int numStates) {
+  auto desc = msg->GetDescriptor();
+  auto refl = msg->GetReflection();
+  for (int i = 0; i < desc->field_count(); ++i) {
+    auto field = desc->field(i);
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE) {
+      refl->SetDouble(msg, field, (*value) += 0.25);
+    } else if (field->is_repeated()) {
+      for (int j = 0; j < numStates; ++j) {
+        Fill(refl->AddMessage(msg, field, factory), factory, value, numStates);
+      }
+    } else {
+      Fill(refl->MutableMessage(msg, field, factory), factory, value,
+           numStates);
+    }
+  }
+}
+
+// sums every double field using protobuf reflection
+double Sum(const Message& msg) {
+  auto refl = msg.GetReflection();
+  std::vector<const FieldDescriptor*> fields;
+  refl->ListFields(msg, &fields);
+  double sum = 0;
+  for (auto field : fields) {
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE) {
+      sum += refl->GetDouble(msg, field);
+    } else if (field->is_repeated()) {
+      for (int j = 0, size = refl->FieldSize(msg, field); j < size; ++j) {
+        sum += Sum(refl->GetRepeatedMessage(msg, field, j));
+      }
+    } else {
+      sum += Sum(refl->GetMessage(msg, field));
+    }
+  }
+  return sum;
+}
+
+// sums every double field using the lightweight decoder
+class SumVisitor : public wpi::DynamicProtobufDecoder::Visitor {
+ public:
+  void Double(const wpi::DynamicProtobufDecoder::Field& field,
+              double value) override {
+    sum += value;
+  }
+
+  double sum = 0;
+};
+
+void RunBenchmark(std::string_view typeName, int numStates, int numLoops) {
+  using std::chrono::duration_cast;
+  using std::chrono::high_resolution_clock;
+  using std::chrono::microseconds;
+
+  wpi::ProtobufMessageDatabase db;
+  std::string file = MakeFile();
+  ASSERT_TRUE(db.Add("bench.proto",
+                     {reinterpret_cast<const uint8_t*>(file.data()),
+                      file.size()}));
+  auto msg = db.Find(typeName);
+  ASSERT_TRUE(msg);
+  double value = 0;
+  Fill(msg, db.GetMessageFactory(), &value, numStates);
+  std::string data = msg->SerializeAsString();
+  std::span<const uint8_t> bytes{reinterpret_cast<const uint8_t*>(data.data()),
+                                 data.size()};
+
+  // current path: parse into a dynamic message and read through reflection
+  double messageSum = 0;
+  auto start = high_resolution_clock::now();
+  for (int i = 0; i < numLoops; ++i) {
+    msg->Clear();
+    ASSERT_TRUE(msg->ParseFromArray(bytes.data(), bytes.size()));
+    messageSum += Sum(*msg);
+  }
+  auto messageUs =
+      duration_cast<microseconds>(high_resolution_clock::now() - start)
+          .count();
+
+  // lightweight decoder
+  auto decoder = db.FindDecoder(typeName);
+  ASSERT_TRUE(decoder);
+  SumVisitor visitor;
+  start = high_resolution_clock::now();
+  for (int i = 0; i < numLoops; ++i) {
+    ASSERT_TRUE(decoder->Decode(bytes, visitor));
+  }
+  auto decoderUs =
+      duration_cast<microseconds>(high_resolution_clock::now() - start)
+          .count();
+
+  wpi::print("{} ({} bytes) x{}: DynamicMessage {} us, decoder {} us\n",
+             typeName, bytes.size(), numLoops, messageUs, decoderUs);
+  EXPECT_EQ(visitor.sum, messageSum);
+}
+}  // namespace
+
+TEST(ProtobufDecoderBenchmark, Pose3d) {
+  RunBenchmark("bench.Pose3d", 0, 100000);
+}
+
+TEST(ProtobufDecoderBenchmark, Trajectory) {
+  RunBenchmark("bench.Trajectory", 100, 1000);
+}
@@ -0,0 +1,370 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/sendable/SendableRegistry.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "wpi/Synchronization.h"
+#include "wpi/mutex.h"
+#include "wpi/sendable/Sendable.h"
+#include "wpi/sendable/SendableBuilder.h"
+
+using wpi::SendableRegistry;
+
+namespace {
+// records double properties; all other properties are ignored
+class TestBuilder : public wpi::SendableBuilder {
+ public:
+  ~TestBuilder() override {
+    if (onDestroy) {
+      onDestroy();
+    }
+  }
+
+  void SetSmartDashboardType(std::string_view type) override {}
+  void SetActuator(bool value) override {}
+  void SetSafeState(std::function<void()> func) override {}
+  void AddBooleanProperty(std::string_view key, std::function<bool()> getter,
+                          std::function<void(bool)> setter) override {}
+  void PublishConstBoolean(std::string_view key, bool value) override {}
+  void AddIntegerProperty(std::string_view key,
+                          std::function<int64_t()> getter,
+                          std::function<void(int64_t)> setter) override {}
+  void PublishConstInteger(std::string_view key, int64_t value) override {}
+  void AddFloatProperty(std::string_view key, std::function<float()> getter,
+                        std::function<void(float)> setter) override {}
+  void PublishConstFloat(std::string_view key, float value) override {}
+  void AddDoubleProperty(std::string_view key, std::function<double()> getter,
+                         std::function<void(double)> setter) override {
+    getters.emplace_back(std::move(getter));
+  }
+  void PublishConstDouble(std::string_view key, double value) override {}
+  void AddStringProperty(
+      std::string_view key, std::function<std::string()> getter,
+      std::function<void(std::string_view)> setter) override {}
+  void PublishConstString(std::string_view key,
+                          std::string_view value) override {}
+  void AddBooleanArrayProperty(
+      std::string_view key, std::function<std::vector<int>()> getter,
+      std::function<void(std::span<const int>)> setter) override {}
+  void PublishConstBooleanArray(std::string_view key,
+                                std::span<const int> value) override {}
+  void AddIntegerArrayProperty(
+      std::string_view key, std::function<std::vector<int64_t>()> getter,
+      std::function<void(std::span<const int64_t>)> setter) override {}
+  void PublishConstIntegerArray(std::string_view key,
+                                std::span<const int64_t> value) override {}
+  void AddFloatArrayProperty(
+      std::string_view key, std::function<std::vector<float>()> getter,
+      std::function<void(std::span<const float>)> setter) override {}
+  void PublishConstFloatArray(std::string_view key,
+                              std::span<const float> value) override {}
+  void AddDoubleArrayProperty(
+      std::string_view key, std::function<std::vector<double>()> getter,
+      std::function<void(std::span<const double>)> setter) override {}
+  void PublishConstDoubleArray(std::string_view key,
+                               std::span<const double> value) override {}
+  void AddStringArrayProperty(
+      std::string_view key, std::function<std::vector<std::string>()> getter,
+      std::function<void(std::span<const std::string>)> setter) override {}
+  void PublishConstStringArray(std::string_view key,
+                               std::span<const std::string> value) override {}
+  void AddRawProperty(
+      std::string_view key, std::string_view typeString,
+      std::function<std::vector<uint8_t>()> getter,
+      std::function<void(std::span<const uint8_t>)> setter) override {}
+  void PublishConstRaw(std::string_view key, std::string_view typeString,
+                       std::span<const uint8_t> value) override {}
+  void AddSmallStringProperty(
+      std::string_view key,
+      std::function<std::string_view(wpi::SmallVectorImpl<char>& buf)> getter,
+      std::function<void(std::string_view)> setter) override {}
+  void AddSmallBooleanArrayProperty(
+      std::string_view key,
+      std::function<std::span<const int>(wpi::SmallVectorImpl<int>& buf)>
+          getter,
+      std::function<void(std::span<const int>)> setter) override {}
+  void AddSmallIntegerArrayProperty(
+      std::string_view key,
+      std::function<
+          std::span<const int64_t>(wpi::SmallVectorImpl<int64_t>& buf)>
+          getter,
+      std::function<void(std::span<const int64_t>)> setter) override {}
+  void AddSmallFloatArrayProperty(
+      std::string_view key,
+      std::function<std::span<const float>(wpi::SmallVectorImpl<float>& buf)>
+          getter,
+      std::function<void(std::span<const float>)> setter) override {}
+  void AddSmallDoubleArrayProperty(
+      std::string_view key,
+      std::function<std::span<const double>(wpi::SmallVectorImpl<double>& buf)>
+          getter,
+      std::function<void(std::span<const double>)> setter) override {}
+  void AddSmallStringArrayProperty(
+      std::string_view key,
+      std::function<
+          std::span<const std::string>(wpi::SmallVectorImpl<std::string>& buf)>
+          getter,
+      std::function<void(std::span<const std::string>)> setter) override {}
+  void AddSmallRawProperty(
+      std::string_view key, std::string_view typeString,
+      std::function<std::span<uint8_t>(wpi::SmallVectorImpl<uint8_t>& buf)>
+          getter,
+      std::function<void(std::span<const uint8_t>)> setter) override {}
+
+  BackendKind GetBackendKind() const override { return kUnknown; }
+  bool IsPublished() const override { return true; }
+
+  void Update() override {
+    ++updates;
+    if (onUpdate) {
+      onUpdate();
+    }
+    values.clear();
+    for (auto&& getter : getters) {
+      values.emplace_back(getter());
+    }
+  }
+
+  void ClearProperties() override {
+    getters.clear();
+    ++clears;
+  }
+
+  std::vector<std::function<double()>> getters;
+  std::vector<double> values;
+  std::atomic_int updates{0};
+  int clears = 0;
+  std::function<void()> onUpdate;
+  std::function<void()> onDestroy;
+};
+
+class TestSendable : public wpi::Sendable {
+ public:
+  explicit TestSendable(double value = 0) : value{value} {}
+  ~TestSendable() override { SendableRegistry::Remove(this); }
+
+  void InitSendable(wpi::SendableBuilder& builder) override {
+    builder.AddDoubleProperty(
+        "value", [this] { return value; }, nullptr);
+  }
+
+  double value;
+};
+
+// publishes a sendable with a TestBuilder, returning the builder
+TestBuilder* Publish(TestSendable* sendable, std::string_view name) {
+  SendableRegistry::Add(sendable, name);
+  auto builder = std::make_unique<TestBuilder>();
+  auto rv = builder.get();
+  SendableRegistry::Publish(SendableRegistry::GetUniqueId(sendable),
+                            std::move(builder));
+  return rv;
+}
+}  // namespace
+
+TEST(SendableRegistryTest, RemoveWaitsForUpdate) {
+  TestSendable sendable{1.0};
+  auto builder = Publish(&sendable, "sendable");
+  auto uid = SendableRegistry::GetUniqueId(&sendable);
+
+  wpi::mutex eventsMutex;
+  std::vector<std::string> events;
+  auto addEvent = [&](std::string event) {
+    std::scoped_lock lock{eventsMutex};
+    events.emplace_back(std::move(event));
+  };
+  wpi::Event updating;
+  wpi::Event release;
+  builder->onUpdate = [&] {
+    wpi::SetEvent(updating.GetHandle());
+    wpi::WaitForObject(release.GetHandle());
+    addEvent("updated");
+  };
+  builder->onDestroy = [&] { addEvent("destroyed"); };
+
+  std::thread updater{[&] { SendableRegistry::Update(uid); }};
+  ASSERT_TRUE(wpi::WaitForObject(updating.GetHandle(), 1.0, nullptr));
+
+  // Remove() must not destroy the builder until the update finishes; the
+  // delay just gives an incorrect Remove() a chance to do so
+  std::thread remover{[&] {
+    EXPECT_TRUE(SendableRegistry::Remove(&sendable));
+    addEvent("removed");
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  wpi::SetEvent(release.GetHandle());
+  updater.join();
+  remover.join();
+
+  EXPECT_EQ(events,
+            (std::vector<std::string>{"updated", "destroyed", "removed"}));
+  EXPECT_FALSE(SendableRegistry::Contains(&sendable));
+  EXPECT_EQ(SendableRegistry::GetSendable(uid), nullptr);
+  // no effect once removed
+  SendableRegistry::Update(uid);
+}
+
+TEST(SendableRegistryTest, RemoveFromGetter) {
+  TestSendable sendable{1.0};
+  auto builder = Publish(&sendable, "sendable");
+  auto uid = SendableRegistry::GetUniqueId(&sendable);
+
+  std::vector<std::string> events;
+  builder->getters.emplace_back([&] {
+    EXPECT_TRUE(SendableRegistry::Remove(&sendable));
+    events.emplace_back("removed");
+    return 2.0;
+  });
+  builder->onDestroy = [&] { events.emplace_back("destroyed"); };
+
+  // must not deadlock; the builder is destroyed once the update finishes
+  SendableRegistry::Update(uid);
+  EXPECT_EQ(events, (std::vector<std::string>{"removed", "destroyed"}));
+  EXPECT_FALSE(SendableRegistry::Contains(&sendable));
+  EXPECT_EQ(SendableRegistry::GetSendable(uid), nullptr);
+}
+
+TEST(SendableRegistryTest, MoveFromGetter) {
+  TestSendable from{1.0};
+  auto builder = Publish(&from, "moved");
+  auto uid = SendableRegistry::GetUniqueId(&from);
+
+  TestSendable to{2.0};
+  builder->getters.emplace_back([&] {
+    SendableRegistry::Move(&to, &from);
+    // not rebuilt while the properties are being read
+    EXPECT_EQ(builder->clears, 0);
+    return 0.0;
+  });
+  SendableRegistry::Update(uid);
+  EXPECT_EQ(builder->values, (std::vector<double>{1.0, 0.0}));
+  EXPECT_EQ(builder->clears, 1);
+  EXPECT_EQ(SendableRegistry::GetSendable(uid), &to);
+
+  SendableRegistry::Update(uid);
+  EXPECT_EQ(builder->values, std::vector<double>{2.0});
+}
+
+TEST(SendableRegistryTest, MoveRebuildsBuilder) {
+  auto from = std::make_unique<TestSendable>(1.0);
+  auto builder = Publish(from.get(), "moved");
+  auto uid = SendableRegistry::GetUniqueId(from.get());
+  EXPECT_EQ(builder->values, std::vector<double>{1.0});
+
+  // as a move constructor would
+  TestSendable to{from->value};
+  SendableRegistry::Move(&to, from.get());
+  from.reset();
+  to.value = 2.0;
+
+  EXPECT_EQ(builder->clears, 1);
+  EXPECT_EQ(SendableRegistry::GetSendable(uid), &to);
+  EXPECT_EQ(SendableRegistry::GetUniqueId(&to), uid);
+  EXPECT_EQ(SendableRegistry::GetName(&to), "moved");
+
+  // the property getter now reads the new object
+  SendableRegistry::Update(uid);
+  EXPECT_EQ(builder->values, std::vector<double>{2.0});
+}
+
+TEST(SendableRegistryTest, UpdateAllConcurrentRegistration) {
+  constexpr int kNumSendables = 10;
+  constexpr int kNumUpdates = 200;
+
+  std::vector<std::unique_ptr<TestSendable>> sendables;
+  std::vector<TestBuilder*> builders;
+  std::vector<SendableRegistry::UID> uids;
+  for (int i = 0; i < kNumSendables; ++i) {
+    sendables.emplace_back(std::make_unique<TestSendable>(i));
+    builders.emplace_back(
+        Publish(sendables.back().get(), fmt::format("sendable{}", i)));
+    uids.emplace_back(SendableRegistry::GetUniqueId(sendables.back().get()));
+  }
+
+  // the registry is not locked while builders update, so objects can be
+  // registered from within an update (this deadlocks if it is locked)
+  int registeredInUpdate = 0;
+  builders[0]->onUpdate = [&] {
+    std::thread{[&] {
+      TestSendable other;
+      SendableRegistry::Add(&other, "inupdate");
+      SendableRegistry::GetUniqueId(&other);
+      ++registeredInUpdate;
+    }}.join();
+  };
+
+  // other objects come and go while the updates run
+  std::atomic_bool done{false};
+  std::thread registrar{[&] {
+    int i = 0;
+    while (!done) {
+      TestSendable other;
+      SendableRegistry::AddLW(&other, "Other", fmt::format("other{}", i++));
+      SendableRegistry::GetUniqueId(&other);
+    }
+  }};
+
+  for (int i = 0; i < kNumUpdates; ++i) {
+    SendableRegistry::UpdateAll(uids);
+  }
+  done = true;
+  registrar.join();
+
+  EXPECT_EQ(registeredInUpdate, kNumUpdates);
+  for (int i = 0; i < kNumSendables; ++i) {
+    // one update when published
+    EXPECT_EQ(builders[i]->updates.load(), kNumUpdates + 1);
+    EXPECT_EQ(builders[i]->values, std::vector<double>{1.0 * i});
+  }
+}
+
+TEST(SendableRegistryTest, ForeachLiveWindowData) {
+  SendableRegistry::SetLiveWindowBuilderFactory(
+      [] { return std::make_unique<TestBuilder>(); });
+  TestSendable sendable;
+  SendableRegistry::AddLW(&sendable, "Subsystem", "name");
+  int handle = SendableRegistry::GetDataHandle();
+
+  int calls = 0;
+  SendableRegistry::ForeachLiveWindow(handle, [&](auto& cbdata) {
+    if (cbdata.sendable != &sendable) {
+      return;
+    }
+    ++calls;
+    EXPECT_EQ(cbdata.name, "name");
+    EXPECT_EQ(cbdata.subsystem, "Subsystem");
+    EXPECT_FALSE(cbdata.data);
+    // the registry is not locked while the callback runs
+    EXPECT_EQ(SendableRegistry::GetName(cbdata.sendable), "name");
+    cbdata.data = std::make_shared<int>(5);
+  });
+  EXPECT_EQ(calls, 1);
+
+  // the data pointer set in the callback is written back
+  auto data = SendableRegistry::GetData(&sendable, handle);
+  ASSERT_TRUE(data);
+  EXPECT_EQ(*static_cast<int*>(data.get()), 5);
+  SendableRegistry::ForeachLiveWindow(handle, [&](auto& cbdata) {
+    if (cbdata.sendable == &sendable) {
+      ++calls;
+      EXPECT_EQ(cbdata.data, data);
+    }
+  });
+  EXPECT_EQ(calls, 2);
+
+  SendableRegistry::SetLiveWindowBuilderFactory(nullptr);
+}
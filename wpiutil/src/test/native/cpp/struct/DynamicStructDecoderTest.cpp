@@ -0,0 +1,117 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/struct/DynamicStructDecoder.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace wpi;
+
+class DynamicStructDecoderTest : public ::testing::Test {
+ protected:
+  StructDescriptorDatabase db;
+  std::string err;
+};
+
+TEST_F(DynamicStructDecoderTest, Columns) {
+  ASSERT_TRUE(db.Add("inner", "double x; double y", &err));
+  auto desc = db.Add(
+      "test", "inner a; inner b[2]; int8 c[3]; char s[4]; uint8 d:4; bool e:1",
+      &err);
+  ASSERT_TRUE(desc);
+  ASSERT_TRUE(desc->IsValid());
+  DynamicStructDecoder decoder{desc};
+  auto columns = decoder.GetColumns();
+  ASSERT_EQ(columns.size(), 12u);
+  EXPECT_EQ(columns[0].name, "a.x");
+  EXPECT_EQ(columns[1].name, "a.y");
+  EXPECT_EQ(columns[2].name, "b[0].x");
+  EXPECT_EQ(columns[5].name, "b[1].y");
+  EXPECT_EQ(columns[6].name, "c[0]");
+  EXPECT_EQ(columns[8].name, "c[2]");
+  EXPECT_EQ(columns[8].arrIndex, 2u);
+  EXPECT_EQ(columns[9].name, "s");
+  EXPECT_EQ(columns[10].name, "d");
+  EXPECT_EQ(columns[11].name, "e");
+  EXPECT_EQ(decoder.FindColumn("b[1].x"), 4);
+  EXPECT_EQ(decoder.FindColumn("b"), -1);
+}
+
+TEST_F(DynamicStructDecoderTest, Decode) {
+  ASSERT_TRUE(db.Add("inner", "double x; float y", &err));
+  auto desc = db.Add("test",
+                     "inner a; int16 b; uint32 c; bool d; char s[3]; "
+                     "int8 e:4; uint8 f:3; bool g:1",
+                     &err);
+  ASSERT_TRUE(desc);
+  ASSERT_TRUE(desc->IsValid());
+  auto fA = desc->FindFieldByName("a");
+  auto fB = desc->FindFieldByName("b");
+  auto fC = desc->FindFieldByName("c");
+  auto fD = desc->FindFieldByName("d");
+  auto fS = desc->FindFieldByName("s");
+  auto fE = desc->FindFieldByName("e");
+  auto fF = desc->FindFieldByName("f");
+  auto fG = desc->FindFieldByName("g");
+  auto fX = fA->GetStruct()->FindFieldByName("x");
+  auto fY = fA->GetStruct()->FindFieldByName("y");
+
+  // enough records to span multiple blocks, plus a partial trailing record
+  constexpr size_t kCount = 1000;
+  size_t size = desc->GetSize();
+  std::vector<uint8_t> data(size * kCount + 1);
+  for (size_t i = 0; i < kCount; ++i) {
+    MutableDynamicStruct s{desc, std::span{data}.subspan(i * size, size)};
+    auto a = s.GetStructField(fA);
+    a.SetDoubleField(fX, i * 0.5);
+    a.SetFloatField(fY, i * 0.25f);
+    s.SetIntField(fB, -static_cast<int64_t>(i));
+    s.SetUintField(fC, i * 100000);
+    s.SetBoolField(fD, (i % 2) == 0);
+    s.SetStringField(fS, (i % 3) == 0 ? "abc" : "x");
+    s.SetIntField(fE, i % 16);
+    s.SetUintField(fF, i % 8);
+    s.SetBoolField(fG, (i % 3) == 0);
+  }
+
+  DynamicStructDecoder decoder{desc};
+  DynamicStructColumns columns;
+  ASSERT_EQ(decoder.Decode(data, &columns), kCount);
+  ASSERT_EQ(decoder.Decode(std::span{data}.first(size * 2), &columns), 2u);
+  ASSERT_EQ(columns.size(), kCount + 2);
+
+  auto x = columns.GetDoubleColumn(decoder.FindColumn("a.x"));
+  auto y = columns.GetFloatColumn(decoder.FindColumn("a.y"));
+  auto b = columns.GetIntColumn(decoder.FindColumn("b"));
+  auto c = columns.GetUintColumn(decoder.FindColumn("c"));
+  auto d = columns.GetBoolColumn(decoder.FindColumn("d"));
+  auto str = columns.GetStringColumn(decoder.FindColumn("s"));
+  auto e = columns.GetIntColumn(decoder.FindColumn("e"));
+  auto f = columns.GetUintColumn(decoder.FindColumn("f"));
+  auto g = columns.GetBoolColumn(decoder.FindColumn("g"));
+  ASSERT_EQ(x.size(), kCount + 2);
+  ASSERT_EQ(g.size(), kCount + 2);
+  for (size_t j = 0; j < kCount + 2; ++j) {
+    size_t i = j < kCount ? j : j - kCount;
+    DynamicStruct s{desc, std::span{data}.subspan(i * size, size)};
+    EXPECT_EQ(x[j], i * 0.5);
+    EXPECT_EQ(y[j], i * 0.25f);
+    EXPECT_EQ(b[j], -static_cast<int64_t>(i));
+    EXPECT_EQ(c[j], i * 100000);
+    EXPECT_EQ(d[j], (i % 2) == 0 ? 1 : 0);
+    EXPECT_EQ(str[j], s.GetStringField(fS));
+    EXPECT_EQ(e[j], s.GetIntField(fE));
+    EXPECT_EQ(f[j], i % 8);
+    EXPECT_EQ(g[j], (i % 3) == 0 ? 1 : 0);
+  }
+
+  columns.clear();
+  EXPECT_EQ(columns.size(), 0u);
+  EXPECT_TRUE(columns.GetDoubleColumn(decoder.FindColumn("a.x")).empty());
+}